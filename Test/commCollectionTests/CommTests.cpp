@@ -6,7 +6,16 @@
 //  Copyright (c) 2016 NASA Diagnostics and Prognostics Group. All rights reserved.
 //
 
+#include <chrono>
+#include <cmath>
+#include <condition_variable>
+#include <cstdio>
+#include <fstream>
+#include <ios>
 #include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
 
 #include "Test.h"
 #include "CommTests.h"
@@ -16,6 +25,8 @@
 #include "PlaybackCommunicator.h"
 #include "CommunicatorFactory.h"
 #include "DataStore.h"
+#include "MappedFile.h"
+#include "RecordingFile.h"
 
 using namespace PCOE;
 using namespace PCOE::Test;
@@ -101,11 +112,264 @@ void RecorderCommunicatorTest()
     RecorderCommunicator theComm2(theMap);
 }
 
+namespace {
+    // Poll a communicator and wait up to a second for the data it reads
+    DataStore pollAndWait(CommonCommunicator & comm, std::mutex & m,
+                          std::condition_variable & cv, bool & received, DataStore & data) {
+        std::unique_lock<std::mutex> lock(m);
+        received = false;
+        comm.poll();
+        cv.wait_for(lock, std::chrono::seconds(1), [&] { return received; });
+        Assert::IsTrue(received, "No data read");
+        return data;
+    }
+}
+
 void PlaybackCommunicatorTest()
 {
     ConfigMap theMap;
-//    PlaybackCommunicator theComm(theMap);
-//
-//    theMap.set("file", "TestRecorderFile.txt");
-//    PlaybackCommunicator theComm2(theMap);
+    theMap.set("file", "TestPlaybackFile.txt");
+    try {
+        PlaybackCommunicator theComm(theMap);
+        Assert::Fail("Opened missing file");
+    }
+    catch (const std::ios_base::failure &) { }
+
+    {
+        std::ofstream out("TestPlaybackFile.txt");
+        out << "Recorded by test\n"
+            << "Timestamp\tpower\tvoltage\ttemperature\r\n"
+            << "0.00\t0.00\t20.00\t4.10\r\n"
+            << "1.5\t-4.25e1\t0.1\t12345678901234567890123\n"
+            << "2\tnan\t 3.5 (1500)\t1e-30\n"
+            << "3\t1\t2\n";
+    }
+    theMap.set("delim", "\\t");
+    PlaybackCommunicator theComm(theMap);
+
+    std::mutex m;
+    std::condition_variable cv;
+    bool received = false;
+    DataStore data;
+    theComm.subscribe([&](DataStore & ds) {
+        std::lock_guard<std::mutex> guard(m);
+        data = ds;
+        received = true;
+        cv.notify_all();
+    });
+
+    DataStore ds = pollAndWait(theComm, m, cv, received, data);
+    Assert::AreEqual(3, ds.size(), "Incorrect number of parameters");
+    Assert::AreEqual(0.0, ds["power"], 1e-15, "Incorrect power [0]");
+    Assert::AreEqual(20.0, ds["voltage"], 1e-15, "Incorrect voltage [0]");
+    Assert::AreEqual(4.1, ds["temperature"], 1e-15, "Incorrect temperature [0]");
+    auto start = ds["power"].getTime();
+
+    ds = pollAndWait(theComm, m, cv, received, data);
+    Assert::AreEqual(-42.5, ds["power"], 1e-15, "Incorrect power [1]");
+    Assert::AreEqual(0.1, ds["voltage"], 1e-15, "Incorrect voltage [1]");
+    Assert::AreEqual(12345678901234567890123.0, ds["temperature"], 1e7, "Incorrect temperature [1]");
+    Assert::AreEqual(static_cast<Datum<double>::ms_rep>(1500), ds["power"].getTime() - start, "Incorrect timestamp [1]");
+
+    ds = pollAndWait(theComm, m, cv, received, data);
+    Assert::IsTrue(std::isnan(ds["power"].get()), "Incorrect power [2]");
+    Assert::AreEqual(3.5, ds["voltage"], 1e-15, "Incorrect voltage [2]");
+    Assert::AreEqual(1e-30, ds["temperature"], 1e-45, "Incorrect temperature [2]");
+
+    // Short row, then end of file
+    ds = pollAndWait(theComm, m, cv, received, data);
+    Assert::AreEqual(0, ds.size(), "Data read from short row");
+    ds = pollAndWait(theComm, m, cv, received, data);
+    Assert::AreEqual(0, ds.size(), "Data read past end of file");
+
+    theComm.stop();
+    theComm.join();
+    std::remove("TestPlaybackFile.txt");
+}
+
+namespace {
+    // Record snapshots of data and prognostic results with a recorder
+    void recordSnapshots(const ConfigMap & config) {
+        ProgData progData;
+        progData.setPredictions(1, 2);
+        progData.addEvent("EOD");
+        progData.addSystemTrajectory("SOC");
+        progData.setUncertainty(UType::Samples);
+        progData.events["EOD"].timeOfEvent.npoints(3);
+        progData.sysTrajectories["SOC"][0].npoints(3);
+        ProgDataMap progDataMap;
+        progDataMap["Battery"] = &progData;
+
+        RecorderCommunicator recorder(config);
+        DataStore data;
+        for (int i = 0; i < 3; i++) {
+            data["voltage"] = 4.0 - i;
+            data["power"] = 10.0 * i;
+            progData.events["EOD"].timeOfEvent.setVec(0, { 100.0 + i, 110.0 + i, 120.0 + i });
+            progData.sysTrajectories["SOC"][0].setVec(0, { 0.5, 0.25, 0.125 });
+            recorder.enqueue(AllData(data, DataStoreString(), progDataMap));
+        }
+        for (int i = 0; i < 100 && recorder.getQueueStats().written < 3; i++) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        }
+        Assert::AreEqual(3, recorder.getQueueStats().written, "Snapshots not written");
+    }
+
+    std::vector<std::string> readLines(const std::string & fileName) {
+        std::ifstream in(fileName);
+        std::vector<std::string> lines;
+        std::string line;
+        while (std::getline(in, line)) {
+            lines.push_back(line);
+        }
+        return lines;
+    }
+}
+
+void RecorderBinaryTest()
+{
+    ConfigMap theMap;
+    theMap.set("saveFile", "TestRecording.csv");
+    recordSnapshots(theMap);
+    theMap.set("saveFile", "TestRecording.bin");
+    theMap.set("format", "binary");
+    theMap.set("chunkSize", "2");
+    recordSnapshots(theMap);
+
+    // Converted recordings have the same columns as csv recordings
+    RecorderCommunicator::convertToCsv("TestRecording.bin", "TestConverted.csv");
+    std::vector<std::string> csv = readLines("TestRecording.csv");
+    std::vector<std::string> converted = readLines("TestConverted.csv");
+    Assert::AreEqual(5, converted.size(), "Incorrect number of lines");
+    Assert::AreEqual(csv.size(), converted.size(), "Line counts differ");
+    Assert::IsTrue(csv[1] == converted[1], "Headers differ");
+    Assert::IsTrue(converted[1].find("pData-Battery.Events[EOD].TOE") != std::string::npos,
+                   "Event not in header");
+    Assert::IsTrue(converted[4].find("[102.000000 (v=1; t=") != std::string::npos,
+                   "Event samples not converted");
+
+    // Binary recordings play back directly
+    ConfigMap playbackMap;
+    playbackMap.set("file", "TestRecording.bin");
+    PlaybackCommunicator theComm(playbackMap);
+    std::mutex m;
+    std::condition_variable cv;
+    bool received = false;
+    DataStore data;
+    theComm.subscribe([&](DataStore & ds) {
+        std::lock_guard<std::mutex> guard(m);
+        data = ds;
+        received = true;
+        cv.notify_all();
+    });
+    for (int i = 0; i < 3; i++) {
+        DataStore ds = pollAndWait(theComm, m, cv, received, data);
+        Assert::AreEqual(2, ds.size(), "Incorrect number of parameters");
+        Assert::AreEqual(4.0 - i, ds["voltage"], 1e-15, "Incorrect voltage");
+        Assert::AreEqual(10.0 * i, ds["power"], 1e-15, "Incorrect power");
+    }
+    DataStore ds = pollAndWait(theComm, m, cv, received, data);
+    Assert::AreEqual(0, ds.size(), "Data read past end of recording");
+
+    theComm.stop();
+    theComm.join();
+    std::remove("TestRecording.csv");
+    std::remove("TestRecording.bin");
+    std::remove("TestConverted.csv");
+}
+
+namespace {
+    // Record snapshots whose prognostic results change after the first: prognoser A is
+    // missing from the second snapshot, and prognoser B gains an event
+    void recordChangingSnapshots(const ConfigMap & config) {
+        ProgData progDataA;
+        ProgData progDataB;
+        for (ProgData * progData : { &progDataA, &progDataB }) {
+            progData->setPredictions(1, 2);
+            progData->addEvent("EOD");
+            progData->setUncertainty(UType::Samples);
+            progData->events["EOD"].timeOfEvent.npoints(2);
+        }
+        progDataA.events["EOD"].timeOfEvent.setVec(0, { 1.0, 2.0 });
+        progDataB.events["EOD"].timeOfEvent.setVec(0, { 3.0, 4.0 });
+        ProgDataMap progDataMap;
+        progDataMap["A"] = &progDataA;
+        progDataMap["B"] = &progDataB;
+
+        RecorderCommunicator recorder(config);
+        DataStore data;
+        data["voltage"] = 4.0;
+        recorder.enqueue(AllData(data, DataStoreString(), progDataMap));
+        // Prognostic results are shared, so the first must be written before they change
+        for (int i = 0; i < 100 && recorder.getQueueStats().written < 1; i++) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        }
+
+        ProgDataMap changedMap;
+        changedMap["B"] = &progDataB;
+        progDataB.addEvent("EOL");
+        progDataB.events["EOD"].timeOfEvent.npoints(2);
+        progDataB.events["EOD"].timeOfEvent.setVec(0, { 3.0, 4.0 });
+        recorder.enqueue(AllData(data, DataStoreString(), changedMap));
+        recorder.enqueue(AllData(data, DataStoreString(), progDataMap));
+
+        for (int i = 0; i < 100 && recorder.getQueueStats().written < 3; i++) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        }
+        Assert::AreEqual(3, recorder.getQueueStats().written, "Snapshots not written");
+    }
+
+    std::size_t countSeparators(const std::string & line) {
+        std::size_t count = 0;
+        for (std::size_t pos = line.find(", "); pos != std::string::npos; pos = line.find(", ", pos + 2)) {
+            count++;
+        }
+        return count;
+    }
+}
+
+void RecorderSchemaTest()
+{
+    // Every row of a csv recording has the columns of the header
+    ConfigMap theMap;
+    theMap.set("saveFile", "TestSchema.csv");
+    recordChangingSnapshots(theMap);
+    std::vector<std::string> csv = readLines("TestSchema.csv");
+    Assert::AreEqual(5, csv.size(), "Incorrect number of lines");
+    for (std::size_t line = 2; line < csv.size(); line++) {
+        Assert::AreEqual(countSeparators(csv[1]), countSeparators(csv[line]), "Row does not match header");
+    }
+
+    // Binary recordings keep recording, with the missing prognoser left empty
+    theMap.set("saveFile", "TestSchema.bin");
+    theMap.set("format", "binary");
+    recordChangingSnapshots(theMap);
+    MappedFile input("TestSchema.bin");
+    RecordingReader reader(input.data(), input.size());
+    std::size_t columnA = reader.getColumns().size();
+    std::size_t columnB = reader.getColumns().size();
+    for (std::size_t column = 0; column < reader.getColumns().size(); column++) {
+        const std::string & name = reader.getColumns()[column].name;
+        if (name.find("pData-A.Events[EOD].TOE") == 0) {
+            columnA = column;
+        }
+        if (name.find("pData-B.Events[EOD].TOE") == 0) {
+            columnB = column;
+        }
+    }
+    Assert::AreEqual(3, reader.getColumns().size(), "Incorrect number of columns");
+    Assert::IsTrue(columnA < 3 && columnB < 3, "Event columns not recorded");
+
+    Assert::IsTrue(reader.nextChunk(), "No rows recorded");
+    Assert::AreEqual(3, reader.rows(), "Incorrect number of rows");
+    for (std::size_t row = 0; row < 3; row++) {
+        RecordingReader::Cell a = reader.get(columnA, row);
+        RecordingReader::Cell b = reader.get(columnB, row);
+        Assert::AreEqual(row == 1 ? 0 : 2, a.count, "Incorrect samples for A");
+        Assert::AreEqual(2, b.count, "Incorrect samples for B");
+        Assert::AreEqual(3.0, b.values[0], 0.0, "Incorrect time of event for B");
+    }
+
+    std::remove("TestSchema.csv");
+    std::remove("TestSchema.bin");
 }
@@ -12,5 +12,7 @@
 void RandomCommTest();
 void RecorderCommunicatorTest();
 void PlaybackCommunicatorTest();
+void RecorderBinaryTest();
+void RecorderSchemaTest();
 
 #endif // COMMTESTS_H
@@ -26,6 +26,8 @@ int main() {
     context.AddTest("RandomComm", RandomCommTest);
     context.AddTest("PlaybackComm", PlaybackCommunicatorTest);
     context.AddTest("RecorderComm", RecorderCommunicatorTest);
+    context.AddTest("RecorderBinary", RecorderBinaryTest);
+    context.AddTest("RecorderSchema", RecorderSchemaTest);
 
     int result = context.Execute();
     std::ofstream junit("testresults/commCollection.xml");
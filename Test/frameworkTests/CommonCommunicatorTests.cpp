@@ -10,7 +10,9 @@
  *             Administration. All Rights Reserved.
  **/
 
+#include <atomic>
 #include <thread>
+#include <vector>
 
 #include "Test.h"
 
@@ -53,6 +55,34 @@ namespace TestCommonCommunicator {
         Assert::AreEqual(tc.readData, ds, "Read data");
     }
 
+    void snapshot() {
+        AllDataPool pool;
+        DataStore ds;
+        ds["a"] = 42;
+        ProgDataMap pdm;
+        const AllData * first;
+        {
+            // One snapshot is shared by every communicator
+            AllDataSnapshot data = pool.publish(ds, DataStoreString(), pdm);
+            first = data.get();
+            TestCommunicator tc1;
+            TestCommunicator tc2;
+            tc1.enqueue(data);
+            tc2.enqueue(data);
+            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+            Assert::AreEqual(1, tc1.writeCount, "Write count");
+            Assert::AreEqual(1, tc2.writeCount, "Write count");
+            Assert::AreEqual(ds, tc1.writeData, "Write data");
+            Assert::AreEqual(ds, tc2.writeData, "Write data");
+        }
+
+        // Once released, its storage is reused for the next snapshot
+        ds["a"] = 7;
+        AllDataSnapshot next = pool.publish(ds, DataStoreString(), pdm);
+        Assert::IsTrue(first == next.get(), "Storage not reused");
+        Assert::AreEqual(ds, next->doubleDatastore, "Reused snapshot data");
+    }
+
     void stop() {
         using clock = std::chrono::high_resolution_clock;
         using duration = clock::duration;
@@ -65,4 +95,132 @@ namespace TestCommonCommunicator {
         duration timeTaken = clock::now() - start;
         Assert::IsTrue(timeTaken < std::chrono::milliseconds(1), "Took too long to join");
     }
+
+    /** Send values 1 to count to the communicator. The first is being written,
+     *  and the writer waits, while the rest are sent. */
+    static void sendWhileWriting(GatedCommunicator & gc, int count) {
+        for (int i = 1; i <= count; i++) {
+            DataStore ds;
+            ds["a"] = i;
+            gc.enqueue(AllData(ds, DataStoreString(), ProgDataMap()));
+            while (i == 1 && !gc.writing) {
+                std::this_thread::yield();
+            }
+        }
+    }
+
+    static void waitForWrites(GatedCommunicator & gc, unsigned long long count) {
+        for (int i = 0; i < 1000 && gc.getQueueStats().written < count; i++) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+    }
+
+    void dropOldest() {
+        ConfigMap config;
+        config.set("queueCapacity", "2");
+        config.set("queuePolicy", "dropOldest");
+        GatedCommunicator gc(config);
+        sendWhileWriting(gc, 5);
+        QueueStats stats = gc.getQueueStats();
+        Assert::AreEqual(2, stats.capacity, "Capacity");
+        Assert::AreEqual(2, stats.depth, "Depth");
+        Assert::AreEqual(2, stats.dropped, "Dropped");
+
+        gc.release();
+        waitForWrites(gc, 3);
+        std::vector<double> expected = { 1, 4, 5 };
+        Assert::AreEqual(expected, gc.written(), "Written values");
+        stats = gc.getQueueStats();
+        Assert::AreEqual(0, stats.depth, "Depth after writing");
+        Assert::AreEqual(3, stats.written, "Written");
+    }
+
+    void coalesce() {
+        ConfigMap config;
+        config.set("queuePolicy", "coalesce");
+        GatedCommunicator gc(config);
+        sendWhileWriting(gc, 5);
+        QueueStats stats = gc.getQueueStats();
+        Assert::AreEqual(1, stats.depth, "Depth");
+        Assert::AreEqual(3, stats.dropped, "Dropped");
+
+        gc.release();
+        waitForWrites(gc, 2);
+        std::vector<double> expected = { 1, 5 };
+        Assert::AreEqual(expected, gc.written(), "Written values");
+    }
+
+    void defaultPolicy() {
+        // A slow communicator must not stall the caller, so items are dropped by default
+        ConfigMap config;
+        config.set("queueCapacity", "2");
+        GatedCommunicator gc(config);
+        sendWhileWriting(gc, 5);
+        Assert::AreEqual(2, gc.getQueueStats().dropped, "Dropped");
+        gc.release();
+    }
+
+    void block() {
+        ConfigMap config;
+        config.set("queueCapacity", "2");
+        config.set("queuePolicy", "block");
+        GatedCommunicator gc(config);
+        sendWhileWriting(gc, 3);
+
+        // The queue is full, so the next enqueue waits for a write
+        std::atomic<bool> sent(false);
+        std::thread sender([&gc, &sent]() {
+            DataStore ds;
+            ds["a"] = 4;
+            gc.enqueue(AllData(ds, DataStoreString(), ProgDataMap()));
+            sent = true;
+        });
+        std::this_thread::sleep_for(std::chrono::milliseconds(20));
+        Assert::IsFalse(sent, "Enqueue did not wait for space");
+
+        gc.release();
+        sender.join();
+        waitForWrites(gc, 4);
+        std::vector<double> expected = { 1, 2, 3, 4 };
+        Assert::AreEqual(expected, gc.written(), "Written values");
+        QueueStats stats = gc.getQueueStats();
+        Assert::AreEqual(0, stats.dropped, "Dropped");
+        Assert::IsTrue(stats.maxLatency >= std::chrono::milliseconds(20), "Max latency");
+        Assert::IsTrue(stats.meanLatency <= stats.maxLatency, "Mean latency");
+    }
+
+    void subclassPolicy() {
+        // A communicator may choose the policy used when none is configured
+        ConfigMap config;
+        config.set("queueCapacity", "2");
+        GatedCommunicator gc(config, QueuePolicy::Block);
+        sendWhileWriting(gc, 3);
+
+        std::thread sender([&gc]() {
+            DataStore ds;
+            ds["a"] = 4;
+            gc.enqueue(AllData(ds, DataStoreString(), ProgDataMap()));
+        });
+        std::this_thread::sleep_for(std::chrono::milliseconds(20));
+        gc.release();
+        sender.join();
+        waitForWrites(gc, 4);
+        std::vector<double> expected = { 1, 2, 3, 4 };
+        Assert::AreEqual(expected, gc.written(), "Written values");
+        Assert::AreEqual(0, gc.getQueueStats().dropped, "Dropped");
+    }
+
+    void readBetweenWrites() {
+        // A read requested while writes are queued is made before the rest of the queue is written
+        ConfigMap config;
+        config.set("queuePolicy", "block");
+        GatedCommunicator gc(config);
+        sendWhileWriting(gc, 4);
+        gc.requestRead();
+
+        gc.release();
+        waitForWrites(gc, 4);
+        std::vector<double> expected = { 1, -1, 2, 3, 4 };
+        Assert::AreEqual(expected, gc.written(), "Order of reads and writes");
+    }
 }
@@ -13,6 +13,11 @@
 #ifndef COMMONCOMMUNICATORTESTS_H
 #define COMMONCOMMUNICATORTESTS_H
 
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <vector>
+
 #include "CommonCommunicator.h"
 
 namespace TestCommonCommunicator {
@@ -27,7 +32,7 @@ namespace TestCommonCommunicator {
             return readData;
         }
 
-        void write(AllData aData) override {
+        void write(const AllData & aData) override {
             ++writeCount;
             writeData = aData.doubleDatastore;
             writeProgData = aData.progData;
@@ -40,10 +45,71 @@ namespace TestCommonCommunicator {
         ProgDataMap writeProgData;
     };
 
+    /** Records the value of "a" in each write. Writes wait until released. */
+    class GatedCommunicator : public CommonCommunicator {
+    public:
+        explicit GatedCommunicator(const ConfigMap & config) : CommonCommunicator(config) { }
+
+        GatedCommunicator(const ConfigMap & config, QueuePolicy defaultPolicy)
+            : CommonCommunicator(config, defaultPolicy) { }
+
+        ~GatedCommunicator() override {
+            release();
+            stop();
+            join();
+        }
+
+        void poll() override { }
+
+        /** Reads are recorded as -1 among the written values */
+        DataStore read() override {
+            std::lock_guard<std::mutex> lock(m);
+            values.push_back(-1);
+            return DataStore();
+        }
+
+        void requestRead() {
+            setRead();
+        }
+
+        void write(const AllData & aData) override {
+            std::unique_lock<std::mutex> lock(m);
+            values.push_back(aData.doubleDatastore.at("a"));
+            writing = true;
+            gate.wait(lock, [this]() { return open; });
+        }
+
+        void release() {
+            std::lock_guard<std::mutex> lock(m);
+            open = true;
+            gate.notify_all();
+        }
+
+        std::vector<double> written() {
+            std::lock_guard<std::mutex> lock(m);
+            return values;
+        }
+
+        std::atomic<bool> writing{false};
+
+    private:
+        std::mutex m;
+        std::condition_variable gate;
+        bool open = false;
+        std::vector<double> values;
+    };
+
     void construct();
     void enqueue();
     void subscribe();
+    void snapshot();
     void stop();
+    void dropOldest();
+    void coalesce();
+    void defaultPolicy();
+    void block();
+    void subclassPolicy();
+    void readBetweenWrites();
 }
 
 #endif // COMMONCOMMUNICATORTESTS_H
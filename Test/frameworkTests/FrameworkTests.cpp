@@ -6,6 +6,11 @@
 //  Copyright (c) 2016 United States Government as represented by the Administrator of the National Aeronautics and Space Administration.  All Rights Reserved.
 //
 
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <thread>
 #include <vector>
 #include <string>
 
@@ -20,6 +25,48 @@
 using namespace PCOE;
 using namespace PCOE::Test;
 
+namespace {
+    // Prognoser that counts its steps
+    class CountingPrognoser : public CommonPrognoser {
+    public:
+        explicit CountingPrognoser(GSAPConfigMap & config) : CommonPrognoser(config), steps(0) { }
+
+        void step() override {
+            steps++;
+        }
+
+        std::atomic<unsigned int> steps;
+    };
+
+    // Prognoser that keeps the history it loads
+    class HistoryPrognoser : public CommonPrognoser {
+    public:
+        explicit HistoryPrognoser(GSAPConfigMap & config) : CommonPrognoser(config), loaded(false) { }
+
+        void step() override { }
+
+        void setHistory(const ProgData & history) override {
+            lastState = history;
+            loaded = true;
+        }
+
+        ProgData & getResults() {
+            return results;
+        }
+
+        ProgData lastState;
+        bool loaded;
+    };
+
+    // Wait up to a second for the prognoser to reach a number of steps
+    bool waitForSteps(const CountingPrognoser & prognoser, unsigned int steps) {
+        for (int i = 0; i < 100 && prognoser.steps < steps; i++) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        }
+        return prognoser.steps >= steps;
+    }
+}
+
 void PrognoserFactoryTest()
 {
     PrognoserFactory & theFactory = PrognoserFactory::instance();
@@ -61,3 +108,144 @@ void PCOE::CommManagerTest()
     comm.stop();
     comm.join();
 }
+
+void PCOE::CommManagerSubscribeTest()
+{
+    CommManager & comm = CommManager::instance();
+    comm.registerKey("Test_SubscribeA");
+    comm.registerKey("Test_SubscribeB");
+    unsigned int calls = 0;
+    unsigned long id = comm.subscribe({ "Test_SubscribeA", "Test_SubscribeB" }, [&calls]() { calls++; });
+
+    // One call per update, however many watched keys it contains
+    DataStore both;
+    both["Test_SubscribeA"] = 1.0;
+    both["Test_SubscribeB"] = 2.0;
+    comm.updateLookup(both);
+    Assert::AreEqual(1, calls);
+    Assert::AreEqual(2.0, comm.getValue("Test_SubscribeB"), 1e-12);
+
+    // Updates to other keys are ignored
+    DataStore other;
+    other["Test_SubscribeC"] = 3.0;
+    comm.updateLookup(other);
+    Assert::AreEqual(1, calls);
+
+    comm.unsubscribe(id);
+    comm.updateLookup(both);
+    Assert::AreEqual(1, calls);
+}
+
+void PCOE::CommManagerHandleTest()
+{
+    CommManager & comm = CommManager::instance();
+    TagTable::Handle a = comm.registerKey("Test_HandleA");
+    TagTable::Handle b = comm.registerKey("Test_HandleB");
+    Assert::AreNotEqual(a, b, "Keys share a handle");
+    TagTable::Handle again = comm.registerKey("Test_HandleA");
+    Assert::AreEqual(a, again, "Registering again changed the handle");
+
+    DataStore ds;
+    ds["Test_HandleA"] = 4.0;
+    comm.updateLookup(ds);
+    Datum<double> value = comm.getValue(a);
+    Assert::AreEqual(4.0, value.get(), 1e-12);
+    Assert::AreEqual(ds["Test_HandleA"].getTime(), value.getTime());
+    Assert::AreEqual(comm.getValue("Test_HandleA").get(), value.get(), 1e-12);
+    Assert::IsTrue(std::isnan(comm.getValue(b).get()), "Unwritten key has a value");
+
+    // Keys first seen in an update get handles too
+    ds["Test_HandleC"] = 5.0;
+    comm.updateLookup(ds);
+    TagTable::Handle c = comm.registerKey("Test_HandleC");
+    Assert::AreEqual(5.0, comm.getValue(c).get(), 1e-12);
+}
+
+void PCOE::PrognoserWakeTest()
+{
+    CommManager & comm = CommManager::instance();
+    GSAPConfigMap config;
+    config.set("name", "WakeTest");
+    config.set("id", "wake");
+    config.set("type", "Counting");
+    config["inTags"] = { "voltage:Test_PrognoserWake" };
+
+    CountingPrognoser prognoser(config);
+    prognoser.start();
+    Assert::IsTrue(waitForSteps(prognoser, 1), "No step on start");
+
+    // Without new data the prognoser stays idle, even past the loop interval
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    unsigned int steps = prognoser.steps;
+    std::this_thread::sleep_for(std::chrono::milliseconds(700));
+    Assert::AreEqual(steps, prognoser.steps.load(), "Stepped without new data");
+
+    // Data for other tags does not wake it
+    DataStore other;
+    other["Test_PrognoserOther"] = 1.0;
+    comm.updateLookup(other);
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    Assert::AreEqual(steps, prognoser.steps.load(), "Woken by unrelated data");
+
+    // New data for its tag wakes it
+    DataStore data;
+    data["Test_PrognoserWake"] = 1.0;
+    comm.updateLookup(data);
+    Assert::IsTrue(waitForSteps(prognoser, steps + 1), "No step after new data");
+
+    // Stopping wakes the thread so it exits promptly
+    auto stopTime = std::chrono::steady_clock::now();
+    prognoser.stop();
+    prognoser.join();
+    Assert::IsTrue(std::chrono::steady_clock::now() - stopTime < std::chrono::milliseconds(400),
+                   "Stop did not wake the prognoser");
+    std::remove("./Counting_wake.hist");
+}
+
+void PrognoserHistoryTest()
+{
+    GSAPConfigMap config;
+    config.set("name", "HistoryTest");
+    config.set("id", "history");
+    config.set("type", "History");
+    config.set("resetHist", "true");
+    {
+        HistoryPrognoser prognoser(config);
+        prognoser.loadHistory();
+        Assert::IsFalse(prognoser.loaded, "History loaded from new file");
+
+        ProgData & results = prognoser.getResults();
+        results.addEvent("EOD");
+        results.addSystemTrajectory("SOC");
+        results.addInternal("R", 1.5);
+        results.setUncertainty(UType::Samples);
+        results.events["EOD"].timeOfEvent.npoints(3);
+        results.events["EOD"].timeOfEvent.setVec(0, { 10.0, 20.0, 30.0 });
+        results.events["EOD"].probMatrix[0] = 0.25;
+        results.events["EOD"].occurrenceMatrix[0] = { true, false, true };
+        results.sysTrajectories["SOC"][0].npoints(2);
+        results.sysTrajectories["SOC"][0].setVec(0, { 0.5, 0.75 });
+
+        prognoser.saveState();
+        results.internals["R"] = 2.5;
+        prognoser.saveState();
+    }
+
+    config.set("resetHist", "false");
+    HistoryPrognoser prognoser(config);
+    prognoser.loadHistory();
+    Assert::IsTrue(prognoser.loaded, "History not loaded");
+    ProgData & history = prognoser.lastState;
+    Assert::IsTrue(history.events.includes("EOD"), "Event not loaded");
+    UData & toe = history.events["EOD"].timeOfEvent;
+    Assert::IsTrue(toe.uncertainty() == UType::Samples, "Incorrect event uncertainty");
+    Assert::AreEqual(3, toe.npoints(), "Incorrect event samples");
+    Assert::AreEqual(20.0, toe[1], 1e-12, "Incorrect event sample");
+    Assert::AreEqual(0.25, history.events["EOD"].probMatrix[0], 1e-12, "Incorrect probability");
+    Assert::IsTrue(history.events["EOD"].occurrenceMatrix[0] == std::vector<bool>({ true, false, true }),
+                   "Incorrect occurrence");
+    Assert::IsTrue(history.sysTrajectories.includes("SOC"), "Trajectory not loaded");
+    Assert::AreEqual(0.75, history.sysTrajectories["SOC"][0][1], 1e-12, "Incorrect trajectory sample");
+    Assert::AreEqual(2.5, history.internals["R"], 1e-12, "Latest state not loaded");
+    std::remove("./History_history.hist");
+}
@@ -11,8 +11,12 @@
 
 namespace PCOE {
     void CommManagerTest();
+    void CommManagerSubscribeTest();
+    void PrognoserWakeTest();
+    void CommManagerHandleTest();
 }
 
 void PrognoserFactoryTest();
+void PrognoserHistoryTest();
 
 #endif // FRAMEWORKTESTS_H
@@ -27,6 +27,10 @@ int main() {
     TestContext context;
     context.AddTest("Prognoser Factory", PrognoserFactoryTest);
     context.AddTest("CommManagerTest", PCOE::CommManagerTest);
+    context.AddTest("CommManager Subscribe", PCOE::CommManagerSubscribeTest);
+    context.AddTest("Prognoser Wakes on Data", PCOE::PrognoserWakeTest);
+    context.AddTest("Prognoser History", PrognoserHistoryTest);
+    context.AddTest("CommManager Handles", PCOE::CommManagerHandleTest);
 
     // ProgManager
     context.AddTest("construct_default", TestProgManager::construct_default, "ProgManager");
@@ -38,7 +42,14 @@ int main() {
     context.AddTest("construct", TestCommonCommunicator::construct, "Common Communicator");
     context.AddTest("enqueue", TestCommonCommunicator::enqueue, "Common Communicator");
     context.AddTest("subscribe", TestCommonCommunicator::subscribe, "Common Communicator");
+    context.AddTest("snapshot", TestCommonCommunicator::snapshot, "Common Communicator");
     context.AddTest("stop", TestCommonCommunicator::stop, "Common Communicator");
+    context.AddTest("dropOldest", TestCommonCommunicator::dropOldest, "Common Communicator");
+    context.AddTest("coalesce", TestCommonCommunicator::coalesce, "Common Communicator");
+    context.AddTest("defaultPolicy", TestCommonCommunicator::defaultPolicy, "Common Communicator");
+    context.AddTest("block", TestCommonCommunicator::block, "Common Communicator");
+    context.AddTest("subclassPolicy", TestCommonCommunicator::subclassPolicy, "Common Communicator");
+    context.AddTest("readBetweenWrites", TestCommonCommunicator::readBetweenWrites, "Common Communicator");
 
     int result = context.Execute();
     std::ofstream junit("testresults/framework.xml");
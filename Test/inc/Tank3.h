@@ -54,6 +54,8 @@ public:
 
     void stateEqn(const double t, std::vector<double> & x, const std::vector<double> & u, const std::vector<double> & n, const double dt);
     void outputEqn(const double t, const std::vector<double> & x, const std::vector<double> & u, const std::vector<double> & n, std::vector<double> & z);
+    void stateEqnBatch(const double t, PCOE::Matrix & X, const PCOE::Matrix & U, const PCOE::Matrix & N, const double dt);
+    void outputEqnBatch(const double t, const PCOE::Matrix & X, const PCOE::Matrix & U, const PCOE::Matrix & N, PCOE::Matrix & Z);
     void initialize(std::vector<double> & x, const std::vector<double> & u, const std::vector<double> & z);
 };
 #endif
@@ -74,6 +74,52 @@ void Tank3::outputEqn(const double, const std::vector<double> & x, const std::ve
 
 }
 
+// Tank3 State Equation (batched)
+void Tank3::stateEqnBatch(const double, PCOE::Matrix & X, const PCOE::Matrix & U, const PCOE::Matrix & N, const double dt) {
+    double * m1 = X.rowData(0);
+    double * m2 = X.rowData(1);
+    double * m3 = X.rowData(2);
+    const double * u1 = U.rowData(0);
+    const double * u2 = U.rowData(1);
+    const double * u3 = U.rowData(2);
+    const double * n1 = N.rowData(0);
+    const double * n2 = N.rowData(1);
+    const double * n3 = N.rowData(2);
+
+    for (std::size_t i = 0; i < X.cols(); i++) {
+        // Constraints
+        double p1 = m1[i] / parameters.K1;
+        double p2 = m2[i] / parameters.K2;
+        double p3 = m3[i] / parameters.K3;
+        double q1 = p1 / parameters.R1;
+        double q2 = p2 / parameters.R2;
+        double q3 = p3 / parameters.R3;
+        double q1c2 = (p1 - p2) / parameters.R1c2;
+        double q2c3 = (p2 - p3) / parameters.R2c3;
+        double m1dot = -q1 - q1c2 + u1[i];
+        double m2dot = q1c2 - q2 - q2c3 + u2[i];
+        double m3dot = q2c3 - q3 + u3[i];
+
+        // Update state and add process noise
+        m1[i] = m1[i] + m1dot*dt + dt*n1[i];
+        m2[i] = m2[i] + m2dot*dt + dt*n2[i];
+        m3[i] = m3[i] + m3dot*dt + dt*n3[i];
+    }
+}
+
+// Tank3 Output Equation (batched)
+void Tank3::outputEqnBatch(const double, const PCOE::Matrix & X, const PCOE::Matrix &, const PCOE::Matrix & N, PCOE::Matrix & Z) {
+    for (unsigned int j = 0; j < 3; j++) {
+        const double K = j == 0 ? parameters.K1 : (j == 1 ? parameters.K2 : parameters.K3);
+        const double * m = X.rowData(j);
+        const double * n = N.rowData(j);
+        double * p = Z.rowData(j);
+        for (std::size_t i = 0; i < X.cols(); i++) {
+            p[i] = m[i] / K + n[i];
+        }
+    }
+}
+
 void Tank3::initialize(vector<double> & x, const vector<double> &, const vector<double> &)
 {
     x[0] = 0;
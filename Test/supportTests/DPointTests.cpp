@@ -6,6 +6,8 @@
 //  Copyright © 2016 United States Government as represented by the Administrator of the National Aeronautics and Space Administration.  All Rights Reserved.
 //
 
+#include <cstdint>
+
 #include "Test.h"
 #include "DPointTests.h"
 #include "DataPoint.h"
@@ -77,3 +79,52 @@ void testDPointMeta()
     test.setName("Test 2 This is a very long name");
     Assert::AreEqual(0, test.getName().compare("Test 2 This is a very long name"));
 }
+
+void testDPointSampleData()
+{
+    DataPoint test;
+    test.setUncertainty(UType::Samples);
+    test.setNumTimes(2);
+    for (unsigned int t = 0; t <= 2; t++) {
+        test[t].npoints(3);
+    }
+    test[2].setVec(0, { 7, 8, 9 });
+
+    double * values = test.sampleData(2, 3);
+    std::size_t stride = test.getSampleStride();
+    Assert::IsTrue(reinterpret_cast<std::uintptr_t>(values) % 64 == 0, "Samples not aligned");
+    Assert::IsTrue(stride >= 3, "Stride too small");
+    for (unsigned int t = 0; t < 2; t++) {
+        for (unsigned int s = 0; s < 3; s++) {
+            values[t * stride + s] = 10 * t + s;
+        }
+    }
+
+    // Written times are unchanged until they are committed, which releases the storage
+    Assert::IsFalse(test[0].valid());
+    test.commitSamples();
+    Assert::AreEqual(0, test.getSampleStride(), "Sample storage not released");
+
+    // Written times are read through UData; other times are unchanged
+    Assert::AreEqual(1.0, test[0][1], 1e-12);
+    Assert::AreEqual(12.0, test[1][2], 1e-12);
+    Assert::IsTrue(test[1].valid());
+    Assert::AreEqual(8.0, test[2][1], 1e-12);
+
+    // Values written later replace values set through UData
+    test[0].setVec(0, { 1, 1, 1 });
+    values = test.sampleData(1, 3);
+    values[0] = 5;
+    values[1] = 6;
+    values[2] = 7;
+    Assert::AreEqual(1.0, test[0][1], 1e-12);
+    test.commitSamples();
+    Assert::AreEqual(6.0, test[0][1], 1e-12);
+    Assert::AreEqual(11.0, test[1][1], 1e-12);
+
+    try {
+        test.sampleData(5, 3);
+        Assert::Fail("Wrote past the last time");
+    }
+    catch (std::out_of_range &) { }
+}
@@ -11,6 +11,7 @@
 
 void testDPointInit();
 void testDPointMeta();
+void testDPointSampleData();
 void testDPointUpdate();
 
 #endif // DPOINTTESTS_H
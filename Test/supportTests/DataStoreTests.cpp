@@ -6,11 +6,19 @@
 //  Copyright © 2016 United States Government as represented by the Administrator of the National Aeronautics and Space Administration.  All Rights Reserved.
 //
 
+#include <atomic>
 #include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <fstream>
+#include <stdexcept>
+#include <thread>
 
 #include "Test.h"
+#include "CheckpointFile.h"
 #include "DataStore.h"
 #include "Datum.h"
+#include "TagTable.h"
 #include "DataStoreTests.h"
 
 using namespace PCOE;
@@ -54,3 +62,192 @@ void DStoreUse()
     Datum<double> c(1.9);
     Assert::AreEqual(1.9, c, 1e-12, "Incorrect value of c");
 }
+
+void TagTableUse()
+{
+    using namespace std::chrono;
+    TagTable table;
+    Assert::AreEqual(0, table.size(), "Non-zero size after initialization");
+    TagTable::Handle a = table.add();
+    TagTable::Handle b = table.add();
+    Assert::AreEqual(0, a, "Incorrect first handle");
+    Assert::AreEqual(1, b, "Incorrect second handle");
+    Assert::AreEqual(2, table.size(), "Incorrect size after adding");
+    Assert::IsTrue(std::isnan(table.get(a).get()), "Value set before first write");
+    Assert::AreEqual(0, table.get(a).getTime(), "Time set before first write");
+
+    Datum<double> value(1.5);
+    table.set(b, value);
+    Datum<double> result = table.get(b);
+    Assert::AreEqual(1.5, result.get(), 1e-12, "Incorrect value after set");
+    Assert::AreEqual(value.getTime(), result.getTime(), "Incorrect time after set");
+    Assert::IsTrue(std::isnan(table.get(a).get()), "Set changed another slot");
+
+    // Grows past the first block
+    for (TagTable::Handle i = table.size(); i <= TagTable::BLOCK_SIZE; i++) {
+        table.add();
+    }
+    TagTable::Handle last = table.size() - 1;
+    table.set(last, Datum<double>(2.5));
+    Assert::AreEqual(2.5, table.get(last).get(), 1e-12, "Incorrect value in second block");
+
+    try {
+        table.get(table.size());
+        Assert::Fail("Read from invalid handle");
+    }
+    catch (std::out_of_range &) {}
+}
+
+void TagTableConcurrent()
+{
+    using namespace std::chrono;
+    TagTable table;
+    TagTable::Handle handle = table.add();
+    table.set(handle, Datum<double>(0.0, Datum<double>::time_point(milliseconds(0))));
+
+    // The writer keeps value and time equal, so a torn read shows up as a mismatch
+    const int count = 100000;
+    std::atomic<bool> done(false);
+    std::thread writer([&]() {
+        for (int i = 1; i <= count; i++) {
+            table.set(handle, Datum<double>(i, Datum<double>::time_point(milliseconds(i))));
+        }
+        done = true;
+    });
+
+    bool consistent = true;
+    double previous = 0;
+    while (!done) {
+        Datum<double> result = table.get(handle);
+        double value = result.get();
+        Datum<double>::ms_rep time = result.getTime();
+        if (static_cast<Datum<double>::ms_rep>(value) != time || value < previous) {
+            consistent = false;
+        }
+        previous = value;
+    }
+    writer.join();
+    Assert::IsTrue(consistent, "Inconsistent read during write");
+    Assert::AreEqual(static_cast<double>(count), table.get(handle).get(), 1e-12, "Incorrect final value");
+}
+
+static std::vector<char> toRecord(const std::string & text) {
+    return std::vector<char>(text.begin(), text.end());
+}
+
+void CheckpointFileUse()
+{
+    const std::string path = "TestCheckpointFile.hist";
+    std::remove(path.c_str());
+    std::vector<char> record;
+    {
+        CheckpointFile file(path);
+        Assert::IsFalse(file.readLatest(record), "Record read from empty file");
+
+        file.append(toRecord("first"));
+        file.append(toRecord("second"));
+        file.flush();
+        Assert::IsTrue(file.readLatest(record), "No record read");
+        Assert::IsTrue(record == toRecord("second"), "Latest record not read");
+
+        // Written asynchronously, then on close
+        file.append(toRecord("third"));
+    }
+    {
+        CheckpointFile file(path);
+        Assert::IsTrue(file.readLatest(record), "No record read after reopening");
+        Assert::IsTrue(record == toRecord("third"), "Record not written on close");
+
+        file.append(std::vector<char>());
+        file.flush();
+        Assert::IsTrue(file.readLatest(record), "Empty record not read");
+        Assert::IsTrue(record.empty(), "Empty record not empty");
+    }
+    std::remove(path.c_str());
+}
+
+void CheckpointFileRotation()
+{
+    const std::string path = "TestCheckpointFile.hist";
+    std::remove(path.c_str());
+    std::vector<char> record;
+    std::ifstream::pos_type compactedSize;
+    {
+        CheckpointFile file(path, 3);
+        for (int i = 1; i <= 20; i++) {
+            file.append(toRecord("record " + std::to_string(i)));
+            file.flush();
+            Assert::IsTrue(file.getNumRecords() < 6, "Records not removed");
+            Assert::IsTrue(file.readLatest(record), "No record read");
+            Assert::IsTrue(record == toRecord("record " + std::to_string(i)), "Latest record not read");
+            if (i == 6) {
+                compactedSize = std::ifstream(path, std::ios::binary | std::ios::ate).tellg();
+            }
+        }
+        Assert::AreEqual(5, file.getNumRecords(), "Incorrect number of records");
+    }
+
+    // The file stays the size of the records kept
+    std::ifstream::pos_type size = std::ifstream(path, std::ios::binary | std::ios::ate).tellg();
+    Assert::IsTrue(size < 2 * compactedSize, "File keeps growing");
+    Assert::IsFalse(std::ifstream(path + ".tmp").good(), "Temporary file left behind");
+    {
+        CheckpointFile file(path, 3);
+        Assert::AreEqual(5, file.getNumRecords(), "Incorrect number of records after reopening");
+        Assert::IsTrue(file.readLatest(record), "No record read after reopening");
+        Assert::IsTrue(record == toRecord("record 20"), "Latest record not read after reopening");
+    }
+
+    // A file holding more records than are kept is compacted when it is opened
+    {
+        CheckpointFile file(path, 1);
+        Assert::AreEqual(1, file.getNumRecords(), "File with too many records not compacted");
+        Assert::IsTrue(file.readLatest(record), "No record read after compacting");
+        Assert::IsTrue(record == toRecord("record 20"), "Latest record not kept");
+    }
+
+    try {
+        CheckpointFile file(path, 0);
+        Assert::Fail("Opened a file that keeps no records");
+    }
+    catch (const std::range_error &) { }
+    std::remove(path.c_str());
+}
+
+void CheckpointFileRecovery()
+{
+    const std::string path = "TestCheckpointFile.hist";
+    std::remove(path.c_str());
+    {
+        CheckpointFile file(path);
+        file.append(toRecord("complete"));
+    }
+    {
+        // Simulate a crash part way through a write
+        std::ofstream out(path, std::ios::binary | std::ios::app);
+        out << "RECD partial record";
+    }
+    std::vector<char> record;
+    {
+        CheckpointFile file(path);
+        Assert::IsTrue(file.readLatest(record), "No record read after incomplete write");
+        Assert::IsTrue(record == toRecord("complete"), "Incorrect record after incomplete write");
+        file.append(toRecord("next"));
+    }
+    {
+        CheckpointFile file(path);
+        Assert::IsTrue(file.readLatest(record), "No record read after recovery");
+        Assert::IsTrue(record == toRecord("next"), "Record not appended after recovery");
+    }
+
+    {
+        std::ofstream out(path, std::ios::binary | std::ios::trunc);
+        out << "time:1,e[EOD][T0(1)]:2";
+    }
+    try {
+        CheckpointFile file(path);
+        Assert::Fail("Opened a file that is not a checkpoint file");
+    }
+    catch (const std::runtime_error &) { }
+    std::remove(path.c_str());
+}
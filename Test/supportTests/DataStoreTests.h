@@ -11,5 +11,10 @@
 
 void DStoreInit();
 void DStoreUse();
+void TagTableUse();
+void TagTableConcurrent();
+void CheckpointFileUse();
+void CheckpointFileRotation();
+void CheckpointFileRecovery();
 
 #endif // DATASTORETESTS_H
@@ -17,6 +17,10 @@
 *     All Rights Reserved.
 */
 
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
 #include <iostream>
 #include <random>
 #include <sstream>
@@ -24,6 +28,7 @@
 #include "Test.h"
 #include "MatrixTests.h"
 #include "Matrix.h"
+#include "MatrixDecomposition.h"
 
 using namespace PCOE;
 using namespace PCOE::Test;
@@ -1061,6 +1066,22 @@ namespace TestMatrix {
         }
     }
 
+    void transposeInto() {
+        Matrix matrix(2, 3, { 1, 2, 3, 4, 5, 6 });
+        Matrix expected(3, 2, { 1, 4, 2, 5, 3, 6 });
+
+        // A result of the wrong size is resized
+        Matrix result(1, 1);
+        matrix.transposeInto(result);
+        Assert::IsTrue(expected == result, "Unexpected transpose");
+
+        // A result of the right size is overwritten
+        matrix[0][0] = 7;
+        expected[0][0] = 7;
+        matrix.transposeInto(result);
+        Assert::IsTrue(expected == result, "Unexpected transpose of reused result");
+    }
+
     void cholesky() {
         Matrix matrix(3, 3, {
             25, 15, -5,
@@ -1128,4 +1149,348 @@ namespace TestMatrix {
         }
         catch (std::domain_error) { }
     }
+
+    static Matrix randomMatrix(std::size_t m, std::size_t n) {
+        Matrix r(m, n);
+        for (std::size_t i = 0; i < m; ++i) {
+            for (std::size_t j = 0; j < n; ++j) {
+                r[i][j] = dist(rng);
+            }
+        }
+        return r;
+    }
+
+    void weightedcovariance_kernels() {
+        // Seven samples of three and two dimensional quantities, as in a UKF with three states
+        Matrix x = randomMatrix(3, 7);
+        Matrix z = randomMatrix(2, 7);
+        std::vector<double> w = { 0.4, 0.1, 0.1, 0.1, 0.1, 0.1, 0.1 };
+        double alpha = 0.5;
+        double beta = 2;
+
+        std::vector<double> xMean(3);
+        std::vector<double> zMean(2);
+        Matrix xc(3, 7);
+        Matrix zc(2, 7);
+        PCOE::weightedCenter(x, w, xMean, xc);
+        PCOE::weightedCenter(z, w, zMean, zc);
+        for (std::size_t i = 0; i < 3; ++i) {
+            double e = 0;
+            for (std::size_t k = 0; k < 7; ++k) {
+                e += w[k] * x[i][k];
+            }
+            Assert::AreEqual(e, xMean[i], 1e-9, "Unexpected mean");
+            for (std::size_t k = 0; k < 7; ++k) {
+                double xck = xc[i][k];
+                Assert::AreEqual(x[i][k] - e, xck, 1e-9, "Unexpected centered value");
+            }
+        }
+
+        // Covariance, with the first weight corrected once per sample as the member function does
+        double w0Correction = 7 * (1 - alpha * alpha + beta);
+        Matrix pxx(3, 3, NAN);
+        PCOE::weightedCovariance(xc, w, w0Correction, pxx);
+        Matrix member = x.weightedCovariance(Matrix(7, 1, { 0.4, 0.1, 0.1, 0.1, 0.1, 0.1, 0.1 }), alpha, beta);
+        for (std::size_t i = 0; i < 3; ++i) {
+            for (std::size_t j = 0; j < 3; ++j) {
+                double e = w0Correction * (x[i][0] - xMean[i]) * (x[j][0] - xMean[j]);
+                for (std::size_t k = 0; k < 7; ++k) {
+                    e += w[k] * (x[i][k] - xMean[i]) * (x[j][k] - xMean[j]);
+                }
+                double a = pxx[i][j];
+                double m = member[i][j];
+                Assert::AreEqual(e, a, 1e-6 * std::abs(e) + 1e-9, "Unexpected covariance");
+                Assert::AreEqual(e, m, 1e-6 * std::abs(e) + 1e-9, "Unexpected covariance from member");
+            }
+        }
+        Assert::IsTrue(pxx == pxx.transpose(), "Covariance is not symmetric");
+
+        // Cross-covariance
+        Matrix pxz(3, 2);
+        PCOE::weightedCrossCovariance(xc, zc, w, pxz);
+        for (std::size_t i = 0; i < 3; ++i) {
+            for (std::size_t j = 0; j < 2; ++j) {
+                double e = 0;
+                for (std::size_t k = 0; k < 7; ++k) {
+                    e += w[k] * (x[i][k] - xMean[i]) * (z[j][k] - zMean[j]);
+                }
+                double a = pxz[i][j];
+                Assert::AreEqual(e, a, 1e-6 * std::abs(e) + 1e-9, "Unexpected cross-covariance");
+            }
+        }
+
+        try {
+            Matrix wrongSize(2, 2);
+            PCOE::weightedCovariance(xc, w, 0, wrongSize);
+            Assert::Fail("Computed covariance into a matrix of the wrong size");
+        }
+        catch (std::domain_error) { }
+
+        try {
+            Matrix pzx(2, 3);
+            PCOE::weightedCrossCovariance(xc, zc, w, pzx);
+            Assert::Fail("Computed cross-covariance into a matrix of the wrong size");
+        }
+        catch (std::domain_error) { }
+    }
+
+    void solve() {
+        // The first pivot is zero, so this requires row interchanges
+        Matrix matrix(3, 3, {
+            0, 2, 1,
+            1, 1, 1,
+            2, 1, 3
+        });
+        Matrix b(3, 2, {
+             7, -1,
+             6,  0,
+            13, -1
+        });
+        Matrix e(3, 2, {
+            1,  1,
+            2,  0,
+            3, -1
+        });
+
+        Matrix a = matrix.solve(b);
+        for (std::size_t i = 0; i < 3; ++i) {
+            for (std::size_t j = 0; j < 2; ++j) {
+                Assert::AreEqual(e.at(i, j), a.at(i, j), 1e-12, "Invalid solution");
+            }
+        }
+
+        try {
+            Matrix(3, 3, { 1, 2, 3, 2, 4, 6, 1, 1, 1 }).solve(b);
+            Assert::Fail("Solved a singular system");
+        }
+        catch (std::domain_error) { }
+
+        try {
+            matrix.solve(Matrix(2, 1));
+            Assert::Fail("Solved with the wrong number of rows");
+        }
+        catch (std::domain_error) { }
+    }
+
+    void lu_decomposition() {
+        std::size_t n = 25;
+        Matrix matrix(n, n);
+        Matrix b(n, 3);
+        for (std::size_t i = 0; i < n; ++i) {
+            for (std::size_t j = 0; j < n; ++j) {
+                matrix[i][j] = dist(rng);
+            }
+            for (std::size_t j = 0; j < 3; ++j) {
+                b[i][j] = dist(rng);
+            }
+        }
+
+        // A*x must reproduce b, and A*inv(A) must be the identity
+        LUDecomposition lu(matrix);
+        Matrix residual = matrix * lu.solve(b) - b;
+        Matrix identity = matrix * lu.inverse();
+        for (std::size_t i = 0; i < n; ++i) {
+            for (std::size_t j = 0; j < 3; ++j) {
+                Assert::AreEqual(0, residual.at(i, j), 1e-6, "Invalid solution");
+            }
+            for (std::size_t j = 0; j < n; ++j) {
+                Assert::AreEqual(i == j ? 1 : 0, identity.at(i, j), 1e-9, "Invalid inverse");
+            }
+        }
+
+        Matrix small(3, 3, {
+             3,  5,  7,
+            19, 17, 13,
+            11,  3,  1
+        });
+        Assert::AreEqual(small.determinant(), LUDecomposition(small).determinant(), 1e-9, "Invalid determinant");
+    }
+
+    void cholesky_decomposition() {
+        Matrix matrix(3, 3, {
+            25, 15, -5,
+            15, 18,  0,
+            -5,  0, 11
+        });
+        Matrix b(3, 1, { 35, 33, 6 });
+        Matrix e(3, 1, { 1, 1, 1 });
+
+        CholeskyDecomposition chol(matrix);
+        Assert::AreEqual(matrix.chol(), chol.lower(), "Unexpected factor");
+        Matrix a = chol.solve(b);
+        for (std::size_t i = 0; i < 3; ++i) {
+            Assert::AreEqual(e.at(i, 0), a.at(i, 0), 1e-12, "Invalid solution");
+        }
+
+        try {
+            CholeskyDecomposition(Matrix(2, 2, { 1, 2, 2, 1 }));
+            Assert::Fail("Factored a matrix that is not positive definite");
+        }
+        catch (std::domain_error) { }
+    }
+
+    void cholesky_update() {
+        // Factor AA' for a wide random A, without forming AA'
+        Matrix a = randomMatrix(4, 9);
+        Matrix aaT = a * a.transpose();
+        CholeskyDecomposition product;
+        product.factorProduct(a);
+        Matrix l = product.lower();
+        Matrix llT = l * l.transpose();
+        for (std::size_t i = 0; i < 4; ++i) {
+            double diagonal = l[i][i];
+            Assert::IsTrue(diagonal > 0, "Diagonal is not positive");
+            for (std::size_t j = 0; j < 4; ++j) {
+                double e = aaT[i][j];
+                double actual = llT[i][j];
+                Assert::AreEqual(e, actual, 1e-9 * std::abs(aaT[i][i]), "Unexpected product factor");
+                if (j > i) {
+                    double upper = l[i][j];
+                    Assert::IsTrue(std::fpclassify(upper) == FP_ZERO, "Factor is not lower triangular");
+                }
+            }
+        }
+
+        // Rank-one update and downdate agree with refactoring
+        std::vector<double> x = { dist(rng), dist(rng), dist(rng), dist(rng) };
+        Matrix xxT(4, 4);
+        for (std::size_t i = 0; i < 4; ++i) {
+            for (std::size_t j = 0; j < 4; ++j) {
+                xxT[i][j] = x[i] * x[j];
+            }
+        }
+        std::vector<double> scratch = x;
+        product.update(scratch);
+        Matrix updated = aaT + xxT;
+        Matrix updatedLower = CholeskyDecomposition(updated).lower();
+        for (std::size_t i = 0; i < 4; ++i) {
+            for (std::size_t j = 0; j <= i; ++j) {
+                double e = updatedLower[i][j];
+                double actual = product.lower()[i][j];
+                Assert::AreEqual(e, actual, 1e-9 * std::abs(updatedLower[j][j]), "Unexpected update");
+            }
+        }
+        scratch = x;
+        product.downdate(scratch);
+        for (std::size_t i = 0; i < 4; ++i) {
+            for (std::size_t j = 0; j <= i; ++j) {
+                double e = l[i][j];
+                double actual = product.lower()[i][j];
+                Assert::AreEqual(e, actual, 1e-6 * std::abs(l[j][j]), "Unexpected downdate");
+            }
+        }
+
+        try {
+            CholeskyDecomposition identity(Matrix::identity(2));
+            std::vector<double> tooBig = { 2, 0 };
+            identity.downdate(tooBig);
+            Assert::Fail("Downdated to a matrix that is not positive definite");
+        }
+        catch (std::domain_error) { }
+
+        try {
+            CholeskyDecomposition tall;
+            tall.factorProduct(Matrix(3, 2));
+            Assert::Fail("Factored the product of a tall matrix");
+        }
+        catch (std::domain_error) { }
+    }
+
+    // Reference i-j-k product with one dot product per element
+    static Matrix referenceMultiply(const Matrix& a, const Matrix& b) {
+        Matrix r(a.rows(), b.cols());
+        for (std::size_t i = 0; i < a.rows(); ++i) {
+            for (std::size_t j = 0; j < b.cols(); ++j) {
+                double e = 0;
+                for (std::size_t k = 0; k < a.cols(); ++k) {
+                    e += a[i][k] * b[k][j];
+                }
+                r[i][j] = e;
+            }
+        }
+        return r;
+    }
+
+    void gemm() {
+        // Sizes exercise the small kernel, the blocked kernel, partial strips and several blocks of B
+        const std::size_t sizes[][3] = { { 3, 5, 2 }, { 40, 33, 45 }, { 70, 300, 9 }, { 20, 600, 530 } };
+        for (auto& size : sizes) {
+            Matrix a = randomMatrix(size[0], size[1]);
+            Matrix b = randomMatrix(size[1], size[2]);
+            Matrix c = randomMatrix(size[0], size[2]);
+            Matrix e = referenceMultiply(a, b) * 0.5 + c * 2.0;
+
+            PCOE::gemm(0.5, a, b, 2.0, c);
+            for (std::size_t i = 0; i < size[0]; ++i) {
+                for (std::size_t j = 0; j < size[2]; ++j) {
+                    Assert::AreEqual(e[i][j], c[i][j], 1e-6 * std::abs(e[i][j]) + 1e-6, "Unexpected value");
+                }
+            }
+
+            // With beta = 0, the initial contents of C are ignored
+            c = Matrix(size[0], size[2], NAN);
+            PCOE::gemm(1.0, a, b, 0.0, c);
+            e = referenceMultiply(a, b);
+            for (std::size_t i = 0; i < size[0]; ++i) {
+                for (std::size_t j = 0; j < size[2]; ++j) {
+                    Assert::AreEqual(e[i][j], c[i][j], 1e-6 * std::abs(e[i][j]) + 1e-6, "Unexpected value with beta = 0");
+                }
+            }
+        }
+
+        try {
+            Matrix a(3, 3);
+            PCOE::gemm(1.0, a, a, 0.0, a);
+            Assert::Fail("Multiplied into an argument");
+        }
+        catch (std::domain_error) { }
+
+        try {
+            Matrix a(3, 2);
+            Matrix c(3, 3);
+            PCOE::gemm(1.0, a, a, 0.0, c);
+            Assert::Fail("Multiplied incompatible matrices");
+        }
+        catch (std::domain_error) { }
+    }
+
+    void gemm_benchmark() {
+        // Compares the reference product against operator* (which allocates the result)
+        // and gemm into an existing matrix, for the sizes used by the UKF and predictor
+        std::printf("\n%8s %14s %14s %14s\n", "size", "reference (ns)", "operator* (ns)", "gemm (ns)");
+        for (std::size_t n = 2; n <= 64; n *= 2) {
+            Matrix a = randomMatrix(n, n);
+            Matrix b = randomMatrix(n, n);
+            Matrix c(n, n);
+            std::size_t reps = std::max<std::size_t>(10, 4000000 / (n * n * n));
+            double checksum = 0;
+
+            auto start = std::chrono::steady_clock::now();
+            for (std::size_t r = 0; r < reps; ++r) {
+                checksum += referenceMultiply(a, b)[0][0];
+            }
+            auto referenceTime = std::chrono::steady_clock::now() - start;
+
+            start = std::chrono::steady_clock::now();
+            for (std::size_t r = 0; r < reps; ++r) {
+                checksum -= (a * b)[0][0];
+            }
+            auto operatorTime = std::chrono::steady_clock::now() - start;
+
+            start = std::chrono::steady_clock::now();
+            for (std::size_t r = 0; r < reps; ++r) {
+                PCOE::gemm(1.0, a, b, 0.0, c);
+                checksum += c[0][0];
+            }
+            auto gemmTime = std::chrono::steady_clock::now() - start;
+
+            using std::chrono::nanoseconds;
+            using std::chrono::duration_cast;
+            std::printf("%8zu %14.0f %14.0f %14.0f\n", n,
+                static_cast<double>(duration_cast<nanoseconds>(referenceTime).count()) / static_cast<double>(reps),
+                static_cast<double>(duration_cast<nanoseconds>(operatorTime).count()) / static_cast<double>(reps),
+                static_cast<double>(duration_cast<nanoseconds>(gemmTime).count()) / static_cast<double>(reps));
+            Assert::IsFalse(std::isnan(checksum));
+        }
+    }
 }
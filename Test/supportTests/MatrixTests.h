@@ -57,6 +57,8 @@ namespace TestMatrix {
     void subtract_matrix();
     void subtract_salar();
     void multiply_matrix();
+    void gemm();
+    void gemm_benchmark();
     void multiply_scalar();
     void divide_scalar();
 
@@ -68,11 +70,19 @@ namespace TestMatrix {
     void minors();
     void submatrix();
     void transpose();
+    void transposeInto();
 
     // Special operations
     void cholesky();
     void weightedmean();
     void weightedcovariance();
+    void weightedcovariance_kernels();
+
+    // Linear systems
+    void solve();
+    void lu_decomposition();
+    void cholesky_decomposition();
+    void cholesky_update();
 
 }
 
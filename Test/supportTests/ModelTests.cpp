@@ -17,11 +17,13 @@
 *     All Rights Reserved.
 */
 
+#include <cmath>
 #include <iostream>
 
 #include "Test.h"
 
 #include "ModelTests.h"
+#include "Matrix.h"
 #include "Model.h"
 #include "Tank3.h"
 #include "Battery.h"
@@ -144,6 +146,44 @@ void testTankOutputEqn()
     Assert::AreEqual(1.0 / 30.0, z[2], 1e-12);
 }
 
+void testTankBatchEqns()
+{
+    // Create Tank3 model
+    Tank3 TankModel = Tank3();
+    TankModel.parameters.K1 = 1;
+    TankModel.parameters.K2 = 2;
+    TankModel.parameters.K3 = 3;
+    TankModel.parameters.R1 = 1;
+    TankModel.parameters.R2 = 2;
+    TankModel.parameters.R3 = 3;
+    TankModel.parameters.R1c2 = 1;
+    TankModel.parameters.R2c3 = 2;
+
+    // Set up a block of 5 samples, one per column
+    Matrix X(3, 5);
+    Matrix U(3, 5);
+    Matrix N(3, 5);
+    for (unsigned int i = 0; i < 3; i++) {
+        for (unsigned int j = 0; j < 5; j++) {
+            X[i][j] = 0.1 * (i + 1) * (j + 1);
+            U[i][j] = 1 + 0.5 * j;
+            N[i][j] = 0.01 * i;
+        }
+    }
+
+    // Batched equations must match the default implementation, which calls the scalar equations
+    Matrix XScalar = X;
+    TankModel.stateEqnBatch(0, X, U, N, 0.1);
+    TankModel.Model::stateEqnBatch(0, XScalar, U, N, 0.1);
+    Assert::IsTrue(X == XScalar);
+
+    Matrix Z(3, 5);
+    Matrix ZScalar(3, 5);
+    TankModel.outputEqnBatch(0, X, U, N, Z);
+    TankModel.Model::outputEqnBatch(0, X, U, N, ZScalar);
+    Assert::IsTrue(Z == ZScalar);
+}
+
 void testBatterySetParameters()
 {
     // Create battery model
@@ -340,3 +380,65 @@ void testBatteryPredictedOutputEqn()
     // Check values
     Assert::AreEqual(1, z[0], 1e-5);
 }
+
+void testBatteryBatchEqns()
+{
+    // Create battery model
+    Battery battery = Battery();
+
+    // Set up a block of samples at different states of charge
+    const unsigned int numSamples = 4;
+    Matrix X(8, numSamples);
+    Matrix U(1, numSamples);
+    Matrix N(8, numSamples);
+    std::vector<double> x(8);
+    std::vector<double> u0(1);
+    std::vector<double> z0(2);
+    u0[0] = 0.4;
+    z0[0] = 20;
+    for (unsigned int j = 0; j < numSamples; j++) {
+        z0[1] = 4.1 - 0.3 * j;
+        battery.initialize(x, u0, z0);
+        X.col(j, x);
+        U[0][j] = 1 + j;
+        for (unsigned int i = 0; i < 8; i++) {
+            N[i][j] = 1e-6 * i;
+        }
+    }
+
+    // Batched equations must match the default implementation, which calls the scalar equations
+    std::vector<bool> occurred;
+    std::vector<bool> occurredScalar;
+    battery.thresholdEqnBatch(0, X, U, occurred);
+    battery.PrognosticsModel::thresholdEqnBatch(0, X, U, occurredScalar);
+    Assert::IsTrue(occurred == occurredScalar);
+    Assert::IsFalse(occurred[0]);
+    Assert::IsTrue(occurred[numSamples - 1]);
+
+    Matrix Z(2, numSamples);
+    Matrix ZScalar(2, numSamples);
+    Matrix zeroNoise(2, numSamples);
+    battery.outputEqnBatch(0, X, U, zeroNoise, Z);
+    battery.Model::outputEqnBatch(0, X, U, zeroNoise, ZScalar);
+    for (unsigned int j = 0; j < numSamples; j++) {
+        Assert::AreEqual(ZScalar[0][j], Z[0][j], 1e-12);
+        Assert::AreEqual(ZScalar[1][j], Z[1][j], 1e-12);
+    }
+
+    Matrix SOC(1, numSamples);
+    Matrix SOCScalar(1, numSamples);
+    battery.predictedOutputEqnBatch(0, X, U, SOC);
+    battery.PrognosticsModel::predictedOutputEqnBatch(0, X, U, SOCScalar);
+    for (unsigned int j = 0; j < numSamples; j++) {
+        Assert::AreEqual(SOCScalar[0][j], SOC[0][j], 1e-12);
+    }
+
+    Matrix XScalar = X;
+    battery.stateEqnBatch(0, X, U, N, 1);
+    battery.Model::stateEqnBatch(0, XScalar, U, N, 1);
+    for (unsigned int i = 0; i < 8; i++) {
+        for (unsigned int j = 0; j < numSamples; j++) {
+            Assert::AreEqual(XScalar[i][j], X[i][j], 1e-9 * std::abs(XScalar[i][j]) + 1e-15);
+        }
+    }
+}
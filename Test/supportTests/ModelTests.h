@@ -24,6 +24,7 @@
 void testTankInitialize();
 void testTankStateEqn();
 void testTankOutputEqn();
+void testTankBatchEqns();
 
 // Battery model tests
 void testBatterySetParameters();
@@ -33,5 +34,6 @@ void testBatteryOutputEqn();
 void testBatteryThresholdEqn();
 void testBatteryInputEqn();
 void testBatteryPredictedOutputEqn();
+void testBatteryBatchEqns();
 
 #endif // MODELTESTS_H
@@ -18,21 +18,47 @@
 *     All Rights Reserved.
 */
 
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstdlib>
 #include <iostream>
+#include <new>
 
 #include "Test.h"
 
 #include "ObserverTests.h"
 #include "Tank3.h"
 #include "Battery.h"
+#include "GSAPConfigMap.h"
 #include "Matrix.h"
 #include "UnscentedKalmanFilter.h"
+#include "SquareRootUnscentedKalmanFilter.h"
+#include "ParticleFilter.h"
+#include "ObserverFactory.h"
 #include "ThreadSafeLog.h"
 #include "ModelFactory.h"
 
 using namespace PCOE;
 using namespace PCOE::Test;
 
+// Count heap allocations made by the test executable, so that tests can check
+// that code which should not allocate doesn't.
+static std::atomic<std::size_t> allocationCount(0);
+
+void * operator new(std::size_t size) {
+    allocationCount++;
+    void * p = std::malloc(size == 0 ? 1 : size);
+    if (p == nullptr) {
+        throw std::bad_alloc();
+    }
+    return p;
+}
+
+void operator delete(void * p) noexcept {
+    std::free(p);
+}
+
 void observerTestsInit() {
     // Set up the log
     Log & log = Log::Instance("ObserverTests.log");
@@ -222,6 +248,75 @@ void testUKFTankStep()
     Assert::IsTrue(xCov[2][2] > 0.194574e-4 && xCov[2][2] < 0.1945742e-4);
 }
 
+void testUKFTankStepAllocations()
+{
+    // Create Tank model
+    Tank3 TankModel = Tank3();
+
+    // Set parameter values
+    TankModel.parameters.K1 = 1;
+    TankModel.parameters.K2 = 2;
+    TankModel.parameters.K3 = 3;
+    TankModel.parameters.R1 = 1;
+    TankModel.parameters.R2 = 2;
+    TankModel.parameters.R3 = 3;
+    TankModel.parameters.R1c2 = 1;
+    TankModel.parameters.R2c3 = 2;
+
+    // Set up u, x, noise and z
+    std::vector<double> u(3, 1);
+    std::vector<double> x(3, 0);
+    std::vector<double> ns(3, 0.001);
+    std::vector<double> no(3, 0.01);
+    std::vector<double> z(3, 0);
+
+    // Set up Q and R
+    Matrix Q(TankModel.getNumStates(), TankModel.getNumStates());
+    for (unsigned int i = 0; i < TankModel.getNumStates(); i++) {
+        Q[i][i] = 1e-5;
+    }
+    Matrix R(TankModel.getNumOutputs(), TankModel.getNumOutputs());
+    for (unsigned int i = 0; i < TankModel.getNumOutputs(); i++) {
+        R[i][i] = 1e-2;
+    }
+
+    // Create and initialize a UKF
+    UnscentedKalmanFilter UKF(&TankModel, Q, R);
+    double t = 0;
+    double dt = 0.1;
+    UKF.initialize(t, x, u);
+
+    // Warm up, so that any lazily sized storage has been allocated
+    for (int i = 0; i < 3; i++) {
+        t += dt;
+        TankModel.stateEqn(t, x, u, ns, dt);
+        TankModel.outputEqn(t, x, u, no, z);
+        UKF.step(t, u, z);
+    }
+
+    // Writing a log line allocates, so only log errors while counting
+    LOG_VERBOSITY oldLevel = LOG_LEVEL;
+    Log::SetVerbosity(LOG_ERROR);
+
+    std::size_t allocationsBefore = allocationCount;
+    for (int i = 0; i < 10; i++) {
+        t += dt;
+        TankModel.stateEqn(t, x, u, ns, dt);
+        TankModel.outputEqn(t, x, u, no, z);
+        UKF.step(t, u, z);
+    }
+    std::size_t allocations = allocationCount - allocationsBefore;
+
+    Log::SetVerbosity(oldLevel);
+    Assert::IsTrue(allocations == 0, "UKF step allocated after warm-up");
+
+    // The estimate should still track the simulated state
+    std::vector<double> xMean = UKF.getStateMean();
+    for (unsigned int i = 0; i < 3; i++) {
+        Assert::AreEqual(x[i], xMean[i], 1e-2);
+    }
+}
+
 void testUKFTankGetInputs()
 {
     // Create Tank model
@@ -499,3 +594,377 @@ void testUKFBatteryFromConfig()
     }
     catch (...) { }
 }
+
+void testSRUKFTankStep()
+{
+    // Create Tank model
+    Tank3 TankModel = Tank3();
+
+    // Set parameter values
+    TankModel.parameters.K1 = 1;
+    TankModel.parameters.K2 = 2;
+    TankModel.parameters.K3 = 3;
+    TankModel.parameters.R1 = 1;
+    TankModel.parameters.R2 = 2;
+    TankModel.parameters.R3 = 3;
+    TankModel.parameters.R1c2 = 1;
+    TankModel.parameters.R2c3 = 2;
+
+    // Set up u, x, noise and z
+    std::vector<double> u(3, 1);
+    std::vector<double> x(3, 0);
+    std::vector<double> ns(3, 0.001);
+    std::vector<double> no(3, 0.01);
+    std::vector<double> z(3, 0);
+
+    // Set up Q and R
+    Matrix Q(TankModel.getNumStates(), TankModel.getNumStates());
+    for (unsigned int i = 0; i < TankModel.getNumStates(); i++) {
+        Q[i][i] = 1e-5;
+    }
+    Matrix R(TankModel.getNumOutputs(), TankModel.getNumOutputs());
+    for (unsigned int i = 0; i < TankModel.getNumOutputs(); i++) {
+        R[i][i] = 1e-2;
+    }
+
+    // Create and initialize a square-root UKF and a UKF
+    SquareRootUnscentedKalmanFilter SRUKF(&TankModel, Q, R);
+    UnscentedKalmanFilter UKF(&TankModel, Q, R);
+    double t = 0;
+    double dt = 0.1;
+    SRUKF.initialize(t, x, u);
+    UKF.initialize(t, x, u);
+    Assert::AreEqual(Q, SRUKF.getStateCovariance());
+
+    // Make sure can't step without incrementing time
+    try {
+        SRUKF.step(t, u, z);
+        Assert::Fail("Step without incrementing time");
+    }
+    catch (...) { }
+
+    // Simulate to get outputs for time t
+    t += dt;
+    TankModel.stateEqn(t, x, u, ns, dt);
+    TankModel.outputEqn(t, x, u, no, z);
+
+    // After one step from the same covariance, both filters should give the same estimate
+    SRUKF.step(t, u, z);
+    UKF.step(t, u, z);
+    std::vector<double> xMean = SRUKF.getStateMean();
+    std::vector<double> xMeanUKF = UKF.getStateMean();
+    std::vector<double> zMean = SRUKF.getOutputMean();
+    std::vector<double> zMeanUKF = UKF.getOutputMean();
+    Matrix xCov = SRUKF.getStateCovariance();
+    Matrix xCovUKF = UKF.getStateCovariance();
+    for (unsigned int i = 0; i < 3; i++) {
+        Assert::AreEqual(xMeanUKF[i], xMean[i], 1e-12, "xMean");
+        Assert::AreEqual(zMeanUKF[i], zMean[i], 1e-12, "zMean");
+        for (unsigned int j = 0; j < 3; j++) {
+            double expected = xCovUKF[i][j];
+            double actual = xCov[i][j];
+            Assert::AreEqual(expected, actual, 1e-12, "xCov");
+        }
+    }
+
+    // The square root stays lower triangular with a positive diagonal
+    const Matrix & S = SRUKF.getStateCovarianceSqrt();
+    for (unsigned int i = 0; i < 3; i++) {
+        double diagonal = S[i][i];
+        Assert::IsTrue(diagonal > 0, "Diagonal of S is not positive");
+        for (unsigned int j = i + 1; j < 3; j++) {
+            double upper = S[i][j];
+            Assert::IsTrue(std::fpclassify(upper) == FP_ZERO, "S is not lower triangular");
+        }
+    }
+}
+
+void testSRUKFBatteryStep()
+{
+    // Create battery model
+    Battery battery = Battery();
+
+    // Initialize
+    std::vector<double> x(8);
+    std::vector<double> u0(1);
+    std::vector<double> z0(2);
+    u0[0] = 0;
+    z0[0] = 20;
+    z0[1] = 4.2;
+    battery.initialize(x, u0, z0);
+
+    // Set up Q and R
+    Matrix Q(battery.getNumStates(), battery.getNumStates());
+    for (unsigned int i = 0; i < battery.getNumStates(); i++) {
+        Q[i][i] = 1e-10;
+    }
+    Matrix R(battery.getNumOutputs(), battery.getNumOutputs());
+    for (unsigned int i = 0; i < battery.getNumOutputs(); i++) {
+        R[i][i] = 1e-2;
+    }
+
+    // Create a square-root UKF, which uses a negative first weight for the battery (kappa = -5)
+    SquareRootUnscentedKalmanFilter SRUKF(&battery, Q, R);
+    double dt = 1;
+    double t = 0;
+    std::vector<double> u(1);
+    SRUKF.initialize(t, x, u);
+
+    // Run a long discharge. The covariance must stay positive definite throughout.
+    std::vector<double> z(battery.getNumOutputs());
+    std::vector<double> xNoise(battery.getNumStates());
+    std::vector<double> zNoise(battery.getNumOutputs());
+    u[0] = 8;
+    for (int i = 0; i < 2000; i++) {
+        t += dt;
+        battery.stateEqn(t, x, u, xNoise, dt);
+        battery.outputEqn(t, x, u, zNoise, z);
+        SRUKF.step(t, u, z);
+    }
+
+    std::vector<double> xMean = SRUKF.getStateMean();
+    std::vector<double> zMean = SRUKF.getOutputMean();
+    Assert::AreEqual(z[1], zMean[1], 1e-3, "zMean[1]");
+    Assert::AreEqual(x[Battery::stateIndices::qnS], xMean[Battery::stateIndices::qnS], 1, "xMean[qnS]");
+
+    const Matrix & S = SRUKF.getStateCovarianceSqrt();
+    for (unsigned int i = 0; i < battery.getNumStates(); i++) {
+        double diagonal = S[i][i];
+        Assert::IsTrue(diagonal > 0 && std::isfinite(diagonal), "Diagonal of S is not positive");
+    }
+
+    // The state estimate reports the covariance
+    std::vector<UData> estimate = SRUKF.getStateEstimate();
+    Matrix xCov = SRUKF.getStateCovariance();
+    double mean = estimate[5][MEAN];
+    double covar = estimate[5][COVAR(5)];
+    double expectedCovar = xCov[5][5];
+    Assert::AreEqual(xMean[5], mean, 1e-12, "Estimate mean");
+    Assert::AreEqual(expectedCovar, covar, 1e-12 * expectedCovar, "Estimate covariance");
+}
+
+void testSRUKFFromFactory()
+{
+    GSAPConfigMap paramMap;
+
+    // Build Q and R
+    std::vector<std::string> qStrings;
+    for (int i = 0; i < 8; i++) {
+        for (int j = 0; j < 8; j++) {
+            qStrings.push_back(i == j ? "1e-10" : "0");
+        }
+    }
+    paramMap["Observer.Q"] = qStrings;
+    paramMap["Observer.R"] = { "1e-2", "0", "0", "1e-2" };
+
+    // Construct a square-root UKF from the factory, and use it
+    ObserverFactory & factory = ObserverFactory::instance();
+    std::unique_ptr<Observer> observer = factory.Create("SRUKF", paramMap);
+    Battery battery = Battery();
+    observer->setModel(&battery);
+
+    std::vector<double> x(8);
+    std::vector<double> u(1);
+    std::vector<double> z = { 20, 4.2 };
+    battery.initialize(x, u, z);
+    observer->initialize(0, x, u);
+    observer->step(1, u, z);
+    Assert::IsTrue(observer->isInitialized(), "Not initialized");
+    Assert::AreEqual(1, observer->getTime(), 1e-12);
+
+    // Q must be square
+    qStrings.pop_back();
+    paramMap["Observer.Q"] = qStrings;
+    try {
+        factory.Create("SRUKF", paramMap);
+        Assert::Fail("Created with a non-square Q");
+    }
+    catch (std::domain_error &) { }
+}
+
+// Run a seeded particle filter on the tank for a number of steps
+static ParticleFilter runSeededTankFilter(Tank3 & TankModel, unsigned int numThreads, unsigned int numSteps,
+                                          std::vector<double> & x) {
+    // Set parameter values
+    TankModel.parameters.K1 = 1;
+    TankModel.parameters.K2 = 2;
+    TankModel.parameters.K3 = 3;
+    TankModel.parameters.R1 = 1;
+    TankModel.parameters.R2 = 2;
+    TankModel.parameters.R3 = 3;
+    TankModel.parameters.R1c2 = 1;
+    TankModel.parameters.R2c3 = 2;
+
+    // Set up Q and R
+    Matrix Q(3, 3);
+    Matrix R(3, 3);
+    for (unsigned int i = 0; i < 3; i++) {
+        Q[i][i] = 1e-5;
+        R[i][i] = 1e-4;
+    }
+
+    ParticleFilter PF(&TankModel, Q, R, 3000);
+    PF.setNumThreads(numThreads);
+    PF.setSeed(7);
+
+    std::vector<double> u(3, 1);
+    std::vector<double> ns(3, 0);
+    std::vector<double> no(3, 0);
+    std::vector<double> z(3, 0);
+    x.assign(3, 0);
+    double t = 0;
+    double dt = 0.1;
+    PF.initialize(t, x, u);
+    for (unsigned int i = 0; i < numSteps; i++) {
+        t += dt;
+        TankModel.stateEqn(t, x, u, ns, dt);
+        TankModel.outputEqn(t, x, u, no, z);
+        PF.step(t, u, z);
+    }
+    return PF;
+}
+
+void testPFTankStep()
+{
+    Tank3 TankModel = Tank3();
+    std::vector<double> x;
+    ParticleFilter PF = runSeededTankFilter(TankModel, 1, 20, x);
+
+    // The estimate should track the simulated state
+    std::vector<double> xMean = PF.getStateMean();
+    std::vector<double> zMean = PF.getOutputMean();
+    for (unsigned int i = 0; i < 3; i++) {
+        Assert::AreEqual(x[i], xMean[i], 0.05 * x[i], "xMean");
+    }
+    Assert::AreEqual(x[0], zMean[0], 0.05 * x[0], "zMean");
+
+    // Weights are normalized
+    double sum = 0;
+    for (double w : PF.getWeights()) {
+        sum += w;
+    }
+    Assert::AreEqual(1, sum, 1e-9, "Weights do not sum to one");
+
+    // The state estimate holds the particles as weighted samples
+    std::vector<UData> estimate = PF.getStateEstimate();
+    Assert::AreEqual(3, estimate.size());
+    Assert::IsTrue(estimate[1].uncertainty() == UType::WSamples, "Estimate is not weighted samples");
+    Assert::AreEqual(3000, estimate[1].npoints());
+    double sample = estimate[1][SAMPLE(42)];
+    double weight = estimate[1][WEIGHT(42)];
+    double particle = PF.getParticles()[1][42];
+    Assert::AreEqual(particle, sample, 0.0);
+    Assert::AreEqual(PF.getWeights()[42], weight, 0.0);
+
+    // With a fixed seed, results do not depend on the number of threads
+    Tank3 OtherTankModel = Tank3();
+    ParticleFilter parallelPF = runSeededTankFilter(OtherTankModel, 4, 20, x);
+    Assert::IsTrue(PF.getParticles() == parallelPF.getParticles(), "Particles differ with threads");
+    Assert::IsTrue(PF.getWeights() == parallelPF.getWeights(), "Weights differ with threads");
+
+    // At least one particle is required
+    try {
+        ParticleFilter emptyPF(&OtherTankModel, Matrix(3, 3), Matrix(3, 3), 0);
+        Assert::Fail("Created without particles");
+    }
+    catch (std::range_error &) { }
+}
+
+// One state that follows a random walk, observed directly
+class RandomWalk final : public Model {
+public:
+    RandomWalk() {
+        numStates = 1;
+        numInputs = 0;
+        numOutputs = 1;
+        m_dt = 1;
+    }
+
+    void stateEqn(const double, std::vector<double> & x, const std::vector<double> &,
+                  const std::vector<double> & n, const double) override {
+        x[0] += n[0];
+    }
+
+    void outputEqn(const double, const std::vector<double> & x, const std::vector<double> &,
+                   const std::vector<double> & n, std::vector<double> & z) override {
+        z[0] = x[0] + n[0];
+    }
+
+    void initialize(std::vector<double> & x, const std::vector<double> &,
+                    const std::vector<double> & z) override {
+        x[0] = z[0];
+    }
+};
+
+void testPFZeroWeightOutlier()
+{
+    GSAPConfigMap paramMap;
+    paramMap["Observer.Q"] = { "1" };
+    paramMap["Observer.R"] = { "1e-6" };
+    paramMap.set("Observer.numParticles", "1000");
+    paramMap.set("Observer.seed", "5");
+    paramMap.set("Observer.resampleThreshold", "0");
+    ParticleFilter PF(paramMap);
+    RandomWalk model;
+    PF.setModel(&model);
+
+    std::vector<double> u;
+    PF.initialize(0, { 0 }, u);
+
+    // A precise measurement gives most particles a weight of zero
+    PF.step(1, u, { 0 });
+    const std::vector<double> & weights = PF.getWeights();
+    Assert::IsTrue(std::count(weights.begin(), weights.end(), 0.0) > 0, "No particle has zero weight");
+
+    // An outlier is far more likely for some particles of zero weight than for any other particle
+    PF.step(2, u, { 3 });
+    double sum = 0;
+    for (double w : weights) {
+        Assert::IsTrue(std::isfinite(w), "Weight is not finite");
+        sum += w;
+    }
+    Assert::AreEqual(1, sum, 1e-9, "Weights do not sum to one");
+}
+
+void testPFFromFactory()
+{
+    GSAPConfigMap paramMap;
+
+    // Build Q and R
+    std::vector<std::string> qStrings;
+    for (int i = 0; i < 8; i++) {
+        for (int j = 0; j < 8; j++) {
+            qStrings.push_back(i == j ? "1e-10" : "0");
+        }
+    }
+    paramMap["Observer.Q"] = qStrings;
+    paramMap["Observer.R"] = { "1e-2", "0", "0", "1e-2" };
+    paramMap.set("Observer.numParticles", "500");
+    paramMap.set("Observer.numThreads", "0");
+    paramMap.set("Observer.seed", "3");
+
+    // Construct a particle filter from the factory, and use it
+    ObserverFactory & factory = ObserverFactory::instance();
+    std::unique_ptr<Observer> observer = factory.Create("PF", paramMap);
+    Battery battery = Battery();
+    observer->setModel(&battery);
+
+    std::vector<double> x(8);
+    std::vector<double> u(1);
+    std::vector<double> z = { 20, 4.2 };
+    battery.initialize(x, u, z);
+    observer->initialize(0, x, u);
+    for (int i = 1; i <= 10; i++) {
+        observer->step(i, u, z);
+    }
+    std::vector<double> xMean = observer->getStateMean();
+    Assert::AreEqual(x[Battery::stateIndices::qnS], xMean[Battery::stateIndices::qnS], 1e-3, "xMean[qnS]");
+
+    // numParticles is required
+    paramMap.erase("Observer.numParticles");
+    try {
+        factory.Create("PF", paramMap);
+        Assert::Fail("Created without numParticles");
+    }
+    catch (std::range_error &) { }
+}
@@ -27,10 +27,21 @@ void observerTestsInit();
 void testUKFTankInitialize();
 void testUKFTankStep();
 void testUKFTankGetInputs();
+void testUKFTankStepAllocations();
 
 // UKF Battery tests
 void testUKFBatteryFromConfig();
 void testUKFBatteryInitialize();
 void testUKFBatteryStep();
 
+// Square-root UKF tests
+void testSRUKFTankStep();
+void testSRUKFBatteryStep();
+void testSRUKFFromFactory();
+
+// Particle filter tests
+void testPFTankStep();
+void testPFZeroWeightOutlier();
+void testPFFromFactory();
+
 #endif // OBSERVERTESTS_H
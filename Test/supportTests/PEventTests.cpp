@@ -75,6 +75,43 @@ void testPEventUpdate()
 //    Assert::AreEqual(6, test.timeOfEvent.size());
 }
 
+void testPEventOccurrence()
+{
+    ProgEvent test;
+    test.setNumOccurrenceSamples(70);
+    test.setNumTimes(2);
+    Assert::AreEqual(3, test.occurrenceMatrix.size());
+    Assert::AreEqual(70, test.occurrenceMatrix[2].size());
+    Assert::AreEqual(2, test.occurrenceMatrix.wordStride());
+
+    // Samples are packed 64 to a word
+    test.occurrenceMatrix[1][65] = true;
+    Assert::IsTrue(test.occurrenceMatrix[1][65]);
+    Assert::IsFalse(test.occurrenceMatrix[1][64]);
+    Assert::IsFalse(test.occurrenceMatrix[2][65]);
+    Assert::IsTrue(test.occurrenceMatrix.words(1)[1] == 2, "Sample not packed");
+
+    // Rows are used like std::vector<bool>, and may have their own size
+    test.occurrenceMatrix[0] = { true, false, true };
+    Assert::AreEqual(3, test.occurrenceMatrix[0].size());
+    Assert::IsTrue(test.occurrenceMatrix[0] == std::vector<bool>({ true, false, true }));
+    test.occurrenceMatrix[2].resize(130);
+    Assert::AreEqual(3, test.occurrenceMatrix.wordStride());
+    Assert::AreEqual(130, test.occurrenceMatrix[2].size());
+    Assert::IsTrue(test.occurrenceMatrix[1][65], "Sample lost when rows grew");
+
+    ProgEvent copy = test;
+    Assert::IsTrue(copy.occurrenceMatrix == test.occurrenceMatrix);
+    copy.occurrenceMatrix[1][65] = false;
+    Assert::IsFalse(copy.occurrenceMatrix == test.occurrenceMatrix);
+
+    // Samples removed from a row are cleared
+    test.setNumOccurrenceSamples(60);
+    Assert::AreEqual(60, test.occurrenceMatrix[1].size());
+    test.occurrenceMatrix[1].resize(70);
+    Assert::IsFalse(test.occurrenceMatrix[1][65]);
+}
+
 void testPEventMeta()
 {
     ProgEvent test;
@@ -11,6 +11,7 @@
 
 void testPEventInit();
 void testPEventMeta();
+void testPEventOccurrence();
 void testPEventUpdate();
 
 #endif // PEVENTTESTS_H
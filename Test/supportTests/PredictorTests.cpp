@@ -18,15 +18,23 @@
 *     All Rights Reserved.
 */
 
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
 #include <iostream>
 #include <vector>
 #include <memory>
 
+#include "Exceptions.h"
 #include "GSAPConfigMap.h"
 #include "MonteCarloPredictor.h"
+#include "Random.h"
+#include "SamplePoints.h"
 #include "UData.h"
 #include "Battery.h"
 #include "PredictorTests.h"
+#include "StatisticalTools.h"
 
 #include "Test.h"
 #include "PrognosticsModelFactory.h"
@@ -138,6 +146,396 @@ void testMonteCarloBatteryPredict()
     Assert::AreEqual(0.275, meanSOCAt2500, 0.025);
 }
 
+// Run a battery prediction with the given number of threads and a fixed seed
+static ProgData runSeededBatteryPrediction(const std::string & numThreads,
+                                           const std::string & stopAtEvent = "false",
+                                           const std::string & sampling = "random",
+                                           const std::string & seed = "42",
+                                           const unsigned int numSamples = 130,
+                                           const std::string & processNoise = "1e-5",
+                                           const unsigned int horizon = 5000) {
+    GSAPConfigMap configMap;
+    configMap.set("Predictor.numSamples", std::to_string(numSamples));
+    configMap.set("Predictor.horizon", std::to_string(horizon));
+    configMap.set("Predictor.numThreads", numThreads);
+    configMap.set("Predictor.seed", seed);
+    configMap.set("Predictor.stopAtEvent", stopAtEvent);
+    configMap.set("Predictor.sampling", sampling);
+    configMap.set("Model.event", "EOD");
+    configMap.set("Model.predictedOutputs", "SOC");
+    configMap["Model.processNoise"] = std::vector<std::string>(8, processNoise);
+    configMap["Predictor.inputUncertainty"] = { "8", "0.1", "5000", "1" };
+
+    Battery battery = Battery();
+    std::vector<double> x(8);
+    std::vector<double> u0 = { 0 };
+    std::vector<double> z0 = { 20, 4.2 };
+    battery.initialize(x, u0, z0);
+
+    MonteCarloPredictor MCP(configMap);
+    MCP.setModel(&battery);
+
+    std::vector<UData> state(battery.getNumStates());
+    for (unsigned int i = 0; i < battery.getNumStates(); i++) {
+        state[i].uncertainty(UType::MeanCovar);
+        state[i].npoints(battery.getNumStates());
+        state[i][MEAN] = x[i];
+        std::vector<double> covariance(battery.getNumStates(), 1e-10);
+        covariance[i] = 1e-5;
+        state[i].setVec(COVAR(0), covariance);
+    }
+
+    ProgData data;
+    data.setUncertainty(UType::Samples);
+    data.addEvent("EOD");
+    data.addSystemTrajectory("SOC");
+    data.sysTrajectories.setNSamples(numSamples);
+    data.setPredictions(1, horizon);
+    data.setupOccurrence(numSamples);
+    data.events["EOD"].timeOfEvent.npoints(numSamples);
+
+    MCP.predict(0, state, data);
+    return data;
+}
+
+// Results with a fixed seed must not depend on the number of threads
+void testMonteCarloBatteryThreads()
+{
+    ProgData serial = runSeededBatteryPrediction("1");
+    ProgData parallel = runSeededBatteryPrediction("3");
+
+    Assert::IsTrue(serial.events["EOD"].timeOfEvent == parallel.events["EOD"].timeOfEvent, "Time of event differs");
+    Assert::IsTrue(serial.events["EOD"].occurrenceMatrix == parallel.events["EOD"].occurrenceMatrix, "Occurrence differs");
+    for (unsigned int i = 0; i <= 5000; i += 500) {
+        Assert::IsTrue(serial.sysTrajectories["SOC"][i] == parallel.sysTrajectories["SOC"][i], "Trajectory differs");
+    }
+}
+
+// Stopping samples at their event must not change the time of event, and the results up to the event
+void testMonteCarloBatteryStopAtEvent()
+{
+    ProgData full = runSeededBatteryPrediction("1");
+    ProgData stopped = runSeededBatteryPrediction("2", "true");
+
+    auto & fullEvent = full.events["EOD"];
+    auto & stoppedEvent = stopped.events["EOD"];
+    Assert::IsTrue(fullEvent.timeOfEvent == stoppedEvent.timeOfEvent, "Time of event differs");
+    for (unsigned int sample = 0; sample < fullEvent.timeOfEvent.npoints(); sample++) {
+        double toe = fullEvent.timeOfEvent[sample];
+        Assert::IsFalse(std::isinf(toe), "Event not reached within horizon");
+        unsigned int eventIndex = static_cast<unsigned int>(toe);
+        for (unsigned int timeIndex = 0; timeIndex <= 5000; timeIndex += 50) {
+            double soc = stopped.sysTrajectories["SOC"][timeIndex][sample];
+            if (timeIndex <= eventIndex) {
+                Assert::IsTrue(fullEvent.occurrenceMatrix[timeIndex][sample] == stoppedEvent.occurrenceMatrix[timeIndex][sample],
+                               "Occurrence differs before event");
+                double fullSoc = full.sysTrajectories["SOC"][timeIndex][sample];
+                Assert::AreEqual(fullSoc, soc, 1e-12);
+            }
+            else {
+                Assert::IsTrue(stoppedEvent.occurrenceMatrix[timeIndex][sample], "Occurrence not set after event");
+                Assert::IsTrue(std::isnan(soc), "Trajectory written after event");
+            }
+        }
+    }
+}
+
+// Statistics gathered during prediction must match those computed from the samples
+void testMonteCarloBatteryStatistics()
+{
+    ProgData data = runSeededBatteryPrediction("3", "true");
+    auto & event = data.events["EOD"];
+
+    std::vector<double> toe = event.timeOfEvent.getVec();
+    std::vector<double> occurred;
+    for (double t : toe) {
+        if (!std::isinf(t)) {
+            occurred.push_back(t);
+        }
+    }
+    Assert::AreEqual(occurred.size(), event.toeStatistics.count(), "Incorrect number of events");
+    Assert::AreEqual(static_cast<double>(occurred.size()) / toe.size(), event.eventProb, 1e-12, "Incorrect event probability");
+    Assert::AreEqual(calculatemean(occurred.data(), static_cast<int>(occurred.size())), event.toeStatistics.mean(), 1e-6,
+                     "Incorrect mean time of event");
+    Assert::AreEqual(calculatestdv(occurred.data(), static_cast<int>(occurred.size())), event.toeStatistics.stdv(), 1e-6,
+                     "Incorrect time of event deviation");
+
+    std::sort(toe.begin(), toe.end());
+    for (double p : { 0.05, 0.5, 0.95 }) {
+        double expected = toe[static_cast<std::size_t>(std::ceil(p * toe.size())) - 1];
+        Assert::AreEqual(expected, event.toeHistogram.quantile(p), 1e-6, "Incorrect time of event percentile");
+    }
+
+    // Every time of the prediction has a probability, up to the end of the horizon
+    Assert::AreEqual(event.occurrenceMatrix.size(), event.probMatrix.size(), "Incorrect number of probabilities");
+    for (unsigned int timeIndex = 0; timeIndex < event.probMatrix.size(); timeIndex++) {
+        auto row = event.occurrenceMatrix[timeIndex];
+        double expected = static_cast<double>(std::count(row.begin(), row.end(), true)) / row.size();
+        Assert::AreEqual(expected, event.probMatrix[timeIndex], 1e-12, "Incorrect probability of occurrence");
+    }
+    Assert::AreEqual(1.0, event.probMatrix.back(), 1e-12, "Event has not occurred by the end of the horizon");
+}
+
+// Samples in which the event does not occur within the horizon are counted above the histogram bins
+void testMonteCarloBatteryStatisticsShortHorizon()
+{
+    ProgData data = runSeededBatteryPrediction("3", "true", "random", "42", 130, "1e-5", 3050);
+    auto & event = data.events["EOD"];
+
+    std::vector<double> toe = event.timeOfEvent.getVec();
+    std::size_t notOccurred = static_cast<std::size_t>(std::count_if(toe.begin(), toe.end(),
+                                                                     [](double t) { return std::isinf(t); }));
+    Assert::IsTrue(notOccurred > 0 && notOccurred < toe.size(), "Horizon does not split the samples");
+    Assert::AreEqual(notOccurred, event.toeHistogram.above(), "Incorrect number of samples above the bins");
+    Assert::AreEqual(toe.size(), event.toeHistogram.total(), "Incorrect number of samples in the histogram");
+    Assert::AreEqual(static_cast<double>(toe.size() - notOccurred) / toe.size(), event.eventProb, 1e-12,
+                     "Incorrect event probability");
+
+    std::sort(toe.begin(), toe.end());
+    for (double p : { 0.05, 0.5, 0.95 }) {
+        double expected = toe[static_cast<std::size_t>(std::ceil(p * toe.size())) - 1];
+        double actual = event.toeHistogram.quantile(p);
+        if (std::isinf(expected)) {
+            Assert::IsTrue(std::isinf(actual) && actual > 0, "Percentile above the horizon is not infinite");
+        }
+        else {
+            Assert::AreEqual(expected, actual, 1e-6, "Incorrect time of event percentile");
+        }
+    }
+    Assert::IsTrue(std::isinf(event.toeHistogram.quantile(1.0)), "Upper percentile is not infinite");
+}
+
+// A probability matrix shorter than the prediction is grown to hold every time
+void testMonteCarloBatteryShortProbMatrix()
+{
+    const unsigned int numSamples = 20;
+    GSAPConfigMap configMap;
+    configMap.set("Predictor.numSamples", std::to_string(numSamples));
+    configMap.set("Predictor.horizon", "5000");
+    configMap.set("Predictor.seed", "13");
+    configMap.set("Predictor.stopAtEvent", "true");
+    configMap.set("Model.event", "EOD");
+    configMap.set("Model.predictedOutputs", "SOC");
+    configMap["Model.processNoise"] = std::vector<std::string>(8, "1e-5");
+    configMap["Predictor.inputUncertainty"] = { "8", "0.1", "5000", "1" };
+
+    Battery battery = Battery();
+    std::vector<double> x(8);
+    std::vector<double> u0 = { 0 };
+    std::vector<double> z0 = { 20, 4.2 };
+    battery.initialize(x, u0, z0);
+
+    MonteCarloPredictor MCP(configMap);
+    MCP.setModel(&battery);
+
+    std::vector<UData> state(battery.getNumStates());
+    for (unsigned int i = 0; i < battery.getNumStates(); i++) {
+        state[i].uncertainty(UType::WSamples);
+        state[i].npoints(1);
+        state[i].setVec({ x[i], 1 });
+    }
+
+    ProgData data;
+    data.setUncertainty(UType::Samples);
+    data.addEvent("EOD");
+    data.addSystemTrajectory("SOC");
+    data.sysTrajectories.setNSamples(numSamples);
+    data.setPredictions(1, 5000);
+    data.setupOccurrence(numSamples);
+    data.events["EOD"].timeOfEvent.npoints(numSamples);
+    data.events["EOD"].probMatrix.resize(10);
+
+    MCP.predict(0, state, data);
+
+    auto & event = data.events["EOD"];
+    Assert::AreEqual(5001, event.probMatrix.size(), "Probability matrix not grown");
+    Assert::AreEqual(1.0, event.probMatrix[5000], 1e-12, "Incorrect probability at the end of the horizon");
+    auto row = event.occurrenceMatrix[3000];
+    double expected = static_cast<double>(std::count(row.begin(), row.end(), true)) / row.size();
+    Assert::AreEqual(expected, event.probMatrix[3000], 1e-12, "Incorrect probability of occurrence");
+}
+
+// Points of each sampling method must lie in the unit hypercube and be stratified as documented
+void testSamplePoints()
+{
+    const std::size_t dimensions = 9;
+    const std::size_t count = 64;
+
+    SamplePoints lhs(SamplePoints::Method::LatinHypercube, dimensions, count, 7);
+    SamplePoints sobol(SamplePoints::Method::Sobol, dimensions, count, 7);
+    SamplePoints halton(SamplePoints::Method::Halton, dimensions, count, 7);
+    for (const SamplePoints * points : { &lhs, &sobol, &halton }) {
+        Assert::AreEqual(dimensions, points->dimensions());
+        Assert::AreEqual(count, points->size());
+        for (std::size_t i = 0; i < count; i++) {
+            for (std::size_t d = 0; d < dimensions; d++) {
+                double u = (*points)[i][d];
+                Assert::IsTrue(u > 0 && u < 1, "Coordinate outside (0, 1)");
+            }
+        }
+    }
+
+    // One point in each of count strata of every dimension. The first 2^k Sobol points have the same property.
+    for (const SamplePoints * points : { &lhs, &sobol }) {
+        for (std::size_t d = 0; d < dimensions; d++) {
+            std::vector<bool> filled(count, false);
+            for (std::size_t i = 0; i < count; i++) {
+                std::size_t stratum = static_cast<std::size_t>((*points)[i][d] * count);
+                Assert::IsFalse(filled[stratum], "Stratum holds more than one point");
+                filled[stratum] = true;
+            }
+        }
+    }
+
+    // Different keys give different points
+    SamplePoints other(SamplePoints::Method::Sobol, dimensions, count, 8);
+    Assert::IsTrue(other[0][0] < sobol[0][0] || other[0][0] > sobol[0][0], "Randomization does not depend on key");
+
+    try {
+        SamplePoints tooMany(SamplePoints::Method::Sobol, SamplePoints::MAX_SOBOL_DIMENSIONS + 1, count, 7);
+        Assert::Fail("Too many Sobol dimensions accepted");
+    }
+    catch (std::range_error &) {
+    }
+
+    Assert::AreEqual(1.959963984540054, inverseNormalCdf(0.975), 1e-12);
+    Assert::AreEqual(-1.959963984540054, inverseNormalCdf(0.025), 1e-12);
+    Assert::AreEqual(0.0, inverseNormalCdf(0.5), 1e-15);
+    Assert::AreEqual(-8.222082216130435, inverseNormalCdf(1e-16), 1e-9);
+    Assert::IsTrue(std::isinf(inverseNormalCdf(1)), "Inverse of 1 is not infinite");
+    Assert::IsNaN(inverseNormalCdf(1.5));
+}
+
+static double meanTimeOfEvent(ProgData data) {
+    std::vector<double> toe = data.events["EOD"].timeOfEvent.getVec();
+    return calculatemean(toe.data(), static_cast<int>(toe.size()));
+}
+
+// Every sampling method must estimate the same mean time of event, and not depend on the number of threads
+void testMonteCarloBatterySampling()
+{
+    // Process noise is negligible, so the spread of the mean comes from the dimensions the sampling methods
+    // place. The reference then has a standard deviation of about 1.2 s, and each method about 1 s or less.
+    double reference = meanTimeOfEvent(runSeededBatteryPrediction("4", "true", "random", "5", 4096, "1e-12"));
+    const std::vector<std::string> methods = { "antithetic", "lhs", "halton", "sobol" };
+    for (const std::string & sampling : methods) {
+        ProgData serial = runSeededBatteryPrediction("1", "true", sampling, "42", 130, "1e-12");
+        ProgData parallel = runSeededBatteryPrediction("3", "true", sampling, "42", 130, "1e-12");
+        Assert::IsTrue(serial.events["EOD"].timeOfEvent == parallel.events["EOD"].timeOfEvent, "Time of event differs");
+        Assert::AreEqual(reference, meanTimeOfEvent(serial), 5, "Incorrect mean time of event for " + sampling);
+    }
+
+    GSAPConfigMap configMap;
+    configMap.set("Predictor.numSamples", "10");
+    configMap.set("Predictor.horizon", "5000");
+    configMap.set("Model.event", "EOD");
+    configMap.set("Model.predictedOutputs", "SOC");
+    configMap["Model.processNoise"] = std::vector<std::string>(8, "1e-5");
+    configMap["Predictor.inputUncertainty"] = { "8", "0.1", "5000", "1" };
+    configMap.set("Predictor.sampling", "stratified");
+    try {
+        MonteCarloPredictor MCP(configMap);
+        Assert::Fail("Unknown sampling method accepted");
+    }
+    catch (ConfigurationError &) {
+    }
+}
+
+// Compares the spread of the mean time of event estimated by each sampling method, over repeated seeds.
+// Process noise is negligible, so the variance comes from the initial state and input parameters, which
+// are the dimensions the sampling methods place.
+void testMonteCarloBatterySamplingBenchmark()
+{
+    const unsigned int repetitions = 8;
+    const std::vector<std::string> methods = { "random", "antithetic", "lhs", "halton", "sobol" };
+    std::vector<double> spreads(methods.size());
+
+    std::printf("\n%12s %12s %12s %12s\n", "samples", "method", "SD (s)", "time (ms)");
+    for (unsigned int numSamples = 16; numSamples <= 64; numSamples *= 2) {
+        for (std::size_t m = 0; m < methods.size(); m++) {
+            RunningStatistics means;
+            auto start = std::chrono::steady_clock::now();
+            for (unsigned int r = 0; r < repetitions; r++) {
+                ProgData data = runSeededBatteryPrediction("4", "true", methods[m], std::to_string(r + 1),
+                                                           numSamples, "1e-12");
+                means.add(meanTimeOfEvent(data));
+            }
+            auto elapsed = std::chrono::steady_clock::now() - start;
+            spreads[m] = means.stdv();
+            std::printf("%12u %12s %12.2f %12.1f\n", numSamples, methods[m].c_str(), spreads[m],
+                static_cast<double>(std::chrono::duration_cast<std::chrono::microseconds>(elapsed).count()) / 1000 / repetitions);
+        }
+    }
+
+    // With 64 samples, stratified and antithetic sampling must clearly beat random sampling
+    for (const char * method : { "antithetic", "lhs", "sobol", "halton" }) {
+        std::size_t m = static_cast<std::size_t>(std::find(methods.begin(), methods.end(), method) - methods.begin());
+        Assert::IsTrue(spreads[m] < 0.5 * spreads[0], "No improvement over random sampling for " + std::string(method));
+    }
+}
+
+// Predict from a state given as weighted samples, such as the estimate of a particle filter
+void testMonteCarloBatteryWeightedSamples()
+{
+    const unsigned int numSamples = 200;
+    GSAPConfigMap configMap;
+    configMap.set("Predictor.numSamples", std::to_string(numSamples));
+    configMap.set("Predictor.horizon", "5000");
+    configMap.set("Predictor.seed", "11");
+    configMap.set("Model.event", "EOD");
+    configMap.set("Model.predictedOutputs", "SOC");
+    configMap["Model.processNoise"] = std::vector<std::string>(8, "1e-10");
+    configMap["Predictor.inputUncertainty"] = { "8", "0.01", "5000", "1" };
+
+    Battery battery = Battery();
+    std::vector<double> full(8);
+    std::vector<double> u = { 8 };
+    std::vector<double> z0 = { 20, 4.2 };
+    battery.initialize(full, u, z0);
+
+    // The second particle is partly discharged
+    std::vector<double> discharged = full;
+    std::vector<double> noise(8, 0);
+    for (unsigned int t = 0; t < 1500; t++) {
+        battery.stateEqn(t, discharged, u, noise, 1);
+    }
+
+    MonteCarloPredictor MCP(configMap);
+    MCP.setModel(&battery);
+
+    std::vector<UData> state(battery.getNumStates());
+    for (unsigned int i = 0; i < battery.getNumStates(); i++) {
+        state[i].uncertainty(UType::WSamples);
+        state[i].npoints(2);
+        state[i].setVec({ full[i], 0.25, discharged[i], 0.75 });
+    }
+
+    ProgData data;
+    data.setUncertainty(UType::Samples);
+    data.addEvent("EOD");
+    data.addSystemTrajectory("SOC");
+    data.sysTrajectories.setNSamples(numSamples);
+    data.setPredictions(1, 5000);
+    data.setupOccurrence(numSamples);
+    data.events["EOD"].timeOfEvent.npoints(numSamples);
+
+    MCP.predict(0, state, data);
+
+    // Samples drawn from the discharged particle reach EOD about 1500 s earlier
+    std::vector<double> toe = data.events["EOD"].timeOfEvent.getVec();
+    double earliest = *std::min_element(toe.begin(), toe.end());
+    double latest = *std::max_element(toe.begin(), toe.end());
+    Assert::AreEqual(1500, latest - earliest, 100, "Particles do not separate time of event");
+    unsigned int early = 0;
+    for (double t : toe) {
+        if (t < (earliest + latest) / 2) {
+            early++;
+        }
+    }
+    double fraction = static_cast<double>(early) / numSamples;
+    Assert::AreEqual(0.75, fraction, 0.1, "Samples not drawn in proportion to weight");
+}
+
 // Test error cases with config parameters
 void testMonteCarloBatteryConfig()
 {
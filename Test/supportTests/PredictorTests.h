@@ -26,5 +26,14 @@ void predictorTestInit();
 // MC Battery tests
 void testMonteCarloBatteryPredict();
 void testMonteCarloBatteryConfig();
+void testMonteCarloBatteryThreads();
+void testMonteCarloBatteryStopAtEvent();
+void testMonteCarloBatteryWeightedSamples();
+void testMonteCarloBatteryStatistics();
+void testMonteCarloBatteryStatisticsShortHorizon();
+void testMonteCarloBatteryShortProbMatrix();
+void testMonteCarloBatterySampling();
+void testMonteCarloBatterySamplingBenchmark();
+void testSamplePoints();
 
 #endif // PREDICTORTESTS_H
@@ -0,0 +1,181 @@
+/**  RandomTests - Body
+ *   @file      Unit tests for random number generation
+ *
+ *   @copyright Copyright (c) 2016 United States Government as represented by
+ *              the Administrator of the National Aeronautics and Space
+ *              Administration. All Rights Reserved.
+ */
+
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <random>
+#include <vector>
+
+#include "GaussianVariable.h"
+#include "Random.h"
+#include "RandomTests.h"
+#include "StatisticalTools.h"
+#include "Test.h"
+
+using namespace PCOE;
+using namespace PCOE::Test;
+
+// The same key and stream give the same values; other streams give other values
+void testRandomStreams()
+{
+    Philox4x32 a(42, 7);
+    Philox4x32 b(42, 7);
+    Philox4x32 c(42, 8);
+    bool differs = false;
+    for (unsigned int i = 0; i < 100; i++) {
+        Philox4x32::result_type value = a();
+        Assert::AreEqual(value, b());
+        differs = differs || value != c();
+    }
+    Assert::IsTrue(differs, "Streams are not independent");
+
+    // discard skips the same values as drawing them
+    Philox4x32 skipped(42, 7);
+    Philox4x32 drawn(42, 7);
+    skipped.discard(13);
+    for (unsigned int i = 0; i < 13; i++) {
+        drawn();
+    }
+    Assert::AreEqual(drawn(), skipped());
+}
+
+void testRandomFillUniform()
+{
+    const std::size_t count = 100000;
+    std::vector<double> values(count);
+    Philox4x32 generator(1);
+    fillUniform(generator, values.data(), count);
+
+    RunningStatistics statistics;
+    for (double u : values) {
+        Assert::IsTrue(u > 0 && u < 1, "Uniform value outside (0, 1)");
+        statistics.add(u);
+    }
+    Assert::AreEqual(0.5, statistics.mean(), 0.005);
+    Assert::AreEqual(1.0 / 12, statistics.variance(), 0.002);
+
+    // Values match drawing one at a time
+    Philox4x32 single(1);
+    for (std::size_t i = 0; i < 10; i++) {
+        Assert::AreEqual(values[i], uniformOpen(single), 0.0);
+    }
+}
+
+void testRandomFillNormal()
+{
+    const std::size_t count = 200001;  // Odd, and not a multiple of the chunk size
+    std::vector<double> values(count + 1, 99.0);
+    Philox4x32 generator(2);
+    fillNormal(generator, values.data(), count);
+    Assert::AreEqual(99.0, values[count], 0.0, "Wrote past the end of the buffer");
+
+    RunningStatistics statistics;
+    std::size_t withinOneSD = 0;
+    for (std::size_t i = 0; i < count; i++) {
+        Assert::IsFalse(std::isnan(values[i]) || std::isinf(values[i]), "Normal value is not finite");
+        statistics.add(values[i]);
+        if (std::abs(values[i]) < 1) {
+            withinOneSD++;
+        }
+    }
+    Assert::AreEqual(0.0, statistics.mean(), 0.01);
+    Assert::AreEqual(1.0, statistics.variance(), 0.01);
+    Assert::AreEqual(0.682689, static_cast<double>(withinOneSD) / count, 0.005);
+
+    // Reproducible from the stream
+    std::vector<double> again(count);
+    Philox4x32 same(2);
+    fillNormal(same, again.data(), count);
+    for (std::size_t i = 0; i < count; i += 997) {
+        Assert::AreEqual(values[i], again[i], 0.0);
+    }
+}
+
+void testRandomInverseNormalCdf()
+{
+    std::vector<double> p = { 1e-300, 1e-10, 0.001, 0.02425, 0.1, 0.5, 0.8, 0.97575, 0.999, 1 - 1e-10 };
+    std::vector<double> x(p.size());
+    inverseNormalCdf(p.data(), x.data(), p.size());
+    for (std::size_t i = 0; i < p.size(); i++) {
+        Assert::AreEqual(inverseNormalCdf(p[i]), x[i], 0.0);
+        // Round trip through the CDF, computed from the smaller tail
+        double cdf = x[i] < 0 ? 0.5 * std::erfc(-x[i] / std::sqrt(2.0)) : 1 - 0.5 * std::erfc(x[i] / std::sqrt(2.0));
+        Assert::AreEqual(p[i], cdf, 1e-14 * std::max(1.0, 1 / p[i]) * p[i] + 1e-16);
+    }
+    Assert::AreEqual(-6.361340902404056, inverseNormalCdf(1e-10), 1e-9);
+    Assert::AreEqual(1.281551565544601, inverseNormalCdf(0.9), 1e-12);
+
+    // Converted in place
+    inverseNormalCdf(p.data(), p.data(), p.size());
+    Assert::AreEqual(x[5], p[5], 0.0);
+}
+
+void testRandomGaussianVariable()
+{
+    GaussianVariable variable(10, 2);
+    Assert::AreEqual(10 + 2 * 1.959963984540054, variable.invertcdfur(0.975), 1e-9);
+    Assert::AreEqual(10.0, variable.invertcdfur(0.5), 1e-12);
+
+    const int count = 10000;
+    variable.setseed(3);
+    variable.generatesamplesdirect(count);
+    Assert::AreEqual(10.0, calculatemean(variable.VarSamples, count), 0.1);
+    Assert::AreEqual(2.0, calculatestdv(variable.VarSamples, count), 0.1);
+    double first = variable.VarSamples[0];
+    variable.setseed(3);
+    variable.generatesamplesdirect(1);
+    Assert::AreEqual(first, variable.VarSamples[0], 0.0, "Samples are not reproducible");
+
+    variable.generatesamplesicdfur(count);
+    Assert::AreEqual(10.0, calculatemean(variable.VarSamples, count), 0.1);
+    Assert::AreEqual(2.0, calculatestdv(variable.VarSamples, count), 0.1);
+}
+
+// Compares drawing normals one at a time through std::normal_distribution with filling a buffer
+void testRandomNormalBenchmark()
+{
+    const std::size_t count = 1 << 20;
+    std::vector<double> values(count);
+    double checksum = 0;
+
+    auto start = std::chrono::steady_clock::now();
+    std::mt19937 twister(5);
+    std::normal_distribution<> twisterNormal(0, 1);
+    for (std::size_t i = 0; i < count; i++) {
+        values[i] = twisterNormal(twister);
+    }
+    auto twisterTime = std::chrono::steady_clock::now() - start;
+    checksum += values[count - 1];
+
+    start = std::chrono::steady_clock::now();
+    Philox4x32 philox(5);
+    std::normal_distribution<> philoxNormal(0, 1);
+    for (std::size_t i = 0; i < count; i++) {
+        values[i] = philoxNormal(philox);
+    }
+    auto philoxTime = std::chrono::steady_clock::now() - start;
+    checksum += values[count - 1];
+
+    start = std::chrono::steady_clock::now();
+    Philox4x32 generator(5);
+    fillNormal(generator, values.data(), count);
+    auto fillTime = std::chrono::steady_clock::now() - start;
+    checksum += values[count - 1];
+
+    using std::chrono::nanoseconds;
+    using std::chrono::duration_cast;
+    std::printf("\n%28s %10s\n", "method", "ns/value");
+    std::printf("%28s %10.2f\n", "mt19937 normal_distribution",
+        static_cast<double>(duration_cast<nanoseconds>(twisterTime).count()) / count);
+    std::printf("%28s %10.2f\n", "Philox4x32 normal_distribution",
+        static_cast<double>(duration_cast<nanoseconds>(philoxTime).count()) / count);
+    std::printf("%28s %10.2f\n", "Philox4x32 fillNormal",
+        static_cast<double>(duration_cast<nanoseconds>(fillTime).count()) / count);
+    Assert::IsFalse(std::isnan(checksum));
+}
@@ -0,0 +1,19 @@
+/**  RandomTests - Header
+ *   @file      Unit tests for random number generation
+ *
+ *   @copyright Copyright (c) 2016 United States Government as represented by
+ *              the Administrator of the National Aeronautics and Space
+ *              Administration. All Rights Reserved.
+ */
+
+#ifndef RANDOMTESTS_H
+#define RANDOMTESTS_H
+
+void testRandomStreams();
+void testRandomFillUniform();
+void testRandomFillNormal();
+void testRandomInverseNormalCdf();
+void testRandomGaussianVariable();
+void testRandomNormalBenchmark();
+
+#endif // RANDOMTESTS_H
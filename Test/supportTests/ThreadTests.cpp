@@ -7,9 +7,21 @@
 //
 
 
+#include <atomic>
+#include <chrono>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
 #include "Test.h"
 #include "ThreadTests.h"
 #include "Thread.h"
+#include "Task.h"
+#include "Executor.h"
+#include "BoundedQueue.h"
+#include "ThreadSafeLog.h"
 
 using namespace PCOE;
 using namespace PCOE::Test;
@@ -35,6 +47,74 @@ public:
     }
 };
 
+class TestTaskClass final : public Task
+{
+public:
+    TestTaskClass() : Task(), runs(0), cleanups(0), delay(0) {}
+
+    ~TestTaskClass() {
+        if (getState() == ThreadState::Started) {
+            stop();
+        }
+        if (getState() == ThreadState::Stopped) {
+            join();
+        }
+    }
+
+    void request() {
+        schedule();
+    }
+
+    std::atomic<unsigned int> runs;
+    std::atomic<unsigned int> cleanups;
+    std::atomic<int> delay;  ///< If positive, each cycle schedules another after this many ms
+
+private:
+    void run() final override {
+        runs++;
+        if (delay > 0) {
+            scheduleAfter(std::chrono::milliseconds(delay));
+        }
+    }
+
+    void cleanup() final override {
+        cleanups++;
+    }
+};
+
+class TestTaskExceptionClass final : public Task
+{
+public:
+    TestTaskExceptionClass() : runs(0) { }
+
+    ~TestTaskExceptionClass() {
+        if (getState() != ThreadState::Ended) {
+            stop();
+            join();
+        }
+    }
+
+    void request() {
+        schedule();
+    }
+
+    std::atomic<unsigned int> runs;
+
+private:
+    void run() final override {
+        runs++;
+        throw std::runtime_error("Task failed");
+    }
+};
+
+// Wait up to a second for a task to reach a number of runs
+static bool waitForRuns(const TestTaskClass & task, unsigned int runs) {
+    for (int i = 0; i < 100 && task.runs < runs; i++) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    return task.runs >= runs;
+}
+
 void tctrltests() {
     TestThreadClass test;
     Assert::AreEqual(ThreadState::Created, test.getState());
@@ -60,3 +140,263 @@ void exceptiontest() {
         Assert::Fail();
     }
 }
+
+void taskctrltests() {
+    TestTaskClass test;
+    Assert::AreEqual(ThreadState::Created, test.getState());
+    test.enable();
+    Assert::AreEqual(ThreadState::Enabled, test.getState());
+
+    // Cycles only run when started
+    test.request();
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    Assert::AreEqual(0, test.runs.load(), "Ran while enabled");
+    test.start();
+    Assert::AreEqual(ThreadState::Started, test.getState());
+    Assert::IsTrue(waitForRuns(test, 1), "No cycle on start");
+    unsigned int runs = test.runs;
+    test.request();
+    Assert::IsTrue(waitForRuns(test, runs + 1), "No cycle on request");
+
+    test.pause();
+    Assert::AreEqual(ThreadState::Paused, test.getState());
+    runs = test.runs;
+    test.request();
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    Assert::AreEqual(runs, test.runs.load(), "Ran while paused");
+
+    test.stop();
+    Assert::AreEqual(ThreadState::Stopped, test.getState());
+    test.join();
+    Assert::AreEqual(ThreadState::Ended, test.getState());
+    Assert::AreEqual(1, test.cleanups.load(), "Cleanup count");
+}
+
+void taskdelaytest() {
+    TestTaskClass test;
+    test.delay = 20;
+    test.start();
+    Assert::IsTrue(waitForRuns(test, 3), "Delayed cycles did not run");
+
+    // Stopping cancels the pending delayed cycle
+    test.stop();
+    test.join();
+    unsigned int runs = test.runs;
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    Assert::AreEqual(runs, test.runs.load(), "Ran after stop");
+}
+
+void taskexceptiontest() {
+    TestTaskExceptionClass test;
+    test.start();
+    // A failed cycle is logged, and the task still runs the cycles requested later
+    for (int i = 0; i < 100 && test.runs < 1; i++) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    test.request();
+    for (int i = 0; i < 100 && test.runs < 2; i++) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    Assert::AreEqual(2, test.runs.load(), "Cycle not run after a failure");
+    Assert::AreEqual(ThreadState::Started, test.getState());
+    test.stop();
+    test.join();
+    Assert::AreEqual(ThreadState::Ended, test.getState());
+}
+
+void executortests() {
+    Executor & executor = Executor::instance();
+    Assert::IsTrue(executor.getNumWorkers() >= 1, "No workers");
+
+    std::vector<unsigned int> values(100, 0);
+    executor.parallelFor(100, [&values](unsigned int i) { values[i] = i * i; });
+    for (unsigned int i = 0; i < 100; i++) {
+        Assert::AreEqual(i * i, values[i]);
+    }
+
+    // Nested calls help with queued tasks rather than blocking a worker
+    std::atomic<unsigned int> count(0);
+    executor.parallelFor(8, [&executor, &count](unsigned int) {
+        executor.parallelFor(8, [&count](unsigned int) { count++; });
+    });
+    Assert::AreEqual(64, count.load());
+
+    // The exception with the smallest index is rethrown
+    try {
+        executor.parallelFor(10, [](unsigned int i) {
+            if (i >= 3) {
+                throw std::out_of_range(std::to_string(i));
+            }
+        });
+        Assert::Fail("No exception");
+    }
+    catch (std::out_of_range & ex) {
+        Assert::AreEqual(std::string("3"), std::string(ex.what()));
+    }
+
+    // A task that throws does not end its worker
+    executor.submit([]() { throw std::runtime_error("Task failed"); });
+    count = 0;
+    executor.parallelFor(16, [&count](unsigned int) { count++; });
+    Assert::AreEqual(16, count.load());
+
+    // Tasks submitted from other threads are all run while workers take them
+    std::atomic<unsigned int> submitted(0);
+    std::vector<std::thread> submitters;
+    for (int t = 0; t < 4; t++) {
+        submitters.emplace_back([&executor, &submitted]() {
+            for (int i = 0; i < 250; i++) {
+                executor.submit([&submitted]() { submitted++; });
+            }
+        });
+    }
+    for (auto & submitter : submitters) {
+        submitter.join();
+    }
+    for (int i = 0; i < 100 && submitted < 1000; i++) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    Assert::AreEqual(1000, submitted.load(), "Submitted tasks not run");
+
+    // Cancelled timers do not run
+    std::atomic<bool> ran(false);
+    unsigned long id = executor.submitAfter(std::chrono::milliseconds(50), [&ran]() { ran = true; });
+    Assert::IsTrue(executor.cancel(id), "Could not cancel");
+    std::this_thread::sleep_for(std::chrono::milliseconds(80));
+    Assert::IsFalse(ran, "Cancelled timer ran");
+}
+
+void boundedqueuetests() {
+    BoundedQueue<int> queue(3);
+    Assert::AreEqual(4, queue.capacity(), "Capacity not rounded to a power of two");
+    Assert::AreEqual(0, queue.size(), "Non-zero size after initialization");
+
+    int value = 0;
+    Assert::IsFalse(queue.tryPop(value), "Pop from empty queue");
+    for (int i = 0; i < 4; i++) {
+        Assert::IsTrue(queue.tryPush(std::move(i)), "Push to queue with space");
+    }
+    Assert::IsFalse(queue.tryPush(4), "Push to full queue");
+    Assert::AreEqual(4, queue.size(), "Incorrect size when full");
+
+    // Items come out in order, and wrap around the ring
+    for (int i = 0; i < 10; i++) {
+        Assert::IsTrue(queue.tryPop(value), "Pop from non-empty queue");
+        Assert::AreEqual(i, value, "Items out of order");
+        Assert::IsTrue(queue.tryPush(i + 4), "Push after pop");
+    }
+}
+
+void boundedqueueconcurrent() {
+    const int producers = 4;
+    const int count = 20000;
+    BoundedQueue<int> queue(64);
+
+    std::vector<std::thread> threads;
+    for (int p = 0; p < producers; p++) {
+        threads.emplace_back([&queue, p, count]() {
+            for (int i = 0; i < count; i++) {
+                int value = p * count + i;
+                while (!queue.tryPush(std::move(value))) {
+                    std::this_thread::yield();
+                }
+            }
+        });
+    }
+
+    // Every item arrives once, and each producer's items stay in order
+    std::vector<int> last(producers, -1);
+    long long sum = 0;
+    int received = 0;
+    bool ordered = true;
+    while (received < producers * count) {
+        int value;
+        if (queue.tryPop(value)) {
+            int p = value / count;
+            ordered = ordered && value > last[static_cast<std::size_t>(p)];
+            last[static_cast<std::size_t>(p)] = value;
+            sum += value;
+            received++;
+        }
+    }
+    for (auto & thread : threads) {
+        thread.join();
+    }
+    long long n = producers * count;
+    Assert::AreEqual(n * (n - 1) / 2, sum, "Items lost or repeated");
+    Assert::IsTrue(ordered, "Items from one producer out of order");
+}
+
+static std::vector<std::string> readLines(const std::string & path) {
+    std::ifstream file(path);
+    std::vector<std::string> lines;
+    std::string line;
+    while (std::getline(file, line)) {
+        lines.push_back(line);
+    }
+    return lines;
+}
+
+void asynclogtests() {
+    const std::string path = "AsyncLogTest.log";
+    Log & log = Log::Instance(path);
+    Log::SetAsync(true, std::chrono::milliseconds(10000));
+
+    // Lines from every thread are written once Flush returns
+    const int threads = 4;
+    const int count = 200;
+    std::vector<std::thread> writers;
+    for (int t = 0; t < threads; t++) {
+        writers.emplace_back([&log, t, count]() {
+            for (int i = 0; i < count; i++) {
+                log.FormatLine(LOG_INFO, "AsyncTest", "thread %d line %d", t, i);
+            }
+        });
+    }
+    for (auto & writer : writers) {
+        writer.join();
+    }
+    std::string longText(1000, 'x');
+    log.FormatLine(LOG_INFO, "AsyncTest", "long %s", longText.c_str());
+    log.LogVerbatim("verbatim");
+    Log::Flush();
+
+    std::vector<std::string> lines = readLines(path);
+    Assert::AreEqual(threads * count + 2, lines.size(), "Incorrect line count");
+    Assert::AreEqual(std::string("verbatim"), lines.back(), "Verbatim line");
+    std::string longLine = lines[lines.size() - 2];
+    Assert::IsTrue(longLine.find("|AsyncTest|long " + longText) != std::string::npos, "Long line");
+    Assert::AreEqual(std::string(" INFO|"), lines[0].substr(13, 6), "Line format");
+
+    // Errors are written without waiting for the flush interval
+    log.WriteLine(LOG_ERROR, "AsyncTest", "error");
+    bool written = false;
+    for (int i = 0; i < 1000 && !written; i++) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        written = readLines(path).size() == lines.size() + 1;
+    }
+    Log::SetAsync(false);
+    Assert::IsTrue(written, "Error not flushed");
+}
+
+void logmacrotests() {
+    Log & log = Log::Instance("LogMacroTest.log");
+    LOG_VERBOSITY oldLevel = LOG_LEVEL;
+    Log::SetVerbosity(LOG_INFO);
+
+    // Arguments are only evaluated for lines that are logged
+    int evaluated = 0;
+    auto argument = [&evaluated]() { return ++evaluated; };
+    PCOE_LOG_FORMAT(log, LOG_DEBUG, "LogMacroTest", "value %d", argument());
+    PCOE_LOG_LINE(log, LOG_TRACE, "LogMacroTest", std::to_string(argument()));
+    Assert::AreEqual(0, evaluated, "Arguments of filtered lines evaluated");
+    PCOE_LOG_FORMAT(log, LOG_INFO, "LogMacroTest", "value %d", argument());
+    PCOE_LOG_LINE(log, LOG_WARN, "LogMacroTest", std::to_string(argument()));
+    Assert::AreEqual(2, evaluated, "Arguments of logged lines not evaluated");
+    Log::SetVerbosity(oldLevel);
+
+    std::vector<std::string> lines = readLines("LogMacroTest.log");
+    Assert::AreEqual(2, lines.size(), "Incorrect line count");
+    Assert::IsTrue(lines[0].find(" INFO|LogMacroTest|value 1") != std::string::npos, "Formatted line");
+    Assert::IsTrue(lines[1].find(" WARN|LogMacroTest|2") != std::string::npos, "Written line");
+}
@@ -11,5 +11,13 @@
 
 void tctrltests();
 void exceptiontest();
+void taskctrltests();
+void taskdelaytest();
+void taskexceptiontest();
+void executortests();
+void boundedqueuetests();
+void boundedqueueconcurrent();
+void asynclogtests();
+void logmacrotests();
 
 #endif // THREADTESTS_H
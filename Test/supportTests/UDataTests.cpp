@@ -21,6 +21,7 @@
 #include "Test.h"
 #include "UDataTests.h"
 #include "UData.h"
+#include "UDataViews.h"
 
 using namespace PCOE;
 using namespace PCOE::Test;
@@ -321,6 +322,61 @@ namespace TestUData {
         Assert::AreEqual(2, vec1.size(), "Unexpected UType::MeanSD vector size");
         Assert::AreEqual(1.0, vec1[0], 1e-12, "Unexpected first element");
         Assert::AreEqual(2.0, vec1[1], 1e-12, "Unexpected second element");
+
+        double buffer[3] = { 0.0, 0.0, 0.0 };
+        Assert::AreEqual(2, ud.getVec(0, buffer, 3), "Unexpected count written to buffer");
+        Assert::AreEqual(2.0, buffer[1], 1e-12, "Unexpected element in buffer");
+        Assert::AreEqual(1, ud.getVec(1, buffer, 1), "Unexpected count written to short buffer");
+        Assert::AreEqual(2.0, buffer[0], 1e-12, "Unexpected element in short buffer");
+        Assert::AreEqual(0, ud.getVec(2, buffer, 3), "Values written past the end of the data");
+    }
+
+    void views() {
+        UData ud(UType::MeanCovar);
+        ud.npoints(2);
+        ud.setVec({ 1.0, 0.5, 0.25 });
+        MeanCovarView meanCovar(ud);
+        Assert::AreEqual(1.0, meanCovar.mean(), 1e-12, "Unexpected mean");
+        Assert::AreEqual(2, meanCovar.covar().size(), "Unexpected covariance size");
+        Assert::AreEqual(0.25, meanCovar.covar()[1], 1e-12, "Unexpected covariance");
+        Assert::AreEqual(0.5, meanCovar.covar(0), 1e-12, "Unexpected covariance by index");
+        Assert::IsTrue(meanCovar.covar().data() == ud.data() + COVAR(0), "Covariance was copied");
+
+        try {
+            SamplesView wrongType(ud);
+            Assert::Fail("View created for a different uncertainty type");
+        }
+        catch (std::invalid_argument &) {}
+
+        ud.uncertainty(UType::Samples);
+        ud.npoints(3);
+        ud.setVec({ 3.0, 4.0, 5.0 });
+        SamplesView samples(ud);
+        double sum = 0.0;
+        for (double x : samples.samples()) {
+            sum += x;
+        }
+        Assert::AreEqual(3, samples.size(), "Unexpected number of samples");
+        Assert::AreEqual(12.0, sum, 1e-12, "Unexpected sum of samples");
+        ud[1] = 6.0;
+        Assert::AreEqual(6.0, samples[1], 1e-12, "View does not reflect changes");
+
+        ud.uncertainty(UType::WSamples);
+        ud.setVec({ 1.0, 0.25, 2.0, 0.75 });
+        WSamplesView wSamples(ud);
+        Assert::AreEqual(3, wSamples.size(), "Unexpected number of weighted samples");
+        Assert::AreEqual(2.0, wSamples.sample(1), 1e-12, "Unexpected weighted sample");
+        Assert::AreEqual(0.75, wSamples.weight(1), 1e-12, "Unexpected weight");
+
+        ud.uncertainty(UType::MeanSD);
+        ud.setVec({ 4.0, 2.0 });
+        MeanSDView meanSD(ud);
+        Assert::AreEqual(4.0, meanSD.mean(), 1e-12, "Unexpected mean");
+        Assert::AreEqual(2.0, meanSD.sd(), 1e-12, "Unexpected SD");
+
+        ud.uncertainty(UType::Point);
+        ud.set(VALUE, 9.0);
+        Assert::AreEqual(9.0, PointView(ud).value(), 1e-12, "Unexpected point value");
     }
 
     void point() {
@@ -44,6 +44,7 @@ namespace TestUData {
     void percentiles();
     void samples();
     void wSamples();
+    void views();
 }
 
 #endif // UDATATESTS_H
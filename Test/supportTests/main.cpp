@@ -27,6 +27,7 @@
 #include "PEventTests.h"
 #include "PredictorTests.h"
 #include "ProgDataTests.h"
+#include "RandomTests.h"
 #include "ThreadTests.h"
 #include "UDataTests.h"
 
@@ -67,10 +68,16 @@ int main() {
     context.AddTest("percentiles", TestUData::percentiles, "UData");
     context.AddTest("samples", TestUData::samples, "UData");
     context.AddTest("wSamples", TestUData::wSamples, "UData");
+    context.AddTest("views", TestUData::views, "UData");
 
     // DStore Tests
     context.AddTest("Init", DStoreInit, "DStore");
     context.AddTest("Use", DStoreUse, "DStore");
+    context.AddTest("Use", TagTableUse, "TagTable");
+    context.AddTest("Concurrent", TagTableConcurrent, "TagTable");
+    context.AddTest("Use", CheckpointFileUse, "Checkpoint");
+    context.AddTest("Rotation", CheckpointFileRotation, "Checkpoint");
+    context.AddTest("Recovery", CheckpointFileRecovery, "Checkpoint");
 
     // DPoints Tests
     context.AddTest("Initialization", testPEventsInit, "DPoints");
@@ -82,6 +89,7 @@ int main() {
     context.AddTest("Initialization", testDPointInit, "DPoint");
     context.AddTest("Meta", testDPointMeta, "DPoint");
     context.AddTest("Update", testDPointUpdate, "DPoint");
+    context.AddTest("Sample Data", testDPointSampleData, "DPoint");
 
     // Matrix Tests
     // Matrix Creation
@@ -117,6 +125,8 @@ int main() {
     context.AddTest("subtract_matrix", TestMatrix::subtract_matrix, "Matrix");
     context.AddTest("subtract_salar", TestMatrix::subtract_salar, "Matrix");
     context.AddTest("multiply_matrix", TestMatrix::multiply_matrix, "Matrix");
+    context.AddTest("gemm", TestMatrix::gemm, "Matrix");
+    context.AddTest("gemm_benchmark", TestMatrix::gemm_benchmark, "Matrix");
     context.AddTest("multiply_scalar", TestMatrix::multiply_scalar, "Matrix");
     context.AddTest("divide_scalar", TestMatrix::divide_scalar, "Matrix");
     // Complex operations
@@ -127,15 +137,30 @@ int main() {
     context.AddTest("minors", TestMatrix::minors, "Matrix");
     context.AddTest("submatrix", TestMatrix::submatrix, "Matrix");
     context.AddTest("transpose", TestMatrix::transpose, "Matrix");
+    context.AddTest("transposeInto", TestMatrix::transposeInto, "Matrix");
     // Special operations
     context.AddTest("cholesky", TestMatrix::cholesky, "Matrix");
     context.AddTest("weightedmean", TestMatrix::weightedmean, "Matrix");
     context.AddTest("weightedcovariance", TestMatrix::weightedcovariance, "Matrix");
+    context.AddTest("weightedcovariance_kernels", TestMatrix::weightedcovariance_kernels, "Matrix");
+    context.AddTest("solve", TestMatrix::solve, "Matrix");
+    context.AddTest("lu_decomposition", TestMatrix::lu_decomposition, "Matrix");
+    context.AddTest("cholesky_decomposition", TestMatrix::cholesky_decomposition, "Matrix");
+    context.AddTest("cholesky_update", TestMatrix::cholesky_update, "Matrix");
+
+    // Random Tests
+    context.AddTest("Streams", testRandomStreams, "Random");
+    context.AddTest("Fill Uniform", testRandomFillUniform, "Random");
+    context.AddTest("Fill Normal", testRandomFillNormal, "Random");
+    context.AddTest("Inverse Normal CDF", testRandomInverseNormalCdf, "Random");
+    context.AddTest("Gaussian Variable", testRandomGaussianVariable, "Random");
+    context.AddTest("Normal Benchmark", testRandomNormalBenchmark, "Random");
 
     // Model Tests
     context.AddTest("Tank Initialization", testTankInitialize, "Model Tank");
     context.AddTest("Tank State Eqn", testTankStateEqn, "Model Tank");
     context.AddTest("Tank Output Eqn", testTankOutputEqn, "Model Tank");
+    context.AddTest("Tank Batch Eqns", testTankBatchEqns, "Model Tank");
 
     context.AddTest("Battery Set Parameters", testBatterySetParameters, "Model Battery");
     context.AddTest("Battery Initialization", testBatteryInitialization, "Model Battery");
@@ -144,6 +169,7 @@ int main() {
     context.AddTest("Battery Threshold Eqn", testBatteryThresholdEqn, "Model Battery");
     context.AddTest("Battery Input Eqn", testBatteryInputEqn, "Model Battery");
     context.AddTest("Battery Predicted Output Eqn", testBatteryPredictedOutputEqn, "Model Battery");
+    context.AddTest("Battery Batch Eqns", testBatteryBatchEqns, "Model Battery");
 
     // Observer Tests
     context.AddCategoryInitializer("Observer", observerTestsInit);
@@ -151,16 +177,28 @@ int main() {
     context.AddTest("UKF Initialize for Tank", testUKFTankInitialize, "Observer");
     context.AddTest("UKF Step for Tank", testUKFTankStep, "Observer");
     context.AddTest("UKF Tank Get Inputs", testUKFTankGetInputs, "Observer");
+    context.AddTest("UKF Step for Tank does not allocate", testUKFTankStepAllocations, "Observer");
 
     // UKF Battery tests
     context.AddTest("UKF Battery Construction from ConfigMap", testUKFBatteryFromConfig, "Observer");
     context.AddTest("UKF Initialization for Battery", testUKFBatteryInitialize, "Observer");
     context.AddTest("UKF Step for Battery", testUKFBatteryStep, "Observer");
 
+    // Square-root UKF Tests
+    context.AddTest("SRUKF Step for Tank", testSRUKFTankStep, "Observer");
+    context.AddTest("SRUKF Step for Battery", testSRUKFBatteryStep, "Observer");
+    context.AddTest("SRUKF Construction from ObserverFactory", testSRUKFFromFactory, "Observer");
+
+    // Particle filter Tests
+    context.AddTest("PF Step for Tank", testPFTankStep, "Observer");
+    context.AddTest("PF Outlier after Zero Weights", testPFZeroWeightOutlier, "Observer");
+    context.AddTest("PF Construction from ObserverFactory", testPFFromFactory, "Observer");
+
     // PEvent Tests
     context.AddTest("Initialization", testPEventInit, "PEvent");
     context.AddTest("Meta Data", testPEventMeta, "PEvent");
     context.AddTest("Update", testPEventUpdate, "PEvent");
+    context.AddTest("Occurrence", testPEventOccurrence, "PEvent");
 
     // ProgData Tests
     context.AddTest("Prog Data", progDataTest, "ProgData");
@@ -169,11 +207,28 @@ int main() {
     // Thread Tests
     context.AddTest("treadctrl", tctrltests, "Thread");
     context.AddTest("Exception", exceptiontest, "Thread");
+    context.AddTest("taskctrl", taskctrltests, "Thread");
+    context.AddTest("Task delay", taskdelaytest, "Thread");
+    context.AddTest("Task exception", taskexceptiontest, "Thread");
+    context.AddTest("Executor", executortests, "Thread");
+    context.AddTest("Bounded queue", boundedqueuetests, "Thread");
+    context.AddTest("Bounded queue concurrent", boundedqueueconcurrent, "Thread");
+    context.AddTest("Async log", asynclogtests, "Thread");
+    context.AddTest("Log macros", logmacrotests, "Thread");
 
     // Predictor Tests
     context.AddCategoryInitializer("Predictor", predictorTestInit);
     context.AddTest("Monte Carlo Predictor Configuration for Battery", testMonteCarloBatteryConfig, "Predictor");
     context.AddTest("Monte Carlo Prediction for Battery", testMonteCarloBatteryPredict, "Predictor");
+    context.AddTest("Monte Carlo Prediction with Threads", testMonteCarloBatteryThreads, "Predictor");
+    context.AddTest("Monte Carlo Prediction Stopping at Event", testMonteCarloBatteryStopAtEvent, "Predictor");
+    context.AddTest("Monte Carlo Prediction from Weighted Samples", testMonteCarloBatteryWeightedSamples, "Predictor");
+    context.AddTest("Monte Carlo Prediction Statistics", testMonteCarloBatteryStatistics, "Predictor");
+    context.AddTest("Monte Carlo Prediction Statistics with a Short Horizon", testMonteCarloBatteryStatisticsShortHorizon, "Predictor");
+    context.AddTest("Monte Carlo Prediction into a Short Probability Matrix", testMonteCarloBatteryShortProbMatrix, "Predictor");
+    context.AddTest("Sample Points", testSamplePoints, "Predictor");
+    context.AddTest("Monte Carlo Prediction Sampling Methods", testMonteCarloBatterySampling, "Predictor");
+    context.AddTest("Monte Carlo Prediction Sampling Benchmark", testMonteCarloBatterySamplingBenchmark, "Predictor");
 
     int result = context.Execute();
     std::ofstream junit("testresults/support.xml");
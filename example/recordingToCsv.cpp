@@ -0,0 +1,32 @@
+//
+//  recordingToCsv.cpp
+//  Example
+//
+//  Converts a binary recording written by the RecorderCommunicator (format: binary)
+//  to the csv format it writes by default.
+//
+//  Copyright © 2016 United States Government as represented by the Administrator of the National Aeronautics and Space Administration.  All Rights Reserved.
+//
+
+#include <cstdio>
+#include <exception>
+
+#include "RecorderCommunicator.h"
+
+using namespace PCOE;
+
+int main(int argc, char * argv[]) {
+    if (argc != 3) {
+        std::fprintf(stderr, "Usage: %s <recording> <csv file>\n", argv[0]);
+        return 1;
+    }
+
+    try {
+        RecorderCommunicator::convertToCsv(argv[1], argv[2]);
+    }
+    catch (const std::exception & ex) {
+        std::fprintf(stderr, "Could not convert %s: %s\n", argv[1], ex.what());
+        return 1;
+    }
+    return 0;
+}
@@ -173,6 +173,41 @@ class Battery final : public PCOE::PrognosticsModel {
     void predictedOutputEqn(const double t, const std::vector<double> & x,
                             const std::vector<double> & u, std::vector<double> & z);
 
+    /** @brief      Execute state equation for a block of samples (one sample per column).
+    *   @param      t Time
+    *   @param      X State matrix. This gets updated to the states at the new time.
+    *   @param      U Input matrix
+    *   @param      N Process noise matrix
+    *   @param      dt Sampling time
+    **/
+    void stateEqnBatch(const double t, PCOE::Matrix & X, const PCOE::Matrix & U,
+                       const PCOE::Matrix & N, const double dt);
+    /** @brief      Execute output equation for a block of samples (one sample per column).
+    *   @param      t Time
+    *   @param      X State matrix
+    *   @param      U Input matrix
+    *   @param      N Sensor noise matrix
+    *   @param      Z Output matrix. This gets updated to the outputs at the given time.
+    **/
+    void outputEqnBatch(const double t, const PCOE::Matrix & X, const PCOE::Matrix & U,
+                        const PCOE::Matrix & N, PCOE::Matrix & Z);
+    /** @brief      Execute threshold equation for a block of samples (one sample per column).
+    *   @param      t Time
+    *   @param      X State matrix
+    *   @param      U Input matrix
+    *   @param      occurred Whether the threshold is reached, one for each sample. Gets overwritten.
+    **/
+    void thresholdEqnBatch(const double t, const PCOE::Matrix & X, const PCOE::Matrix & U,
+                           std::vector<bool> & occurred);
+    /** @brief      Execute predicted output equation for a block of samples (one sample per column).
+    *   @param      t Time
+    *   @param      X State matrix
+    *   @param      U Input matrix
+    *   @param      Z Predicted output matrix. Gets overwritten.
+    **/
+    void predictedOutputEqnBatch(const double t, const PCOE::Matrix & X, const PCOE::Matrix & U,
+                                 PCOE::Matrix & Z);
+
     // Set default parameters, based on 18650 cells
     void setParameters(const double qMobile = 7600);
 
@@ -24,6 +24,8 @@
 #ifndef PCOE_COMMMANAGER_H
 #define PCOE_COMMMANAGER_H
 
+#include <functional>
+#include <map>
 #include <string>
 #include <vector>
 #include <mutex>
@@ -33,6 +35,7 @@
 #include "GSAPConfigMap.h"
 #include "Singleton.h"
 #include "Datum.h"
+#include "TagTable.h"
 
 namespace PCOE {
     class Log;
@@ -41,21 +44,42 @@ namespace PCOE {
 
     class CommManager : public Thread, public Singleton<CommManager> {
         friend void CommManagerTest();
+        friend void CommManagerSubscribeTest();
+        friend void PrognoserWakeTest();
+        friend void CommManagerHandleTest();
         friend class Singleton<CommManager>;  // Needed for singleton
     public:
+        using Listener = std::function<void()>;
+
         void configure(const GSAPConfigMap & params);
 
         /** @brief      Register a key with the Comm Manager
-
+         *  @return     Handle of the key, for use with getValue(TagTable::Handle)
          *
          *  This method allows users of the CommManager to register keys they expect
          *  to use. If the key has not yet been registered by another user the key
-         *  will be added to the datamap.
+         *  will be added to the datamap. Registering a key again returns the same
+         *  handle.
          */
-        void registerKey(const std::string & key);
+        TagTable::Handle registerKey(const std::string & key);
 
         bool registerProgData(const std::string & key, ProgData * pData);
 
+        /** @brief      Subscribe to updates of a set of keys
+         *  @param      keys Keys to watch
+         *  @param      fn Function called on the communications thread each time
+         *              new data arrives for one or more of the keys. It should
+         *              return quickly, and must not call back into the CommManager.
+         *  @return     Id of the subscription, used to unsubscribe
+         */
+        unsigned long subscribe(const std::vector<std::string> & keys, const Listener & fn);
+
+        /** @brief      Remove a subscription. Once this returns, its function is
+         *              not running and will not be called again.
+         *  @param      id Id returned by subscribe
+         */
+        void unsubscribe(unsigned long id);
+
         /** @brief      Get the value associated with a key
          *  @param[in]  key Key for which the value is requested
          *
@@ -63,6 +87,13 @@ namespace PCOE {
          *              Will be null if key does not exist
          */
         Datum<double> getValue(const std::string & key) const;
+
+        /** @brief      Get the value associated with a key handle without locking
+         *  @param[in]  handle Handle returned by registerKey
+         *
+         *  @return     Datum containing the latest value. Times are to the millisecond.
+         */
+        Datum<double> getValue(TagTable::Handle handle) const;
         
         Datum<std::string> getString(const std::string & key) const;
 
@@ -81,10 +112,21 @@ namespace PCOE {
 
         void updateLookup(DataStore & ds);
 
+        struct Subscription {
+            std::vector<std::string> keys;
+            Listener fn;
+        };
+
         ProgDataMap progData;
 
+        /// Find or add the handle of a key. Requires lookupMutex.
+        TagTable::Handle handleOf(const std::string & key);
+
         DataStore lookup;
+        std::unordered_map<std::string, TagTable::Handle> handles;
+        TagTable values;  ///< Values of lookup, by handle
         DataStoreString stringLookup;
+        AllDataPool snapshots;  ///< Storage for the data published to communicators
     
         bool threadStarted;
 
@@ -92,6 +134,10 @@ namespace PCOE {
         unsigned long stepSize;
         mutable mutex progDataMutex;
         mutable mutex lookupMutex;
+
+        std::map<unsigned long, Subscription> subscriptions;
+        unsigned long nextSubscription;
+        std::mutex subscriptionMutex;
     };
 }
 
@@ -19,17 +19,21 @@
 #ifndef PCOE_COMMONCOMMUNICATOR_H
 #define PCOE_COMMONCOMMUNICATOR_H
 
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
 #include <unordered_map>
 #include <string>
+#include <memory>
 #include <mutex>
-#include <condition_variable>
+#include <functional>
 #include <utility>
-#include <queue>
 
+#include "BoundedQueue.h"
 #include "DataStore.h"
 #include "ProgData.h"
 #include "ConfigMap.h"
-#include "Thread.h"
+#include "Task.h"
 #include "ThreadSafeLog.h"
 
 namespace PCOE {
@@ -52,21 +56,91 @@ namespace PCOE {
         }
     };
 
+    /** @brief Read-only AllData, shared by every communicator it is sent to */
+    using AllDataSnapshot = std::shared_ptr<const AllData>;
+
+    /** @class  AllDataPool
+     *  @brief  Creates AllData snapshots. When no communicator holds a snapshot
+     *          any more, its storage returns to the pool and is reused by a later
+     *          snapshot, so the maps keep their nodes and buckets.
+     */
+    class AllDataPool {
+    public:
+        AllDataPool();
+
+        /** @brief  Create a snapshot holding a copy of the given data
+         *  @return The snapshot. It may outlive the pool.
+         */
+        AllDataSnapshot publish(const DataStore & doubleDatastore,
+                                const DataStoreString & stringDataStore,
+                                const ProgDataMap & progData);
+
+    private:
+        struct Storage {
+            std::mutex m;
+            std::vector<std::unique_ptr<AllData>> available;
+        };
+        std::shared_ptr<Storage> storage;
+    };
+
+
+    /** @brief What enqueue does when a communicator's write queue is full */
+    enum class QueuePolicy {
+        Block,       ///< Wait for the communicator to write an item. Enqueue runs on the
+                     ///< CommManager thread, so this stalls polling and reads for every
+                     ///< prognoser until the slowest communicator catches up.
+        DropOldest,  ///< Discard the oldest queued item
+        Coalesce     ///< Keep only the latest item; queued items are discarded on every enqueue
+    };
+
+    /** @brief Write queue statistics, for monitoring */
+    struct QueueStats {
+        std::size_t depth;       ///< Items waiting to be written
+        std::size_t capacity;    ///< Maximum items waiting to be written
+        unsigned long long written;  ///< Items written
+        unsigned long long dropped;  ///< Items discarded by the queue policy
+        std::chrono::microseconds meanLatency;  ///< Mean time from enqueue until written
+        std::chrono::microseconds maxLatency;   ///< Maximum time from enqueue until written
+    };
 
-    class CommonCommunicator : private Thread {
+    class CommonCommunicator : private Task {
     public:
         using Callback = std::function<void(DataStore&)>;
 
+        /// Write queue capacity when none is configured
+        static const std::size_t DEFAULT_QUEUE_CAPACITY = 256;
+
         /** @brief      Constructor for CommonCommunicator- Initializes Log
          *  @see        CommunicatorFactory
          **/
         CommonCommunicator();
 
+        /** @brief      Constructor for CommonCommunicator that configures the write queue
+         *  @param      config  Configuration map for the communicator. The following
+         *              optional parameters are used:
+         *                  queueCapacity   Maximum items waiting to be written (default 256)
+         *                  queuePolicy     What happens when the queue is full: dropOldest,
+         *                                  coalesce or block (default dropOldest, unless
+         *                                  the communicator chooses another). block
+         *                                  stalls the CommManager loop while this
+         *                                  communicator is behind, so only use it when
+         *                                  every item must be written. Dropped items are
+         *                                  counted in getQueueStats and logged.
+         *  @see        CommunicatorFactory
+         **/
+        explicit CommonCommunicator(const ConfigMap & config);
+
         virtual ~CommonCommunicator() override;
 
-        void enqueue(const AllData &);
+        /** @brief      Queue a snapshot to be written. The snapshot is shared, not copied.
+         **/
+        void enqueue(AllDataSnapshot data);
+
+        /** @brief      Queue a copy of data to be written
+         **/
+        void enqueue(const AllData & data);
 
-        using Thread::join;
+        using Task::join;
 
         virtual void poll() = 0;
 
@@ -74,29 +148,72 @@ namespace PCOE {
 
         void subscribe(const Callback& fn);
 
+        /** @brief      Get write queue statistics
+         **/
+        QueueStats getQueueStats() const;
+
     protected:
+        /** @brief      Constructor for communicators that need a different queue policy
+         *              when none is configured, such as those that must not lose items
+         *  @param      config          Configuration map for the communicator
+         *  @param      defaultPolicy   Queue policy when queuePolicy is not configured
+         **/
+        CommonCommunicator(const ConfigMap & config, QueuePolicy defaultPolicy);
 
         void setRead();
 
+        /** @brief      Stop reading and writing, and wait for the current read or
+         *              write to finish. Communicators whose read or write use
+         *              their own members call this in their destructor.
+         **/
+        void finish();
+
         virtual DataStore read() = 0;
 
-        virtual void write(AllData) = 0;
+        /** @brief      Read new data into a DataStore that is reused between
+         *              reads. The default replaces its contents with read().
+         *              Override to update the values in place without allocating.
+         *  @param      data  DataStore to fill. Holds the previous read, unless a
+         *              subscriber changed it.
+         **/
+        virtual void readInto(DataStore & data);
+
+        virtual void write(const AllData &) = 0;
 
-        using Thread::log;
+        using Task::log;
     private:
         using mutex = std::mutex;
         using lock_guard = std::lock_guard<mutex>;
         using unique_lock = std::unique_lock<mutex>;
+        using clock = std::chrono::steady_clock;
+
+        struct WriteItem {
+            AllDataSnapshot data;
+            clock::time_point enqueued;
+        };
+
+        CommonCommunicator(QueuePolicy policy, std::size_t capacity);
 
         void run() final override;
 
+        /// Wake enqueue calls waiting for space
+        void notifySpace();
+
+        /// Count an item discarded because the queue was full, and log the loss
+        void reportDropped();
+
         std::vector<Callback> subscribers;
-        std::queue<AllData> writeItems;
-        bool readWaiting;
+        DataStore readData;  ///< Reused for each read
+        BoundedQueue<WriteItem> writeItems;
+        const QueuePolicy policy;
+        std::atomic<bool> readWaiting;
+        std::atomic<unsigned int> blockedWriters;  ///< enqueue calls waiting for space
+        std::condition_variable space;
+        std::atomic<unsigned long long> written;
+        std::atomic<unsigned long long> dropped;
+        std::atomic<unsigned long long> totalLatency;  ///< Nanoseconds
+        std::atomic<unsigned long long> maxLatency;    ///< Nanoseconds
         mutex m;
-        std::condition_variable cv;
-        mutex sm;
-        std::condition_variable scv;
     };
 }
 
@@ -33,17 +33,19 @@
 
 #include <string>
 #include <map>
+#include <memory>
 #include <vector>
 
-#include "Thread.h"  // For Start, Stop, pause, ... etc.
+#include "Task.h"  // For Start, Stop, pause, ... etc.
 #include "ProgData.h"
 #include "DataStore.h"
 
 namespace PCOE {
+    class CheckpointFile;
     class CommManager;
     class GSAPConfigMap;
 
-    class CommonPrognoser : public Thread {
+    class CommonPrognoser : public Task {
     public:
         /** @brief      Common Prognoser Constructor
          *  @param      config Map of configuration parameters in the prognoser configuration
@@ -58,16 +60,27 @@ namespace PCOE {
          */
         CommonPrognoser(GSAPConfigMap & config);
 
-        /**  @brief       Main Prognostics Thread
+        /** @brief      Common Prognoser Destructor
          *
-         *   Directs the main prognostics loop- runs until monitor->stop()
+         *  Removes the data subscription, then stops the prognoser and waits
+         *  for its last cycle to finish.
+         */
+        virtual ~CommonPrognoser() override;
+
+        /**  @brief       Main Prognostics Cycle
+         *
+         *   Runs one cycle of the prognostics loop on the shared executor. If
+         *   the prognoser has trigger tags, a cycle runs each time new data
+         *   arrives for one of them. Otherwise cycles run every loopInterval ms.
          */
         void run() override;
 
-        /// Save the current state to the prognostic history file
+        /// Append the current state to the prognostic history file. The state
+        /// is written asynchronously.
         void saveState() const;
 
-        /// Load the last state from the prognostic history file
+        /// Load the last state from the prognostic history file. Reads only the
+        /// latest state, so takes the same time however long the history is.
         void loadHistory();
 
         /// Reset the prognostic history file (incase of maintanance, etc.)
@@ -133,13 +146,32 @@ namespace PCOE {
 
         CommManager& comm;  ///> Communciations Manager
 
+        /**  @brief     Set the tags whose new data wakes the prognostics loop
+         *   @param     tags Tag names. If empty, the loop runs every loopInterval ms.
+         *
+         *   By default these are the tags in the inTags configuration parameter.
+         */
+        void setTriggerTags(const std::vector<std::string> & tags);
+
     private:
+        /// Save the final state once the prognoser is stopped
+        void cleanup() override;
+
+        /// Load the last state from a text history file written by earlier versions
+        bool loadTextHistory(ProgData & lastState);
+
         std::string histFileName;  ///< Name of history file
-        std::vector<std::string> histStr;  ///< Current contents of history file
+        std::string textHistFileName;  ///< Name of text history file written by earlier versions
+        std::unique_ptr<CheckpointFile> checkpoint;  ///< History file
 
         unsigned int loopInterval;  ///< Time between prognostic loops (ms)
         unsigned int saveInterval;  ///< Loops between saves
         bool usingPlaybackData;  ///< Using Playback data
+
+        unsigned long loopCounter;  ///< Number of cycles run
+        bool historyLoaded;  ///< Whether the history file has been loaded
+        bool subscribed;  ///< Whether there are trigger tags
+        unsigned long subscription;  ///< Id of the CommManager subscription to the trigger tags
     };
 }
 
@@ -29,6 +29,7 @@
 #include "PrognosticsModel.h"
 #include "Observer.h"
 #include "Predictor.h"
+#include "TagTable.h"
 
 namespace PCOE {
     class ModelBasedPrognoser : public CommonPrognoser
@@ -39,6 +40,8 @@ namespace PCOE {
         std::unique_ptr<Predictor> predictor;
         std::vector<std::string> inputs;
         std::vector<std::string> outputs;
+        std::vector<TagTable::Handle> inputHandles;   ///< CommManager handles of inputs
+        std::vector<TagTable::Handle> outputHandles;  ///< CommManager handles of outputs
         bool initialized;
         double firstTime;
         double lastTime;
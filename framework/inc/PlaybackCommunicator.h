@@ -5,8 +5,15 @@
  *
  *   @brief     Playback Communicator class- playback input data from a csv file
  *
+ *              The file is memory mapped and each row is parsed in place. The
+ *              columns are matched to their tags once, when the header is read,
+ *              so reading a row does not allocate. Binary recordings written by
+ *              the RecorderCommunicator are recognized and played back directly.
+ *
  *   @note      This class will look for the following optional configuration parameters:
  *                  file        Name of the file that will be played back (default RecordedMessages.csv)
+ *                  delim       Column delimiter, or \t for tab (default ,)
+ *                  timestampFromFile   Whether data is timestamped from the first column (default true)
  *
  *   @see        CommonCommunicator
  *
@@ -24,12 +31,16 @@
 #ifndef PCOE_PLAYBACKCOMMUNICATOR_H
 #define PCOE_PLAYBACKCOMMUNICATOR_H
 
-#include <fstream>
+#include <chrono>
+#include <cstdint>
+#include <memory>
 #include <string>
 #include <vector>
 
 #include "CommonCommunicator.h"  ///< Parent Class
 #include "CommunicatorFactory.h"
+#include "MappedFile.h"
+#include "RecordingFile.h"
 
 namespace PCOE {
     class PlaybackCommunicator : public CommonCommunicator {
@@ -43,20 +54,43 @@ namespace PCOE {
         inline void poll() override { setRead(); }
 
         /** @brief      subscriber callback funciton- used to introduce data into the prognostic framework
-         *  @param      data  Reference to DataStore containing all the data
-         *  @return     Updated Datastore with new data
+         *  @return     Datastore with the next row of data. Empty at the end of the file.
          **/
         DataStore read() override;
 
-        void write(AllData) override;
+        /** @brief      Read the next row of data, updating data in place
+         *  @param      data  DataStore to fill. Emptied at the end of the file.
+         **/
+        void readInto(DataStore & data) override;
+
+        void write(const AllData &) override;
 
         ~PlaybackCommunicator();
 
     private:
-        std::ifstream playbackStream;       ///< The stream to be used as a header
+        /// Read the names of the parameters from a text header
+        void readHeader();
+
+        /// Parse the next row into row. Returns false at the end of the file.
+        bool parseRow();
+
+        /// Read the next row of a binary recording into row
+        bool readRecordingRow();
+
+        MappedFile playbackFile;            ///< The file being played back
+        const char * position;              ///< Start of the next row
+        const char * end;                   ///< End of the file
         std::vector<std::string> header;    ///< The input parameters to be played back (from the header)
+        DataStore row;                      ///< Last row read, with a key for each parameter
+        std::vector<Datum<double> *> columns;  ///< Element of row for each parameter
         char delim;                         ///< Delimiter
         bool timestampFromFile;
+        bool started;                       ///< Whether startTime is set
+        std::chrono::time_point<std::chrono::system_clock> startTime;  ///< Time of the first row
+        std::unique_ptr<RecordingReader> recording;  ///< Binary recording, if the file is one
+        std::vector<std::size_t> recordingColumns;   ///< Recording column for each parameter
+        std::size_t recordingRow;                    ///< Next row in the current chunk
+        std::int64_t firstRowTime;                   ///< Recorded time of the first row (ms)
     };
 }
 
@@ -45,7 +45,7 @@ namespace PCOE {
          **/
         DataStore read() override;
 
-        void write(AllData) override;
+        void write(const AllData &) override;
 
     private:
         unsigned long int maxRand;  ///< Maximum Random Number allowed
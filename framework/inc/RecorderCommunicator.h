@@ -30,8 +30,23 @@
  *                  epoch
  *              Prognostic Results are printed with a timestamp and validity in the format (v=%8, t=%7)
  *
+ *              With format set to binary, the same columns are instead written to a
+ *              columnar binary recording (@see RecordingFile.h). Sample vectors are
+ *              written as contiguous blocks, and chunks of rows are written at once.
+ *              convertToCsv converts a recording to the text format above, and the
+ *              PlaybackCommunicator plays back either format.
+ *
+ *              In both formats the columns are fixed by the first snapshot written.
+ *              Later snapshots are written against those columns: data, events,
+ *              prediction times and trajectories that were not in the first snapshot
+ *              are skipped, and columns with nothing to write are left empty.
+ *
  *   @note      This class will look for the following optional configuration parameters:
  *                  saveFile    File to which the data will be saved (default "RecordedMessages.csv")
+ *                  format      csv or binary (default csv)
+ *                  chunkSize   Snapshots in each chunk of a binary recording (default 64)
+ *                  queueCapacity, queuePolicy  Write queue settings (@see CommonCommunicator).
+ *                              The policy defaults to block, so no snapshot is left out.
  *
  *   @see        CommonCommunicator
  *
@@ -50,9 +65,15 @@
 #ifndef PCOE_RECORDERCOMMUNICATOR_H
 #define PCOE_RECORDERCOMMUNICATOR_H
 
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
 #include "DataStore.h"
 #include "CommonCommunicator.h"
 #include "CommunicatorFactory.h"
+#include "RecordingFile.h"
 
 namespace PCOE {
     class RecorderCommunicator : public CommonCommunicator {
@@ -72,11 +93,46 @@ namespace PCOE {
          *  @param      data        Reference to DataStore containing all the input data
          *  @param      progData    Output from each prognoser
          **/
-        void write(AllData) override;
+        void write(const AllData &) override;
+
+        /** @brief      Convert a binary recording to the csv format
+         *  @param      recordingFile   Binary recording to read
+         *  @param      csvFile         File to write. Replaced if it exists.
+         *  @exception  std::runtime_error if either file cannot be opened
+         *  @exception  FormatError if recordingFile is not a recording
+         **/
+        static void convertToCsv(const std::string & recordingFile, const std::string & csvFile);
 
     private:
+        /// Columns written for one prognoser
+        struct ProgColumns {
+            std::string name;
+            std::size_t nTimes;                     ///< Prediction times written for each value
+            std::vector<std::string> events;
+            std::vector<bool> occurrence;           ///< Whether each event has occurrence columns
+            std::vector<std::string> trajectories;
+        };
+
+        /// Receives one cell of a row: kind, values, count, valid, time
+        using CellWriter = std::function<void(RecordingColumnKind, const double *, std::size_t, bool, long long)>;
+
+        /** @brief      Set the columns from a snapshot
+         *  @return     Columns written for data, in the order they are written
+         **/
+        std::vector<RecordingColumn> columnsFor(const AllData & data);
+
+        /// Write each column of a snapshot, in order
+        void writeCells(const AllData & data, const CellWriter & writeCell);
+
+        /// Write a snapshot to the binary recording
+        void writeRecording(const AllData & data);
+
         bool init;                      ///< Has the recorderCommunicator been initialized
         std::FILE* theFile;             ///< The file to be used for writing
+        std::unique_ptr<RecordingWriter> recording;  ///< Binary recording, if used
+        std::vector<std::string> dataKeys;   ///< Data written to the recording
+        std::vector<ProgColumns> progColumns;  ///< Prognosers written to the recording
+        std::vector<double> flags;           ///< Occurrence being written
 
         // Keys to control what is written
         bool writeOccur;
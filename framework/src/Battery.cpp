@@ -20,6 +20,7 @@
 #include "Battery.h"
 
 #include <cmath>
+#include <stdexcept>
 #include <vector>
 
 #include "ConfigMap.h"
@@ -55,162 +56,137 @@ Battery::Battery(const ConfigMap & configMap) : Battery::Battery() {
     }
 }
 
+namespace {
+    // Redlich-Kister expansion of the equilibrium potential of one electrode
+    struct RedlichKister {
+        double U0;
+        double A[13];
+    };
+
+    RedlichKister positiveElectrode(const Battery::Parameters & p) {
+        RedlichKister rk = { p.U0p, { p.Ap0, p.Ap1, p.Ap2, p.Ap3, p.Ap4, p.Ap5, p.Ap6,
+                                      p.Ap7, p.Ap8, p.Ap9, p.Ap10, p.Ap11, p.Ap12 } };
+        return rk;
+    }
+
+    RedlichKister negativeElectrode(const Battery::Parameters & p) {
+        RedlichKister rk = { p.U0n, { p.An0, p.An1, p.An2, p.An3, p.An4, p.An5, p.An6,
+                                      p.An7, p.An8, p.An9, p.An10, p.An11, p.An12 } };
+        return rk;
+    }
+
+    // Equilibrium potential of an electrode at surface mole fraction x. Term k of the expansion is
+    // A[k]*((2x-1)^(k+1) - 2k*x*(1-x)*(2x-1)^(k-1))/F. The powers are built up by multiplication
+    // rather than calls to pow, so that loops over samples can be vectorized.
+    inline double equilibriumPotential(const RedlichKister & rk, const Battery::Parameters & p,
+                                       const double Tb, const double x) {
+        const double y = 2 * x - 1;
+        const double xx = x * (-x + 1);
+        double sum = rk.A[0] * y;
+        double yLow = 1;        // (2x-1)^(k-1)
+        double yHigh = y * y;   // (2x-1)^(k+1)
+        for (unsigned int k = 1; k < 13; k++) {
+            sum += rk.A[k] * (yHigh - 2 * k * xx * yLow);
+            yLow *= y;
+            yHigh *= y;
+        }
+        return rk.U0 + sum / p.F + p.R*Tb*log((-x + 1) / x) / p.F;
+    }
+
+    // Battery voltage for the given states
+    inline double batteryVoltage(const Battery::Parameters & p, const RedlichKister & pos,
+                                 const RedlichKister & neg, const double (&x)[8]) {
+        double xnS = x[5] / p.qSMax;
+        double xpS = x[7] / p.qSMax;
+        double Ven = equilibriumPotential(neg, p, x[0], xnS);
+        double Vep = equilibriumPotential(pos, p, x[0], xpS);
+        return -Ven + Vep - x[1] - x[2] - x[3];
+    }
+
+    // Advance the states x by dt, given power P and process noise n
+    inline void batteryStateUpdate(const Battery::Parameters & p, const RedlichKister & pos,
+                                   const RedlichKister & neg, double (&x)[8], const double P,
+                                   const double (&n)[8], const double dt) {
+        // Extract states
+        double Tb = x[0];
+        double Vo = x[1];
+        double Vsn = x[2];
+        double Vsp = x[3];
+        double qnB = x[4];
+        double qnS = x[5];
+        double qpB = x[6];
+        double qpS = x[7];
+
+        // Constraints
+        double Tbdot = 0;
+        double CpBulk = qpB / p.VolB;
+        double CpSurface = qpS / p.VolS;
+        double CnBulk = qnB / p.VolB;
+        double CnSurface = qnS / p.VolS;
+        double xSn = qnS / p.qSMax;
+        double xSp = qpS / p.qBMax;
+        double qdotDiffusionBSn = (CnBulk - CnSurface) / p.tDiffusion;
+        double qdotDiffusionBSp = (CpBulk - CpSurface) / p.tDiffusion;
+        double Jn0 = p.kn*pow(xSn, p.alpha)*pow(-xSn + 1, p.alpha);
+        double Jp0 = p.kp*pow(xSp, p.alpha)*pow(-xSp + 1, p.alpha);
+        double V = batteryVoltage(p, pos, neg, x);
+        double i = P / V;
+        double qnSdot = -i + qdotDiffusionBSn;
+        double Jn = i / p.Sn;
+        double VoNominal = p.Ro*i;
+        double Jp = i / p.Sp;
+        double qnBdot = -qdotDiffusionBSn;
+        double qpBdot = -qdotDiffusionBSp;
+        double qpSdot = i + qdotDiffusionBSp;
+        double Vodot = (-Vo + VoNominal) / p.to;
+        double VsnNominal = p.R*Tb*asinh(0.5*Jn / Jn0) / (p.F*p.alpha);
+        double VspNominal = p.R*Tb*asinh(0.5*Jp / Jp0) / (p.F*p.alpha);
+        double Vsndot = (-Vsn + VsnNominal) / p.tsn;
+        double Vspdot = (-Vsp + VspNominal) / p.tsp;
+
+        // Update state and add process noise
+        x[0] = Tb + Tbdot*dt + dt*n[0];
+        x[1] = Vo + Vodot*dt + dt*n[1];
+        x[2] = Vsn + Vsndot*dt + dt*n[2];
+        x[3] = Vsp + Vspdot*dt + dt*n[3];
+        x[4] = qnB + qnBdot*dt + dt*n[4];
+        x[5] = qnS + qnSdot*dt + dt*n[5];
+        x[6] = qpB + qpBdot*dt + dt*n[6];
+        x[7] = qpS + qpSdot*dt + dt*n[7];
+    }
+}
+
 // Battery State Equation
-void Battery::stateEqn(const double, std::vector<double> & x, 
-                       const std::vector<double> & u, const std::vector<double> & n, 
+void Battery::stateEqn(const double, std::vector<double> & x,
+                       const std::vector<double> & u, const std::vector<double> & n,
                        const double dt) {
-
-    // Extract states
-    double Tb = x[0];
-    double Vo = x[1];
-    double Vsn = x[2];
-    double Vsp = x[3];
-    double qnB = x[4];
-    double qnS = x[5];
-    double qpB = x[6];
-    double qpS = x[7];
-
-    // Extract inputs
-    double P = u[0];
-
-    // Constraints
-    double Tbdot = 0;
-    double CpBulk = qpB / parameters.VolB;
-    double CpSurface = qpS / parameters.VolS;
-    double CnSurface = qnS / parameters.VolS;
-    double xSn = qnS / parameters.qSMax;
-    double xnS = qnS / parameters.qSMax;
-    double Ven11 = parameters.An11*(-22 * xnS*(-xnS + 1)*pow(2 * xnS - 1, 10) + pow(2 * xnS - 1, 12)) / parameters.F;
-    double Ven1 = parameters.An1*(-2 * xnS*(-xnS + 1) + pow(2 * xnS - 1, 2)) / parameters.F;
-    double CnBulk = qnB / parameters.VolB;
-    double Ven6 = parameters.An6*(-12 * xnS*(-xnS + 1)*pow(2 * xnS - 1, 5) + pow(2 * xnS - 1, 7)) / parameters.F;
-    double xpS = qpS / parameters.qSMax;
-    double xSp = qpS / parameters.qBMax;
-    double qdotDiffusionBSp = (CpBulk - CpSurface) / parameters.tDiffusion;
-    double Ven8 = parameters.An8*(-16 * xnS*(-xnS + 1)*pow(2 * xnS - 1, 7) + pow(2 * xnS - 1, 9)) / parameters.F;
-    double Ven7 = parameters.An7*(-14 * xnS*(-xnS + 1)*pow(2 * xnS - 1, 6) + pow(2 * xnS - 1, 8)) / parameters.F;
-    double Ven9 = parameters.An9*(-18 * xnS*(-xnS + 1)*pow(2 * xnS - 1, 8) + pow(2 * xnS - 1, 10)) / parameters.F;
-    double Ven4 = parameters.An4*(-8 * xnS*(-xnS + 1)*pow(2 * xnS - 1, 3) + pow(2 * xnS - 1, 5)) / parameters.F;
-    double Ven3 = parameters.An3*(-6 * xnS*(-xnS + 1)*pow(2 * xnS - 1, 2) + pow(2 * xnS - 1, 4)) / parameters.F;
-    double Ven2 = parameters.An2*(-4 * xnS*(-xnS + 1)*(2 * xnS - 1) + pow(2 * xnS - 1, 3)) / parameters.F;
-    double qdotDiffusionBSn = (CnBulk - CnSurface) / parameters.tDiffusion;
-    double Ven5 = parameters.An5*(-10 * xnS*(-xnS + 1)*pow(2 * xnS - 1, 4) + pow(2 * xnS - 1, 6)) / parameters.F;
-    double Vep4 = parameters.Ap4*(-8 * xpS*(-xpS + 1)*pow(2 * xpS - 1, 3) + pow(2 * xpS - 1, 5)) / parameters.F;
-    double Vep6 = parameters.Ap6*(-12 * xpS*(-xpS + 1)*pow(2 * xpS - 1, 5) + pow(2 * xpS - 1, 7)) / parameters.F;
-    double Vep0 = parameters.Ap0*(2 * xpS - 1) / parameters.F;
-    double Vep3 = parameters.Ap3*(-6 * xpS*(-xpS + 1)*pow(2 * xpS - 1, 2) + pow(2 * xpS - 1, 4)) / parameters.F;
-    double Vep10 = parameters.Ap10*(-20 * xpS*(-xpS + 1)*pow(2 * xpS - 1, 9) + pow(2 * xpS - 1, 11)) / parameters.F;
-    double Vep12 = parameters.Ap12*(-24 * xpS*(-xpS + 1)*pow(2 * xpS - 1, 11) + pow(2 * xpS - 1, 13)) / parameters.F;
-    double Jn0 = parameters.kn*pow(xSn, parameters.alpha)*pow(-xSn + 1, parameters.alpha);
-    double Vep7 = parameters.Ap7*(-14 * xpS*(-xpS + 1)*pow(2 * xpS - 1, 6) + pow(2 * xpS - 1, 8)) / parameters.F;
-    double Vep2 = parameters.Ap2*(-4 * xpS*(-xpS + 1)*(2 * xpS - 1) + pow(2 * xpS - 1, 3)) / parameters.F;
-    double Vep11 = parameters.Ap11*(-22 * xpS*(-xpS + 1)*pow(2 * xpS - 1, 10) + pow(2 * xpS - 1, 12)) / parameters.F;
-    double Ven0 = parameters.An0*(2 * xnS - 1) / parameters.F;
-    double Ven12 = parameters.An12*(-24 * xnS*(-xnS + 1)*pow(2 * xnS - 1, 11) + pow(2 * xnS - 1, 13)) / parameters.F;
-    double Ven10 = parameters.An10*(-20 * xnS*(-xnS + 1)*pow(2 * xnS - 1, 9) + pow(2 * xnS - 1, 11)) / parameters.F;
-    double Vep9 = parameters.Ap9*(-18 * xpS*(-xpS + 1)*pow(2 * xpS - 1, 8) + pow(2 * xpS - 1, 10)) / parameters.F;
-    double Vep5 = parameters.Ap5*(-10 * xpS*(-xpS + 1)*pow(2 * xpS - 1, 4) + pow(2 * xpS - 1, 6)) / parameters.F;
-    double Vep8 = parameters.Ap8*(-16 * xpS*(-xpS + 1)*pow(2 * xpS - 1, 7) + pow(2 * xpS - 1, 9)) / parameters.F;
-    double Vep1 = parameters.Ap1*(-2 * xpS*(-xpS + 1) + pow(2 * xpS - 1, 2)) / parameters.F;
-    double Jp0 = parameters.kp*pow(xSp, parameters.alpha)*pow(-xSp + 1, parameters.alpha);
-    double Ven = parameters.U0n + Ven0 + Ven1 + Ven10 + Ven11 + Ven12 + Ven2 + Ven3 + Ven4 + Ven5 + Ven6 + Ven7 + Ven8 + Ven9 + parameters.R*Tb*log((-xnS + 1) / xnS) / parameters.F;
-    double Vep = parameters.U0p + Vep0 + Vep1 + Vep10 + Vep11 + Vep12 + Vep2 + Vep3 + Vep4 + Vep5 + Vep6 + Vep7 + Vep8 + Vep9 + parameters.R*Tb*log((-xpS + 1) / xpS) / parameters.F;
-    double V = -Ven + Vep - Vo - Vsn - Vsp;
-    double i = P / V;
-    double qnSdot = -i + qdotDiffusionBSn;
-    double Jn = i / parameters.Sn;
-    double VoNominal = parameters.Ro*i;
-    double Jp = i / parameters.Sp;
-    double qnBdot = -qdotDiffusionBSn;
-    double qpBdot = -qdotDiffusionBSp;
-    double qpSdot = i + qdotDiffusionBSp;
-    double Vodot = (-Vo + VoNominal) / parameters.to;
-    double VsnNominal = static_cast<double>(parameters.R*Tb*asinh((1.0L / 2.0L)*Jn / Jn0) / (parameters.F*parameters.alpha));
-    double VspNominal = static_cast<double>(parameters.R*Tb*asinh((1.0L / 2.0L)*Jp / Jp0) / (parameters.F*parameters.alpha));
-    double Vsndot = (-Vsn + VsnNominal) / parameters.tsn;
-    double Vspdot = (-Vsp + VspNominal) / parameters.tsp;
-
-    // Update state
-    x[0] = Tb + Tbdot*dt;
-    x[1] = Vo + Vodot*dt;
-    x[2] = Vsn + Vsndot*dt;
-    x[3] = Vsp + Vspdot*dt;
-    x[4] = qnB + qnBdot*dt;
-    x[5] = qnS + qnSdot*dt;
-    x[6] = qpB + qpBdot*dt;
-    x[7] = qpS + qpSdot*dt;
-
-    // Add process noise
-    x[0] += dt*n[0];
-    x[1] += dt*n[1];
-    x[2] += dt*n[2];
-    x[3] += dt*n[3];
-    x[4] += dt*n[4];
-    x[5] += dt*n[5];
-    x[6] += dt*n[6];
-    x[7] += dt*n[7];
+    double xs[8];
+    double ns[8];
+    for (unsigned int i = 0; i < 8; i++) {
+        xs[i] = x[i];
+        ns[i] = n[i];
+    }
+    batteryStateUpdate(parameters, positiveElectrode(parameters), negativeElectrode(parameters),
+                       xs, u[indices.inputs.P], ns, dt);
+    for (unsigned int i = 0; i < 8; i++) {
+        x[i] = xs[i];
+    }
 }
 
 // Battery Output Equation
 void Battery::outputEqn(const double, const std::vector<double> & x,
                         const std::vector<double> &, const std::vector<double> & n,
                         std::vector<double> & z) {
+    double xs[8];
+    for (unsigned int i = 0; i < 8; i++) {
+        xs[i] = x[i];
+    }
+    double Tbm = xs[indices.states.Tb] - 273.15;
+    double Vm = batteryVoltage(parameters, positiveElectrode(parameters), negativeElectrode(parameters), xs);
 
-    // Extract states
-    double Tb = x[0];
-    double Vo = x[1];
-    double Vsn = x[2];
-    double Vsp = x[3];
-    //double qnB = x[4];
-    double qnS = x[5];
-    //double qpB = x[6];
-    double qpS = x[7];
-
-    // Extract inputs
-    //double P = u[0];
-
-    // Constraints
-    double xnS = qnS / parameters.qSMax;
-    double Tbm = Tb - 273.15;
-    double Ven11 = parameters.An11*(-22 * xnS*(-xnS + 1)*pow(2 * xnS - 1, 10) + pow(2 * xnS - 1, 12)) / parameters.F;
-    double xpS = qpS / parameters.qSMax;
-    double Vep6 = parameters.Ap6*(-12 * xpS*(-xpS + 1)*pow(2 * xpS - 1, 5) + pow(2 * xpS - 1, 7)) / parameters.F;
-    double Ven5 = parameters.An5*(-10 * xnS*(-xnS + 1)*pow(2 * xnS - 1, 4) + pow(2 * xnS - 1, 6)) / parameters.F;
-    double Ven7 = parameters.An7*(-14 * xnS*(-xnS + 1)*pow(2 * xnS - 1, 6) + pow(2 * xnS - 1, 8)) / parameters.F;
-    double Vep4 = parameters.Ap4*(-8 * xpS*(-xpS + 1)*pow(2 * xpS - 1, 3) + pow(2 * xpS - 1, 5)) / parameters.F;
-    double Ven9 = parameters.An9*(-18 * xnS*(-xnS + 1)*pow(2 * xnS - 1, 8) + pow(2 * xnS - 1, 10)) / parameters.F;
-    double Ven3 = parameters.An3*(-6 * xnS*(-xnS + 1)*pow(2 * xnS - 1, 2) + pow(2 * xnS - 1, 4)) / parameters.F;
-    double Vep7 = parameters.Ap7*(-14 * xpS*(-xpS + 1)*pow(2 * xpS - 1, 6) + pow(2 * xpS - 1, 8)) / parameters.F;
-    double Vep11 = parameters.Ap11*(-22 * xpS*(-xpS + 1)*pow(2 * xpS - 1, 10) + pow(2 * xpS - 1, 12)) / parameters.F;
-    double Ven12 = parameters.An12*(-24 * xnS*(-xnS + 1)*pow(2 * xnS - 1, 11) + pow(2 * xnS - 1, 13)) / parameters.F;
-    double Vep9 = parameters.Ap9*(-18 * xpS*(-xpS + 1)*pow(2 * xpS - 1, 8) + pow(2 * xpS - 1, 10)) / parameters.F;
-    double Vep5 = parameters.Ap5*(-10 * xpS*(-xpS + 1)*pow(2 * xpS - 1, 4) + pow(2 * xpS - 1, 6)) / parameters.F;
-    double Ven1 = parameters.An1*(-2 * xnS*(-xnS + 1) + pow(2 * xnS - 1, 2)) / parameters.F;
-    double Vep8 = parameters.Ap8*(-16 * xpS*(-xpS + 1)*pow(2 * xpS - 1, 7) + pow(2 * xpS - 1, 9)) / parameters.F;
-    double Ven6 = parameters.An6*(-12 * xnS*(-xnS + 1)*pow(2 * xnS - 1, 5) + pow(2 * xnS - 1, 7)) / parameters.F;
-    double Ven8 = parameters.An8*(-16 * xnS*(-xnS + 1)*pow(2 * xnS - 1, 7) + pow(2 * xnS - 1, 9)) / parameters.F;
-    double Vep3 = parameters.Ap3*(-6 * xpS*(-xpS + 1)*pow(2 * xpS - 1, 2) + pow(2 * xpS - 1, 4)) / parameters.F;
-    double Vep10 = parameters.Ap10*(-20 * xpS*(-xpS + 1)*pow(2 * xpS - 1, 9) + pow(2 * xpS - 1, 11)) / parameters.F;
-    double Vep12 = parameters.Ap12*(-24 * xpS*(-xpS + 1)*pow(2 * xpS - 1, 11) + pow(2 * xpS - 1, 13)) / parameters.F;
-    double Ven4 = parameters.An4*(-8 * xnS*(-xnS + 1)*pow(2 * xnS - 1, 3) + pow(2 * xnS - 1, 5)) / parameters.F;
-    double Ven2 = parameters.An2*(-4 * xnS*(-xnS + 1)*(2 * xnS - 1) + pow(2 * xnS - 1, 3)) / parameters.F;
-    double Vep2 = parameters.Ap2*(-4 * xpS*(-xpS + 1)*(2 * xpS - 1) + pow(2 * xpS - 1, 3)) / parameters.F;
-    double Ven0 = parameters.An0*(2 * xnS - 1) / parameters.F;
-    double Ven10 = parameters.An10*(-20 * xnS*(-xnS + 1)*pow(2 * xnS - 1, 9) + pow(2 * xnS - 1, 11)) / parameters.F;
-    double Vep1 = parameters.Ap1*(-2 * xpS*(-xpS + 1) + pow(2 * xpS - 1, 2)) / parameters.F;
-    double Vep0 = parameters.Ap0*(2 * xpS - 1) / parameters.F;
-    double Ven = parameters.U0n + Ven0 + Ven1 + Ven10 + Ven11 + Ven12 + Ven2 + Ven3 + Ven4 + Ven5 + Ven6 + Ven7 + Ven8 + Ven9 + parameters.R*Tb*log((-xnS + 1) / xnS) / parameters.F;
-    double Vep = parameters.U0p + Vep0 + Vep1 + Vep10 + Vep11 + Vep12 + Vep2 + Vep3 + Vep4 + Vep5 + Vep6 + Vep7 + Vep8 + Vep9 + parameters.R*Tb*log((-xpS + 1) / xpS) / parameters.F;
-    double V = -Ven + Vep - Vo - Vsn - Vsp;
-    double Vm = V;
-
-    // Set outputs
-    z[0] = Tbm;
-    z[1] = Vm;
-
-    // Add noise
-    z[0] += n[0];
-    z[1] += n[1];
+    // Set outputs and add noise
+    z[indices.outputs.Tbm] = Tbm + n[0];
+    z[indices.outputs.Vm] = Vm + n[1];
 }
 
 // Battery Threshold Equation
@@ -263,6 +239,91 @@ void Battery::predictedOutputEqn(const double, const std::vector<double> & x, co
     z[0] = SOC;
 }
 
+// The batched equations load each sample's states into locals and run the same kernels as the
+// scalar equations, so one call processes a whole block without virtual calls per sample.
+
+// Battery State Equation (batched)
+void Battery::stateEqnBatch(const double, PCOE::Matrix & X, const PCOE::Matrix & U,
+                            const PCOE::Matrix & N, const double dt) {
+    const RedlichKister pos = positiveElectrode(parameters);
+    const RedlichKister neg = negativeElectrode(parameters);
+    double * xRows[8];
+    const double * nRows[8];
+    for (unsigned int i = 0; i < 8; i++) {
+        xRows[i] = X.rowData(i);
+        nRows[i] = N.rowData(i);
+    }
+    const double * P = U.rowData(indices.inputs.P);
+
+    for (std::size_t sample = 0; sample < X.cols(); sample++) {
+        double x[8];
+        double n[8];
+        for (unsigned int i = 0; i < 8; i++) {
+            x[i] = xRows[i][sample];
+            n[i] = nRows[i][sample];
+        }
+        batteryStateUpdate(parameters, pos, neg, x, P[sample], n, dt);
+        for (unsigned int i = 0; i < 8; i++) {
+            xRows[i][sample] = x[i];
+        }
+    }
+}
+
+// Battery Output Equation (batched)
+void Battery::outputEqnBatch(const double, const PCOE::Matrix & X, const PCOE::Matrix &,
+                             const PCOE::Matrix & N, PCOE::Matrix & Z) {
+    const RedlichKister pos = positiveElectrode(parameters);
+    const RedlichKister neg = negativeElectrode(parameters);
+    const double * xRows[8];
+    for (unsigned int i = 0; i < 8; i++) {
+        xRows[i] = X.rowData(i);
+    }
+    const double * nTbm = N.rowData(indices.outputs.Tbm);
+    const double * nVm = N.rowData(indices.outputs.Vm);
+    double * Tbm = Z.rowData(indices.outputs.Tbm);
+    double * Vm = Z.rowData(indices.outputs.Vm);
+
+    for (std::size_t sample = 0; sample < X.cols(); sample++) {
+        double x[8];
+        for (unsigned int i = 0; i < 8; i++) {
+            x[i] = xRows[i][sample];
+        }
+        Tbm[sample] = x[indices.states.Tb] - 273.15 + nTbm[sample];
+        Vm[sample] = batteryVoltage(parameters, pos, neg, x) + nVm[sample];
+    }
+}
+
+// Battery Threshold Equation (batched)
+void Battery::thresholdEqnBatch(const double, const PCOE::Matrix & X, const PCOE::Matrix &,
+                                std::vector<bool> & occurred) {
+    const RedlichKister pos = positiveElectrode(parameters);
+    const RedlichKister neg = negativeElectrode(parameters);
+    const double * xRows[8];
+    for (unsigned int i = 0; i < 8; i++) {
+        xRows[i] = X.rowData(i);
+    }
+
+    occurred.resize(X.cols());
+    for (std::size_t sample = 0; sample < X.cols(); sample++) {
+        double x[8];
+        for (unsigned int i = 0; i < 8; i++) {
+            x[i] = xRows[i][sample];
+        }
+        occurred[sample] = batteryVoltage(parameters, pos, neg, x) <= parameters.VEOD;
+    }
+}
+
+// Battery Predicted Outputs Equation (batched)
+void Battery::predictedOutputEqnBatch(const double, const PCOE::Matrix & X, const PCOE::Matrix &,
+                                      PCOE::Matrix & Z) {
+    const double * qnS = X.rowData(indices.states.qnS);
+    const double * qnB = X.rowData(indices.states.qnB);
+    double * SOC = Z.rowData(0);
+    for (std::size_t sample = 0; sample < X.cols(); sample++) {
+        SOC[sample] = (qnS[sample] + qnB[sample]) / parameters.qnMax;
+    }
+}
+
 // Set model parameters, given qMobile
 void Battery::setParameters(const double qMobile) {
     // Set qMobile
@@ -27,6 +27,7 @@
 
 #include "CommManager.h"
 #include "CommunicatorFactory.h"
+#include "Executor.h"
 #include "ThreadSafeLog.h"
 
 namespace PCOE {
@@ -38,7 +39,9 @@ namespace PCOE {
     const std::string COMM_KEY = "Communicators";
 
     CommManager::CommManager() : Thread(), threadStarted(false),
-        stepSize(DEFAULT_STEP_SIZE) {
+        stepSize(DEFAULT_STEP_SIZE), nextSubscription(0) {
+        // Communicators run on the executor, so it must be destroyed after them
+        Executor::instance();
         moduleName = "CommManager";
         log.WriteLine(LOG_INFO, moduleName, "Enabling");
     }
@@ -74,15 +77,16 @@ namespace PCOE {
                 break;
             }
 
+            // Publish one snapshot, shared by every communicator
+            AllDataSnapshot data;
             {
                 std::lock(lookupMutex, progDataMutex);
                 lock_guard lookuplock(lookupMutex, std::adopt_lock);
                 lock_guard proglock(progDataMutex, std::adopt_lock);
-                
-                AllData data(lookup, stringLookup, progData);
-                for (auto & it : comms) {
-                    it->enqueue(data);
-                }
+                data = snapshots.publish(lookup, stringLookup, progData);
+            }
+            for (auto & it : comms) {
+                it->enqueue(data);
             }
 
             // Second check so it will stop quicker (publisher may take some time)
@@ -93,9 +97,8 @@ namespace PCOE {
         }
     }
 
-    void CommManager::registerKey(const std::string & tagName) {
+    TagTable::Handle CommManager::registerKey(const std::string & tagName) {
         lock_guard lock(lookupMutex);
-        std::stringstream a;
 
         if (lookup.find(tagName) == lookup.end()) {
             // TagName doesn't exist
@@ -108,6 +111,17 @@ namespace PCOE {
             log.FormatLine(LOG_DEBUG, moduleName,
                 "Tag already registered, skipping: %s", tagName.c_str());
         }
+        return handleOf(tagName);
+    }
+
+    TagTable::Handle CommManager::handleOf(const std::string & tagName) {
+        auto it = handles.find(tagName);
+        if (it != handles.end()) {
+            return it->second;
+        }
+        TagTable::Handle handle = values.add();
+        handles.emplace(tagName, handle);
+        return handle;
     }
 
     bool CommManager::registerProgData(const std::string & componentName, ProgData * pDataIn) {
@@ -126,9 +140,23 @@ namespace PCOE {
         return true;
     }
 
+    unsigned long CommManager::subscribe(const std::vector<std::string> & keys, const Listener & fn) {
+        std::lock_guard<std::mutex> lock(subscriptionMutex);
+        unsigned long id = nextSubscription++;
+        subscriptions[id] = Subscription{ keys, fn };
+        log.FormatLine(LOG_DEBUG, moduleName, "Added subscription %lu to %u keys", id,
+            static_cast<unsigned int>(keys.size()));
+        return id;
+    }
+
+    void CommManager::unsubscribe(unsigned long id) {
+        std::lock_guard<std::mutex> lock(subscriptionMutex);
+        subscriptions.erase(id);
+    }
+
     Datum<double> CommManager::getValue(const std::string & tagName) const {
         lock_guard lock(lookupMutex);
-        log.FormatLine(LOG_DEBUG, moduleName, "Requesting value for %s", tagName.c_str());
+        PCOE_LOG_FORMAT(log, LOG_DEBUG, moduleName.c_str(), "Requesting value for %s", tagName.c_str());
         auto it = lookup.find(tagName);
         if (it != lookup.end()) {
             // tagName Exists
@@ -139,9 +167,13 @@ namespace PCOE {
         throw std::out_of_range("Requested tag does not exist");
     }
     
+    Datum<double> CommManager::getValue(TagTable::Handle handle) const {
+        return values.get(handle);
+    }
+
     Datum<std::string> CommManager::getString(const std::string & tagName) const {
         lock_guard lock(lookupMutex);
-        log.FormatLine(LOG_DEBUG, moduleName, "Requesting value for %s", tagName.c_str());
+        PCOE_LOG_FORMAT(log, LOG_DEBUG, moduleName.c_str(), "Requesting value for %s", tagName.c_str());
         auto it = stringLookup.find(tagName);
         if (it != stringLookup.end()) {
             // tagName Exists
@@ -153,9 +185,23 @@ namespace PCOE {
     }
 
     void CommManager::updateLookup(DataStore& ds) {
-        lock_guard lock(lookupMutex);
-        for (auto it : ds) {
-            lookup[it.first] = it.second;
+        {
+            lock_guard lock(lookupMutex);
+            for (auto & it : ds) {
+                lookup[it.first] = it.second;
+                values.set(handleOf(it.first), it.second);
+            }
+        }
+
+        // Notify each subscriber watching at least one of the updated keys once
+        std::lock_guard<std::mutex> lock(subscriptionMutex);
+        for (auto & it : subscriptions) {
+            for (auto & key : it.second.keys) {
+                if (ds.find(key) != ds.end()) {
+                    it.second.fn();
+                    break;
+                }
+            }
         }
     }
 }
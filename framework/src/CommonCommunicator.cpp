@@ -9,38 +9,166 @@
  *    All Rights Reserved.
  */
 
+#include <stdexcept>
+#include <thread>
+
 #include "CommonCommunicator.h"
 
 namespace PCOE {
-    CommonCommunicator::CommonCommunicator() : subscribers(), writeItems(),
-        readWaiting(false), m(), cv(), sm() {
-        // Implemenation Note: The use of sm/scv here is needed to prevent
-        // read/write operations being requested before the processing thread
-        // is started. Otherwise, the processing thread may block when it has
-        // items to process.
-        unique_lock slock(sm);
+    const std::string MODULE_NAME = "CommonComm";
+
+    // Configuration Keys
+    const std::string QUEUE_CAPACITY_KEY = "queueCapacity";
+    const std::string QUEUE_POLICY_KEY = "queuePolicy";
+
+    const std::size_t CommonCommunicator::DEFAULT_QUEUE_CAPACITY;
+
+    static QueuePolicy policyFromConfig(const ConfigMap & config, QueuePolicy defaultPolicy) {
+        if (!config.includes(QUEUE_POLICY_KEY)) {
+            return defaultPolicy;
+        }
+        const std::string & name = config.at(QUEUE_POLICY_KEY)[0];
+        if (name == "block") {
+            return QueuePolicy::Block;
+        }
+        if (name == "dropOldest") {
+            return QueuePolicy::DropOldest;
+        }
+        if (name == "coalesce") {
+            return QueuePolicy::Coalesce;
+        }
+        Log::Instance().FormatLine(LOG_ERROR, MODULE_NAME, "Unknown queue policy %s", name.c_str());
+        throw std::range_error("Unknown queue policy");
+    }
+
+    static std::size_t capacityFromConfig(const ConfigMap & config) {
+        if (!config.includes(QUEUE_CAPACITY_KEY)) {
+            return CommonCommunicator::DEFAULT_QUEUE_CAPACITY;
+        }
+        unsigned long capacity = std::stoul(config.at(QUEUE_CAPACITY_KEY)[0]);
+        if (capacity == 0) {
+            Log::Instance().WriteLine(LOG_ERROR, MODULE_NAME, "Queue capacity must be positive");
+            throw std::range_error("Queue capacity must be positive");
+        }
+        return capacity;
+    }
+
+    AllDataPool::AllDataPool() : storage(std::make_shared<Storage>()) { }
+
+    AllDataSnapshot AllDataPool::publish(const DataStore & doubleDatastore,
+                                         const DataStoreString & stringDataStore,
+                                         const ProgDataMap & progData) {
+        std::unique_ptr<AllData> data;
+        {
+            std::lock_guard<std::mutex> lock(storage->m);
+            if (!storage->available.empty()) {
+                data = std::move(storage->available.back());
+                storage->available.pop_back();
+            }
+        }
+        if (data) {
+            // Assignment reuses the nodes of the previous contents
+            data->doubleDatastore = doubleDatastore;
+            data->stringDataStore = stringDataStore;
+            data->progData = progData;
+        }
+        else {
+            data.reset(new AllData(doubleDatastore, stringDataStore, progData));
+        }
+
+        std::weak_ptr<Storage> pool = storage;
+        return AllDataSnapshot(data.release(), [pool](const AllData * released) {
+            std::unique_ptr<AllData> owned(const_cast<AllData *>(released));
+            if (auto poolStorage = pool.lock()) {
+                std::lock_guard<std::mutex> lock(poolStorage->m);
+                poolStorage->available.push_back(std::move(owned));
+            }
+        });
+    }
+
+    CommonCommunicator::CommonCommunicator()
+        : CommonCommunicator(QueuePolicy::DropOldest, DEFAULT_QUEUE_CAPACITY) { }
+
+    CommonCommunicator::CommonCommunicator(const ConfigMap & config)
+        : CommonCommunicator(config, QueuePolicy::DropOldest) { }
+
+    CommonCommunicator::CommonCommunicator(const ConfigMap & config, QueuePolicy defaultPolicy)
+        : CommonCommunicator(policyFromConfig(config, defaultPolicy), capacityFromConfig(config)) { }
+
+    CommonCommunicator::CommonCommunicator(QueuePolicy queuePolicy, std::size_t capacity)
+        : subscribers(), writeItems(capacity), policy(queuePolicy), readWaiting(false),
+          blockedWriters(0), space(), written(0), dropped(0), totalLatency(0),
+          maxLatency(0), m() {
+        // Reads and writes run as cycles on the shared executor
         start();
-        scv.wait(slock);
     }
 
     CommonCommunicator::~CommonCommunicator() {
-        unique_lock lock(m);
-        setState(ThreadState::Stopped);
-        cv.notify_one();
-        lock.unlock();
-        join();
+        finish();
+    }
+
+    void CommonCommunicator::finish() {
+        ThreadState current = getState();
+        if (current == ThreadState::Started || current == ThreadState::Paused) {
+            stop();
+        }
+        if (current != ThreadState::Ended) {
+            join();
+        }
+    }
+
+    void CommonCommunicator::enqueue(AllDataSnapshot data) {
+        WriteItem item{ std::move(data), clock::now() };
+        WriteItem discarded;
+        switch (policy) {
+        case QueuePolicy::Coalesce:
+            // Discarding queued items is the purpose of this policy, so they are not reported
+            while (writeItems.tryPop(discarded)) {
+                ++dropped;
+            }
+            // The writer may have taken an item meanwhile, so push as DropOldest
+            // fall through
+        case QueuePolicy::DropOldest:
+            while (!writeItems.tryPush(std::move(item))) {
+                if (writeItems.tryPop(discarded)) {
+                    reportDropped();
+                }
+            }
+            break;
+        case QueuePolicy::Block:
+        default:
+            if (!writeItems.tryPush(std::move(item))) {
+                unique_lock lock(m);
+                ++blockedWriters;
+                // Pairs with the fence in notifySpace, so a pop is either
+                // seen here or sees this writer waiting
+                std::atomic_thread_fence(std::memory_order_seq_cst);
+                bool pushed = false;
+                space.wait(lock, [this, &item, &pushed]() {
+                    pushed = writeItems.tryPush(std::move(item));
+                    ThreadState current = getState();
+                    return pushed || current == ThreadState::Stopped || current == ThreadState::Ended;
+                });
+                --blockedWriters;
+                if (!pushed) {
+                    // Stopped before there was space
+                    lock.unlock();
+                    reportDropped();
+                    return;
+                }
+            }
+            break;
+        }
+        schedule();
     }
 
     void CommonCommunicator::enqueue(const AllData & data) {
-        lock_guard lock(m);
-        writeItems.push(data);
-        cv.notify_one();
+        enqueue(std::make_shared<const AllData>(data));
     }
 
     void CommonCommunicator::setRead() {
-        lock_guard lock(m);
         readWaiting = true;
-        cv.notify_one();
+        schedule();
     }
 
     void CommonCommunicator::subscribe(const Callback& fn) {
@@ -48,40 +176,85 @@ namespace PCOE {
         subscribers.push_back(fn);
     }
 
+    QueueStats CommonCommunicator::getQueueStats() const {
+        using std::chrono::microseconds;
+        using std::chrono::nanoseconds;
+        using std::chrono::duration_cast;
+        QueueStats stats;
+        stats.depth = writeItems.size();
+        stats.capacity = writeItems.capacity();
+        stats.written = written;
+        stats.dropped = dropped;
+        unsigned long long total = totalLatency;
+        unsigned long long mean = stats.written == 0 ? 0 : total / stats.written;
+        stats.meanLatency = duration_cast<microseconds>(nanoseconds(mean));
+        stats.maxLatency = duration_cast<microseconds>(nanoseconds(maxLatency.load()));
+        return stats;
+    }
+
     void CommonCommunicator::stop() {
+        Task::stop();
+        // Release enqueue calls waiting for space that will not come
         lock_guard lock(m);
-        Thread::stop();
-        cv.notify_one();
+        space.notify_all();
     }
 
-    void CommonCommunicator::run() {
-        unique_lock slock(sm);
-        slock.unlock();
-        unique_lock lock(m);
-        scv.notify_one();
-        while (getState() != ThreadState::Stopped) {
-            cv.wait(lock);
+    void CommonCommunicator::notifySpace() {
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (blockedWriters > 0) {
+            lock_guard lock(m);
+            space.notify_all();
+        }
+    }
 
+    void CommonCommunicator::reportDropped() {
+        unsigned long long total = ++dropped;
+        // Log the first loss and then each time the total doubles, so that a full
+        // queue is visible without logging every item
+        if ((total & (total - 1)) == 0) {
+            log.FormatLine(LOG_WARN, MODULE_NAME, "Write queue full; %llu items dropped so far", total);
+        }
+    }
+
+    void CommonCommunicator::readInto(DataStore & data) {
+        data = read();
+    }
+
+    void CommonCommunicator::run() {
+        WriteItem item;
+        for (;;) {
             if (getState() == ThreadState::Stopped) {
                 // Exit early to avoid long program exit times
                 break;
             }
-            while (!writeItems.empty() || readWaiting) {
-                if (!writeItems.empty()) {
-                    AllData p = writeItems.front();
-                    writeItems.pop();
-                    write(p);
-                }
-                else if (readWaiting) {
-                    DataStore ds = read();
-                    readWaiting = false;
-                    for (Callback& fn : subscribers) {
-                        lock.unlock();
-                        fn(ds);
-                        lock.lock();
-                    }
+            // Reads and writes alternate, so neither starves the other
+            bool worked = false;
+            if (writeItems.tryPop(item)) {
+                worked = true;
+                notifySpace();
+                write(*item.data);
+                unsigned long long latency = static_cast<unsigned long long>(
+                    std::chrono::duration_cast<std::chrono::nanoseconds>(clock::now() - item.enqueued).count());
+                item.data.reset();
+                totalLatency += latency;
+                unsigned long long previous = maxLatency;
+                while (latency > previous && !maxLatency.compare_exchange_weak(previous, latency)) { }
+                ++written;
+            }
+            if (readWaiting.exchange(false)) {
+                worked = true;
+                // Requests made while reading get a read of their own
+                readInto(readData);
+                unique_lock lock(m);
+                for (Callback& fn : subscribers) {
+                    lock.unlock();
+                    fn(readData);
+                    lock.lock();
                 }
             }
+            if (!worked) {
+                break;
+            }
         }
     }
 }
@@ -27,14 +27,17 @@
 
 #include <sys/stat.h>       // For file exists in loadHistory
 #include <cmath>
-#include <thread>           // For thread sleep
+#include <cstdint>
+#include <cstring>
 #include <sstream>
+#include <stdexcept>
 #include <fstream>
 #include <vector>
 #include <map>
 #include <string>
 #include <chrono>
 
+#include "CheckpointFile.h"
 #include "CommonPrognoser.h"
 #include "SharedLib.h"
 #include "CommManager.h"
@@ -56,10 +59,14 @@ namespace PCOE {
     std::string         MODULE_NAME;
 
     CommonPrognoser::CommonPrognoser(GSAPConfigMap & configParams)
-        : Thread(), comm(CommManager::instance()),
+        : Task(), comm(CommManager::instance()),
         loopInterval(DEFAULT_LOOP_INTERVAL),
         saveInterval(DEFAULT_SAVE_INTERVAL),
-        usingPlaybackData(false) {
+        usingPlaybackData(false),
+        loopCounter(0),
+        historyLoaded(false),
+        subscribed(false),
+        subscription(0) {
         configParams.checkRequiredParams({ NAME_KEY, ID_KEY, TYPE_KEY });
 
         // Handle Required configs
@@ -77,19 +84,24 @@ namespace PCOE {
         }
 
         // HANDLE TAGS
+        std::vector<std::string> tagNames;
         if (configParams.includes(TAG_KEY)) {
             for (auto & it : configParams.at(TAG_KEY)) {
                 size_t pos = it.find_first_of(':');
                 std::string commonName = it.substr(0, pos);
                 std::string tagName = it.substr(pos + 1, it.length() - pos + 1);
                 comm.registerKey(tagName);
+                tagNames.push_back(tagName);
             }
         }
+        setTriggerTags(tagNames);
         comm.registerProgData(configParams.at(NAME_KEY)[0], &results);
 
-        histFileName = configParams.at(HIST_PATH_KEY)[0] + PATH_SEPARATOR \
+        std::string histBaseName = configParams.at(HIST_PATH_KEY)[0] + PATH_SEPARATOR \
             + results.getPrognoserName() + "_" \
-            + results.getUniqueId() + ".txt";
+            + results.getUniqueId();
+        histFileName = histBaseName + ".hist";
+        textHistFileName = histBaseName + ".txt";
         moduleName = results.getComponentName() + " " + results.getPrognoserName() + " Prognoser";
         MODULE_NAME = moduleName + "-Common";
         log.WriteLine(LOG_DEBUG, MODULE_NAME, "Reading configuration file");
@@ -99,311 +111,429 @@ namespace PCOE {
             // Reset History flag has been set
             resetHistory();
         }
+        try {
+            checkpoint.reset(new CheckpointFile(histFileName));
+        }
+        catch (const std::runtime_error &) {
+            log.FormatLine(LOG_ERROR, MODULE_NAME,
+                "Could not open history file %s. State will not be saved", histFileName.c_str());
+        }
         enable();
     }
 
+    CommonPrognoser::~CommonPrognoser() {
+        if (subscribed) {
+            comm.unsubscribe(subscription);
+        }
+
+        // The last cycle must finish while the derived prognoser still exists
+        ThreadState current = getState();
+        if (current == ThreadState::Enabled || current == ThreadState::Started ||
+            current == ThreadState::Paused) {
+            stop();
+        }
+        if (current != ThreadState::Created && current != ThreadState::Ended) {
+            join();
+        }
+    }
+
     //*----------------------------------------------*
-    //|           Main Prognostics Thread            |
+    //|           Main Prognostics Cycle             |
     //*----------------------------------------------*
     void CommonPrognoser::run() {
-        unsigned long loopCounter = 0;
-
-        loadHistory();  // Load prognoser history file
-        // @note(CT): Cannot be in constructor because
-        // derived will not exist yet at that point
-
-        log.WriteLine(LOG_TRACE, MODULE_NAME, "Starting Prognostics Loop");
-        while (getState() != ThreadState::Stopped) {
-            log.FormatLine(LOG_TRACE, MODULE_NAME, "Loop %i", loopCounter);
-            if (getState() == ThreadState::Started) {
-                // Run Cycle
-                checkInputValidity();  // SOMETIMES FAILS HERE
-                if (isEnoughData()) {
-                    log.WriteLine(LOG_TRACE, MODULE_NAME,
-                        "Has enough data- starting monitor step");
-                    step();
-                }
-                checkResultValidity();
+        if (!historyLoaded) {
+            loadHistory();  // Load prognoser history file
+            // @note(CT): Cannot be in constructor because
+            // derived will not exist yet at that point
+            historyLoaded = true;
+        }
 
-                if (0 == loopCounter%saveInterval) {
-                    saveState();
-                }
-            }  // End if(started)
+        log.FormatLine(LOG_TRACE, MODULE_NAME, "Loop %i", loopCounter);
+        // Run Cycle
+        checkInputValidity();  // SOMETIMES FAILS HERE
+        if (isEnoughData()) {
+            log.WriteLine(LOG_TRACE, MODULE_NAME,
+                "Has enough data- starting monitor step");
+            step();
+        }
+        checkResultValidity();
 
+        if (0 == loopCounter%saveInterval) {
+            saveState();
+        }
+        loopCounter++;
+
+        if (!subscribed) {
             log.WriteLine(LOG_TRACE, MODULE_NAME, "Waiting");
-            if (getState() == ThreadState::Stopped) {
-                break;
-            }
-            std::this_thread::sleep_for(std::chrono::milliseconds(loopInterval));
-            loopCounter++;
-        }  // End While(not stopped)
+            scheduleAfter(std::chrono::milliseconds(loopInterval));
+        }
+    }
 
+    void CommonPrognoser::cleanup() {
         /// Cleanup activities
         log.WriteLine(LOG_INFO, MODULE_NAME, "Cleaning Up");
         saveState();  // Save final state
+        if (checkpoint) {
+            checkpoint->flush();
+        }
     }
 
     //*----------------------------------------------*
     //|              Support Functions               |
     //*----------------------------------------------*
 
+    void CommonPrognoser::setTriggerTags(const std::vector<std::string> & tags) {
+        if (subscribed) {
+            comm.unsubscribe(subscription);
+            subscribed = false;
+        }
+        if (!tags.empty()) {
+            subscription = comm.subscribe(tags, [this]() { this->schedule(); });
+            subscribed = true;
+        }
+    }
+
     void CommonPrognoser::checkResultValidity() {
         log.WriteLine(LOG_TRACE, MODULE_NAME, "Checking Result Validity");
     }
 
-    inline void saveMap(std::fstream& fdHist, const std::map<std::string, double>& valueMap) {
-        for (auto & it : valueMap) {
-            fdHist << it.first << ":" << it.second << ",";
-        }
-    }
+    namespace {
+        /// Appends values to a history record
+        class RecordWriter {
+        public:
+            explicit RecordWriter(std::vector<char> & buffer) : out(buffer) { }
 
-    void CommonPrognoser::saveState() const {
-        // @todo(CT): Make more efficient- right now it copies every udata vector
+            template <class T>
+            void put(const T value) {
+                const char * bytes = reinterpret_cast<const char *>(&value);
+                out.insert(out.end(), bytes, bytes + sizeof(T));
+            }
 
-        log.WriteLine(LOG_DEBUG, MODULE_NAME, "Saving state to file");
-        std::fstream fdHist;
-        fdHist.open(histFileName, std::fstream::out);
-        if (!fdHist.is_open()) {
-            log.WriteLine(LOG_ERROR, MODULE_NAME,
-                "Could not open history file to save state");
-            return;
-        }
+            void putString(const std::string & value) {
+                put(static_cast<std::uint32_t>(value.size()));
+                out.insert(out.end(), value.begin(), value.end());
+            }
 
-        // Print previous lines
-        for (auto & it : histStr) {
-            fdHist << it << '\n';
-        }
+            void putUData(const UData & value) {
+                put(static_cast<std::int32_t>(value.uncertainty()));
+                put(static_cast<std::uint64_t>(value.npoints()));
+                put(static_cast<std::uint64_t>(value.size()));
+                for (double x : value) {
+                    put(x);
+                }
+            }
+
+        private:
+            std::vector<char> & out;
+        };
 
-        // Time
-        fdHist << "time:" << millisecondsNow();
-
-        // For each Event
-        for (auto && itEvents : results.getEventNames()) {
-            const auto & event = results.events[itEvents];
-            // timeOfEvent
-            const auto && vec = event.timeOfEvent.getVec(0);
-            std::stringstream tmp;
-            tmp << ",e[" << itEvents;
-            for (unsigned long it = 0; it < vec.size(); ++it) {
-                fdHist << tmp.str() << "].TOE["\
-                    << it << "](" << static_cast<int>(event.timeOfEvent.uncertainty()) \
-                    << "):" << event.timeOfEvent.get();
+        /// Reads values from a history record
+        class RecordReader {
+        public:
+            explicit RecordReader(const std::vector<char> & buffer) : in(buffer), pos(0) { }
+
+            template <class T>
+            T get() {
+                T value;
+                std::memcpy(&value, take(sizeof(T)), sizeof(T));
+                return value;
+            }
+
+            std::string getString() {
+                std::size_t size = get<std::uint32_t>();
+                const char * data = take(size);
+                return std::string(data, size);
             }
 
-            // Occurrence
-            fdHist << tmp.str() << "].pMat[T+0]:" \
-                << static_cast<double>(event.probMatrix[0]);
+            void getUData(UData & value) {
+                value.uncertainty(static_cast<UType>(get<std::int32_t>()));
+                value.npoints(get<std::uint64_t>());
+                std::vector<double> data(get<std::uint64_t>());
+                for (double & x : data) {
+                    x = get<double>();
+                }
+                if (data.size() != value.size()) {
+                    throw std::out_of_range("Uncertain data size does not match its type");
+                }
+                value.setVec(0, data);
+            }
 
-            // OccurrenceMat (if used)
-            if (!event.occurrenceMatrix[NOW].empty()) {
-                for (unsigned int theSample = 0; theSample < event.occurrenceMatrix[0].size(); theSample++) {
-                    fdHist << tmp.str() << "].oMat[T+0]" << theSample \
-                        << "]:" << event.occurrenceMatrix[0][theSample];
+        private:
+            const char * take(std::size_t size) {
+                if (size > in.size() - pos) {
+                    throw std::out_of_range("History record is truncated");
                 }
+                const char * data = in.data() + pos;
+                pos += size;
+                return data;
             }
+
+            const std::vector<char> & in;
+            std::size_t pos;
+        };
+    }
+
+    void CommonPrognoser::saveState() const {
+        if (!checkpoint) {
+            return;
         }
+        log.WriteLine(LOG_DEBUG, MODULE_NAME, "Saving state to file");
 
-        // For System Trajectories
-        for (auto & itOutputs : results.getSystemTrajectoryNames()) {
-            const auto && vec = results.sysTrajectories[itOutputs][0].getVec(0);
-            std::stringstream tmp;
-            tmp << ",sTraj[" << itOutputs << "][T+0][";
-            for (unsigned int it = 0; it < vec.size(); ++it) {
-                fdHist << tmp.str() << it << "](" \
-                    << static_cast<int>(results.sysTrajectories[itOutputs][0].uncertainty()) << "):"\
-                    << results.sysTrajectories[itOutputs][0][it];
+        // Record layout: time, then events, system trajectories and internals,
+        // each preceded by its count
+        std::vector<char> record;
+        RecordWriter writer(record);
+        writer.put(static_cast<std::uint64_t>(millisecondsNow()));
+
+        std::vector<std::string> eventNames = results.getEventNames();
+        writer.put(static_cast<std::uint32_t>(eventNames.size()));
+        for (auto & eventName : eventNames) {
+            const auto & event = results.events[eventName];
+            writer.putString(eventName);
+            writer.putUData(event.timeOfEvent);
+            writer.put(event.probMatrix[0]);
+            auto occurrence = event.occurrenceMatrix[0];
+            writer.put(static_cast<std::uint32_t>(occurrence.size()));
+            for (bool occurred : occurrence) {
+                writer.put(static_cast<std::uint8_t>(occurred));
             }
         }
 
-        // Internal State
-        saveMap(fdHist, results.internals);
+        std::vector<std::string> trajectoryNames = results.getSystemTrajectoryNames();
+        writer.put(static_cast<std::uint32_t>(trajectoryNames.size()));
+        for (auto & trajectoryName : trajectoryNames) {
+            writer.putString(trajectoryName);
+            writer.putUData(results.sysTrajectories[trajectoryName][0]);
+        }
 
-        fdHist.close();
-        log.WriteLine(LOG_TRACE, MODULE_NAME, "Finished saving state to file");
-    }
+        writer.put(static_cast<std::uint32_t>(results.internals.size()));
+        for (auto & internal : results.internals) {
+            writer.putString(internal.first);
+            writer.put(internal.second);
+        }
 
-    //unsigned int getTimeIndex(const double value, ProgData &pd) {
-    //    // Converts time value (T+X) to index T[I]
-    //    static std::vector<double> timeVec;
-    //
-    //    for (unsigned int it = 0; it < timeVec.size(); ++it) {
-    //        // If it exists
-    //        if (std::abs(timeVec[it]-value) <= 1e-9) {
-    //            return it;
-    //        }
-    //    }
-    //    // New timestamp
-    //    timeVec.push_back(value);
-    //    pd.setPredictions(timeVec);
-    //    return (unsigned int) timeVec.size()-1;
-    //}
+        checkpoint->append(std::move(record));
+        log.WriteLine(LOG_TRACE, MODULE_NAME, "Queued state to save to file");
+    }
 
     void CommonPrognoser::loadHistory() {
-        struct stat buf;
-        if (stat(histFileName.c_str(), &buf) != -1) {
-            // File exists
-            std::fstream fdHist;
-            fdHist.open(histFileName.c_str(), std::fstream::in);  // Used c str for C98 Compatability
-
-            if (fdHist.is_open()) {
-                // File was opened correctly
-                log.FormatLine(LOG_INFO, MODULE_NAME, "Loading Prognostic history file %s for %s",
-                    histFileName.c_str(), results.getComponentName().c_str());
-                std::string line;
-
-                while (getline(fdHist, line)) {
-                    // get the data
-                    if (!line.empty()) {
-                        // ignore empty lines
-                        histStr.push_back(line);  // Record line for saveState
+        ProgData lastState;
+        std::vector<char> record;
+        bool loaded = false;
+        if (checkpoint && checkpoint->readLatest(record)) {
+            log.FormatLine(LOG_INFO, MODULE_NAME, "Loading Prognostic history file %s for %s",
+                histFileName.c_str(), results.getComponentName().c_str());
+            try {
+                RecordReader reader(record);
+                reader.get<std::uint64_t>();  // Time
+
+                std::uint32_t nEvents = reader.get<std::uint32_t>();
+                for (std::uint32_t i = 0; i < nEvents; i++) {
+                    std::string eventName = reader.getString();
+                    if (!lastState.events.includes(eventName)) {
+                        lastState.addEvent(eventName);
+                    }
+                    ProgEvent & theEvent = lastState.events[eventName];
+                    reader.getUData(theEvent.timeOfEvent);
+                    theEvent.probMatrix[0] = reader.get<double>();
+                    auto occurrence = theEvent.occurrenceMatrix[0];
+                    occurrence.resize(reader.get<std::uint32_t>());
+                    for (std::size_t sample = 0; sample < occurrence.size(); sample++) {
+                        occurrence[sample] = reader.get<std::uint8_t>() != 0;
                     }
                 }
 
-                if (histStr.size() != 0) {
-                    // Atleast one line received
-                    // Initialize Model
-                    std::vector<std::string> enteries;
-                    std::string entry;
-                    std::istringstream ss(histStr.back());
-                    ProgData lastState;
-                    std::vector<double> timeVec;
-
-                    while (std::getline(ss, entry, ':')) {
-                        // While another key exists
-                        switch (entry[0]) {
-                        case 't':   // time
-                            std::getline(ss, entry, ',');
-                            break;
-
-                            {case 'e':  // Event
-                                std::string eventName, subEntry, value;
-                                std::istringstream sss(entry);
-
-                                std::getline(sss, eventName, '[');
-                                std::getline(sss, eventName, ']');
-                                if (!lastState.events.includes(eventName)) {
-                                    lastState.addEvent(eventName);
-                                }
-                                ProgEvent & theEvent = lastState.events[eventName];
-
-                                std::getline(sss, subEntry, '[');
-                                char identifier = subEntry[1];
-                                std::getline(sss, subEntry, ']');
-                                std::getline(ss, entry, ',');  // Get the value
-
-                                switch (identifier) {
-                                    {case 'T':
-                                        std::string type;
-                                        std::getline(sss, type, '(');
-                                        std::getline(sss, type, ')');
-                                        theEvent.timeOfEvent.uncertainty(static_cast<UType>(std::stoi(type)));
-                                        if (std::stoul(subEntry) >= theEvent.timeOfEvent.npoints()) {
-                                            theEvent.timeOfEvent.npoints(static_cast<unsigned int>(std::stoul(subEntry) + 1));
-                                        }
-                                        theEvent.timeOfEvent[std::stoul(subEntry)] = std::stod(entry);
-
-                                        break; }
-
-                                    {case 'p':
-                                        theEvent.probMatrix[0] = std::stod(entry);
-                                        break; }
-
-                                    {case 'o':
-                                        std::getline(sss, subEntry, '[');
-                                        std::getline(sss, subEntry, ']');
-
-                                        if (std::stoul(subEntry) >= theEvent.occurrenceMatrix[0].size()) {
-                                            theEvent.occurrenceMatrix[0].resize(std::stoul(subEntry) + 1);
-                                            /// @todo(CT): resize above for efficiency
-                                        }
-                                        theEvent.occurrenceMatrix[0][std::stoul(subEntry)] = std::stoi(entry) != 0;
-                                        break; }
-
-                                default:
-                                    log.WriteLine(LOG_ERROR, MODULE_NAME,
-                                        "Unknown Event parameter in history file");
-                                    break;
-                                }
-                                break; }
-
-                            {case 's':  // System Trajectories
-                                std::string trajName, timeStampStr, uIndex, type;
-                                std::istringstream sss(entry);
-
-                                std::getline(sss, trajName, '[');
-                                std::getline(sss, trajName, ']');
-                                if (!lastState.sysTrajectories.includes(trajName)) {
-                                    lastState.addSystemTrajectory(trajName);
-                                }
-                                DataPoint & theTraj = lastState.sysTrajectories[trajName];
-
-                                std::getline(sss, timeStampStr, '[');
-                                std::getline(sss, timeStampStr, ']');
-                                std::getline(sss, uIndex, '[');
-                                std::getline(sss, uIndex, ']');
-                                std::getline(sss, type, '(');
-                                std::getline(sss, type, ')');
-                                std::getline(ss, entry, ',');
-
-                                if (entry.empty() || type.empty() || uIndex.empty()) {
-                                    log.FormatLine(LOG_WARN, MODULE_NAME, "Found element of improper format: %s. Skipping", entry.c_str());
-                                    break;
-                                }
-                                theTraj.setUncertainty(static_cast<UType>(std::stoi(type)));
-                                double value = std::stod(entry);
-                                unsigned int sampleIndex = static_cast<unsigned int>(std::stoul(uIndex));
-
-                                if (sampleIndex >= theTraj[0].size()) {
-                                    theTraj[0].npoints(sampleIndex + 1);
-                                    /// @todo(CT): resize above for efficiency
-                                }
-                                theTraj[0][sampleIndex] = value;
-
-                                break; }
-
-                            {case 'i':  // Internal
-                                std::string internalName;
-                                std::istringstream sss(entry);
-
-                                std::getline(sss, internalName, '[');
-                                std::getline(sss, internalName, ']');
-                                std::getline(ss, entry, ',');
-
-                                lastState.internals[internalName] = std::stod(entry);
-                                break; }
-
-                        default:  // Unknown
-                            log.FormatLine(LOG_WARN, MODULE_NAME,
-                                "Unknown parameter found in history file - %s",
-                                entry.c_str());
-                            std::getline(ss, entry, ',');
-                            break;
-                        }
+                std::uint32_t nTrajectories = reader.get<std::uint32_t>();
+                for (std::uint32_t i = 0; i < nTrajectories; i++) {
+                    std::string trajectoryName = reader.getString();
+                    if (!lastState.sysTrajectories.includes(trajectoryName)) {
+                        lastState.addSystemTrajectory(trajectoryName);
                     }
-
-                    setHistory(lastState);
+                    UData value;
+                    reader.getUData(value);
+                    DataPoint & theTraj = lastState.sysTrajectories[trajectoryName];
+                    theTraj.setUncertainty(value.uncertainty());
+                    theTraj[0] = value;
                 }
-                else {
-                    // File was empty
-                    log.FormatLine(LOG_WARN, MODULE_NAME,
-                        "Prognostic history file %s was empty",
-                        histFileName.c_str());
+
+                std::uint32_t nInternals = reader.get<std::uint32_t>();
+                for (std::uint32_t i = 0; i < nInternals; i++) {
+                    std::string internalName = reader.getString();
+                    lastState.internals[internalName] = reader.get<double>();
                 }
+                loaded = true;
             }
-            else {
-                // File not opened correctly
-                log.FormatLine(LOG_WARN, MODULE_NAME,
-                    "Prognostic history file %s could not be opened",
-                    histFileName.c_str());
+            catch (const std::out_of_range & ex) {
+                log.FormatLine(LOG_ERROR, MODULE_NAME,
+                    "Prognostic history file %s is malformed: %s", histFileName.c_str(), ex.what());
             }
         }
         else {
+            loaded = loadTextHistory(lastState);
+        }
+
+        if (loaded) {
+            setHistory(lastState);
+        }
+        log.WriteLine(LOG_TRACE, MODULE_NAME, "Loading history from file");
+    }
+
+    bool CommonPrognoser::loadTextHistory(ProgData & lastState) {
+        struct stat buf;
+        if (stat(textHistFileName.c_str(), &buf) == -1) {
             log.FormatLine(LOG_INFO, MODULE_NAME,
                 "Prognostic history file %s does not exist yet",
                 histFileName.c_str());
+            return false;
         }
 
-        log.WriteLine(LOG_TRACE, MODULE_NAME, "Loading history from file");
+        // File exists
+        std::fstream fdHist;
+        fdHist.open(textHistFileName.c_str(), std::fstream::in);  // Used c str for C98 Compatability
+        if (!fdHist.is_open()) {
+            // File not opened correctly
+            log.FormatLine(LOG_WARN, MODULE_NAME,
+                "Prognostic history file %s could not be opened",
+                textHistFileName.c_str());
+            return false;
+        }
+
+        // File was opened correctly
+        log.FormatLine(LOG_INFO, MODULE_NAME, "Loading Prognostic history file %s for %s",
+            textHistFileName.c_str(), results.getComponentName().c_str());
+        std::string line;
+        std::string lastLine;
+        while (getline(fdHist, line)) {
+            if (!line.empty()) {
+                // ignore empty lines
+                lastLine = line;
+            }
+        }
+
+        if (lastLine.empty()) {
+            // File was empty
+            log.FormatLine(LOG_WARN, MODULE_NAME,
+                "Prognostic history file %s was empty",
+                textHistFileName.c_str());
+            return false;
+        }
+
+        // Initialize Model
+        std::string entry;
+        std::istringstream ss(lastLine);
+        while (std::getline(ss, entry, ':')) {
+            // While another key exists
+            switch (entry[0]) {
+            case 't':   // time
+                std::getline(ss, entry, ',');
+                break;
+
+                {case 'e':  // Event
+                    std::string eventName, subEntry, value;
+                    std::istringstream sss(entry);
+
+                    std::getline(sss, eventName, '[');
+                    std::getline(sss, eventName, ']');
+                    if (!lastState.events.includes(eventName)) {
+                        lastState.addEvent(eventName);
+                    }
+                    ProgEvent & theEvent = lastState.events[eventName];
+
+                    std::getline(sss, subEntry, '[');
+                    char identifier = subEntry[1];
+                    std::getline(sss, subEntry, ']');
+                    std::getline(ss, entry, ',');  // Get the value
+
+                    switch (identifier) {
+                        {case 'T':
+                            std::string type;
+                            std::getline(sss, type, '(');
+                            std::getline(sss, type, ')');
+                            theEvent.timeOfEvent.uncertainty(static_cast<UType>(std::stoi(type)));
+                            if (std::stoul(subEntry) >= theEvent.timeOfEvent.npoints()) {
+                                theEvent.timeOfEvent.npoints(static_cast<unsigned int>(std::stoul(subEntry) + 1));
+                            }
+                            theEvent.timeOfEvent[std::stoul(subEntry)] = std::stod(entry);
+
+                            break; }
+
+                        {case 'p':
+                            theEvent.probMatrix[0] = std::stod(entry);
+                            break; }
+
+                        {case 'o':
+                            std::getline(sss, subEntry, '[');
+                            std::getline(sss, subEntry, ']');
+
+                            if (std::stoul(subEntry) >= theEvent.occurrenceMatrix[0].size()) {
+                                theEvent.occurrenceMatrix[0].resize(std::stoul(subEntry) + 1);
+                                /// @todo(CT): resize above for efficiency
+                            }
+                            theEvent.occurrenceMatrix[0][std::stoul(subEntry)] = std::stoi(entry) != 0;
+                            break; }
+
+                    default:
+                        log.WriteLine(LOG_ERROR, MODULE_NAME,
+                            "Unknown Event parameter in history file");
+                        break;
+                    }
+                    break; }
+
+                {case 's':  // System Trajectories
+                    std::string trajName, timeStampStr, uIndex, type;
+                    std::istringstream sss(entry);
+
+                    std::getline(sss, trajName, '[');
+                    std::getline(sss, trajName, ']');
+                    if (!lastState.sysTrajectories.includes(trajName)) {
+                        lastState.addSystemTrajectory(trajName);
+                    }
+                    DataPoint & theTraj = lastState.sysTrajectories[trajName];
+
+                    std::getline(sss, timeStampStr, '[');
+                    std::getline(sss, timeStampStr, ']');
+                    std::getline(sss, uIndex, '[');
+                    std::getline(sss, uIndex, ']');
+                    std::getline(sss, type, '(');
+                    std::getline(sss, type, ')');
+                    std::getline(ss, entry, ',');
+
+                    if (entry.empty() || type.empty() || uIndex.empty()) {
+                        log.FormatLine(LOG_WARN, MODULE_NAME, "Found element of improper format: %s. Skipping", entry.c_str());
+                        break;
+                    }
+                    theTraj.setUncertainty(static_cast<UType>(std::stoi(type)));
+                    double value = std::stod(entry);
+                    unsigned int sampleIndex = static_cast<unsigned int>(std::stoul(uIndex));
+
+                    if (sampleIndex >= theTraj[0].size()) {
+                        theTraj[0].npoints(sampleIndex + 1);
+                        /// @todo(CT): resize above for efficiency
+                    }
+                    theTraj[0][sampleIndex] = value;
+
+                    break; }
+
+                {case 'i':  // Internal
+                    std::string internalName;
+                    std::istringstream sss(entry);
+
+                    std::getline(sss, internalName, '[');
+                    std::getline(sss, internalName, ']');
+                    std::getline(ss, entry, ',');
+
+                    lastState.internals[internalName] = std::stod(entry);
+                    break; }
+
+            default:  // Unknown
+                log.FormatLine(LOG_WARN, MODULE_NAME,
+                    "Unknown parameter found in history file - %s",
+                    entry.c_str());
+                std::getline(ss, entry, ',');
+                break;
+            }
+        }
+        return true;
     }
 
     inline void CommonPrognoser::resetHistory() const {
@@ -414,9 +544,15 @@ namespace PCOE {
         char numstr[21] = { 0 };  // enough to hold all numbers up to 64-bits
         long long int time = system_clock::now().time_since_epoch() / seconds(1);
         snprintf(numstr, 21, "%lld", time);
-        std::string newName = histFileName + "_old" + numstr;
-        if (rename(histFileName.c_str(), newName.c_str())) {
-            log.WriteLine(LOG_WARN, MODULE_NAME, "Could not rename history file");
+        for (const std::string & fileName : { histFileName, textHistFileName }) {
+            struct stat buf;
+            if (stat(fileName.c_str(), &buf) == -1) {
+                continue;
+            }
+            std::string newName = fileName + "_old" + numstr;
+            if (rename(fileName.c_str(), newName.c_str())) {
+                log.WriteLine(LOG_WARN, MODULE_NAME, "Could not rename history file");
+            }
         }
     }
 }
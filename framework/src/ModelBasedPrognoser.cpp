@@ -80,6 +80,17 @@ namespace PCOE {
         inputs = configMap[INPUTS_KEY];
         outputs = configMap[OUTPUTS_KEY];
 
+        // Resolve handles once, so steps read values without locking
+        for (const std::string & input : inputs) {
+            inputHandles.push_back(comm.registerKey(input));
+        }
+        for (const std::string & output : outputs) {
+            outputHandles.push_back(comm.registerKey(output));
+        }
+
+        // Steps are skipped unless output data is new, so wake only when it arrives
+        setTriggerTags(outputs);
+
         // Create progdata
         results.setUncertainty(UType::Samples);             // @todo(MD): do not force samples representation
         results.addEvent(event);                            // @todo(MD): do not assume only a single event
@@ -92,26 +103,26 @@ namespace PCOE {
 
     void ModelBasedPrognoser::step() {
         // Initialize time (convert to seconds)
-        static double initialTime = comm.getValue(outputs[0]).getTime() / 1.0e3;
+        static double initialTime = comm.getValue(outputHandles[0]).getTime() / 1.0e3;
 
         // Get new relative time (convert to seconds)
         // @todo(MD): Add config for time units so conversion is not hard-coded
-        double newT = comm.getValue(outputs[0]).getTime() / 1.0e3 - initialTime;
+        double newT = comm.getValue(outputHandles[0]).getTime() / 1.0e3 - initialTime;
         
         // Fill in input and output data
-        log.WriteLine(LOG_DEBUG, moduleName, "Getting data in step");
+        PCOE_LOG_LINE(log, LOG_DEBUG, moduleName.c_str(), "Getting data in step");
         std::vector<double> u(model->getNumInputs());
         std::vector<double> z(model->getNumOutputs());
         for (unsigned int i = 0; i < model->getNumInputs(); i++) {
-            u[i] = comm.getValue(inputs[i]);
+            u[i] = comm.getValue(inputHandles[i]);
         }
         for (unsigned int i = 0; i < model->getNumOutputs(); i++) {
-            z[i] = comm.getValue(outputs[i]);
+            z[i] = comm.getValue(outputHandles[i]);
         }
 
         // If this is the first step, will want to initialize the observer and the predictor
         if (!initialized) {
-            log.WriteLine(LOG_DEBUG, moduleName, "Initializing ModelBasedPrognoser");
+            PCOE_LOG_LINE(log, LOG_DEBUG, moduleName.c_str(), "Initializing ModelBasedPrognoser");
             std::vector<double> x(model->getNumStates());
             model->initialize(x, u, z);
             observer->initialize(newT, x, u);
@@ -120,21 +131,21 @@ namespace PCOE {
         } else {
             // If time has not advanced, skip this step
             if (newT <= lastTime) {
-                log.WriteLine(LOG_TRACE, moduleName, "Skipping step because time did not advance.");
+                PCOE_LOG_LINE(log, LOG_TRACE, moduleName.c_str(), "Skipping step because time did not advance.");
                 return;
             }
 
             // Run observer
-            log.WriteLine(LOG_DEBUG, moduleName, "Running Observer Step");
+            PCOE_LOG_LINE(log, LOG_DEBUG, moduleName.c_str(), "Running Observer Step");
             observer->step(newT, u, z);
-            log.WriteLine(LOG_DEBUG, moduleName, "Done Running Observer Step");
+            PCOE_LOG_LINE(log, LOG_DEBUG, moduleName.c_str(), "Done Running Observer Step");
 
             // Run predictor
-            log.WriteLine(LOG_DEBUG, moduleName, "Running Prediction Step");
+            PCOE_LOG_LINE(log, LOG_DEBUG, moduleName.c_str(), "Running Prediction Step");
             // Set up state
             std::vector<UData> stateEst = observer->getStateEstimate();
             predictor->predict(newT, stateEst, results);
-            log.WriteLine(LOG_DEBUG, moduleName, "Done Running Prediction Step");
+            PCOE_LOG_LINE(log, LOG_DEBUG, moduleName.c_str(), "Done Running Prediction Step");
 
             // Set lastTime
             lastTime = newT;
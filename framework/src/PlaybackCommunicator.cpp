@@ -5,8 +5,15 @@
  *
  *   @brief     Playback Communicator class- playback input data from a csv file
  *
+ *              The file is memory mapped and each row is parsed in place. The
+ *              columns are matched to their tags once, when the header is read,
+ *              so reading a row does not allocate. Binary recordings written by
+ *              the RecorderCommunicator are recognized and played back directly.
+ *
  *   @note      This class will look for the following optional configuration parameters:
  *                  file        Name of the file that will be played back (default RecordedMessages.csv)
+ *                  delim       Column delimiter, or \t for tab (default ,)
+ *                  timestampFromFile   Whether data is timestamped from the first column (default true)
  *
  *   @see        CommonCommunicator
  *
@@ -21,10 +28,13 @@
  *     All Rights Reserved.
  **/
 
-#include <iostream>
-#include <sstream>
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <ios>
 #include <string>
-#include <chrono> // For timestamps
 
 #include "Exceptions.h"
 #include "PlaybackCommunicator.h"
@@ -44,17 +54,146 @@ namespace PCOE {
     // Log Parameters
     const std::string MODULE_NAME = "playbackComm";
 
+    namespace {
+        /// Powers of ten that are exact as doubles
+        const double POWERS_OF_TEN[] = {
+            1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+            1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+        };
+        const int MAX_EXACT_POWER = 22;
+        const std::uint64_t MAX_EXACT_MANTISSA = 1ULL << 53;
+        const int MAX_MANTISSA_DIGITS = 19;
+
+        inline bool isDigit(char c) {
+            return c >= '0' && c <= '9';
+        }
+
+        std::string fileName(const ConfigMap & config) {
+            return config.includes(FILE_KEY) ? config.at(FILE_KEY)[0] : DEFAULT_FILE_NAME;
+        }
+
+        /// End of the line starting at begin, excluding any carriage return
+        const char * lineEnd(const char * begin, const char * end, const char *& next) {
+            const void * newline = std::memchr(begin, '\n', static_cast<std::size_t>(end - begin));
+            const char * stop = newline == nullptr ? end : static_cast<const char *>(newline);
+            next = stop == end ? end : stop + 1;
+            if (stop != begin && stop[-1] == '\r') {
+                --stop;
+            }
+            return stop;
+        }
+
+        /// End of the field starting at begin
+        inline const char * fieldEnd(const char * begin, const char * end, char delim) {
+            const void * found = std::memchr(begin, delim, static_cast<std::size_t>(end - begin));
+            return found == nullptr ? end : static_cast<const char *>(found);
+        }
+
+        /** Parse the number at the start of [begin, end), skipping leading spaces.
+         *  Numbers that a double holds exactly, scaled by an exact power of ten,
+         *  are converted directly; this is correctly rounded, and covers
+         *  recorded data. Anything else, including nan and inf, goes to strtod.
+         */
+        bool parseNumber(const char * begin, const char * end, double & value) {
+            while (begin != end && *begin == ' ') {
+                ++begin;
+            }
+            const char * p = begin;
+            bool negative = false;
+            if (p != end && (*p == '-' || *p == '+')) {
+                negative = *p == '-';
+                ++p;
+            }
+
+            std::uint64_t mantissa = 0;
+            int digits = 0;
+            int exponent = 0;
+            bool anyDigits = false;
+            bool exact = true;
+            for (; p != end && isDigit(*p); ++p) {
+                anyDigits = true;
+                if (digits < MAX_MANTISSA_DIGITS) {
+                    mantissa = mantissa * 10 + static_cast<std::uint64_t>(*p - '0');
+                    if (mantissa != 0) {
+                        digits++;
+                    }
+                }
+                else {
+                    exponent++;
+                    exact = exact && *p == '0';
+                }
+            }
+            if (p != end && *p == '.') {
+                for (++p; p != end && isDigit(*p); ++p) {
+                    anyDigits = true;
+                    if (digits < MAX_MANTISSA_DIGITS) {
+                        mantissa = mantissa * 10 + static_cast<std::uint64_t>(*p - '0');
+                        if (mantissa != 0) {
+                            digits++;
+                        }
+                        exponent--;
+                    }
+                    else {
+                        exact = exact && *p == '0';
+                    }
+                }
+            }
+            if (anyDigits && p != end && (*p == 'e' || *p == 'E')) {
+                const char * e = p + 1;
+                bool negativeExponent = false;
+                if (e != end && (*e == '-' || *e == '+')) {
+                    negativeExponent = *e == '-';
+                    ++e;
+                }
+                if (e != end && isDigit(*e)) {
+                    int written = 0;
+                    for (; e != end && isDigit(*e); ++e) {
+                        if (written < 100000) {
+                            written = written * 10 + (*e - '0');
+                        }
+                    }
+                    exponent += negativeExponent ? -written : written;
+                }
+            }
+
+            if (anyDigits && exact && mantissa <= MAX_EXACT_MANTISSA &&
+                exponent >= -MAX_EXACT_POWER && exponent <= MAX_EXACT_POWER) {
+                double result = static_cast<double>(mantissa);
+                if (exponent < 0) {
+                    result /= POWERS_OF_TEN[-exponent];
+                }
+                else {
+                    result *= POWERS_OF_TEN[exponent];
+                }
+                value = negative ? -result : result;
+                return true;
+            }
+
+            char buffer[64];
+            std::size_t length = std::min(sizeof(buffer) - 1, static_cast<std::size_t>(end - begin));
+            std::memcpy(buffer, begin, length);
+            buffer[length] = '\0';
+            char * stop;
+            value = std::strtod(buffer, &stop);
+            return stop != buffer;
+        }
+    }
+
     PlaybackCommunicator::PlaybackCommunicator(const ConfigMap & config) :
+        CommonCommunicator(config),
+        playbackFile(fileName(config)),
+        position(nullptr),
+        end(nullptr),
         delim(DEFAULT_DELIM),
-        timestampFromFile(DEFAULT_TIMESTAMP) {
-        std::string playbackFile = DEFAULT_FILE_NAME;
-
+        timestampFromFile(DEFAULT_TIMESTAMP),
+        started(false),
+        recordingRow(0),
+        firstRowTime(0) {
         log.WriteLine(LOG_DEBUG, MODULE_NAME, "Initializing");
         // Read Configuration Map
         if (config.includes(FILE_KEY)) {
-            playbackFile = config.at(FILE_KEY)[0];
             log.FormatLine(LOG_DEBUG, MODULE_NAME, "Configuring- Playback File Name %s",
-                playbackFile.c_str());
+                config.at(FILE_KEY)[0].c_str());
         }
 
         if (config.includes(DELIM_KEY)) {
@@ -76,116 +215,182 @@ namespace PCOE {
         }
 
         log.FormatLine(LOG_INFO, MODULE_NAME,
-            "Opening playback file %s", playbackFile.c_str());
+            "Opening playback file %s", fileName(config).c_str());
 
-        playbackStream.exceptions(std::ios_base::failbit);
-        try {
-            playbackStream.open(playbackFile);
+        if (!playbackFile.isOpen()) {
+            log.WriteLine(LOG_ERROR, MODULE_NAME, "Error opening playback file");
+            throw std::ios_base::failure("Error opening playback file");
         }
-        catch (const std::ios_base::failure ex) {
-            std::string msg =
-                std::string("Error opening playback file: ") + ex.what();
-            log.WriteLine(LOG_ERROR, MODULE_NAME, msg);
-            throw;
+        position = playbackFile.data();
+        end = position + playbackFile.size();
+
+        if (RecordingReader::isRecording(position, playbackFile.size())) {
+            log.WriteLine(LOG_DEBUG, MODULE_NAME, "Reading binary recording");
+            recording.reset(new RecordingReader(position, playbackFile.size()));
+            const auto & recorded = recording->getColumns();
+            for (std::size_t i = 0; i < recorded.size(); i++) {
+                if (recorded[i].kind == RecordingColumnKind::Datum) {
+                    header.push_back(recorded[i].name);
+                    recordingColumns.push_back(i);
+                }
+            }
         }
+        else {
+            readHeader();
+        }
+
+        // Columns point to elements of row, which are not added or removed again
+        row.reserve(header.size());
+        for (const auto & name : header) {
+            columns.push_back(&row[name]);
+        }
+        log.FormatLine(LOG_TRACE, MODULE_NAME,
+            "Registered %d parameters", header.size());
+    }
 
+    void PlaybackCommunicator::readHeader() {
         // Read Header
         log.WriteLine(LOG_TRACE, MODULE_NAME, "Reading Header");
 
-        std::string s;
-        while (s.substr(0, 9).compare("Timestamp") != 0 \
-            && s.substr(0, 9).compare("TimeStamp") != 0) {
-            if (!getline(playbackStream, s)) {
+        const char * headerStart;
+        const char * headerEnd;
+        do {
+            if (position == end) {
                 log.WriteLine(LOG_ERROR, MODULE_NAME,
                     "Playback file not in proper format");
                 throw FormatError("Playback file not in proper format");
             }
-        }
+            headerStart = position;
+            headerEnd = lineEnd(headerStart, end, position);
+        } while (headerEnd - headerStart < 9 ||
+            (std::strncmp(headerStart, "Timestamp", 9) != 0 &&
+                std::strncmp(headerStart, "TimeStamp", 9) != 0));
 
-        // Parse Header
+        // Parse Header. The first column is the timestamp.
         log.WriteLine(LOG_DEBUG, MODULE_NAME, "Parsing Header");
 
-        std::istringstream ss(s);
-        while (ss) {
-            std::string s2;
-            if (!getline(ss, s2, delim)) {
-                break;
-            }
+        const char * field = fieldEnd(headerStart, headerEnd, delim);
+        while (field != headerEnd) {
+            const char * next = fieldEnd(field + 1, headerEnd, delim);
+            std::string name(field + 1, next);
+            trim(name);
+            field = next;
 
-            if (s2.substr(0, 7).compare(" pData-") == 0) {
-                // Break line
+            if (name.compare(0, 6, "pData-") == 0) {
+                // Prognostic results follow the data
                 break;
             }
 
-            if (s2.compare("Timestamp") != 0 && s2.compare(" Running Time") != 0) {
-                // Ignored lines
-                trim(s);
-                header.push_back(s);
+            if (!name.empty() && name.compare("Running Time") != 0) {
+                header.push_back(name);
             }
         }
-        log.FormatLine(LOG_TRACE, MODULE_NAME,
-            "Registered %d parameters", header.size());
     }
 
-    DataStore PlaybackCommunicator::read() {
-        DataStore ds;
-        // Read Line
+    bool PlaybackCommunicator::parseRow() {
+        if (recording) {
+            return readRecordingRow();
+        }
         log.WriteLine(LOG_TRACE, MODULE_NAME, "Getting New Line");
-
-        std::string s;
-        if (!getline(playbackStream, s)) {
+        if (position == end) {
             log.WriteLine(LOG_WARN, MODULE_NAME, "Reached end of file");
-
-            return ds;
+            return false;
         }
 
-        // Parse Line
-        std::istringstream ss(s);
-        std::string s2;
-
-        if (!getline(ss, s2, delim)) {
+        const char * lineStart = position;
+        const char * lineStop = lineEnd(lineStart, end, position);
+        double seconds;
+        if (lineStop == lineStart || !parseNumber(lineStart, lineStop, seconds)) {
             log.WriteLine(LOG_WARN, MODULE_NAME, "Line was empty");
-
-            return ds;
+            return false;
         }
 
         // Otherwise- received timestamp
-        static std::chrono::time_point<std::chrono::system_clock> startingTime = std::chrono::system_clock::now();
-
-        const auto step = std::chrono::milliseconds(static_cast<unsigned long long>(std::stold(s2) * 1000));
-        std::chrono::time_point<std::chrono::system_clock> theTime = startingTime + step;
+        if (!started) {
+            startTime = std::chrono::system_clock::now();
+            started = true;
+        }
+        const auto step = std::chrono::milliseconds(static_cast<long long>(seconds * 1000));
+        const auto theTime = startTime + step;
 
-        for (const auto & it : header) {
-            if (!getline(ss, s2, delim)) {
+        const char * field = fieldEnd(lineStart, lineStop, delim);
+        for (auto column : columns) {
+            if (field == lineStop) {
                 log.WriteLine(LOG_WARN, MODULE_NAME,
                     "parameter not present-reached end of line");
-                return ds;
-            }
-            std::istringstream ss2(s2);
-            std::string s3;
-            if (!getline(ss2, s3, '(')) {
-                ds[it] = std::stof(s2);
-                if (timestampFromFile) {
-                    ds[it].setTime(theTime);
-                }
-                continue;
+                return false;
+            }
+            const char * next = fieldEnd(field + 1, lineStop, delim);
+            double value;
+            if (!parseNumber(field + 1, next, value)) {
+                log.WriteLine(LOG_WARN, MODULE_NAME, "Parameter is not a number");
+                value = NAN;
+            }
+            if (timestampFromFile) {
+                *column = Datum<double>(value, theTime);
             }
-            ds[it] = std::stof(s3);
+            else {
+                column->set(value);
+            }
+            field = next;
+        }
+        return true;
+    }
+
+    bool PlaybackCommunicator::readRecordingRow() {
+        while (recordingRow >= recording->rows()) {
+            if (!recording->nextChunk()) {
+                log.WriteLine(LOG_WARN, MODULE_NAME, "Reached end of file");
+                return false;
+            }
+            recordingRow = 0;
+        }
+
+        if (!started) {
+            startTime = std::chrono::system_clock::now();
+            firstRowTime = recording->rowTime(recordingRow);
+            started = true;
+        }
+
+        for (std::size_t i = 0; i < columns.size(); i++) {
+            RecordingReader::Cell cell = recording->get(recordingColumns[i], recordingRow);
+            double value = cell.count > 0 ? cell.values[0] : NAN;
             if (timestampFromFile) {
-                ds[it].setTime(theTime);
+                const auto step = std::chrono::milliseconds(cell.time - firstRowTime);
+                *columns[i] = Datum<double>(value, startTime + step);
+            }
+            else {
+                columns[i]->set(value);
             }
         }
+        recordingRow++;
+        return true;
+    }
 
-        return ds;
+    DataStore PlaybackCommunicator::read() {
+        if (!parseRow()) {
+            return DataStore();
+        }
+        return row;
     }
-    
-    void PlaybackCommunicator::write(AllData dataIn) {
+
+    void PlaybackCommunicator::readInto(DataStore & data) {
+        if (!parseRow()) {
+            data.clear();
+            return;
+        }
+        // Assigning over the elements left by the last read reuses them
+        data = row;
+    }
+
+    void PlaybackCommunicator::write(const AllData & dataIn) {
         (void) dataIn;
         throw std::domain_error("Write not supported");
     }
 
     PlaybackCommunicator::~PlaybackCommunicator() {
+        // Reads use the mapped file
+        finish();
         log.WriteLine(LOG_INFO, MODULE_NAME, "Closing File");
-        playbackStream.close();
     }
 }
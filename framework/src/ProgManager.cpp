@@ -40,6 +40,9 @@ namespace PCOE {
         "please report them by \nemailing Christopher Teubert (christopher.a.teubert@nasa.gov).";
     const std::string MODULE_NAME = "PrognosticManager";
 
+    // Configuration Keys
+    const std::string ASYNC_LOG_KEY = "asyncLog";
+
     Cmd::Cmd() : command(NONE) {}
 
     class CommonPrognoser;
@@ -66,6 +69,11 @@ namespace PCOE {
 
     void ProgManager::run() {
         /// Setup Log
+        if (configSet && configValues.includes(ASYNC_LOG_KEY) &&
+            (configValues.at(ASYNC_LOG_KEY)[0] == "true" || configValues.at(ASYNC_LOG_KEY)[0] == "1")) {
+            // Lines are written by a background thread
+            Log::SetAsync(true);
+        }
         logger.Initialize(PACKAGE_NAME, VERSION, NOTE);
         logger.WriteLine(LOG_INFO, MODULE_NAME, "Enabling");
 
@@ -150,6 +158,7 @@ namespace PCOE {
 
         // Stop Log, exit thread
         logger.WriteLine(LOG_INFO, MODULE_NAME, "Stopped");
+        Log::Flush();
         logger.Close();
     }
 
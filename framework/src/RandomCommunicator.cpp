@@ -43,6 +43,7 @@ namespace PCOE {
     unsigned int seed = static_cast<unsigned int>(time(nullptr));
 
     RandomCommunicator::RandomCommunicator(const ConfigMap & config) :
+        CommonCommunicator(config),
         maxRand(DEFAULT_MAX_RAND),
         stepSize(DEFAULT_STEP_SIZE) {
         // Handle Configuration
@@ -79,7 +80,7 @@ namespace PCOE {
         return data;
     }
 
-    void RandomCommunicator::write(AllData dataIn) {
+    void RandomCommunicator::write(const AllData & dataIn) {
         data = dataIn.doubleDatastore;
     }
 }
@@ -30,8 +30,13 @@
  *                  epoch
  *              Prognostic Results are printed with a timestamp and validity in the format (v=%8, t=%7)
  *
+ *              With format set to binary, the same columns are instead written to a
+ *              columnar binary recording (@see RecordingFile.h).
+ *
  *   @note      This class will look for the following optional configuration parameters:
  *                  saveFile    File to which the data will be saved (default "RecordedMessages.csv")
+ *                  format      csv or binary (default csv)
+ *                  chunkSize   Snapshots in each chunk of a binary recording (default 64)
  *
  *   @see        CommonCommunicator
  *
@@ -46,13 +51,18 @@
  *     All Rights Reserved.
  */
 
+#include <algorithm>
 #include <iomanip>
 #include <sstream>
 #include <iostream>
 #include <fstream>
 #include <string>
 #include <chrono>
+#include <cmath>
+#include <cstdarg>
+#include <stdexcept>
 
+#include "MappedFile.h"
 #include "RecorderCommunicator.h"
 #include "SharedLib.h"  // For millisecondsNow()
 
@@ -63,6 +73,8 @@ namespace PCOE {
     const bool DEFAULT_WRITE_PROB_OCCUR = false;
     const bool DEFAULT_WRITE_PREDICTIONS = false;
     const bool DEFAULT_WRITE_SYSTEM_TRAJ = true;
+    const std::string DEFAULT_FORMAT = "csv";
+    const std::size_t DEFAULT_CHUNK_SIZE = 64;
 
 
     // Configuration Keys
@@ -71,24 +83,25 @@ namespace PCOE {
     const std::string OCCUR_KEY = "recordOccurance";
     const std::string PREDICT_KEY = "recordPredictions";
     const std::string SYS_TRAJ_KEY = "recordSystemTrajectories";
+    const std::string FORMAT_KEY = "format";
+    const std::string CHUNK_SIZE_KEY = "chunkSize";
 
     // Log Parameters
     const std::string MODULE_NAME = "RecorderComm";
 
     // Format Strings for writing to file
-    const char toeFormatString[] = "pData-%s.Events[%s].TOE (%d), ";
-    const char probFormatString[] = "pData-%s.Events[%s].probMatrix[T+%f], ";
-    const char occFormatString[] = "pData-%s.Events[%s].occurrenceMatrix[T+%f], ";
-    const char sysTrajFormatString[] = "pData-%s.sysTrajectories[%s][T+%f](%d), ";
-    const char dataWithValidityAndTimeSpace[] = "%f (v=%i; t=%li) ";
-    // TODO (JW): duration representations are platform dependant, so %llu is not always correct
+    const char toeFormatString[] = "pData-%s.Events[%s].TOE (%d)";
+    const char probFormatString[] = "pData-%s.Events[%s].probMatrix[T+%f]";
+    const char occFormatString[] = "pData-%s.Events[%s].occurrenceMatrix[T+%f]";
+    const char sysTrajFormatString[] = "pData-%s.sysTrajectories[%s][T+%f](%d)";
+    const char dataWithValidityAndTimeSpace[] = "%f (v=%i; t=%lli) ";
     const char dataWithTime[] = "%f (t=%llu), ";
 
-    static void WriteTime(FILE* theFile) {
+    static void WriteTime(FILE* theFile, unsigned long long msSinceEpoch) {
         // Written by Jason Watkins
         using namespace std::chrono;
 
-        system_clock::time_point now = system_clock::now();
+        system_clock::time_point now = system_clock::time_point(milliseconds(msSinceEpoch));
         std::time_t now_tt = system_clock::to_time_t(now);
         system_clock::time_point now_sec = system_clock::from_time_t(now_tt);
         milliseconds ms = duration_cast<milliseconds>(now - now_sec);
@@ -104,9 +117,63 @@ namespace PCOE {
         std::fprintf(theFile, "%s", ss.str().c_str());
     }
 
+    static std::string FormatName(const char * format, ...) {
+        char name[512];
+        va_list args;
+        va_start(args, format);
+        std::vsnprintf(name, sizeof(name), format, args);
+        va_end(args);
+        return name;
+    }
+
+    // Write a single column of a row
+    static void WriteColumn(FILE* theFile, RecordingColumnKind kind, const double * values,
+                            std::size_t count, bool valid, long long time) {
+        switch (kind) {
+        case RecordingColumnKind::Datum:
+            fprintf(theFile, dataWithTime, count > 0 ? values[0] : NAN,
+                static_cast<unsigned long long>(time));
+            break;
+
+        case RecordingColumnKind::Value:
+            fprintf(theFile, "%f, ", count > 0 ? values[0] : NAN);
+            break;
+
+        case RecordingColumnKind::Samples:
+            // @note(CT): For one character put is more efficient (doesn't have to scan for
+            //      endstring character)
+            fputc('[', theFile);
+            for (std::size_t i = 0; i < count; ++i) {
+                fprintf(theFile, dataWithValidityAndTimeSpace, values[i], static_cast<int>(valid), time);
+            }
+            fprintf(theFile, "], ");
+            break;
+
+        case RecordingColumnKind::Flags:
+        default:
+            fputc('[', theFile);
+            for (std::size_t i = 0; i < count; ++i) {
+                fprintf(theFile, "%s ", values[i] > 0.5 ? "true" : "false");
+            }
+            fprintf(theFile, "], ");
+            break;
+        }
+    }
+
+    static void WriteHeader(FILE* theFile, const std::vector<RecordingColumn> & columns) {
+        fprintf(theFile, "\nTimeStamp, ");
+        for (auto & column : columns) {
+            fprintf(theFile, "%s, ", column.name.c_str());
+        }
+        // Header for timestamp
+        fprintf(theFile, "Running Time\n");
+    }
+
     // --------------------------------------------------------------------------------------------
 
-    RecorderCommunicator::RecorderCommunicator(const ConfigMap & config) : init(false),
+    RecorderCommunicator::RecorderCommunicator(const ConfigMap & config) :
+        CommonCommunicator(config, QueuePolicy::Block),
+        init(false),
         writeOccur(DEFAULT_WRITE_OCCUR),
         writeProbOccur(DEFAULT_WRITE_PROB_OCCUR),
         writePredictions(DEFAULT_WRITE_PREDICTIONS),
@@ -174,13 +241,43 @@ namespace PCOE {
             }
         }
 
+        std::string format = DEFAULT_FORMAT;
+        if (config.includes(FORMAT_KEY)) {
+            format = config.at(FORMAT_KEY)[0];
+            if (format != "csv" && format != "binary") {
+                log.FormatLine(LOG_ERROR, MODULE_NAME, "Unknown format %s", format.c_str());
+                throw std::range_error("Unknown recorder format");
+            }
+            log.FormatLine(LOG_DEBUG, MODULE_NAME, "Configuring to write %s", format.c_str());
+        }
+
+        std::size_t chunkSize = DEFAULT_CHUNK_SIZE;
+        if (config.includes(CHUNK_SIZE_KEY)) {
+            chunkSize = std::stoul(config.at(CHUNK_SIZE_KEY)[0]);
+            log.FormatLine(LOG_DEBUG, MODULE_NAME, "Configuring chunk size to %u", chunkSize);
+        }
+
         // Open File
         log.FormatLine(LOG_INFO, MODULE_NAME,
             "Opening data log file %s", configFile.c_str());
-        theFile = std::fopen(configFile.c_str(), "w");
+        if (format == "binary") {
+            theFile = nullptr;
+            try {
+                recording.reset(new RecordingWriter(configFile, chunkSize));
+            }
+            catch (const std::runtime_error &) {
+                log.FormatLine(LOG_ERROR, MODULE_NAME, "Could not create %s", configFile.c_str());
+                throw;
+            }
+        }
+        else {
+            theFile = std::fopen(configFile.c_str(), "w");
+        }
     }
 
     RecorderCommunicator::~RecorderCommunicator() {
+        // Writes use the file
+        finish();
         if (theFile) {
             // If the file is created, close
             log.WriteLine(LOG_DEBUG, MODULE_NAME, "Closing File");
@@ -193,163 +290,234 @@ namespace PCOE {
         throw std::domain_error("Reading is not supported");
     }
 
-    void RecorderCommunicator::write(AllData dataIn) {
-        
-        DataStore & data = dataIn.doubleDatastore;
-        ProgDataMap & progDataMap = dataIn.progData;
-        if (!init) {
-            log.WriteLine(LOG_DEBUG, MODULE_NAME, "Printing Header");
-
-            // If not initialized- Write Header
-            fprintf(theFile, "\nTimeStamp, ");
-            for (auto & itData : data) {
-                fprintf(theFile, "%s, ", itData.first.c_str());
-            }
+    std::vector<RecordingColumn> RecorderCommunicator::columnsFor(const AllData & dataIn) {
+        std::vector<RecordingColumn> columns;
+        dataKeys.clear();
+        progColumns.clear();
+        for (auto & itData : dataIn.doubleDatastore) {
+            dataKeys.push_back(itData.first);
+            columns.push_back({ RecordingColumnKind::Datum, itData.first });
+        }
 
-            // Header for Prognostic Outputs
-            for (auto & itPD : progDataMap) {
-                const auto progName = itPD.first.c_str();
-                const auto times = itPD.second->getTimes();
-
-                // For each Event
-                for (auto & itEvents : itPD.second->getEventNames()) {
-                    const auto & event = itPD.second->events[itEvents];
-                    const auto eventName = itEvents.c_str();
-                    // timeOfEvent
-                    fprintf(theFile, toeFormatString,
-                        progName, eventName,
-                        static_cast<int>(event.timeOfEvent.uncertainty()));
-
-                    // Probability of Occurrence
-                    if (writeProbOccur) {
-                        if (writePredictions) {
-                            for (auto & theTime : times) {
-                                fprintf(theFile, probFormatString, progName, eventName, theTime);
-                            }
-                        }
-                        else {
-                            fprintf(theFile, probFormatString, progName, eventName, times[0]);
-                        }
+        // Prognostic Outputs
+        for (auto & itPD : dataIn.progData) {
+            const auto progName = itPD.first.c_str();
+            const auto & times = itPD.second->getTimes();
+            ProgColumns prognoser;
+            prognoser.name = itPD.first;
+            prognoser.nTimes = writePredictions ? times.size() : std::min<std::size_t>(1, times.size());
+
+            // For each Event
+            for (auto & itEvents : itPD.second->getEventNames()) {
+                const auto & event = itPD.second->events[itEvents];
+                const auto eventName = itEvents.c_str();
+                prognoser.events.push_back(itEvents);
+                // timeOfEvent
+                columns.push_back({ RecordingColumnKind::Samples, FormatName(toeFormatString,
+                    progName, eventName, static_cast<int>(event.timeOfEvent.uncertainty())) });
+
+                // Probability of Occurrence
+                if (writeProbOccur) {
+                    for (std::size_t theTime = 0; theTime < prognoser.nTimes; theTime++) {
+                        columns.push_back({ RecordingColumnKind::Value,
+                            FormatName(probFormatString, progName, eventName, times[theTime]) });
                     }
+                }
 
-                    // OccurrenceMat (if used)
-                    if (writeOccur) {
-                        if (!event.occurrenceMatrix[NOW].empty()) {
-                            if (writePredictions) {
-                                for (auto & theTime : times) {
-                                    fprintf(theFile, occFormatString, progName, eventName, theTime);
-                                }
-                            }
-                            else {
-                                fprintf(theFile, occFormatString, progName, eventName, times[0]);
-
-                            }
-                        }
+                // OccurrenceMat (if used)
+                bool occurrence = writeOccur && !event.occurrenceMatrix[NOW].empty();
+                prognoser.occurrence.push_back(occurrence);
+                if (occurrence) {
+                    for (std::size_t theTime = 0; theTime < prognoser.nTimes; theTime++) {
+                        columns.push_back({ RecordingColumnKind::Flags,
+                            FormatName(occFormatString, progName, eventName, times[theTime]) });
                     }
-                }  // end for each event
-
-                // For System Trajectories
-                if (writeSysTraj) {
-                    for (auto & itOutputs : itPD.second->getSystemTrajectoryNames()) {
-                        const auto outputName = itOutputs.c_str();
-                        const auto uCert = static_cast<int>(itPD.second->sysTrajectories[itOutputs][0].uncertainty());
-                        if (writePredictions) {
-                            for (auto & theTime : times) {
-                                fprintf(theFile, sysTrajFormatString, progName, outputName, theTime, uCert);
-                            }
-                        }
-                        else {
-                            fprintf(theFile, sysTrajFormatString, progName, outputName, times[0], uCert);
-                        }
-                    }  // end for each output
                 }
-            }
-            // Header for timestamp
-            fprintf(theFile, "Running Time\n");
+            }  // end for each event
 
-            init = true;
-            log.WriteLine(LOG_TRACE, MODULE_NAME, "End Print Header");
+            // For System Trajectories
+            if (writeSysTraj) {
+                for (auto & itOutputs : itPD.second->getSystemTrajectoryNames()) {
+                    const auto outputName = itOutputs.c_str();
+                    const auto uCert = static_cast<int>(itPD.second->sysTrajectories[itOutputs][0].uncertainty());
+                    prognoser.trajectories.push_back(itOutputs);
+                    for (std::size_t theTime = 0; theTime < prognoser.nTimes; theTime++) {
+                        columns.push_back({ RecordingColumnKind::Samples,
+                            FormatName(sysTrajFormatString, progName, outputName, times[theTime], uCert) });
+                    }
+                }  // end for each output
+            }
+            progColumns.push_back(std::move(prognoser));
         }
+        return columns;
+    }
 
-        // Print Data
-        log.WriteLine(LOG_TRACE, MODULE_NAME, "Printing Data Snapshot");
-        WriteTime(theFile);  // Current Time
-
-        // Print Input Data
-        for (auto & itData : data) {
-            fprintf(theFile, dataWithTime, itData.second.get(), itData.second.getTime());
+    void RecorderCommunicator::writeCells(const AllData & dataIn, const CellWriter & writeCell) {
+        auto writeEmpty = [&writeCell](RecordingColumnKind kind) {
+            writeCell(kind, nullptr, 0, false, 0);
+        };
+        auto writeUData = [&writeCell](const UData & value) {
+            writeCell(RecordingColumnKind::Samples, value.data(), value.size(), value.valid(),
+                static_cast<long long>(value.updated().time_since_epoch().count()));
+        };
+
+        // Input Data
+        for (auto & key : dataKeys) {
+            auto it = dataIn.doubleDatastore.find(key);
+            if (it == dataIn.doubleDatastore.end()) {
+                writeEmpty(RecordingColumnKind::Datum);
+                continue;
+            }
+            double value = it->second.get();
+            writeCell(RecordingColumnKind::Datum, &value, 1, true, static_cast<long long>(it->second.getTime()));
         }
 
-        // Print Prognostics Outputs
-        for (auto & itPD : progDataMap) {
-            const auto times = itPD.second->getTimes();
-
-            // Write all only if writePredictions == true
-            const auto nTimes = writePredictions ? times.size() : 1;
+        // Prognostics Outputs. Anything missing from this snapshot is written as empty cells,
+        // so that later columns stay aligned with the header.
+        for (auto & prognoser : progColumns) {
+            auto itPD = dataIn.progData.find(prognoser.name);
+            ProgData * progData = itPD == dataIn.progData.end() ? nullptr : itPD->second;
 
-            // Events
-            for (auto & itEvents : itPD.second->getEventNames()) {
-                const auto & event = itPD.second->events[itEvents];
+            for (std::size_t e = 0; e < prognoser.events.size(); e++) {
+                const ProgEvent * event = nullptr;
+                if (progData != nullptr && progData->events.includes(prognoser.events[e])) {
+                    event = &progData->events[prognoser.events[e]];
+                }
 
                 // timeOfEvent
-                const auto vec = event.timeOfEvent.getVec(0);
-                // @note(CT): For one character put is more efficient (doesn't have to scan for
-                //      endstring character)
-                fputc('[', theFile);
-
-                // Below values do not change inside loop, so there are accessed here for efficiency
-                const auto && timeofEventLastUpdate = event.timeOfEvent.updated();
-                const auto && timeofEventValidity = event.timeOfEvent.valid();
-                for (unsigned long it = 0; it < vec.size(); ++it) {
-                    fprintf(theFile, dataWithValidityAndTimeSpace, vec[it], timeofEventValidity,
-                        timeofEventLastUpdate.time_since_epoch().count());
+                if (event != nullptr) {
+                    writeUData(event->timeOfEvent);
+                }
+                else {
+                    writeEmpty(RecordingColumnKind::Samples);
                 }
-                fprintf(theFile, "], ");
 
                 // Probability of Occurrence
                 if (writeProbOccur) {
-                    for (unsigned int theTime = 0; theTime < nTimes; theTime++) {
-                        fprintf(theFile, "%f, ", event.probMatrix[theTime]);
+                    for (std::size_t theTime = 0; theTime < prognoser.nTimes; theTime++) {
+                        if (event != nullptr && theTime < event->probMatrix.size()) {
+                            writeCell(RecordingColumnKind::Value, &event->probMatrix[theTime], 1, true, 0);
+                        }
+                        else {
+                            writeEmpty(RecordingColumnKind::Value);
+                        }
                     }
                 }
 
                 // OccurrenceMat (if used)
-                if (writeOccur) {
-                    if (!event.occurrenceMatrix[NOW].empty()) {
-                        for (unsigned int theTime = 0; theTime < nTimes; theTime++) {
-                            fputc('[', theFile);
-                            for (const auto & theSample : event.occurrenceMatrix[theTime]) {
-                                fprintf(theFile, "%s ", theSample ? "true" : "false");
-                            }
-                            fprintf(theFile, "], ");
+                if (prognoser.occurrence[e]) {
+                    for (std::size_t theTime = 0; theTime < prognoser.nTimes; theTime++) {
+                        if (event != nullptr && theTime < event->occurrenceMatrix.size()) {
+                            const auto & occurrence = event->occurrenceMatrix[theTime];
+                            flags.assign(occurrence.begin(), occurrence.end());
+                            writeCell(RecordingColumnKind::Flags, flags.data(), flags.size(), true, 0);
+                        }
+                        else {
+                            writeEmpty(RecordingColumnKind::Flags);
                         }
                     }
                 }
             }
 
             // System Trajectories
-            if (writeSysTraj) {
-                for (auto & itOutputs : itPD.second->getSystemTrajectoryNames()) {
-                    for (unsigned int theTime = 0; theTime < nTimes; theTime++) {
-                        const auto vec = itPD.second->sysTrajectories[itOutputs][theTime].getVec(0);
-                        fputc('[', theFile); // for single character fputc is more efficient
-
-                        // Calculate outside of loop for speed
-                        const auto && trajValidity = itPD.second->sysTrajectories[itOutputs][theTime].valid();
-                        const auto && trajLastUpdate = itPD.second->sysTrajectories[itOutputs][theTime].updated();
-                        for (const auto & it : vec) {
-                            fprintf(theFile, dataWithValidityAndTimeSpace, it, trajValidity,
-                                trajLastUpdate.time_since_epoch().count());
-                        }
-                        fprintf(theFile, "], ");
+            for (auto & name : prognoser.trajectories) {
+                DataPoint * trajectory = nullptr;
+                if (progData != nullptr && progData->sysTrajectories.includes(name)) {
+                    trajectory = &progData->sysTrajectories[name];
+                }
+                for (std::size_t theTime = 0; theTime < prognoser.nTimes; theTime++) {
+                    if (trajectory != nullptr && theTime <= trajectory->getNumTimes()) {
+                        writeUData((*trajectory)[theTime]);
+                    }
+                    else {
+                        writeEmpty(RecordingColumnKind::Samples);
                     }
                 }
             }
         }
+    }
+
+    void RecorderCommunicator::write(const AllData & dataIn) {
+        // A failed write is logged and the snapshot skipped, so that recording continues
+        try {
+            if (recording) {
+                writeRecording(dataIn);
+                return;
+            }
+
+            if (!init) {
+                log.WriteLine(LOG_DEBUG, MODULE_NAME, "Printing Header");
+
+                // If not initialized- Write Header
+                WriteHeader(theFile, columnsFor(dataIn));
+
+                init = true;
+                log.WriteLine(LOG_TRACE, MODULE_NAME, "End Print Header");
+            }
+
+            // Print Data
+            log.WriteLine(LOG_TRACE, MODULE_NAME, "Printing Data Snapshot");
+            WriteTime(theFile, millisecondsNow());  // Current Time
+            writeCells(dataIn, [this](RecordingColumnKind kind, const double * values, std::size_t count,
+                                      bool valid, long long time) {
+                WriteColumn(theFile, kind, values, count, valid, time);
+            });
+
+            // Print Timestamp
+            fprintf(theFile, "%llul\n", millisecondsNow());
+            std::fflush(theFile);  // Flush (update file)
+            log.WriteLine(LOG_TRACE, MODULE_NAME, "End Print Line");
+        }
+        catch (const std::exception & e) {
+            log.FormatLine(LOG_ERROR, MODULE_NAME, "Could not record snapshot: %s", e.what());
+        }
+    }
+
+    void RecorderCommunicator::writeRecording(const AllData & dataIn) {
+        if (!recording->hasColumns()) {
+            log.WriteLine(LOG_DEBUG, MODULE_NAME, "Writing recording columns");
+            recording->setColumns(columnsFor(dataIn));
+        }
 
-        // Print Timestamp
-        fprintf(theFile, "%llul\n", millisecondsNow());
-        std::fflush(theFile);  // Flush (update file)
-        log.WriteLine(LOG_TRACE, MODULE_NAME, "End Print Line");
+        recording->beginRow(static_cast<std::int64_t>(millisecondsNow()));
+        try {
+            writeCells(dataIn, [this](RecordingColumnKind, const double * values, std::size_t count,
+                                      bool valid, long long time) {
+                recording->add(values, count, valid, static_cast<std::int64_t>(time));
+            });
+        }
+        catch (...) {
+            // Columns not yet added are left empty, so the next row starts aligned
+            recording->endRow();
+            throw;
+        }
+        recording->endRow();
+    }
+
+    void RecorderCommunicator::convertToCsv(const std::string & recordingFile, const std::string & csvFile) {
+        MappedFile input(recordingFile);
+        if (!input.isOpen()) {
+            throw std::runtime_error("Could not open recording file");
+        }
+        RecordingReader reader(input.data(), input.size());
+        const auto & columns = reader.getColumns();
+
+        std::FILE * output = std::fopen(csvFile.c_str(), "w");
+        if (output == nullptr) {
+            throw std::runtime_error("Could not create csv file");
+        }
+        WriteHeader(output, columns);
+        while (reader.nextChunk()) {
+            for (std::size_t row = 0; row < reader.rows(); row++) {
+                unsigned long long rowTime = static_cast<unsigned long long>(reader.rowTime(row));
+                WriteTime(output, rowTime);
+                for (std::size_t column = 0; column < columns.size(); column++) {
+                    RecordingReader::Cell cell = reader.get(column, row);
+                    WriteColumn(output, columns[column].kind, cell.values, cell.count, cell.valid, cell.time);
+                }
+                fprintf(output, "%llul\n", rowTime);
+            }
+        }
+        std::fclose(output);
     }
 }
@@ -0,0 +1,132 @@
+/**  BoundedQueue - Header
+ *   @class     BoundedQueue BoundedQueue.h
+ *
+ *   @brief     Fixed-capacity, lock-free FIFO queue. Any number of threads may
+ *              push and pop at the same time. Each slot carries a sequence
+ *              number that tells producers and consumers whose turn it is, so
+ *              no operation waits on another thread; a full push or an empty
+ *              pop fails instead.
+ *
+ *   @version   0.1.0
+ *
+ *   @copyright Copyright (c) 2016 United States Government as represented by
+ *     the Administrator of the National Aeronautics and Space Administration.
+ *     All Rights Reserved.
+ */
+
+#ifndef PCOE_BOUNDEDQUEUE_H
+#define PCOE_BOUNDEDQUEUE_H
+
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <utility>
+
+namespace PCOE {
+    template <class T>
+    class BoundedQueue {
+    public:
+        /** @brief      Create an empty queue
+         *  @param      capacity Minimum number of items held. Rounded up to a
+         *              power of two, and at least 2.
+         */
+        explicit BoundedQueue(std::size_t capacity) : cells(), mask(0), enqueuePos(0), dequeuePos(0) {
+            std::size_t size = 2;
+            while (size < capacity) {
+                size *= 2;
+            }
+            cells.reset(new Cell[size]);
+            for (std::size_t i = 0; i < size; i++) {
+                cells[i].sequence.store(i, std::memory_order_relaxed);
+            }
+            mask = size - 1;
+        }
+
+        BoundedQueue(const BoundedQueue &) = delete;
+        BoundedQueue & operator=(const BoundedQueue &) = delete;
+
+        /** @brief      Add an item to the back of the queue
+         *  @param      value Item to add. Moved from only if it was added.
+         *  @return     false if the queue is full
+         */
+        bool tryPush(T && value) {
+            std::size_t pos = enqueuePos.load(std::memory_order_relaxed);
+            for (;;) {
+                Cell & cell = cells[pos & mask];
+                std::size_t sequence = cell.sequence.load(std::memory_order_acquire);
+                if (sequence == pos) {
+                    if (enqueuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                        cell.data = std::move(value);
+                        cell.sequence.store(pos + 1, std::memory_order_release);
+                        return true;
+                    }
+                }
+                else if (sequence < pos) {
+                    // The slot still holds the item from one lap ago
+                    return false;
+                }
+                else {
+                    pos = enqueuePos.load(std::memory_order_relaxed);
+                }
+            }
+        }
+
+        /** @brief      Remove the item at the front of the queue
+         *  @param      value Set to the removed item
+         *  @return     false if the queue is empty
+         */
+        bool tryPop(T & value) {
+            std::size_t pos = dequeuePos.load(std::memory_order_relaxed);
+            for (;;) {
+                Cell & cell = cells[pos & mask];
+                std::size_t sequence = cell.sequence.load(std::memory_order_acquire);
+                if (sequence == pos + 1) {
+                    if (dequeuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                        value = std::move(cell.data);
+                        // Release anything the moved-from item still holds
+                        cell.data = T();
+                        cell.sequence.store(pos + mask + 1, std::memory_order_release);
+                        return true;
+                    }
+                }
+                else if (sequence < pos + 1) {
+                    // The slot has not been filled yet
+                    return false;
+                }
+                else {
+                    pos = dequeuePos.load(std::memory_order_relaxed);
+                }
+            }
+        }
+
+        /// Approximate number of items in the queue
+        std::size_t size() const {
+            std::size_t head = dequeuePos.load(std::memory_order_relaxed);
+            std::size_t tail = enqueuePos.load(std::memory_order_relaxed);
+            return tail > head ? tail - head : 0;
+        }
+
+        /// Maximum number of items in the queue
+        std::size_t capacity() const {
+            return mask + 1;
+        }
+
+    private:
+        struct Cell {
+            std::atomic<std::size_t> sequence;
+            T data;
+        };
+
+        // Keep producer and consumer positions on separate cache lines
+        static const std::size_t CACHE_LINE = 64;
+
+        std::unique_ptr<Cell[]> cells;
+        std::size_t mask;
+        char pad0[CACHE_LINE];
+        std::atomic<std::size_t> enqueuePos;
+        char pad1[CACHE_LINE - sizeof(std::atomic<std::size_t>)];
+        std::atomic<std::size_t> dequeuePos;
+        char pad2[CACHE_LINE - sizeof(std::atomic<std::size_t>)];
+    };
+}
+#endif // PCOE_BOUNDEDQUEUE_H
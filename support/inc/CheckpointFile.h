@@ -0,0 +1,98 @@
+/**  CheckpointFile - Header
+ *   @class     CheckpointFile CheckpointFile.h
+ *
+ *   @brief     Append-only file of binary records, used to checkpoint state.
+ *              Records are appended asynchronously on the shared executor, and
+ *              the latest record is read in constant time, whatever the length
+ *              of the file.
+ *
+ *              Layout (integers in native byte order):
+ *                  File header:    "GSAPHIST", uint32 version, uint32 header size
+ *                  Each record:    uint32 'RECD', uint32 size, uint32 checksum,
+ *                                  payload (size bytes),
+ *                                  uint32 size, uint32 'ENDR'
+ *              The trailer at the end of each record points back to its start,
+ *              so the latest record is found from the end of the file. A record
+ *              left incomplete by a crash is removed when the file is opened.
+ *
+ *              Only the latest records are kept. Once the file holds twice as
+ *              many records as are kept, the latest are written to a temporary
+ *              file that then replaces it, so the file does not grow without
+ *              bound and readers always see a complete file.
+ *
+ *   @version   0.1.0
+ *
+ *   @copyright Copyright (c) 2016 United States Government as represented by
+ *     the Administrator of the National Aeronautics and Space Administration.
+ *     All Rights Reserved.
+ */
+
+#ifndef PCOE_CHECKPOINTFILE_H
+#define PCOE_CHECKPOINTFILE_H
+
+#include <atomic>
+#include <cstdint>
+#include <cstdio>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "Task.h"
+
+namespace PCOE {
+    class CheckpointFile : private Task {
+    public:
+        /// Records kept when no number is given
+        static const std::size_t DEFAULT_MAX_RECORDS = 16;
+
+        /** @brief      Open a checkpoint file, creating it if it does not exist
+         *  @param      path        Path of the file
+         *  @param      maxRecords  Number of the latest records to keep
+         *  @exception  std::runtime_error if the file cannot be opened, or is not
+         *              a checkpoint file
+         *  @exception  std::range_error if maxRecords is zero
+         */
+        explicit CheckpointFile(const std::string & path, std::size_t maxRecords = DEFAULT_MAX_RECORDS);
+
+        /** @brief      Write pending records, then close the file */
+        ~CheckpointFile() override;
+
+        /** @brief      Queue a record to be appended to the file
+         *  @param      record Payload of the record
+         */
+        void append(std::vector<char> record);
+
+        /** @brief      Write pending records on the calling thread, and flush them
+         */
+        void flush();
+
+        /** @brief      Read the latest record in the file, through a memory map
+         *  @param      record Set to the payload of the latest record
+         *  @return     false if the file has no records
+         */
+        bool readLatest(std::vector<char> & record) const;
+
+        /** @brief      Get the path of the file */
+        const std::string & getPath() const { return path; }
+
+        /** @brief      Get the number of records written to the file, up to twice
+         *              the number kept
+         */
+        std::size_t getNumRecords() const { return numRecords; }
+
+    private:
+        void run() override;
+
+        /// Replace the file with one holding only the latest maxRecords records
+        void compact();
+
+        std::string path;
+        const std::size_t maxRecords;
+        std::atomic<std::size_t> numRecords;  ///< Complete records in the file
+        std::FILE * file;
+        std::mutex writeMutex;  ///< Held while writing to file
+        std::mutex pendingMutex;
+        std::vector<std::vector<char>> pending;  ///< Records waiting to be written
+    };
+}
+#endif // PCOE_CHECKPOINTFILE_H
@@ -21,7 +21,10 @@
 #ifndef PCOE_DATAPOINT_H
 #define PCOE_DATAPOINT_H
 
+#include <vector>
+
 #include "ProgMeta.h"
+#include "SampleTensor.h"
 #include "UData.h"
 
 namespace PCOE {
@@ -75,6 +78,32 @@ namespace PCOE {
          **/
         UData & operator[](const std::size_t index);
 
+        /** @brief      Get contiguous storage to write the values of several times at once. Value
+         *              i of time t is at sampleData(...)[t * getSampleStride() + i], and rows start
+         *              on 64 byte boundaries. The written values replace the values of each time
+         *              (as with UData::setVec) when commitSamples is called.
+         *  @param      nTimes      Number of times that will be written, starting at time 0.
+         *                          Every value of these times must be written.
+         *  @param      nValues     Number of values written for each time
+         *  @return     The first value of time 0. Valid until commitSamples, or the next call
+         *              that changes the number of times, points or uncertainty type of the
+         *              data point.
+         *  @exception  std::out_of_range if nTimes is more than the data point holds
+         **/
+        double * sampleData(const std::size_t nTimes, const std::size_t nValues);
+
+        /** @brief      Copy the values written through sampleData into their times. Call this
+         *              from the writing thread once every value has been written; until then
+         *              operator[] returns the previous values of those times. The storage
+         *              returned by sampleData is released, so the values are only held once.
+         **/
+        void commitSamples();
+
+        /** @brief      Get the distance between times in the storage returned by sampleData
+         *  @return     The stride, in values
+         **/
+        std::size_t getSampleStride() const;
+
         /** @brief      Get the number of points considered
          *  @return     The number of points considered
          *
@@ -87,6 +116,12 @@ namespace PCOE {
         /// @brief Data to be stored in datapoint- 2-d: Time x Uncertainty
         std::vector< UData > data;
 
+        /// @brief Values written through sampleData- 2-d: Time x Values. Empty outside of a write.
+        SampleTensor samples;
+
+        /// @brief Number of times, starting at time 0, whose values in samples are newer than in data
+        std::size_t pendingTimes;
+
         UType uType;            ///< Uncertainty Type of the elements in Data (from the UNCERTAINTYTYPE enum)
 
         /** @brief      Set the number of points considered
@@ -36,6 +36,7 @@ namespace PCOE {
         Datum();                    ///< Default Constructor
         Datum(const Datum<T> &);       ///< Copy Constructor
         Datum(const T value);  ///< Build from Value
+        Datum(const T value, time_point tp);  ///< Build from Value and the time it was last edited
 
         /** @brief      Function to copy using =
          *  @example    datum = otherDatum;
@@ -77,6 +78,10 @@ namespace PCOE {
         set(value);
     }
     
+    template <class T>
+    Datum<T>::Datum(const T value, time_point tp) : data(value), lastUpdated(tp) {
+    }
+    
     template <class T>
     Datum<T>::Datum(const Datum<T> & other) {
         data = other.data;
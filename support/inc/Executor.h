@@ -0,0 +1,115 @@
+/** @class     Executor
+ *
+ *  @brief     Process-wide pool of worker threads, sized to the number of
+ *             cores, that runs short tasks. Each worker has its own queue.
+ *             Workers take the newest task from their own queue, and steal
+ *             the oldest task from another worker's queue when theirs is
+ *             empty. Tasks can also be run after a delay.
+ *
+ *  @version   0.1.0
+ *
+ *  @copyright Copyright (c) 2016 United States Government as represented by
+ *    the Administrator of the National Aeronautics and Space Administration.
+ *    All Rights Reserved.
+ */
+
+#ifndef PCOE_EXECUTOR_H
+#define PCOE_EXECUTOR_H
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "Singleton.h"
+
+namespace PCOE {
+    class Executor : public Singleton<Executor> {
+        friend class Singleton<Executor>;
+    public:
+        using Function = std::function<void()>;
+        using clock = std::chrono::steady_clock;
+
+        /** @brief Stops the workers and the timer thread. Tasks that have not
+         *         started are discarded.
+         */
+        ~Executor();
+
+        /** @brief Queue a task to run on a worker. A task submitted from a
+         *         worker goes on that worker's queue.
+         *
+         *  @param fn The task. Exceptions that escape it are logged.
+         */
+        void submit(Function fn);
+
+        /** @brief Run a task after a delay.
+         *
+         *  @param delay Time to wait before running the task.
+         *  @param fn    The task. It runs on the timer thread, and so must be
+         *               short and must not call submitAfter or cancel.
+         *               Usually it submits other work.
+         *  @return      Id of the timer, used to cancel it.
+         */
+        unsigned long submitAfter(std::chrono::milliseconds delay, Function fn);
+
+        /** @brief Cancel a task submitted with @see{submitAfter}. Once this
+         *         returns, the task is not running and will not run.
+         *
+         *  @param id Id returned by @see{submitAfter}.
+         *  @return   Whether the task was cancelled before it ran.
+         */
+        bool cancel(unsigned long id);
+
+        /** @brief Run fn(0), ..., fn(count - 1) as tasks, and wait for them to
+         *         finish. The calling thread runs tasks while it waits, so this
+         *         may be called from a task.
+         *
+         *  @exception Rethrows the exception thrown by the call with the
+         *             smallest index, if any.
+         */
+        void parallelFor(unsigned int count, const std::function<void(unsigned int)> & fn);
+
+        /** Gets the number of worker threads. */
+        unsigned int getNumWorkers() const;
+
+    private:
+        Executor();
+
+        struct Worker {
+            std::mutex m;
+            std::deque<Function> tasks;
+            std::thread thread;
+        };
+
+        /// Take a task from the given worker's queue (newest first), or steal
+        /// one from another (oldest first). self is -1 off the workers.
+        bool takeTask(int self, Function & fn);
+
+        /// Run one queued task, if there is one
+        bool tryRunTask();
+
+        void work(unsigned int index);
+        void runTimers();
+
+        std::vector<std::unique_ptr<Worker>> workers;
+        std::atomic<unsigned int> nextWorker;
+        std::atomic<std::size_t> pending;  ///< Number of queued tasks
+        std::mutex sleepMutex;
+        std::condition_variable sleepCondition;
+        bool stopping;
+
+        std::multimap<clock::time_point, std::pair<unsigned long, Function>> timers;
+        unsigned long nextTimer;
+        std::mutex timerMutex;
+        std::condition_variable timerCondition;
+        std::thread timerThread;
+    };
+}
+#endif // PCOE_EXECUTOR_H
@@ -8,11 +8,16 @@
 #ifndef PCOE_GAUSSIANVARIABLE_H
 #define PCOE_GAUSSIANVARIABLE_H
 
+#include <cstdint>
+
+#include "Random.h"
+
 namespace PCOE {
     class GaussianVariable    // MD: Derive from some abstract class? Common functions would be evaluatepdf/cdf, invertcdf, setparameters, generatesample(s)
     {
     private:
         double mu, sigma; /* mean, standard deviation, variable instance, uniform random variable*/
+        Philox4x32 generator; /* seeded once, when the variable is constructed */
 
     public:
         //double X, U;
@@ -24,6 +29,7 @@ namespace PCOE {
         double evaluatecdf(double); /* variable instance, mean, standard deviation */
         double invertcdfur(double);  /* uniform random variable, mean, standard deviation */
         void setmeanstd(double, double); /* to store the values of mean and standard deviation*/
+        void setseed(std::uint64_t); /* restart the random number stream from a seed, to make samples reproducible */
         void generatesamplesdirect(int); /*generate a particular number of samples using diret c++ random generator*/
         void generatesamplesicdfur(int); /*generate a particular number of samples using cdf inversion*/
     };
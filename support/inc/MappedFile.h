@@ -0,0 +1,53 @@
+/**  MappedFile - Header
+ *   @class     MappedFile MappedFile.h
+ *
+ *   @brief     Read-only view of the contents of a whole file. On POSIX systems
+ *              the file is memory mapped, so only the pages that are used are
+ *              read; elsewhere the file is read into memory.
+ *
+ *   @version   0.1.0
+ *
+ *   @copyright Copyright (c) 2016 United States Government as represented by
+ *     the Administrator of the National Aeronautics and Space Administration.
+ *     All Rights Reserved.
+ */
+
+#ifndef PCOE_MAPPEDFILE_H
+#define PCOE_MAPPEDFILE_H
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+namespace PCOE {
+    class MappedFile {
+    public:
+        /** @brief      Map a file. Check isOpen for success.
+         *  @param      path Path of the file
+         */
+        explicit MappedFile(const std::string & path);
+
+        ~MappedFile();
+
+        MappedFile(const MappedFile &) = delete;
+        MappedFile & operator=(const MappedFile &) = delete;
+
+        /// Whether the file was opened. An empty file is open, with no data.
+        bool isOpen() const { return opened; }
+
+        /// Contents of the file, or nullptr if it is empty or not open
+        const char * data() const { return contents; }
+
+        /// Size of the file in bytes
+        std::size_t size() const { return length; }
+
+    private:
+        bool opened;
+        const char * contents;
+        std::size_t length;
+#ifdef _WIN32
+        std::vector<char> buffer;
+#endif
+    };
+}
+#endif // PCOE_MAPPEDFILE_H
@@ -155,6 +155,29 @@ namespace PCOE {
             return RowVector(data + (m * N));
         }
 
+        /** @brief Gets a pointer to the first element of a row. The elements of
+         *         a row are contiguous, so this allows loops over a row to be
+         *         vectorized.
+         *
+         *  @remarks Does not perform bounds checking.
+         *
+         *  @param m The zero-based row to get.
+         */
+        inline double* rowData(std::size_t m) {
+            return data + (m * N);
+        }
+
+        /** @brief Gets a pointer to the first element of a row of an immutable
+         *         matrix.
+         *
+         *  @remarks Does not perform bounds checking.
+         *
+         *  @param m The zero-based row to get.
+         */
+        inline const double* rowData(std::size_t m) const {
+            return data + (m * N);
+        }
+
         /** @brief Gets an immutable row vector that can be further indexed to get
          *         an element in the matrix.
          *
@@ -445,9 +468,13 @@ namespace PCOE {
         Matrix diagonal() const;
 
         /** @brief Computes the inverse of a square matrix.
+         *
+         *  @remarks Uses an LU decomposition. To solve a linear system, use
+         *           @see{solve} rather than multiplying by the inverse.
          *
          *  @returns A Matrix containing the inverse of the current matrix.
-         *  @exception std::domain_error If the matrix is not square.
+         *  @exception std::domain_error If the matrix is not square or is
+         *             singular.
          */
         Matrix inverse() const;
 
@@ -473,6 +500,19 @@ namespace PCOE {
          */
         Matrix minors() const;
 
+        /** @brief Solves the linear system AX = B, where A is the current
+         *         matrix, using an LU decomposition with partial pivoting.
+         *
+         *  @remarks To solve several systems with the same matrix, factor it
+         *           once with LUDecomposition or CholeskyDecomposition.
+         *
+         *  @param b The right-hand side. May have any number of columns.
+         *  @returns The solution X.
+         *  @exception std::domain_error If the matrix is not square or is
+         *             singular, or if b has the wrong number of rows.
+         */
+        Matrix solve(const Matrix& b) const;
+
         /** @brief Generates a new matrix with the specified row and column removed.
          *
          *  @param m The row to remove.
@@ -489,6 +529,14 @@ namespace PCOE {
          */
         Matrix transpose() const;
 
+        /** @brief Writes the transpose of the current matrix into result. result
+         *         is only resized if it does not have the dimensions of the
+         *         transpose, so a reused result does not allocate.
+         *
+         *  @param result The matrix to hold the transpose.
+         */
+        void transposeInto(Matrix& result) const;
+
         Matrix weightedCovariance(const Matrix& w, const double alpha=1, const double beta=0) const;
 
         Matrix weightedMean(const Matrix& w) const;
@@ -551,6 +599,71 @@ namespace PCOE {
         std::size_t N;
         double* data;
     };
+
+    /** @brief Computes C = alpha*A*B + beta*C in place.
+     *
+     *  @remarks Small products use a simple row-oriented kernel. Larger products
+     *           pack B into narrow column strips and use a cache-blocked kernel
+     *           whose inner loop the compiler vectorizes. Neither kernel
+     *           allocates once the packing buffer of the calling thread has
+     *           grown to the size needed. If beta is zero, C is overwritten.
+     *
+     *  @param alpha Scale factor for A*B.
+     *  @param A     The left-hand matrix.
+     *  @param B     The right-hand matrix.
+     *  @param beta  Scale factor for the initial value of C.
+     *  @param C     The result. Must already have A.rows() rows and B.cols()
+     *               columns, and must not be the same matrix as A or B.
+     *  @exception std::domain_error If the matrix sizes are not compatible or
+     *             C is the same matrix as A or B.
+     */
+    void gemm(double alpha, const Matrix& A, const Matrix& B, double beta, Matrix& C);
+
+    /** @brief Computes the weighted mean of the columns of X, and X with that
+     *         mean subtracted from every column. Does not allocate.
+     *
+     *  @param X    The samples, one per column.
+     *  @param w    The weight of each sample.
+     *  @param mean The weighted mean, X*w. Must already have X.rows() elements.
+     *  @param Xc   The centered samples. Must already be the same size as X,
+     *              and may be the same matrix as X.
+     *  @exception std::domain_error If the sizes are not compatible.
+     */
+    void weightedCenter(const Matrix& X, const std::vector<double>& w,
+                        std::vector<double>& mean, Matrix& Xc);
+
+    /** @brief Computes the weighted covariance C = Xc*diag(w')*Xc' of centered
+     *         samples as a single symmetric rank-k update, where w' is w with
+     *         w0Correction added to the weight of the first sample. Does not
+     *         allocate.
+     *
+     *  @remarks Only the upper triangle is computed. It is then mirrored into
+     *           the lower triangle, so C is exactly symmetric.
+     *
+     *  @param Xc           The centered samples, one per column.
+     *  @param w            The weight of each sample.
+     *  @param w0Correction Added to the weight of the first sample, for
+     *                      example the (1 - alpha^2 + beta) term of a scaled
+     *                      unscented transform.
+     *  @param C            The result. Must already be square with Xc.rows()
+     *                      rows.
+     *  @exception std::domain_error If the sizes are not compatible.
+     */
+    void weightedCovariance(const Matrix& Xc, const std::vector<double>& w,
+                            double w0Correction, Matrix& C);
+
+    /** @brief Computes the weighted cross-covariance C = Xc*diag(w)*Zc' of two
+     *         sets of centered samples. Does not allocate.
+     *
+     *  @param Xc The first centered samples, one per column.
+     *  @param Zc The second centered samples, one per column.
+     *  @param w  The weight of each sample.
+     *  @param C  The result. Must already have Xc.rows() rows and Zc.rows()
+     *            columns.
+     *  @exception std::domain_error If the sizes are not compatible.
+     */
+    void weightedCrossCovariance(const Matrix& Xc, const Matrix& Zc,
+                                 const std::vector<double>& w, Matrix& C);
 }
 
 #endif
\ No newline at end of file
@@ -0,0 +1,143 @@
+/**  @file      MatrixDecomposition.h
+ *
+ *   @brief     Factorizations of square matrices, used to solve linear systems
+ *              without forming an explicit inverse. A factorization is computed
+ *              once and can then be used to solve any number of systems.
+ *
+ *   @version   0.1.0
+ *   @date      2026-10-15
+ *
+ *   @copyright Copyright (c) 2016 United States Government as represented by
+ *              the Administrator of the National Aeronautics and Space
+ *              Administration. All Rights Reserved.
+ */
+
+#ifndef GSAP_MATRIXDECOMPOSITION_H
+#define GSAP_MATRIXDECOMPOSITION_H
+
+#include <cstddef>
+#include <vector>
+
+#include "Matrix.h"
+
+namespace PCOE {
+    /** @brief LU decomposition with partial pivoting, PA = LU, of a square
+     *         matrix.
+     */
+    class LUDecomposition {
+    public:
+        /** @brief Factors a matrix.
+         *
+         *  @param a The matrix to factor.
+         *  @exception std::domain_error If the matrix is not square or is
+         *             singular.
+         */
+        explicit LUDecomposition(const Matrix& a);
+
+        /** @brief Solves AX = B for X.
+         *
+         *  @param b The right-hand side. May have any number of columns.
+         *  @exception std::domain_error If b does not have the same number of
+         *             rows as A.
+         */
+        Matrix solve(const Matrix& b) const;
+
+        /** @brief Calculates the determinant of A. */
+        double determinant() const;
+
+        /** @brief Calculates the inverse of A. */
+        Matrix inverse() const;
+
+    private:
+        Matrix lu;                       // L below the diagonal (unit diagonal implied), U on and above it
+        std::vector<std::size_t> pivot;  // Row of A stored in each row of lu
+        double pivotSign;                // Sign of the row permutation
+    };
+
+    /** @brief Cholesky decomposition, A = LL', of a symmetric positive definite
+     *         matrix.
+     *
+     *  @remarks Only the lower triangle of A is read.
+     */
+    class CholeskyDecomposition {
+    public:
+        /** @brief Creates an empty decomposition, to be filled by @see{factor}. */
+        CholeskyDecomposition() = default;
+
+        /** @brief Factors a matrix.
+         *
+         *  @param a The matrix to factor.
+         *  @exception std::domain_error If the matrix is not square or is not
+         *             positive definite.
+         */
+        explicit CholeskyDecomposition(const Matrix& a);
+
+        /** @brief Factors a matrix, replacing the current factor. Does not
+         *         allocate if the matrix is the same size as the last one.
+         *
+         *  @param a The matrix to factor.
+         *  @exception std::domain_error If the matrix is not square or is not
+         *             positive definite.
+         */
+        void factor(const Matrix& a);
+
+        /** @brief Factors the product AA' without forming it, replacing the
+         *         current factor. L is the transpose of the triangular factor
+         *         of a QR decomposition of A', computed with Householder
+         *         reflections. Does not allocate if A is the same size as the
+         *         last one.
+         *
+         *  @param a A matrix with at least as many columns as rows, whose rows
+         *           are linearly independent.
+         *  @exception std::domain_error If A has more rows than columns or its
+         *             rows are linearly dependent.
+         */
+        void factorProduct(const Matrix& a);
+
+        /** @brief Updates the factor to that of A + xx' in O(n^2) operations.
+         *
+         *  @param x The update vector. Overwritten with scratch values.
+         *  @exception std::domain_error If x does not have one element per
+         *             row of A.
+         */
+        void update(std::vector<double>& x);
+
+        /** @brief Updates the factor to that of A - xx' in O(n^2) operations.
+         *
+         *  @param x The downdate vector. Overwritten with scratch values.
+         *  @exception std::domain_error If x does not have one element per
+         *             row of A, or A - xx' is not positive definite. In the
+         *             latter case the factor is no longer valid.
+         */
+        void downdate(std::vector<double>& x);
+
+        /** @brief Solves AX = B for X using two triangular solves.
+         *
+         *  @param b The right-hand side. May have any number of columns.
+         *  @exception std::domain_error If b does not have the same number of
+         *             rows as A.
+         */
+        Matrix solve(const Matrix& b) const;
+
+        /** @brief Solves AX = B for X into an existing matrix. Does not
+         *         allocate if x is already the same size as b.
+         *
+         *  @param b The right-hand side. May have any number of columns.
+         *  @param x The solution. May be the same matrix as b.
+         *  @exception std::domain_error If b does not have the same number of
+         *             rows as A.
+         */
+        void solve(const Matrix& b, Matrix& x) const;
+
+        /** @brief Gets the lower triangular factor L. */
+        inline const Matrix& lower() const {
+            return l;
+        }
+
+    private:
+        Matrix l;
+        Matrix work;                     // Scratch space for factorProduct
+    };
+}
+
+#endif
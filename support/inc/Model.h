@@ -22,6 +22,8 @@
 
 #include <vector>
 
+#include "Matrix.h"
+
 namespace PCOE {
     class Model {
     protected:
@@ -61,6 +63,35 @@ namespace PCOE {
         virtual void outputEqn(const double t, const std::vector<double> & x,
             const std::vector<double> & u, const std::vector<double> & n,
             std::vector<double> & z) = 0;
+        /** @brief      Execute state equation for a block of samples. This version of the function uses the default sampling time.
+        *               Each column of X, U and N holds one sample, so each row holds one variable for all samples.
+        *   @param      t Time
+        *   @param      X State matrix (numStates x samples). This gets updated to the states at the new time.
+        *   @param      U Input matrix (numInputs x samples)
+        *   @param      N Process noise matrix (numStates x samples)
+        **/
+        void stateEqnBatch(const double t, Matrix & X, const Matrix & U, const Matrix & N);
+        /** @brief      Execute state equation for a block of samples. This version of the function uses a given sampling time.
+        *               The default implementation calls stateEqn once per column. Models should override it
+        *               with a loop over samples that the compiler can vectorize.
+        *   @param      t Time
+        *   @param      X State matrix (numStates x samples). This gets updated to the states at the new time.
+        *   @param      U Input matrix (numInputs x samples)
+        *   @param      N Process noise matrix (numStates x samples)
+        *   @param      dt Sampling time
+        **/
+        virtual void stateEqnBatch(const double t, Matrix & X, const Matrix & U, const Matrix & N,
+            const double dt);
+        /** @brief      Execute output equation for a block of samples.
+        *               The default implementation calls outputEqn once per column.
+        *   @param      t Time
+        *   @param      X State matrix (numStates x samples)
+        *   @param      U Input matrix (numInputs x samples)
+        *   @param      N Sensor noise matrix (numOutputs x samples)
+        *   @param      Z Output matrix (numOutputs x samples). This gets updated to the outputs at the given time.
+        **/
+        virtual void outputEqnBatch(const double t, const Matrix & X, const Matrix & U,
+            const Matrix & N, Matrix & Z);
         /** @brief      Initialize state vector given initial inputs and outputs.
         *   @param      x Current state vector. This gets updated.
         *   @param      u Input vector
@@ -21,12 +21,17 @@
 #ifndef PCOE_MONTECARLOPREDICTOR_H
 #define PCOE_MONTECARLOPREDICTOR_H
 
+#include <cstdint>
 #include <vector>
 #include <string>
 
+#include "Matrix.h"
 #include "Model.h"
+#include "OccurrenceMatrix.h"
 #include "Predictor.h"
 #include "GSAPConfigMap.h"
+#include "SamplePoints.h"
+#include "StatisticalTools.h"
 
 namespace PCOE {
     class MonteCarloPredictor final : public Predictor {
@@ -35,6 +40,74 @@ namespace PCOE {
         std::vector<double> processNoise;  // variance vector (zero-mean assumed)
         std::string event;                 // name of event to predict
         std::vector<double> inputUncertainty;  // uncertainty values associated with inputParameters in model->inputEqn
+        unsigned int numThreads;           // number of executor tasks samples are divided among
+        bool fixedSeed;                    // whether seed was configured (otherwise a new one is drawn for each prediction)
+        std::uint64_t seed;                // key for the per-sample random number streams
+        bool stopAtEvent;                  // whether samples stop being simulated once the event has occurred
+
+        // How the initial state and input parameters of the samples are drawn. Random draws each sample
+        // independently. Antithetic pairs each even sample with the next, which uses the same random numbers
+        // negated (or reflected, for uniform draws), including its process noise. The others place the
+        // samples with SamplePoints and map them through the inverse CDF; process noise is still random.
+        enum class Sampling {
+            Random,
+            Antithetic,
+            LatinHypercube,
+            Halton,
+            Sobol
+        };
+        Sampling sampling;
+
+        std::vector<double> processNoiseSD;    // standard deviation of process noise, one for each state
+
+        // Distribution of the state at the time of prediction. States given as a mean and covariance
+        // are sampled from a normal distribution; states given as weighted samples (e.g., the particles
+        // of a particle filter) are sampled by drawing particles according to their weights.
+        struct StateDistribution {
+            std::vector<double> mean;               // Mean, for a normal distribution
+            Matrix chol;                            // Cholesky factor of the covariance, for a normal distribution
+            Matrix particles;                       // Particles, one per column, for weighted samples
+            std::vector<double> cumulativeWeights;  // Running sum of the particle weights
+        };
+
+        // Where the results of each sample are written. These point directly into the ProgData
+        // storage: sample s at time index t is bit s % 64 of occurrence[t * occurrenceStride + s / 64]
+        // and element trajectories[p][t * trajectoryStride + s] of predicted output p.
+        struct SampleOutputs {
+            OccurrenceMatrix::Word * occurrence;
+            std::size_t occurrenceStride;
+            std::vector<double> toe;
+            std::vector<double *> trajectories;
+            std::size_t trajectoryStride;
+        };
+
+        // Statistics gathered while samples are simulated, so they need not be computed from the samples
+        // afterwards. Each range of samples has its own, and they are merged once all samples are done.
+        struct SampleStatistics {
+            std::vector<std::size_t> occurrences;  // Number of samples in which the event has occurred, per time step
+            RunningStatistics toe;                 // Time of event of the samples in which it occurred
+            Histogram toeHistogram;                // Time of event, one bin per time step
+        };
+
+        /** @brief    Simulate a contiguous range of samples. Results for sample s are
+        *             written only to toe[s], column s of trajectories, and bit s of each
+        *             occurrence row, so ranges can be simulated concurrently. Samples are
+        *             advanced in blocks through the model's batched equations. If
+        *             stopAtEvent is set, a sample stops once its event has occurred.
+        *   @param    tP Time of prediction
+        *   @param    x0 Distribution of the state at time of prediction
+        *   @param    key Seed for the per-sample random number streams
+        *   @param    points Initial state and input parameter draws of each sample, in (0, 1), or
+        *             nullptr to draw them from the random number streams
+        *   @param    first First sample in the range
+        *   @param    last One past the last sample in the range
+        *   @param    numTimes Number of time steps in the prediction
+        *   @param    outputs Where the occurrence, time of event and predicted outputs are written
+        *   @param    statistics Statistics of the range, updated as samples are simulated
+        **/
+        void simulateSamples(const double tP, const StateDistribution & x0,
+            const std::uint64_t key, const SamplePoints * points, const unsigned int first, const unsigned int last,
+            const unsigned int numTimes, SampleOutputs & outputs, SampleStatistics & statistics);
 
     public:
         /** @brief    Constructor for a MonteCarloPredictor based on a configMap
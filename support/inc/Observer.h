@@ -21,12 +21,15 @@
 #ifndef PCOE_OBSERVER_H
 #define PCOE_OBSERVER_H
 
+#include <string>
 #include <vector>
 #include "Model.h"
 #include "UData.h"
 #include "ThreadSafeLog.h"
 
 namespace PCOE {
+    class ConfigMap;
+
     class Observer {
     public:
         Observer() : m_initialized(false), m_t(0), pModel(NULL), log(Log::Instance()) {}
@@ -62,6 +65,17 @@ namespace PCOE {
         bool isInitialized() const;
 
     protected:
+        /** @brief    Read a square matrix, given row by row, from a config map
+         *  @param    configMap  Configuration map holding the matrix
+         *  @param    key        Key of the matrix in configMap
+         *  @param    name       Name of the matrix, for error messages
+         *  @param    moduleName Module to log errors under
+         *  @return   The matrix
+         *  @exception std::domain_error if the number of values is not a square
+         **/
+        Matrix readSquareMatrix(const ConfigMap & configMap, const std::string & key,
+                                const std::string & name, const char * moduleName) const;
+
         bool m_initialized;             // whether or not initialized
         double m_t;                     // time
         std::vector<double> m_uOld;     // inputs at previous time step
@@ -24,7 +24,9 @@
 
 #include "Observer.h"
 #include "Factory.h"
+#include "ParticleFilter.h"
 #include "Singleton.h"
+#include "SquareRootUnscentedKalmanFilter.h"
 #include "UnscentedKalmanFilter.h"
 
 namespace PCOE {
@@ -46,6 +48,8 @@ namespace PCOE {
          **/
         ObserverFactory() {
             Register("UKF", ObserverFactory::Create<UnscentedKalmanFilter>);
+            Register("SRUKF", ObserverFactory::Create<SquareRootUnscentedKalmanFilter>);
+            Register("PF", ObserverFactory::Create<ParticleFilter>);
         }
     };
 }
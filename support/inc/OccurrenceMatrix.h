@@ -0,0 +1,164 @@
+/**  OccurrenceMatrix - Header
+ *   @class     OccurrenceMatrix OccurrenceMatrix.h
+ *
+ *   @brief     Time x sample matrix of booleans, packed 64 to a word in a single
+ *              block. Rows are used like std::vector<bool>, and each row may
+ *              have its own size. Every row has the same capacity in words, so
+ *              sample s of row t is bit s % 64 of words(t)[s / 64].
+ *
+ *   @version   0.1.0
+ *
+ *   @copyright Copyright (c) 2016 United States Government as represented by
+ *     the Administrator of the National Aeronautics and Space Administration.
+ *     All Rights Reserved.
+ */
+
+#ifndef PCOE_OCCURRENCEMATRIX_H
+#define PCOE_OCCURRENCEMATRIX_H
+
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <vector>
+
+namespace PCOE {
+    class OccurrenceMatrix {
+    public:
+        using size_type = std::size_t;
+        using Word = std::uint64_t;
+        static const size_type WORD_BITS = 64;
+
+        /** @brief  Read-only view of one row */
+        class ConstRow {
+        public:
+            class const_iterator {
+            public:
+                using iterator_category = std::forward_iterator_tag;
+                using value_type = bool;
+                using difference_type = std::ptrdiff_t;
+                using pointer = const bool *;
+                using reference = bool;
+
+                const_iterator(const Word * rowWords, size_type sample) : words(rowWords), i(sample) { }
+                bool operator*() const { return ((words[i / WORD_BITS] >> (i % WORD_BITS)) & 1) != 0; }
+                const_iterator & operator++() { i++; return *this; }
+                const_iterator operator++(int) { const_iterator tmp = *this; i++; return tmp; }
+                bool operator==(const const_iterator & other) const { return i == other.i; }
+                bool operator!=(const const_iterator & other) const { return i != other.i; }
+
+            private:
+                const Word * words;
+                size_type i;
+            };
+
+            size_type size() const { return matrix->lengths[index]; }
+            bool empty() const { return size() == 0; }
+
+            /// Get a sample. Not bounds checked, like std::vector<bool>.
+            bool operator[](size_type sample) const {
+                return ((matrix->words(index)[sample / WORD_BITS] >> (sample % WORD_BITS)) & 1) != 0;
+            }
+
+            const_iterator begin() const { return const_iterator(matrix->words(index), 0); }
+            const_iterator end() const { return const_iterator(matrix->words(index), size()); }
+
+            operator std::vector<bool>() const { return std::vector<bool>(begin(), end()); }
+
+            bool operator==(const ConstRow & other) const;
+            bool operator!=(const ConstRow & other) const { return !(*this == other); }
+            bool operator==(const std::vector<bool> & other) const;
+            bool operator!=(const std::vector<bool> & other) const { return !(*this == other); }
+
+        protected:
+            friend class OccurrenceMatrix;
+            ConstRow(const OccurrenceMatrix * source, size_type row)
+                : matrix(const_cast<OccurrenceMatrix *>(source)), index(row) { }
+
+            OccurrenceMatrix * matrix;  ///< Only modified through Row
+            size_type index;
+        };
+
+        /** @brief  View of one row, which can modify it */
+        class Row : public ConstRow {
+        public:
+            /** @brief  Reference to one sample */
+            class reference {
+            public:
+                operator bool() const { return (*word & mask) != 0; }
+                reference & operator=(bool value) {
+                    *word = value ? (*word | mask) : (*word & ~mask);
+                    return *this;
+                }
+                reference & operator=(const reference & other) { return *this = static_cast<bool>(other); }
+
+            private:
+                friend class Row;
+                reference(Word * w, Word m) : word(w), mask(m) { }
+                Word * word;
+                Word mask;
+            };
+
+            using ConstRow::operator[];
+
+            /// Get a sample. Not bounds checked, like std::vector<bool>.
+            reference operator[](size_type sample) {
+                return reference(matrix->words(index) + sample / WORD_BITS, Word(1) << (sample % WORD_BITS));
+            }
+
+            /// Change the size of the row. New samples are false.
+            void resize(size_type samples);
+
+            Row & operator=(const std::vector<bool> & values);
+            Row & operator=(const ConstRow & other) { return *this = static_cast<std::vector<bool>>(other); }
+            Row & operator=(const Row & other) { return *this = static_cast<std::vector<bool>>(other); }
+
+        private:
+            friend class OccurrenceMatrix;
+            Row(OccurrenceMatrix * source, size_type row) : ConstRow(source, row) { }
+        };
+
+        /// Create a matrix with no rows
+        OccurrenceMatrix();
+
+        /// Number of rows
+        size_type size() const { return lengths.size(); }
+        bool empty() const { return lengths.empty(); }
+
+        /** @brief      Change the number of rows
+         *  @param      rows    Number of rows
+         *  @param      samples Size of the rows that are added
+         */
+        void resize(size_type rows, size_type samples = 0);
+
+        /** @brief      Set the size of every row. New samples are false.
+         */
+        void setSamples(size_type samples);
+
+        Row operator[](size_type row) { return Row(this, row); }
+        ConstRow operator[](size_type row) const { return ConstRow(this, row); }
+
+        /** @brief      Packed samples of a row, for direct access. A row holds
+         *              wordStride() words.
+         */
+        Word * words(size_type row) { return bits.data() + row * stride; }
+        const Word * words(size_type row) const { return bits.data() + row * stride; }
+
+        /// Number of words held by each row
+        size_type wordStride() const { return stride; }
+
+        bool operator==(const OccurrenceMatrix & other) const;
+        bool operator!=(const OccurrenceMatrix & other) const { return !(*this == other); }
+
+    private:
+        /// Make every row hold at least samples bits
+        void reserve(size_type samples);
+
+        /// Clear the bits of a row at and above its size
+        void clearTail(size_type row);
+
+        std::vector<Word> bits;
+        std::vector<size_type> lengths;  ///< Size of each row
+        size_type stride;  ///< Words per row
+    };
+}
+#endif // PCOE_OCCURRENCEMATRIX_H
@@ -0,0 +1,152 @@
+/**  ParticleFilter - Header
+*   @file       ParticleFilter.h
+*   @ingroup    GPIC++
+*   @ingroup    Observer
+*
+*   @brief      Particle filter class. Implements sequential importance resampling
+*               state estimation for nonlinear models with non-Gaussian state
+*               distributions. Uses the Model class.
+*
+*   @version    0.1.0
+*
+*   @pre        N/A
+*
+*      Created: October 15, 2026
+*
+*   @copyright Copyright (c) 2016 United States Government as represented by
+*     the Administrator of the National Aeronautics and Space Administration.
+*     All Rights Reserved.
+*/
+
+#ifndef PCOE_PARTICLEFILTER_H
+#define PCOE_PARTICLEFILTER_H
+
+#include <cstdint>
+#include <vector>
+
+#include "Matrix.h"
+#include "MatrixDecomposition.h"
+#include "Observer.h"
+
+namespace PCOE {
+    // Including class prototype to avoid including header
+    class GSAPConfigMap;
+
+    class ParticleFilter final : public Observer {
+    private:
+        std::vector<double> m_xEstimated;
+        std::vector<double> m_zEstimated;
+        Matrix m_Q;
+        Matrix m_R;
+        CholeskyDecomposition m_sqrtQ;      // Lower triangular square root of Q
+        CholeskyDecomposition m_sqrtR;      // Lower triangular square root of R
+        unsigned int m_numParticles;
+        unsigned int m_numThreads;          // number of executor tasks particles are divided among
+        double m_resampleThreshold;         // resample when the effective sample size falls below this fraction
+        bool m_fixedSeed;                   // whether seed was configured (otherwise one is drawn in initialize)
+        std::uint64_t m_seed;               // key for the per-particle random number streams
+        std::uint64_t m_stepCount;          // steps since initialize, used to choose random number streams
+
+        // Particles are stored one per column, so each state is contiguous across particles
+        Matrix m_particles;
+        Matrix m_resampled;                 // Destination of resampling, swapped with m_particles
+        Matrix m_outputs;                   // Output of each particle at the last step
+        std::vector<double> m_weights;      // Normalized weights
+        std::vector<double> m_logLikelihoods;
+
+        // Storage for one block of particles, one per thread
+        struct Workspace {
+            Matrix X;
+            Matrix U;
+            Matrix N;
+            Matrix zeroNoiseZ;
+            Matrix Z;
+            std::vector<double> random;
+            std::vector<double> residual;
+        };
+        std::vector<Workspace> m_work;
+
+        /** @brief Propagate particles [first, last) to newT and compute the log-likelihood
+        *          of z for each. Different ranges may be processed concurrently.
+        **/
+        void propagateParticles(const double newT, const double dt, const std::vector<double> & u,
+            const std::vector<double> & z, const unsigned int first, const unsigned int last,
+            Workspace & work);
+
+        /** @brief Sample initial particles [first, last) from N(x0, Q) */
+        void sampleParticles(const std::vector<double> & x0, const unsigned int first,
+            const unsigned int last);
+
+        /** @brief Run task on contiguous ranges of particles, one range per workspace,
+        *          as tasks on the shared executor
+        **/
+        template <typename Function>
+        void forEachRange(Function task);
+
+        /** @brief Replace the particles using systematic resampling, and reset the weights */
+        void resample();
+
+        /** @brief Compute the weighted mean of the columns of X */
+        void weightedMeanInto(const Matrix & X, std::vector<double> & mean) const;
+
+    public:
+        /** @brief Constructor
+        *   @param m Model pointer
+        *   @param Q Process noise covariance matrix
+        *   @param R Sensor noise covariance matrix
+        *   @param numParticles Number of particles
+        **/
+        ParticleFilter(Model * m, const Matrix Q, const Matrix R, const unsigned int numParticles);
+
+        /** @brief Constructor given a ConfigMap
+        *   @param configMap configuration map specifying parameters (Q, R, numParticles,
+        *          and optionally numThreads, seed and resampleThreshold)
+        **/
+        explicit ParticleFilter(GSAPConfigMap & configMap);
+
+        /** @brief Set model pointer
+        *   @param model given model pointer
+        **/
+        void setModel(Model *model);
+
+        /** @brief Set the number of executor tasks particles are divided among. Takes effect
+        *          at the next call to initialize.
+        *   @param numThreads number of tasks. 0 means one per executor worker.
+        **/
+        void setNumThreads(unsigned int numThreads);
+
+        /** @brief Set the seed of the random number streams, making results reproducible
+        *   @param seed seed value
+        **/
+        void setSeed(std::uint64_t seed);
+
+        /** @brief Initialize the filter, sampling particles from N(x0, Q)
+        *   @param t0 Initial time
+        *   @param x0 Initial state vector
+        *   @param u0 Initial input vector
+        **/
+        void initialize(const double t0, const std::vector<double> & x0,
+            const std::vector<double> & u0);
+
+        /** @brief Estimation step. Propagates and weights the particles, and resamples them
+        *          if the effective sample size is too small.
+        *   @param newT Time value at new step
+        *   @param u Input vector at current time
+        *   @param z Output vector at current time
+        **/
+        void step(const double newT, const std::vector<double> & u,
+            const std::vector<double> & z);
+
+        // Accessors
+        const std::vector<double> & getStateMean() const;
+        const std::vector<double> & getOutputMean() const;
+        /** @brief Get the particles, one per column */
+        const Matrix & getParticles() const;
+        /** @brief Get the normalized weight of each particle */
+        const std::vector<double> & getWeights() const;
+        /** @brief Get the state as weighted samples, one sample per particle */
+        std::vector<UData> getStateEstimate() const;
+    };
+}
+
+#endif // PCOE_PARTICLEFILTER_H
@@ -26,7 +26,9 @@
 #ifndef PCOE_PROGEVENT_H
 #define PCOE_PROGEVENT_H
 
+#include "OccurrenceMatrix.h"
 #include "ProgMeta.h"
+#include "StatisticalTools.h"
 #include "UData.h"
 
 namespace PCOE {
@@ -70,10 +72,22 @@ namespace PCOE {
 
         /** @brief      A two dimentional matrix storing wether the event has occured for each sample. The matrix has the dimensions time x unweighted samples so that:
          *              occurrenceMatrix[0][7]  represents wether the event has occured for sample 7 at time 0.
+         *              Rows are packed bits in one block, and are used like std::vector<bool>.
          *  @see        setNumOccurrenceSamples
          *  @note       probMatrix can be calculated from this
          **/
-        std::vector< std::vector<bool> > occurrenceMatrix;  // 2-dim: Time x samples
+        OccurrenceMatrix occurrenceMatrix;  // 2-dim: Time x samples
+
+        /** @brief      Summary of timeOfEvent, for the samples in which the event occurred within the prediction horizon.
+         *              Filled in by predictors that work with samples, so the samples need not be scanned again.
+         **/
+        RunningStatistics toeStatistics;
+
+        /** @brief      Distribution of timeOfEvent over the prediction times. Bin k holds the samples in which the event
+         *              first occurred at time step k; samples in which it did not occur are counted above the bins.
+         *              Percentiles of timeOfEvent are given by toeHistogram.quantile.
+         **/
+        Histogram toeHistogram;
 
         /** @brief      Set the number of timestamps for which prognostic relevant prognostic data will be recorded
          *  @param      nTimesIn        Number of timestamps
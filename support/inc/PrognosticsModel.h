@@ -21,6 +21,7 @@
 #ifndef PCOE_PROGNOSTICSMODEL_H
 #define PCOE_PROGNOSTICSMODEL_H
 
+#include "Matrix.h"
 #include "Model.h"
 
 #include <vector>
@@ -59,6 +60,32 @@ namespace PCOE {
         virtual void predictedOutputEqn(const double t, const std::vector<double> & x,
             const std::vector<double> & u, std::vector<double> & z) = 0;
 
+        /** @brief      Execute threshold equation for a block of samples (one sample per column).
+        *               The default implementation calls thresholdEqn once per column.
+        *   @param      t Time
+        *   @param      X State matrix (numStates x samples)
+        *   @param      U Input matrix (numInputs x samples)
+        *   @param      occurred Whether the threshold is reached, one for each sample. Gets overwritten.
+        **/
+        virtual void thresholdEqnBatch(const double t, const Matrix & X, const Matrix & U,
+            std::vector<bool> & occurred);
+        /** @brief      Execute input equation for a block of samples (one sample per column).
+        *               The default implementation calls inputEqn once per column.
+        *   @param      t Time
+        *   @param      inputParameters Input parameter matrix (numInputParameters x samples)
+        *   @param      U Input matrix (numInputs x samples). Gets overwritten.
+        **/
+        virtual void inputEqnBatch(const double t, const Matrix & inputParameters, Matrix & U);
+        /** @brief      Execute predicted output equation for a block of samples (one sample per column).
+        *               The default implementation calls predictedOutputEqn once per column.
+        *   @param      t Time
+        *   @param      X State matrix (numStates x samples)
+        *   @param      U Input matrix (numInputs x samples)
+        *   @param      Z Predicted output matrix (numPredictedOutputs x samples). Gets overwritten.
+        **/
+        virtual void predictedOutputEqnBatch(const double t, const Matrix & X, const Matrix & U,
+            Matrix & Z);
+
         inline unsigned int getNumInputParameters() const { return numInputParameters; }
         inline unsigned int getNumPredictedOutputs() const { return numPredictedOutputs; }
     };
@@ -0,0 +1,221 @@
+/**  Random - Header
+ *   @file      Random.h
+ *   @ingroup   GPIC++
+ *   @ingroup   Support
+ *
+ *   @brief     Counter-based random number generation. Every (key, stream)
+ *              pair identifies an independent, reproducible sequence, so a
+ *              sample's random numbers do not depend on which thread draws
+ *              them or in what order. Uniform and normal values can be drawn
+ *              a whole buffer at a time.
+ *
+ *   @version   0.1.0
+ *
+ *   @pre       N/A
+ *
+ *      Created: October 15, 2026
+ *
+ *   @copyright Copyright (c) 2016 United States Government as represented by
+ *     the Administrator of the National Aeronautics and Space Administration.
+ *     All Rights Reserved.
+ */
+
+#ifndef PCOE_RANDOM_H
+#define PCOE_RANDOM_H
+
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+
+namespace PCOE {
+    /** @class      Philox4x32
+     *  @brief      Philox4x32-10 counter-based random number engine
+     *              (Salmon et al., "Parallel Random Numbers: As Easy as 1, 2, 3", SC11).
+     *
+     *  The engine satisfies the UniformRandomBitGenerator requirements, so it
+     *  can be used with the distributions in <random>.
+     *
+     *  @example    Philox4x32 generator(seed, sampleIndex);
+     *              std::vector<double> r(numStates);
+     *              fillNormal(generator, r.data(), r.size());
+     **/
+    class Philox4x32 {
+    public:
+        using result_type = std::uint32_t;
+
+        /** @brief      Construct a generator for a single stream
+         *  @param      key     Seed shared by all streams of a computation
+         *  @param      stream  Index of the stream (e.g., the sample number)
+         **/
+        explicit Philox4x32(const std::uint64_t key, const std::uint64_t stream = 0)
+            : k0(static_cast<std::uint32_t>(key)),
+              k1(static_cast<std::uint32_t>(key >> 32)),
+              s0(static_cast<std::uint32_t>(stream)),
+              s1(static_cast<std::uint32_t>(stream >> 32)),
+              counter(0),
+              block(),
+              index(4) { }
+
+        static constexpr result_type min() {
+            return 0;
+        }
+
+        static constexpr result_type max() {
+            return std::numeric_limits<result_type>::max();
+        }
+
+        /** @brief      Get the next 32-bit value in the stream */
+        inline result_type operator()() {
+            if (index == 4) {
+                generateBlock();
+            }
+            return block[index++];
+        }
+
+        /** @brief      Advance the stream by z values */
+        void discard(unsigned long long z) {
+            while (z > 0 && index < 4) {
+                ++index;
+                --z;
+            }
+            counter += z / 4;
+            if (z % 4 != 0) {
+                generateBlock();
+                index = static_cast<unsigned int>(z % 4);
+            }
+        }
+
+    private:
+        static const std::uint32_t M0 = 0xD2511F53;
+        static const std::uint32_t M1 = 0xCD9E8D57;
+        static const std::uint32_t W0 = 0x9E3779B9;
+        static const std::uint32_t W1 = 0xBB67AE85;
+
+        // Encrypt the current counter block and advance the counter
+        void generateBlock() {
+            std::uint32_t c0 = static_cast<std::uint32_t>(counter);
+            std::uint32_t c1 = static_cast<std::uint32_t>(counter >> 32);
+            std::uint32_t c2 = s0;
+            std::uint32_t c3 = s1;
+            std::uint32_t key0 = k0;
+            std::uint32_t key1 = k1;
+            for (unsigned int round = 0; round < 10; round++) {
+                std::uint64_t p0 = static_cast<std::uint64_t>(M0) * c0;
+                std::uint64_t p1 = static_cast<std::uint64_t>(M1) * c2;
+                std::uint32_t hi0 = static_cast<std::uint32_t>(p0 >> 32);
+                std::uint32_t lo0 = static_cast<std::uint32_t>(p0);
+                std::uint32_t hi1 = static_cast<std::uint32_t>(p1 >> 32);
+                std::uint32_t lo1 = static_cast<std::uint32_t>(p1);
+                c0 = hi1 ^ c1 ^ key0;
+                c1 = lo1;
+                c2 = hi0 ^ c3 ^ key1;
+                c3 = lo0;
+                key0 += W0;
+                key1 += W1;
+            }
+            block[0] = c0;
+            block[1] = c1;
+            block[2] = c2;
+            block[3] = c3;
+            counter++;
+            index = 0;
+        }
+
+        std::uint32_t k0, k1;       // Key
+        std::uint32_t s0, s1;       // Stream (high half of the counter)
+        std::uint64_t counter;      // Block counter (low half of the counter)
+        std::uint32_t block[4];     // Output of the last encrypted block
+        unsigned int index;         // Next unused value in block
+    };
+
+    /** @brief      Inverse of the standard normal cumulative distribution function.
+     *              Acklam's rational approximation (relative error 1.2e-9),
+     *              refined by one step of Halley's method to full double precision.
+     *  @param      p   Probability, in (0, 1)
+     *  @return     x such that P(X <= x) = p for X standard normal. -Inf for
+     *              p = 0, Inf for p = 1, and NaN outside [0, 1].
+     **/
+    inline double inverseNormalCdf(const double p) {
+        static const double a[] = { -3.969683028665376e+01, 2.209460984245205e+02, -2.759285104469687e+02,
+                                    1.383577518672690e+02, -3.066479806614716e+01, 2.506628277459239e+00 };
+        static const double b[] = { -5.447609879822406e+01, 1.615858368580409e+02, -1.556989798598866e+02,
+                                    6.680131188771972e+01, -1.328068155288572e+01 };
+        static const double c[] = { -7.784894002430293e-03, -3.223964580411365e-01, -2.400758277161838e+00,
+                                    -2.549732539343734e+00, 4.374664141464968e+00, 2.938163982698783e+00 };
+        static const double d[] = { 7.784695709041462e-03, 3.224671290700398e-01, 2.445134137142996e+00,
+                                    3.754408661907416e+00 };
+        static const double pLow = 0.02425;
+
+        if (!(p > 0 && p < 1)) {
+            if (p <= 0 && p >= 0) {
+                return -std::numeric_limits<double>::infinity();
+            }
+            if (p <= 1 && p >= 1) {
+                return std::numeric_limits<double>::infinity();
+            }
+            return std::numeric_limits<double>::quiet_NaN();
+        }
+
+        double x;
+        if (p < pLow || p > 1 - pLow) {
+            // Tails
+            double q = std::sqrt(-2 * std::log(p < pLow ? p : 1 - p));
+            x = (((((c[0] * q + c[1]) * q + c[2]) * q + c[3]) * q + c[4]) * q + c[5]) /
+                ((((d[0] * q + d[1]) * q + d[2]) * q + d[3]) * q + 1);
+            if (p > 1 - pLow) {
+                x = -x;
+            }
+        }
+        else {
+            double q = p - 0.5;
+            double r = q * q;
+            x = (((((a[0] * r + a[1]) * r + a[2]) * r + a[3]) * r + a[4]) * r + a[5]) * q /
+                (((((b[0] * r + b[1]) * r + b[2]) * r + b[3]) * r + b[4]) * r + 1);
+        }
+
+        // Halley step. The error of the CDF is computed from whichever tail is
+        // smaller, so it keeps its precision far from the mean.
+        static const double sqrt2 = 1.41421356237309504880;
+        static const double sqrt2Pi = 2.50662827463100050242;
+        double e = x < 0 ? 0.5 * std::erfc(-x / sqrt2) - p : (1 - p) - 0.5 * std::erfc(x / sqrt2);
+        double u = e * sqrt2Pi * std::exp(x * x / 2);
+        return x - u / (1 + x * u / 2);
+    }
+
+    /** @brief      Draw a uniform value from 53 random bits
+     *  @return     A value in the open interval (0, 1)
+     **/
+    inline double uniformOpen(Philox4x32 & generator) {
+        std::uint64_t high = generator() >> 5;
+        std::uint64_t low = generator() >> 6;
+        return (static_cast<double>((high << 26) | low) + 0.5) / 9007199254740992.0;
+    }
+
+    /** @brief      Fill a buffer with uniform values in (0, 1), as uniformOpen
+     *  @param      generator   Stream to draw from
+     *  @param      values      Buffer of at least count values
+     *  @param      count       Number of values to draw
+     **/
+    void fillUniform(Philox4x32 & generator, double * values, std::size_t count);
+
+    /** @brief      Fill a buffer with standard normal values. The uniform draws
+     *              for a chunk of the buffer are made first, and then turned into
+     *              pairs of normals by the Box-Muller transform, so the transform
+     *              runs over whole arrays instead of one draw at a time. An odd
+     *              count discards the last value of the final pair.
+     *  @param      generator   Stream to draw from
+     *  @param      values      Buffer of at least count values
+     *  @param      count       Number of values to draw
+     **/
+    void fillNormal(Philox4x32 & generator, double * values, std::size_t count);
+
+    /** @brief      Apply inverseNormalCdf to a buffer
+     *  @param      p       Probabilities
+     *  @param      x       Output, which may be the same buffer as p
+     *  @param      count   Number of values
+     **/
+    void inverseNormalCdf(const double * p, double * x, std::size_t count);
+}
+
+#endif  // PCOE_RANDOM_H
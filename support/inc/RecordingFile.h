@@ -0,0 +1,175 @@
+/**  RecordingFile - Header
+ *   @file      RecordingFile.h
+ *
+ *   @brief     Binary, columnar recording of data snapshots. Rows are collected
+ *              into chunks, and each chunk stores each column contiguously, so
+ *              whole sample vectors are written and read as single blocks.
+ *
+ *              Layout (integers in native byte order, blocks aligned to 8 bytes):
+ *                  File header:    "GSAPREC\0", uint32 version, uint32 column count
+ *                  Each column:    uint32 kind, uint32 name length,
+ *                                  name, padding
+ *                  Each chunk:     uint32 'CHNK', uint32 row count,
+ *                                  uint64 payload size, then the payload:
+ *                                      int64 row time[rows]
+ *                                      for each column:
+ *                                          uint32 count[rows], padding
+ *                                          uint8 valid[rows], padding
+ *                                          int64 time[rows]
+ *                                          double values[sum of counts]
+ *              A chunk left incomplete by a crash is ignored when reading.
+ *
+ *   @version   0.1.0
+ *
+ *   @copyright Copyright (c) 2016 United States Government as represented by
+ *     the Administrator of the National Aeronautics and Space Administration.
+ *     All Rights Reserved.
+ */
+
+#ifndef PCOE_RECORDINGFILE_H
+#define PCOE_RECORDINGFILE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+namespace PCOE {
+    /** @brief Kind of data held in a recording column. Determines how the
+     *         column is written as text.
+     */
+    enum class RecordingColumnKind : std::uint8_t {
+        Datum = 0,    ///< One value, with the time it was set
+        Value = 1,    ///< One value
+        Samples = 2,  ///< Vector of values, with validity and the time it was updated
+        Flags = 3     ///< Vector of booleans, stored as 0 or 1
+    };
+
+    struct RecordingColumn {
+        RecordingColumnKind kind;
+        std::string name;
+    };
+
+    /** @class  RecordingWriter
+     *  @brief  Writes rows to a recording file. Rows are buffered, and each
+     *          chunk is written with a single write.
+     */
+    class RecordingWriter {
+    public:
+        /** @brief      Create a recording file
+         *  @param      path      Path of the file. Replaced if it exists.
+         *  @param      chunkRows Number of rows in each chunk
+         *  @exception  std::runtime_error if the file cannot be created
+         */
+        RecordingWriter(const std::string & path, std::size_t chunkRows);
+
+        /** @brief      Write buffered rows, then close the file */
+        ~RecordingWriter();
+
+        RecordingWriter(const RecordingWriter &) = delete;
+        RecordingWriter & operator=(const RecordingWriter &) = delete;
+
+        /** @brief      Write the columns. Must be called once, before any rows.
+         */
+        void setColumns(const std::vector<RecordingColumn> & columns);
+
+        /** @brief      Start a row. Each column must then be added in order.
+         *  @param      time Time of the row (ms since epoch)
+         */
+        void beginRow(std::int64_t time);
+
+        /** @brief      Add the next column of the current row
+         *  @param      values  Values of the column
+         *  @param      count   Number of values
+         *  @param      valid   Whether the values are valid
+         *  @param      time    Time the values were set
+         */
+        void add(const double * values, std::size_t count, bool valid, std::int64_t time);
+
+        /** @brief      Finish a row. Writes the chunk once it is full. */
+        void endRow();
+
+        /** @brief      Write buffered rows as a chunk */
+        void flush();
+
+        /// Whether setColumns has been called
+        bool hasColumns() const { return !columns.empty(); }
+
+    private:
+        struct ColumnData {
+            std::vector<std::uint32_t> counts;
+            std::vector<std::uint8_t> valid;
+            std::vector<std::int64_t> times;
+            std::vector<double> values;
+        };
+
+        std::FILE * file;
+        std::size_t chunkRows;
+        std::size_t nextColumn;  ///< Column added next in the current row
+        std::vector<RecordingColumn> columns;
+        std::vector<std::int64_t> rowTimes;
+        std::vector<ColumnData> data;
+        std::vector<char> buffer;  ///< Chunk being written
+    };
+
+    /** @class  RecordingReader
+     *  @brief  Reads a recording from memory, usually a MappedFile. Values are
+     *          read in place.
+     */
+    class RecordingReader {
+    public:
+        /** @brief      Values of one column in one row */
+        struct Cell {
+            const double * values;
+            std::size_t count;
+            bool valid;
+            std::int64_t time;
+        };
+
+        /** @brief      Whether data starts with a recording file header */
+        static bool isRecording(const char * data, std::size_t size);
+
+        /** @brief      Read the header of a recording
+         *  @param      data  Contents of the file. Must outlive the reader, and
+         *              be aligned to 8 bytes.
+         *  @param      size  Size of the file
+         *  @exception  FormatError if the data is not a recording
+         */
+        RecordingReader(const char * data, std::size_t size);
+
+        const std::vector<RecordingColumn> & getColumns() const { return columns; }
+
+        /** @brief      Move to the next chunk
+         *  @return     false if there are no more complete chunks
+         */
+        bool nextChunk();
+
+        /// Number of rows in the current chunk
+        std::size_t rows() const { return rowCount; }
+
+        /// Time of a row in the current chunk (ms since epoch)
+        std::int64_t rowTime(std::size_t row) const;
+
+        /// Values of a column in a row of the current chunk
+        Cell get(std::size_t column, std::size_t row) const;
+
+    private:
+        struct ColumnView {
+            const std::uint32_t * counts;
+            const std::uint8_t * valid;
+            const std::int64_t * times;
+            const double * values;
+            std::vector<std::size_t> offsets;  ///< Index of the first value of each row
+        };
+
+        const char * data;
+        std::size_t size;
+        std::size_t next;  ///< Offset of the next chunk
+        std::size_t rowCount;
+        const std::int64_t * rowTimes;
+        std::vector<RecordingColumn> columns;
+        std::vector<ColumnView> views;
+    };
+}
+#endif // PCOE_RECORDINGFILE_H
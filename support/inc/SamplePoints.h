@@ -0,0 +1,83 @@
+/**  SamplePoints - Header
+ *   @class     SamplePoints SamplePoints.h
+ *
+ *   @brief     A set of points in the unit hypercube that covers it more evenly
+ *              than independent random points, for Monte Carlo integration with
+ *              fewer samples. Points are mapped to other distributions by
+ *              inverse CDF (e.g., inverseNormalCdf in Random.h).
+ *
+ *              Each method is randomized from a key, so that the points are
+ *              unbiased and different keys give independent estimates:
+ *                  LatinHypercube: Each dimension is split into one stratum per
+ *                                  point, and each stratum holds exactly one
+ *                                  point, at a random position. Strata are
+ *                                  paired across dimensions by random
+ *                                  permutations.
+ *                  Halton:         Halton sequence (radical inverses in the
+ *                                  first prime bases), with the digits of
+ *                                  each position scrambled by a random
+ *                                  permutation. Without scrambling, the
+ *                                  large bases of later dimensions are
+ *                                  correlated and no better than random for
+ *                                  a few hundred points.
+ *                  Sobol:          Sobol sequence with Joe and Kuo's direction
+ *                                  numbers, XORed with a random digital shift.
+ *                                  Most even when the number of points is a
+ *                                  power of two.
+ *
+ *   @version   0.1.0
+ *
+ *   @copyright Copyright (c) 2016 United States Government as represented by
+ *     the Administrator of the National Aeronautics and Space Administration.
+ *     All Rights Reserved.
+ */
+
+#ifndef PCOE_SAMPLEPOINTS_H
+#define PCOE_SAMPLEPOINTS_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace PCOE {
+    class SamplePoints {
+    public:
+        enum class Method {
+            LatinHypercube,
+            Halton,
+            Sobol
+        };
+
+        /// Number of dimensions supported by the Sobol method
+        static const std::size_t MAX_SOBOL_DIMENSIONS = 21;
+
+        /** @brief      Generate a set of points
+         *  @param      method      How the points are placed
+         *  @param      dimensions  Number of dimensions of each point
+         *  @param      count       Number of points
+         *  @param      key         Seed for the randomization
+         *  @exception  std::range_error if the method does not support the
+         *              number of dimensions
+         */
+        SamplePoints(Method method, std::size_t dimensions, std::size_t count, std::uint64_t key);
+
+        std::size_t dimensions() const { return nDimensions; }
+        std::size_t size() const { return nPoints; }
+
+        /** @brief      Get a point. Each coordinate is in the open interval (0, 1).
+         *  @param      index   Index of the point, less than size()
+         *  @return     The dimensions() coordinates of the point
+         */
+        const double * operator[](std::size_t index) const { return values.data() + index * nDimensions; }
+
+    private:
+        void generateLatinHypercube(std::uint64_t key);
+        void generateHalton(std::uint64_t key);
+        void generateSobol(std::uint64_t key);
+
+        std::size_t nDimensions;
+        std::size_t nPoints;
+        std::vector<double> values;  ///< Points, one after another
+    };
+}
+#endif // PCOE_SAMPLEPOINTS_H
@@ -0,0 +1,67 @@
+/**  SampleTensor - Header
+ *   @class     SampleTensor SampleTensor.h
+ *
+ *   @brief     Contiguous time x sample array of doubles. Each row starts on a
+ *              64 byte boundary, so element (t, s) is at data()[t * stride() + s]
+ *              and rows can be written through a single strided pointer.
+ *
+ *   @version   0.1.0
+ *
+ *   @copyright Copyright (c) 2016 United States Government as represented by
+ *     the Administrator of the National Aeronautics and Space Administration.
+ *     All Rights Reserved.
+ */
+
+#ifndef PCOE_SAMPLETENSOR_H
+#define PCOE_SAMPLETENSOR_H
+
+#include <cstddef>
+#include <vector>
+
+namespace PCOE {
+    class SampleTensor {
+    public:
+        using size_type = std::size_t;
+
+        /// Create an empty tensor
+        SampleTensor();
+
+        SampleTensor(const SampleTensor & other);
+        SampleTensor & operator=(const SampleTensor & other);
+
+        /** @brief      Change the shape of the tensor. All elements are set to
+         *              NaN.
+         *  @param      rows Number of rows (times)
+         *  @param      cols Number of columns (samples)
+         */
+        void resize(size_type rows, size_type cols);
+
+        /// Remove every row and release the storage
+        void clear();
+
+        /// Number of rows
+        size_type rows() const { return nRows; }
+
+        /// Number of columns
+        size_type cols() const { return nCols; }
+
+        /// Distance between the starts of consecutive rows, in elements
+        size_type stride() const { return rowStride; }
+
+        /// First element of the first row, or nullptr if the tensor is empty
+        double * data() { return nRows == 0 ? nullptr : storage.data() + offset; }
+        const double * data() const { return nRows == 0 ? nullptr : storage.data() + offset; }
+
+        /// First element of a row. The row must be less than rows().
+        double * row(size_type r) { return data() + r * rowStride; }
+        const double * row(size_type r) const { return data() + r * rowStride; }
+
+    private:
+        std::vector<double> storage;
+        size_type offset;  ///< Index of the first aligned element of storage
+        size_type nRows;
+        size_type nCols;
+        size_type rowStride;
+    };
+}
+#endif // PCOE_SAMPLETENSOR_H
@@ -0,0 +1,141 @@
+/**  SquareRootUnscentedKalmanFilter - Header
+*   @file       SquareRootUnscentedKalmanFilter.h
+*   @ingroup    GPIC++
+*   @ingroup    Observer
+*
+*   @brief      Square-root unscented Kalman filter class. Implements the square-root
+*               UKF state estimation algorithm (van der Merwe and Wan, 2001), which
+*               propagates the Cholesky factor of the state covariance instead of the
+*               covariance itself. The covariance it represents is always symmetric
+*               and positive semi-definite, and no factorization of it is needed to
+*               compute sigma points. Uses the Model class.
+*
+*   @version    0.1.0
+*
+*   @pre        N/A
+*
+*      Created: October 15, 2026
+*
+*   @copyright Copyright (c) 2016 United States Government as represented by
+*     the Administrator of the National Aeronautics and Space Administration.
+*     All Rights Reserved.
+*/
+
+#ifndef PCOE_SQUAREROOTUNSCENTEDKALMANFILTER_H
+#define PCOE_SQUAREROOTUNSCENTEDKALMANFILTER_H
+
+#include <vector>
+#include <cmath>
+
+#include "Matrix.h"
+#include "MatrixDecomposition.h"
+#include "Observer.h"
+
+namespace PCOE {
+    // Including class prototype to avoid including header
+    class GSAPConfigMap;
+
+    class SquareRootUnscentedKalmanFilter final : public Observer {
+    private:
+        std::vector<double> m_xEstimated;
+        std::vector<double> m_zEstimated;
+        Matrix m_Q;
+        Matrix m_R;
+        CholeskyDecomposition m_sqrtQ;  // Lower triangular square root of Q
+        CholeskyDecomposition m_sqrtR;  // Lower triangular square root of R
+        CholeskyDecomposition m_S;      // Lower triangular square root of the state covariance
+        double m_kappa = NAN;           // Tuning parameter
+        double m_alpha = NAN;           // Scaling parameter
+        double m_beta = NAN;            // Scaling parameter
+
+        // Sigma points and temporaries used by step, sized once in setModel
+        struct Workspace {
+            Matrix X;                   // Sigma points, propagated in place
+            Matrix Z;                   // Output sigma points
+            Matrix U;                   // Inputs, one column per sigma point
+            Matrix zeroNoiseX;          // Zero process noise, one column per sigma point
+            Matrix zeroNoiseZ;          // Zero sensor noise, one column per sigma point
+            Matrix Xc;                  // Sigma points with the predicted state subtracted
+            Matrix Zc;                  // Output sigma points with the predicted output subtracted
+            Matrix compoundX;           // [sqrt(wc)*Xc, sqrt(Q)], excluding the first sigma point
+            Matrix compoundZ;           // [sqrt(wc)*Zc, sqrt(R)], excluding the first sigma point
+            Matrix Pxz;                 // State-output cross-covariance
+            Matrix PxzT;                // Transpose of Pxz
+            Matrix Kk;                  // Kalman gain
+            Matrix KkT;                 // Transpose of the Kalman gain
+            Matrix KkSz;                // Kk*Sz, whose columns are removed from S
+            CholeskyDecomposition Sz;   // Square root of the output covariance
+            std::vector<double> wm;     // Mean weights
+            std::vector<double> wc;     // Covariance weights
+            std::vector<double> xkk1;
+            std::vector<double> zkk1;
+            std::vector<double> column;
+            std::vector<double> zeroNoiseZVector;
+        } m_work;
+
+        // Add (weight >= 0) or remove (weight < 0) |weight|*v*v' from a factor
+        void rankOneUpdate(CholeskyDecomposition & factor, const Matrix & centered,
+                           std::size_t column, double weight);
+
+    public:
+        /** @brief Constructor
+        *   @param m Model pointer
+        *   @param Q Process noise covariance matrix
+        *   @param R Sensor noise covariance matrix
+        **/
+        SquareRootUnscentedKalmanFilter(Model * m, const Matrix Q, const Matrix R);
+
+        /** @brief Constructor given a ConfigMap
+        *   @param configMap configuration map specifying parameters (Q, R, and
+        *          optionally kappa, alpha and beta)
+        **/
+        explicit SquareRootUnscentedKalmanFilter(GSAPConfigMap & configMap);
+
+        /** @brief Set model pointer
+        *   @param model given model pointer
+        **/
+        void setModel(Model *model);
+
+        /** @brief Set kappa parameter
+         *   @param kappa value of kappa parameter, overrides default
+         **/
+        void setKappa(double kappa);
+
+        /** @brief Set alpha parameter
+         *   @param alpha value of alpha parameter, overrides default
+         **/
+        void setAlpha(double alpha);
+
+        /** @brief Set beta parameter
+         *   @param beta value of beta parameter, overrides default
+         **/
+        void setBeta(double beta);
+
+        /** @brief Initialize the filter, with the state covariance set to Q
+        *   @param t0 Initial time
+        *   @param x0 Initial state vector
+        *   @param u0 Initial input vector
+        **/
+        void initialize(const double t0, const std::vector<double> & x0,
+            const std::vector<double> & u0);
+
+        /** @brief Estimation step. Updates xEstimated, zEstimated and the square root of P.
+        *   @param newT Time value at new step
+        *   @param u Input vector at current time
+        *   @param z Output vector at current time
+        **/
+        void step(const double newT, const std::vector<double> & u,
+            const std::vector<double> & z);
+
+        // Accessors
+        const std::vector<double> & getStateMean() const;
+        const std::vector<double> & getOutputMean() const;
+        /** @brief Get the state covariance, computed from its square root */
+        Matrix getStateCovariance() const;
+        /** @brief Get the lower triangular square root S of the state covariance, P = SS' */
+        const Matrix & getStateCovarianceSqrt() const;
+        std::vector<UData> getStateEstimate() const;
+    };
+}
+
+#endif // PCOE_SQUAREROOTUNSCENTEDKALMANFILTER_H
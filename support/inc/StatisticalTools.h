@@ -6,10 +6,99 @@
 #ifndef PCOE_STATISTICALTOOLS_H
 #define PCOE_STATISTICALTOOLS_H
 
+#include <cstddef>
+#include <vector>
+
 namespace PCOE {
     double calculatemean(double X[], int N);
     double calculatestdv(double X[], int N);
     double calculatecdf(double X[], int N, double Xcritical);
+
+    /** @class  RunningStatistics
+     *  @brief  Mean and variance of a stream of values, updated one value at a
+     *          time (Welford's method). Statistics of separate streams can be
+     *          merged, so each thread can keep its own.
+     */
+    class RunningStatistics {
+    public:
+        RunningStatistics();
+
+        /// Add a value
+        void add(double x);
+
+        /// Add the values of another stream
+        void merge(const RunningStatistics & other);
+
+        std::size_t count() const { return n; }
+
+        /// Mean of the values, or NaN if there are none
+        double mean() const;
+
+        /// Population variance of the values (as calculatestdv), or NaN if there are none
+        double variance() const;
+
+        double stdv() const;
+
+    private:
+        std::size_t n;
+        double m;   ///< Mean
+        double m2;  ///< Sum of squared differences from the mean
+    };
+
+    /** @class  Histogram
+     *  @brief  Counts of values in equal-width bins. Values below the first
+     *          bin or above the last are counted separately. Quantiles are
+     *          found from the counts without keeping the values; they are
+     *          reported as the center of the bin that holds them, so they are
+     *          exact when every value is a bin center (such as the time steps
+     *          of a prediction).
+     */
+    class Histogram {
+    public:
+        /// Create a histogram with no bins
+        Histogram();
+
+        /** @brief  Create a histogram
+         *  @param  lower Lower edge of the first bin
+         *  @param  width Width of each bin
+         *  @param  bins  Number of bins
+         */
+        Histogram(double lower, double width, std::size_t bins);
+
+        /// Add a value. NaN is not counted.
+        void add(double x);
+
+        /// Add the counts of another histogram with the same bins
+        void merge(const Histogram & other);
+
+        std::size_t bins() const { return counts.size(); }
+        std::size_t count(std::size_t bin) const { return counts[bin]; }
+        std::size_t below() const { return underflow; }
+        std::size_t above() const { return overflow; }
+
+        /// Number of values counted, including those outside the bins
+        std::size_t total() const { return n; }
+
+        /// Center of a bin
+        double center(std::size_t bin) const;
+
+        /** @brief  Get the smallest value that at least a fraction p of the
+         *          values are less than or equal to (nearest rank)
+         *  @param  p Fraction, in [0, 1]
+         *  @return The center of the bin holding the quantile. -Inf or Inf if
+         *          it is below or above the bins, and NaN if there are no
+         *          values.
+         */
+        double quantile(double p) const;
+
+    private:
+        double lowerEdge;
+        double binWidth;
+        std::vector<std::size_t> counts;
+        std::size_t underflow;
+        std::size_t overflow;
+        std::size_t n;
+    };
 }
 
 #endif // PCOE_STATISTICALTOOLS_H
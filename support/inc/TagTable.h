@@ -0,0 +1,76 @@
+/**  TagTable - Header
+ *   @class     TagTable TagTable.h
+ *
+ *   @brief     Flat table of tag values, addressed by dense integer handles.
+ *              Each value is published with a sequence lock, so any number of
+ *              threads can read values without taking a lock while one thread
+ *              at a time writes them.
+ *
+ *   @version   0.1.0
+ *
+ *   @copyright Copyright (c) 2016 United States Government as represented by
+ *     the Administrator of the National Aeronautics and Space Administration.
+ *     All Rights Reserved.
+ */
+
+#ifndef PCOE_TAGTABLE_H
+#define PCOE_TAGTABLE_H
+
+#include <atomic>
+#include <cstdint>
+
+#include "Datum.h"
+
+namespace PCOE {
+    class TagTable {
+    public:
+        using Handle = unsigned int;
+
+        /// Number of slots allocated at a time
+        static const Handle BLOCK_SIZE = 1024;
+        /// Maximum number of blocks, so the table holds up to BLOCK_SIZE * MAX_BLOCKS tags
+        static const Handle MAX_BLOCKS = 1024;
+
+        TagTable();
+        ~TagTable();
+
+        TagTable(const TagTable &) = delete;
+        TagTable & operator=(const TagTable &) = delete;
+
+        /** @brief      Add a slot, holding an unset Datum
+         *  @return     Handle of the new slot
+         *  @exception  std::length_error if the table is full
+         *
+         *  Writers (add and set) must be serialized by the caller.
+         **/
+        Handle add();
+
+        /** @brief      Publish a value. Times are stored to the millisecond.
+         *  @param      handle Handle returned by add
+         *  @param      value  New value
+         **/
+        void set(Handle handle, const Datum<double> & value);
+
+        /** @brief      Read a value without locking. Safe to call concurrently
+         *              with writers.
+         *  @param      handle Handle returned by add
+         **/
+        Datum<double> get(Handle handle) const;
+
+        /// Number of slots
+        Handle size() const;
+
+    private:
+        struct Slot {
+            std::atomic<std::uint64_t> sequence;  ///< Odd while the slot is being written
+            std::atomic<double> value;
+            std::atomic<Datum<double>::ms_rep> time;  ///< Milliseconds since epoch
+        };
+
+        const Slot & slot(Handle handle) const;
+
+        std::atomic<Slot *> blocks[MAX_BLOCKS];
+        std::atomic<Handle> count;
+    };
+}
+#endif // PCOE_TAGTABLE_H
@@ -0,0 +1,130 @@
+/** @class     Task
+ *
+ *  @brief     Abstract class for recurring work that runs on the shared
+ *             @see{Executor} instead of owning a thread. It has the same
+ *             states and controls as @see{Thread}. Inheritors provide the
+ *             work done in one cycle, and request cycles with schedule.
+ *             At most one cycle of a task runs at a time.
+ *
+ *  @version   0.1.0
+ *
+ *  @copyright Copyright (c) 2016 United States Government as represented by
+ *    the Administrator of the National Aeronautics and Space Administration.
+ *    All Rights Reserved.
+ */
+
+#ifndef PCOE_TASK_H
+#define PCOE_TASK_H
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <string>
+
+#include "Thread.h"  // For ThreadState
+#include "ThreadSafeLog.h"
+
+namespace PCOE {
+    class Task {
+    public:
+        /** @brief Initializes a new instance of the @see{Task} class that
+         *         uses the default logger.
+         */
+        Task();
+
+        /** Deleted. Scheduled cycles refer to the task. */
+        Task(const Task& other) = delete;
+
+        /** Deleted. Scheduled cycles refer to the task. */
+        Task& operator=(const Task& other) = delete;
+
+        /** @brief Stops the task and waits for a running cycle to finish.
+         *
+         *  @remarks Cycles call virtual methods, so inheritors should stop and
+         *           join the task in their own destructor.
+         */
+        virtual ~Task();
+
+        /** Sets the task state to Enabled.
+         *
+         *  @exception std::domain_error If the task is not in the Created or
+         *                               Enabled state.
+         */
+        virtual void enable();
+
+        /** Sets the task state to Started, and schedules a cycle.
+         *
+         *  @exception std::domain_error If the task is not in the Created,
+         *                               Enabled, Started, or Paused state.
+         */
+        virtual void start();
+
+        /** Sets the task state to Paused.
+         *
+         *  @exception std::domain_error If the task is not in the Enabled,
+         *                               Started, or Paused state.
+         */
+        virtual void pause();
+
+        /** Sets the task state to Stopped, and schedules the call to cleanup.
+         *
+         *  @exception std::domain_error If the task is not in the Enabled,
+         *                               Started, Paused, or Stopped state.
+         */
+        virtual void stop();
+
+        /** Blocks the calling thread until the task is stopped and its last
+         *  cycle has finished, then sets the state to Ended.
+         */
+        void join();
+
+        /** Gets the current state of the task. */
+        ThreadState getState() const;
+
+    protected:
+        /** @brief When overridden in a derived class, does the work of one
+         *         cycle. Called on the executor, only in the Started state.
+         *         An exception thrown by run is logged, and the task stays
+         *         started, so the cycles that are requested later still run.
+         */
+        virtual void run() = 0;
+
+        /** @brief When overridden in a derived class, cleans up after the task
+         *         is stopped. Called once, on the executor.
+         */
+        virtual void cleanup() {}
+
+        /** @brief Request a cycle. If a cycle is already scheduled or running,
+         *         one more cycle runs after it.
+         */
+        void schedule();
+
+        /** @brief Request a cycle after a delay, unless one is already pending.
+         *
+         *  @param delay Time to wait before scheduling the cycle.
+         */
+        void scheduleAfter(std::chrono::milliseconds delay);
+
+        Log log; /**< The log file used to log information about the task. */
+        std::string moduleName; /**< The name of the module that owns the task. */
+
+    private:
+        void execute();
+        void cancelTimer();
+
+        using mutex = std::mutex;
+        using lock_guard = std::lock_guard<mutex>;
+        using unique_lock = std::unique_lock<mutex>;
+        mutex m;
+        std::condition_variable idle;
+        std::atomic<ThreadState> state;
+        bool scheduled;  ///< A cycle is queued or running
+        bool rescheduled;  ///< Another cycle was requested while one was scheduled
+        bool cleanedUp;
+        bool timerPending;  ///< A delayed cycle has been requested
+        bool timerValid;  ///< timer holds the id of the pending delayed cycle
+        unsigned long timer;
+    };
+}
+#endif // PCOE_TASK_H
@@ -17,6 +17,11 @@
  *                  logger.FormatLine(LOG_WARNING, "ClassName", "Key %s not recognized. Did you mean %s? Ignoring key", key, otherKey);
  *                  logger.LogVerbatim("Some text");
  *
+ *              Lines can instead be written by a background thread, so that logging costs the caller
+ *              little more than a copy of the message:
+ *                  Log::SetAsync(true);
+ *              Pending lines can then be written out with Log::Flush().
+ *
  *              At the end of use the log can be closed using the following:
  *                  logger.close();
  *
@@ -53,6 +58,9 @@
 // |             Header Files             |
 // *--------------------------------------*
 
+#include <chrono>
+#include <cstdarg>
+#include <cstdio>
 #include <memory>
 #include <mutex>
 #include <string>
@@ -82,6 +90,33 @@ namespace PCOE {
 
     extern LOG_VERBOSITY LOG_LEVEL;
 
+    // PCOE_LOG_MAX_LEVEL is the most verbose level compiled in (set with the
+    // GSAP_LOG_MAX_LEVEL CMake option). Lines logged through PCOE_LOG_LINE and
+    // PCOE_LOG_FORMAT above it are removed by the compiler, and their arguments
+    // are only evaluated when the line passes the runtime level.
+#ifndef PCOE_LOG_MAX_LEVEL
+#define PCOE_LOG_MAX_LEVEL LOG_TRACE
+#endif
+
+#define PCOE_LOG_ENABLED(level) \
+    ((level) <= ::PCOE::PCOE_LOG_MAX_LEVEL && (level) <= ::PCOE::LOG_LEVEL)
+
+    /// Calls log.WriteLine(level, tag, value) if the level is enabled
+#define PCOE_LOG_LINE(log, level, tag, value) \
+    do { \
+        if (PCOE_LOG_ENABLED(level)) { \
+            (log).WriteLine((level), (tag), (value)); \
+        } \
+    } while (false)
+
+    /// Calls log.FormatLine(level, tag, format, ...) if the level is enabled
+#define PCOE_LOG_FORMAT(log, level, tag, ...) \
+    do { \
+        if (PCOE_LOG_ENABLED(level)) { \
+            (log).FormatLine((level), (tag), __VA_ARGS__); \
+        } \
+    } while (false)
+
     // *--------------------------------------*
     // |              Log Class               |
     // *--------------------------------------*
@@ -142,6 +177,24 @@ namespace PCOE {
         **/
         static void SetVerbosity(const LOG_VERBOSITY verbosity);
 
+        /**
+         *  @brief  Set whether lines from every log are written asynchronously. When
+         *          enabled, WriteLine and FormatLine copy the message into a lock-free
+         *          buffer owned by the calling thread and return. A background thread
+         *          formats the buffered lines and writes them in batches, flushing
+         *          every flushInterval, and as soon as an ERROR or FATAL line is logged.
+         *  @param  enabled         Whether lines are written asynchronously
+         *  @param  flushInterval   Longest time a line waits to be written
+         **/
+        static void SetAsync(bool enabled,
+            std::chrono::milliseconds flushInterval = std::chrono::milliseconds(100));
+
+        /**
+         *  @brief  Blocks until lines logged asynchronously before the call are written
+         *          and flushed
+         **/
+        static void Flush();
+
         /**
          *  @brief  Writes a formatted header to the log
          *  @param  programName     The name of the program writing to the log (or some other identifying name)
@@ -173,6 +226,12 @@ namespace PCOE {
          **/
         void FormatLine(const LOG_VERBOSITY level, const std::string& tag, const std::string format, ...) const;
 
+        /**
+         *  @brief  Same as FormatLine above, for a tag and format that are already
+         *          C strings (such as literals), so that no string is built.
+         **/
+        void FormatLine(const LOG_VERBOSITY level, const char* tag, const char* format, ...) const;
+
         /** @brief  Writes the specified string value, followed by a line terminator
          *          to the log file.
          *
@@ -182,6 +241,11 @@ namespace PCOE {
          **/
         void WriteLine(const LOG_VERBOSITY level, const std::string& tag, const std::string& value) const;
 
+        /** @brief  Same as WriteLine above, for C strings (such as literals), so that
+         *          no string is built.
+         **/
+        void WriteLine(const LOG_VERBOSITY level, const char* tag, const char* value) const;
+
         /**
          *  @brief  Log text verbatim (without changing anything) to the file
          *  @param  text            The text to be logged
@@ -189,6 +253,8 @@ namespace PCOE {
         void LogVerbatim(const std::string & text) const;
 
     private:
+        void VFormatLine(const LOG_VERBOSITY level, const char* tag, const char* format, va_list args) const;
+
         std::shared_ptr<std::FILE> fd;
         mutable std::shared_ptr<std::mutex> m;
     };
@@ -178,6 +178,14 @@ namespace PCOE {
             return m_data.size();
         }
 
+        /** @brief Gets the data vector's storage, in the layout of the
+         *         uncertainty type. Typed access is provided by the views in
+         *         UDataViews.h.
+         **/
+        inline const double* data() const noexcept {
+            return m_data.data();
+        }
+
         /** @brief Set the type of uncertainty to be used. */
         void uncertainty(const UType value);
 
@@ -370,6 +378,17 @@ namespace PCOE {
          **/
         std::vector<double> getVec(const size_type key = 0) const;
 
+        /** @brief Get values in the current object's data without
+         *         allocating.
+         *
+         *  @param key    The index of the first data element to get.
+         *  @param values Buffer the values are written to.
+         *  @param count  The size of the buffer.
+         *  @returns      The number of values written, which is less than
+         *                count if the data ends first.
+         **/
+        size_type getVec(const size_type key, double* values, const size_type count) const;
+
         /** @brief Set values in the current object's data.
          *
          *  @param key   The index of the first elmeent to set. Should be a
@@ -379,6 +398,16 @@ namespace PCOE {
          **/
         void setVec(const size_type key, const std::vector<double>& value);
 
+        /** @brief Set values in the current object's data from an array,
+         *         without copying it into a vector first. Values past the
+         *         end of the data are ignored, as with setVec(key, value).
+         *
+         *  @param key    The index of the first elmeent to set.
+         *  @param values The values to set.
+         *  @param count  The number of values.
+         **/
+        void setVec(const size_type key, const double* values, const size_type count);
+
         /** @brief Set values in the current object's data, starting at the
          *         first value.
          *
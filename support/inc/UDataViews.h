@@ -0,0 +1,150 @@
+/**  UData Views- Header
+ *   @file      Typed views of Uncertain Data
+ *   @ingroup   GPIC++
+ *   @ingroup   ProgData
+ *   @ingroup   UData
+ *
+ *   @brief     Read-only views of the data of a UData object, one for each
+ *              uncertainty type. The uncertainty type is checked once, when the
+ *              view is created; after that the layout is known at compile time,
+ *              so access is inlined instead of going through UDataInterface, and
+ *              vectors are returned as spans over the UData's storage rather
+ *              than as copies.
+ *
+ *              A view is valid until the UData is destroyed, or its number of
+ *              points or uncertainty type is changed.
+ *
+ *   @example   SamplesView samples(ud);
+ *              for (double x : samples.samples()) { ... }
+ *
+ *   @version   0.1.0
+ *
+ *   @copyright Copyright (c) 2016 United States Government as represented by
+ *     the Administrator of the National Aeronautics and Space Administration.
+ *     All Rights Reserved.
+ **/
+
+#ifndef PCOE_UDATAVIEWS_H
+#define PCOE_UDATAVIEWS_H
+
+#include <cstddef>
+#include <stdexcept>
+
+#include "UData.h"
+
+namespace PCOE {
+    /** @class      Span
+     *  @brief      A contiguous range of values owned by another object
+     **/
+    template <class T>
+    class Span {
+    public:
+        using size_type = std::size_t;
+        using iterator = T *;
+
+        Span() : first(nullptr), count(0) { }
+        Span(T * data, size_type size) : first(data), count(size) { }
+
+        inline T * data() const { return first; }
+        inline size_type size() const { return count; }
+        inline bool empty() const { return count == 0; }
+        inline T & operator[](size_type i) const { return first[i]; }
+        inline iterator begin() const { return first; }
+        inline iterator end() const { return first + count; }
+
+    private:
+        T * first;
+        size_type count;
+    };
+
+    /** @class      UDataView
+     *  @brief      Base of the typed views. Checks the uncertainty type.
+     **/
+    template <UType Type>
+    class UDataView {
+    public:
+        using size_type = UData::size_type;
+
+        /** @brief      Create a view of a UData object
+         *  @param      source  The object to view
+         *  @exception  std::invalid_argument if the uncertainty type of source
+         *              does not match the view
+         **/
+        explicit UDataView(const UData & source) : values(source.data()), count(source.size()) {
+            if (source.uncertainty() != Type) {
+                throw std::invalid_argument("UData: uncertainty type does not match view");
+            }
+        }
+
+        /// All values, in the layout of the uncertainty type
+        inline Span<const double> all() const { return Span<const double>(values, count); }
+
+    protected:
+        const double * values;
+        size_type count;
+    };
+
+    /** @class      PointView
+     *  @brief      View of UType::Point data: [Value]
+     **/
+    class PointView : public UDataView<UType::Point> {
+    public:
+        explicit PointView(const UData & source) : UDataView(source) { }
+
+        inline double value() const { return values[VALUE]; }
+    };
+
+    /** @class      MeanSDView
+     *  @brief      View of UType::MeanSD data: [Mean, SD]
+     **/
+    class MeanSDView : public UDataView<UType::MeanSD> {
+    public:
+        explicit MeanSDView(const UData & source) : UDataView(source) { }
+
+        inline double mean() const { return values[MEAN]; }
+        inline double sd() const { return values[SD]; }
+    };
+
+    /** @class      MeanCovarView
+     *  @brief      View of UType::MeanCovar data: [Mean, COVAR(0), COVAR(1), ...]
+     **/
+    class MeanCovarView : public UDataView<UType::MeanCovar> {
+    public:
+        explicit MeanCovarView(const UData & source) : UDataView(source) { }
+
+        inline double mean() const { return values[MEAN]; }
+
+        /// Covariance with point i
+        inline double covar(size_type i) const { return values[COVAR(i)]; }
+
+        /// Row of the covariance matrix
+        inline Span<const double> covar() const { return Span<const double>(values + COVAR(0), count - COVAR(0)); }
+    };
+
+    /** @class      SamplesView
+     *  @brief      View of UType::Samples data: [Sample 0, Sample 1, ...]
+     **/
+    class SamplesView : public UDataView<UType::Samples> {
+    public:
+        explicit SamplesView(const UData & source) : UDataView(source) { }
+
+        inline size_type size() const { return count; }
+        inline double operator[](size_type i) const { return values[i]; }
+        inline Span<const double> samples() const { return all(); }
+    };
+
+    /** @class      WSamplesView
+     *  @brief      View of UType::WSamples data: [SAMPLE(0), WEIGHT(0), SAMPLE(1), ...]
+     **/
+    class WSamplesView : public UDataView<UType::WSamples> {
+    public:
+        explicit WSamplesView(const UData & source) : UDataView(source) { }
+
+        /// Number of weighted samples
+        inline size_type size() const { return count / 2; }
+        inline double sample(size_type i) const { return values[SAMPLE(i)]; }
+        inline double weight(size_type i) const { return values[WEIGHT(i)]; }
+    };
+}
+
+#endif // PCOE_UDATAVIEWS_H
@@ -26,6 +26,7 @@
 #include <cmath>
 
 #include "Matrix.h"
+#include "MatrixDecomposition.h"
 #include "Observer.h"
 
 namespace PCOE {
@@ -49,6 +50,31 @@ namespace PCOE {
         Matrix m_P;
         struct sigmaPoints m_sigmaX;
 
+        // Temporaries used by step, sized once in setModel so that stepping
+        // does not allocate
+        struct Workspace {
+            Matrix Xkk1;            // Propagated state sigma points
+            Matrix Zkk1;            // Propagated output sigma points
+            Matrix Xc;              // Xkk1 with the predicted state subtracted
+            Matrix Zc;              // Zkk1 with the predicted output subtracted
+            Matrix U;               // Inputs, one column per sigma point
+            Matrix zeroNoiseX;      // Zero process noise, one column per sigma point
+            Matrix zeroNoiseZ;      // Zero sensor noise, one column per sigma point
+            Matrix Pkk1;            // Predicted state covariance
+            Matrix Pzz;             // Predicted output covariance
+            Matrix Pxz;             // State-output cross-covariance
+            Matrix PxzT;            // Transpose of Pxz
+            Matrix Kk;              // Kalman gain
+            Matrix KkT;             // Transpose of the Kalman gain
+            Matrix KkPzz;           // Kk*Pzz
+            Matrix scaledP;         // Covariance scaled for sigma point computation
+            CholeskyDecomposition cholP;
+            CholeskyDecomposition cholPzz;
+            std::vector<double> xkk1;
+            std::vector<double> zkk1;
+            std::vector<double> zeroNoiseZVector;
+        } m_work;
+
     public:
         /** @brief Constructor
         *   @param m Model pointer
@@ -0,0 +1,285 @@
+// Copyright (c) 2016 United States Government as represented by
+// the Administrator of the National Aeronautics and Space Administration.
+// All Rights Reserved.
+
+#include <cstring>
+#include <stdexcept>
+#include <utility>
+
+#ifdef _WIN32
+#include <io.h>
+#else
+#include <unistd.h>
+#endif
+
+#include "CheckpointFile.h"
+#include "MappedFile.h"
+
+namespace PCOE {
+    const std::string MODULE_NAME = "CheckpointFile";
+
+    const std::size_t CheckpointFile::DEFAULT_MAX_RECORDS;
+
+    static const char FILE_MAGIC[8] = { 'G', 'S', 'A', 'P', 'H', 'I', 'S', 'T' };
+    static const std::uint32_t VERSION = 1;
+    static const std::uint32_t FILE_HEADER_SIZE = 16;
+    static const std::uint32_t RECORD_MAGIC = 0x52454344;  // RECD
+    static const std::uint32_t TRAILER_MAGIC = 0x454E4452;  // ENDR
+    static const std::uint64_t RECORD_HEADER_SIZE = 12;
+    static const std::uint64_t RECORD_TRAILER_SIZE = 8;
+
+    namespace {
+        /// FNV-1a hash of the payload, to detect torn or corrupt records
+        std::uint32_t checksum(const char * data, std::size_t size) {
+            std::uint32_t hash = 2166136261u;
+            for (std::size_t i = 0; i < size; i++) {
+                hash ^= static_cast<unsigned char>(data[i]);
+                hash *= 16777619u;
+            }
+            return hash;
+        }
+
+        std::uint32_t readUint32(const char * data) {
+            std::uint32_t value;
+            std::memcpy(&value, data, sizeof(value));
+            return value;
+        }
+
+        /// Check for a complete record at offset, and get its payload size
+        bool validRecord(const MappedFile & view, std::uint64_t offset, std::uint32_t & size) {
+            if (offset + RECORD_HEADER_SIZE + RECORD_TRAILER_SIZE > view.size()) {
+                return false;
+            }
+            const char * header = view.data() + offset;
+            size = readUint32(header + 4);
+            std::uint64_t end = offset + RECORD_HEADER_SIZE + size + RECORD_TRAILER_SIZE;
+            if (readUint32(header) != RECORD_MAGIC || end > view.size()) {
+                return false;
+            }
+            const char * payload = header + RECORD_HEADER_SIZE;
+            const char * trailer = payload + size;
+            return readUint32(trailer) == size && readUint32(trailer + 4) == TRAILER_MAGIC &&
+                readUint32(header + 8) == checksum(payload, size);
+        }
+
+        /// Get the offsets of the complete records, in order
+        void findRecords(const MappedFile & view, std::vector<std::uint64_t> & offsets) {
+            std::uint64_t position = FILE_HEADER_SIZE;
+            std::uint32_t size;
+            while (validRecord(view, position, size)) {
+                offsets.push_back(position);
+                position += RECORD_HEADER_SIZE + size + RECORD_TRAILER_SIZE;
+            }
+        }
+
+        void writeFileHeader(std::FILE * file) {
+            std::uint32_t header[2] = { VERSION, FILE_HEADER_SIZE };
+            std::fwrite(FILE_MAGIC, 1, sizeof(FILE_MAGIC), file);
+            std::fwrite(header, sizeof(header[0]), 2, file);
+        }
+
+        /// Find the latest complete record
+        bool findLatest(const MappedFile & view, std::uint64_t & offset, std::uint32_t & size) {
+            if (view.size() < FILE_HEADER_SIZE + RECORD_HEADER_SIZE + RECORD_TRAILER_SIZE) {
+                return false;
+            }
+
+            // Usually the last record is complete, and its trailer gives its start
+            const char * trailer = view.data() + view.size() - RECORD_TRAILER_SIZE;
+            std::uint64_t length = RECORD_HEADER_SIZE + readUint32(trailer) + RECORD_TRAILER_SIZE;
+            if (readUint32(trailer + 4) == TRAILER_MAGIC && length <= view.size() - FILE_HEADER_SIZE) {
+                offset = view.size() - length;
+                if (validRecord(view, offset, size)) {
+                    return true;
+                }
+            }
+
+            // Otherwise, walk the records from the start
+            bool found = false;
+            std::uint64_t position = FILE_HEADER_SIZE;
+            std::uint32_t recordSize;
+            while (validRecord(view, position, recordSize)) {
+                offset = position;
+                size = recordSize;
+                found = true;
+                position += RECORD_HEADER_SIZE + recordSize + RECORD_TRAILER_SIZE;
+            }
+            return found;
+        }
+    }
+
+    CheckpointFile::CheckpointFile(const std::string & filePath, std::size_t maxRecordsIn)
+        : path(filePath), maxRecords(maxRecordsIn), numRecords(0), file(nullptr) {
+        moduleName = MODULE_NAME;
+        if (maxRecords == 0) {
+            log.WriteLine(LOG_ERROR, MODULE_NAME, "At least one record must be kept");
+            throw std::range_error("At least one record must be kept");
+        }
+
+        std::uint64_t validEnd = FILE_HEADER_SIZE;
+        std::size_t size = 0;
+        {
+            MappedFile view(path);
+            size = view.size();
+            if (size > 0) {
+                if (size < FILE_HEADER_SIZE || std::memcmp(view.data(), FILE_MAGIC, sizeof(FILE_MAGIC)) != 0 ||
+                    readUint32(view.data() + 8) != VERSION) {
+                    log.FormatLine(LOG_ERROR, MODULE_NAME, "%s is not a checkpoint file", path.c_str());
+                    throw std::runtime_error("Not a checkpoint file");
+                }
+                std::uint64_t offset;
+                std::uint32_t recordSize;
+                if (findLatest(view, offset, recordSize)) {
+                    validEnd = offset + RECORD_HEADER_SIZE + recordSize + RECORD_TRAILER_SIZE;
+                }
+                // The file holds at most twice the records kept, so counting them takes bounded time
+                std::vector<std::uint64_t> offsets;
+                findRecords(view, offsets);
+                numRecords = offsets.size();
+            }
+        }
+
+        file = std::fopen(path.c_str(), size > 0 ? "r+b" : "w+b");
+        if (file == nullptr) {
+            log.FormatLine(LOG_ERROR, MODULE_NAME, "Could not open %s", path.c_str());
+            throw std::runtime_error("Could not open checkpoint file");
+        }
+
+        if (size == 0) {
+            writeFileHeader(file);
+            std::fflush(file);
+        }
+        else if (validEnd < size) {
+            // Drop the incomplete record left by an interrupted write
+            log.FormatLine(LOG_WARN, MODULE_NAME, "Removing incomplete record from %s", path.c_str());
+#ifdef _WIN32
+            _chsize_s(_fileno(file), static_cast<long long>(validEnd));
+#else
+            if (ftruncate(fileno(file), static_cast<off_t>(validEnd)) != 0) {
+                log.FormatLine(LOG_WARN, MODULE_NAME, "Could not truncate %s", path.c_str());
+            }
+#endif
+        }
+        std::fseek(file, 0, SEEK_END);
+        if (numRecords >= 2 * maxRecords) {
+            compact();
+        }
+        start();
+    }
+
+    CheckpointFile::~CheckpointFile() {
+        flush();
+        stop();
+        join();
+        if (file != nullptr) {
+            std::fclose(file);
+        }
+    }
+
+    void CheckpointFile::append(std::vector<char> record) {
+        {
+            std::lock_guard<std::mutex> guard(pendingMutex);
+            pending.push_back(std::move(record));
+        }
+        schedule();
+    }
+
+    void CheckpointFile::flush() {
+        std::lock_guard<std::mutex> writeGuard(writeMutex);
+        std::vector<std::vector<char>> records;
+        {
+            std::lock_guard<std::mutex> guard(pendingMutex);
+            records.swap(pending);
+        }
+        if (records.empty()) {
+            return;
+        }
+        if (file == nullptr) {
+            log.FormatLine(LOG_ERROR, MODULE_NAME, "Could not write to %s, which is not open", path.c_str());
+            return;
+        }
+
+        for (const std::vector<char> & record : records) {
+            std::uint32_t size = static_cast<std::uint32_t>(record.size());
+            std::uint32_t header[3] = { RECORD_MAGIC, size, checksum(record.data(), record.size()) };
+            std::uint32_t trailer[2] = { size, TRAILER_MAGIC };
+            std::fwrite(header, sizeof(header[0]), 3, file);
+            std::fwrite(record.data(), 1, record.size(), file);
+            std::fwrite(trailer, sizeof(trailer[0]), 2, file);
+        }
+        if (std::fflush(file) != 0) {
+            log.FormatLine(LOG_ERROR, MODULE_NAME, "Could not write to %s", path.c_str());
+            return;
+        }
+        numRecords += records.size();
+        if (numRecords >= 2 * maxRecords) {
+            compact();
+        }
+    }
+
+    void CheckpointFile::compact() {
+        const std::string tempPath = path + ".tmp";
+        std::size_t kept;
+        {
+            MappedFile view(path);
+            std::vector<std::uint64_t> offsets;
+            findRecords(view, offsets);
+            if (offsets.size() <= maxRecords) {
+                numRecords = offsets.size();
+                return;
+            }
+            kept = maxRecords;
+            std::uint64_t first = offsets[offsets.size() - kept];
+
+            // The records are copied as they are, from the first kept to the end of the file
+            std::FILE * temp = std::fopen(tempPath.c_str(), "wb");
+            if (temp == nullptr) {
+                log.FormatLine(LOG_ERROR, MODULE_NAME, "Could not create %s", tempPath.c_str());
+                return;
+            }
+            writeFileHeader(temp);
+            std::fwrite(view.data() + first, 1, static_cast<std::size_t>(view.size() - first), temp);
+            bool written = std::fflush(temp) == 0 && std::ferror(temp) == 0;
+            std::fclose(temp);
+            if (!written) {
+                log.FormatLine(LOG_ERROR, MODULE_NAME, "Could not write %s", tempPath.c_str());
+                std::remove(tempPath.c_str());
+                return;
+            }
+        }
+
+        std::fclose(file);
+#ifdef _WIN32
+        // rename does not replace an existing file on Windows
+        std::remove(path.c_str());
+#endif
+        if (std::rename(tempPath.c_str(), path.c_str()) != 0) {
+            log.FormatLine(LOG_ERROR, MODULE_NAME, "Could not replace %s", path.c_str());
+        }
+        else {
+            numRecords = kept;
+        }
+        file = std::fopen(path.c_str(), "r+b");
+        if (file == nullptr) {
+            log.FormatLine(LOG_ERROR, MODULE_NAME, "Could not reopen %s", path.c_str());
+            return;
+        }
+        std::fseek(file, 0, SEEK_END);
+    }
+
+    bool CheckpointFile::readLatest(std::vector<char> & record) const {
+        MappedFile view(path);
+        std::uint64_t offset;
+        std::uint32_t size;
+        if (view.data() == nullptr || !findLatest(view, offset, size)) {
+            return false;
+        }
+        const char * payload = view.data() + offset + RECORD_HEADER_SIZE;
+        record.assign(payload, payload + size);
+        return true;
+    }
+
+    void CheckpointFile::run() {
+        flush();
+    }
+}
@@ -18,7 +18,9 @@
  *     All Rights Reserved.
  **/
 
+#include <algorithm>
 #include <cmath> // for NAN
+#include <stdexcept>
 
 #include "DataPoint.h"
 
@@ -28,6 +30,7 @@ namespace PCOE {
     // *------------------------*
 
     DataPoint::DataPoint() : ProgMeta(),
+        pendingTimes(0),
         uType(UType::Point),
         nPoints(0) {
         setNumTimes(0);  // Default = 1 timestep (NOW)
@@ -37,7 +40,32 @@ namespace PCOE {
         return data.at(index);
     }
 
+    double * DataPoint::sampleData(const std::size_t nTimes, const std::size_t nValues) {
+        if (nTimes > data.size()) {
+            throw std::out_of_range("DataPoint: more times than the data point holds");
+        }
+        if (samples.rows() != data.size() || samples.cols() != nValues) {
+            commitSamples();
+            samples.resize(data.size(), nValues);
+        }
+        pendingTimes = std::max(pendingTimes, nTimes);
+        return samples.data();
+    }
+
+    void DataPoint::commitSamples() {
+        for (std::size_t t = 0; t < pendingTimes; t++) {
+            data[t].setVec(0, samples.row(t), samples.cols());
+        }
+        pendingTimes = 0;
+        samples.clear();
+    }
+
+    std::size_t DataPoint::getSampleStride() const {
+        return samples.stride();
+    }
+
     void DataPoint::setUncertainty(const UType uncertType) {
+        commitSamples();
         uType = uncertType;
         for (auto & it : data) {
             it.uncertainty(uncertType);
@@ -49,6 +77,7 @@ namespace PCOE {
     }
 
     void DataPoint::setNumTimes(const unsigned int nTimesIn) {
+        commitSamples();
         data.resize(nTimesIn + 1, UData(uType));
         for (auto & it : data) {
             it.npoints(nPoints);
@@ -60,6 +89,7 @@ namespace PCOE {
     }
 
     void DataPoint::setNPoints(const unsigned int nPointsIn) {
+        commitSamples();
         nPoints = nPointsIn;
         for (auto & it : data) {
             it.npoints(nPoints);
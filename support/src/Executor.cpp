@@ -0,0 +1,213 @@
+// Copyright (c) 2016 United States Government as represented by
+// the Administrator of the National Aeronautics and Space Administration.
+// All Rights Reserved.
+
+#include <algorithm>
+#include <exception>
+
+#include "Executor.h"
+#include "ThreadSafeLog.h"
+
+namespace PCOE {
+    const char MODULE_NAME[] = "Executor";
+
+    namespace {
+        // Index of the worker running on this thread, or -1 off the workers
+        thread_local int currentWorker = -1;
+    }
+
+    Executor::Executor() : nextWorker(0), pending(0), stopping(false), nextTimer(0) {
+        unsigned int numWorkers = std::max(1u, std::thread::hardware_concurrency());
+        for (unsigned int i = 0; i < numWorkers; i++) {
+            workers.push_back(std::unique_ptr<Worker>(new Worker()));
+        }
+        for (unsigned int i = 0; i < numWorkers; i++) {
+            workers[i]->thread = std::thread(&Executor::work, this, i);
+        }
+        timerThread = std::thread(&Executor::runTimers, this);
+    }
+
+    Executor::~Executor() {
+        {
+            std::lock(sleepMutex, timerMutex);
+            std::lock_guard<std::mutex> sleepLock(sleepMutex, std::adopt_lock);
+            std::lock_guard<std::mutex> timerLock(timerMutex, std::adopt_lock);
+            stopping = true;
+        }
+        sleepCondition.notify_all();
+        timerCondition.notify_all();
+        for (auto & worker : workers) {
+            worker->thread.join();
+        }
+        timerThread.join();
+    }
+
+    void Executor::submit(Function fn) {
+        std::size_t index = currentWorker >= 0 ? static_cast<std::size_t>(currentWorker)
+                                               : nextWorker++ % workers.size();
+        {
+            // Counted before the task is queued, so that a worker taking the task
+            // never decrements pending before it is incremented
+            std::lock_guard<std::mutex> lock(sleepMutex);
+            pending++;
+        }
+        {
+            std::lock_guard<std::mutex> lock(workers[index]->m);
+            workers[index]->tasks.push_back(std::move(fn));
+        }
+        sleepCondition.notify_one();
+    }
+
+    unsigned long Executor::submitAfter(std::chrono::milliseconds delay, Function fn) {
+        std::lock_guard<std::mutex> lock(timerMutex);
+        unsigned long id = nextTimer++;
+        timers.insert(std::make_pair(clock::now() + delay, std::make_pair(id, std::move(fn))));
+        timerCondition.notify_one();
+        return id;
+    }
+
+    bool Executor::cancel(unsigned long id) {
+        std::lock_guard<std::mutex> lock(timerMutex);
+        for (auto it = timers.begin(); it != timers.end(); ++it) {
+            if (it->second.first == id) {
+                timers.erase(it);
+                return true;
+            }
+        }
+        return false;
+    }
+
+    void Executor::parallelFor(unsigned int count, const std::function<void(unsigned int)> & fn) {
+        struct Group {
+            std::mutex m;
+            std::condition_variable done;
+            unsigned int remaining;
+            std::vector<std::exception_ptr> errors;
+        } group;
+        group.remaining = count;
+        group.errors.resize(count);
+
+        auto runIndex = [&group, &fn](unsigned int i) {
+            try {
+                fn(i);
+            }
+            catch (...) {
+                group.errors[i] = std::current_exception();
+            }
+            std::lock_guard<std::mutex> lock(group.m);
+            if (--group.remaining == 0) {
+                group.done.notify_all();
+            }
+        };
+
+        for (unsigned int i = 1; i < count; i++) {
+            submit([&runIndex, i]() { runIndex(i); });
+        }
+        if (count > 0) {
+            runIndex(0);
+        }
+
+        // Help with queued tasks until the group is done. When no task is queued,
+        // the rest of the group is running elsewhere, so it is safe to block.
+        while (true) {
+            {
+                std::lock_guard<std::mutex> lock(group.m);
+                if (group.remaining == 0) {
+                    break;
+                }
+            }
+            if (!tryRunTask()) {
+                std::unique_lock<std::mutex> lock(group.m);
+                group.done.wait(lock, [&group]() { return group.remaining == 0; });
+                break;
+            }
+        }
+
+        for (auto & error : group.errors) {
+            if (error) {
+                std::rethrow_exception(error);
+            }
+        }
+    }
+
+    unsigned int Executor::getNumWorkers() const {
+        return static_cast<unsigned int>(workers.size());
+    }
+
+    bool Executor::takeTask(int self, Function & fn) {
+        std::size_t numWorkers = workers.size();
+        if (self >= 0) {
+            Worker & own = *workers[static_cast<std::size_t>(self)];
+            std::lock_guard<std::mutex> lock(own.m);
+            if (!own.tasks.empty()) {
+                fn = std::move(own.tasks.back());
+                own.tasks.pop_back();
+                pending--;
+                return true;
+            }
+        }
+        std::size_t start = self >= 0 ? static_cast<std::size_t>(self) + 1 : 0;
+        for (std::size_t i = 0; i < numWorkers; i++) {
+            Worker & victim = *workers[(start + i) % numWorkers];
+            std::lock_guard<std::mutex> lock(victim.m);
+            if (!victim.tasks.empty()) {
+                fn = std::move(victim.tasks.front());
+                victim.tasks.pop_front();
+                pending--;
+                return true;
+            }
+        }
+        return false;
+    }
+
+    bool Executor::tryRunTask() {
+        Function fn;
+        if (!takeTask(currentWorker, fn)) {
+            return false;
+        }
+        // An exception escaping a task would end the worker, so it is logged instead
+        try {
+            fn();
+        }
+        catch (const std::exception & ex) {
+            Log::Instance().FormatLine(LOG_ERROR, MODULE_NAME, "Task failed: %s", ex.what());
+        }
+        catch (...) {
+            Log::Instance().WriteLine(LOG_ERROR, MODULE_NAME, "Task failed with an unknown exception");
+        }
+        return true;
+    }
+
+    void Executor::work(unsigned int index) {
+        currentWorker = static_cast<int>(index);
+        while (true) {
+            if (tryRunTask()) {
+                continue;
+            }
+            std::unique_lock<std::mutex> lock(sleepMutex);
+            sleepCondition.wait(lock, [this]() { return stopping || pending > 0; });
+            if (stopping) {
+                return;
+            }
+        }
+    }
+
+    void Executor::runTimers() {
+        std::unique_lock<std::mutex> lock(timerMutex);
+        while (!stopping) {
+            if (timers.empty()) {
+                timerCondition.wait(lock);
+                continue;
+            }
+            auto next = timers.begin();
+            if (clock::now() < next->first) {
+                timerCondition.wait_until(lock, next->first);
+                continue;
+            }
+            Function fn = std::move(next->second.second);
+            timers.erase(next);
+            // Run while holding the lock, so that cancel waits for it
+            fn();
+        }
+    }
+}
@@ -8,49 +8,48 @@
 #include "GaussianVariable.h"
 
 namespace PCOE {
-    GaussianVariable::GaussianVariable(double x, double y) { //If mean and standard deviation are specified
+    namespace {
+        std::uint64_t randomSeed() {
+            std::random_device rd;
+            return (static_cast<std::uint64_t>(rd()) << 32) | rd();
+        }
+    }
+
+    GaussianVariable::GaussianVariable(double x, double y) : generator(randomSeed()) { //If mean and standard deviation are specified
         mu = x;
         sigma = y;
     }
 
-    GaussianVariable::GaussianVariable() { //If mean and standard deviation are not specified
+    GaussianVariable::GaussianVariable() : generator(randomSeed()) { //If mean and standard deviation are not specified
         mu = 0;
         sigma = 1;
     }
 
     void GaussianVariable::generatesamplesdirect(int Nsamples)
     {
-        std::random_device rd;
-        std::mt19937 gen(rd());
-        std::normal_distribution<> dis(mu, sigma);
-
-
-        for (int i = 0; i < Nsamples; i++)
+        std::size_t count = static_cast<std::size_t>(Nsamples);
+        fillNormal(generator, VarSamples, count);
+        for (std::size_t i = 0; i < count; i++)
         {
-
-            VarSamples[i] = dis(gen);
+            VarSamples[i] = mu + sigma * VarSamples[i];
         }
-
     }
 
     void GaussianVariable::generatesamplesicdfur(int Nsamples)
     {
-        double temp;
-
-        std::random_device rd;
-        std::mt19937 gen(rd());
-        std::uniform_real_distribution<> dis(0, 1);
-
-
-        for (int i = 0; i < Nsamples; i++)
+        std::size_t count = static_cast<std::size_t>(Nsamples);
+        fillUniform(generator, VarSamples, count);
+        inverseNormalCdf(VarSamples, VarSamples, count);
+        for (std::size_t i = 0; i < count; i++)
         {
-
-            temp = dis(gen);
-            VarSamples[i] = invertcdfur(temp);
+            VarSamples[i] = mu + sigma * VarSamples[i];
         }
-
     }
 
+    void GaussianVariable::setseed(std::uint64_t seed)
+    {
+        generator = Philox4x32(seed);
+    }
 
     void GaussianVariable::setmeanstd(double x, double y)
     {
@@ -71,21 +70,7 @@ namespace PCOE {
 
 
     double GaussianVariable::invertcdfur(double U) {
-        // Based on approximation of  Milton Abramowitz, Irene A. Stegun
-        double c[] = { 2.515517, 0.802853, 0.010328 };
-        double d[] = { 1.432788, 0.189269, 0.001308 };
-        double t;
-        double intermediate;
-
-        t = sqrt(-2 * log(U));
-        intermediate = t - ((c[2] * t + c[1])*t + c[0]) / (((d[2] * t + d[1])*t + d[0])*t + 1.0);
-
-        if (U < 0.5) {
-            return (-intermediate*sigma + mu);
-        }
-        else {
-            return (intermediate*sigma + mu);
-        }
+        return mu + sigma * inverseNormalCdf(U);
     }
 }
 
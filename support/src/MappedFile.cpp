@@ -0,0 +1,64 @@
+// Copyright (c) 2016 United States Government as represented by
+// the Administrator of the National Aeronautics and Space Administration.
+// All Rights Reserved.
+
+#include <cstdio>
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#include "MappedFile.h"
+
+namespace PCOE {
+    MappedFile::MappedFile(const std::string & path) : opened(false), contents(nullptr), length(0) {
+#ifdef _WIN32
+        std::FILE * f = std::fopen(path.c_str(), "rb");
+        if (f == nullptr) {
+            return;
+        }
+        opened = true;
+        std::fseek(f, 0, SEEK_END);
+        long fileLength = std::ftell(f);
+        std::fseek(f, 0, SEEK_SET);
+        if (fileLength > 0) {
+            buffer.resize(static_cast<std::size_t>(fileLength));
+            length = std::fread(&buffer[0], 1, buffer.size(), f);
+            contents = buffer.data();
+        }
+        std::fclose(f);
+#else
+        int fd = open(path.c_str(), O_RDONLY);
+        if (fd == -1) {
+            return;
+        }
+        struct stat info;
+        if (fstat(fd, &info) == 0) {
+            opened = true;
+            if (info.st_size > 0) {
+                void * mapped = mmap(nullptr, static_cast<std::size_t>(info.st_size),
+                                     PROT_READ, MAP_SHARED, fd, 0);
+                if (mapped == MAP_FAILED) {
+                    opened = false;
+                }
+                else {
+                    contents = static_cast<const char *>(mapped);
+                    length = static_cast<std::size_t>(info.st_size);
+                }
+            }
+        }
+        close(fd);
+#endif
+    }
+
+    MappedFile::~MappedFile() {
+#ifndef _WIN32
+        if (contents != nullptr) {
+            munmap(const_cast<char *>(contents), length);
+        }
+#endif
+    }
+}
@@ -13,10 +13,12 @@
  */
 
 #include "Matrix.h"
+#include "MatrixDecomposition.h"
 
 #include <algorithm>
 #include <cmath>
 #include <cstring>
+#include <limits>
 #include <stdexcept>
 
 namespace PCOE {
@@ -261,15 +263,7 @@ namespace PCOE {
             throw std::domain_error("Matrices are compatible.");
         }
         Matrix r(M, rhs.N);
-        for (size_t i = 0; i < M; i++) {
-            for (size_t j = 0; j < rhs.N; j++) {
-                double e = 0;
-                for (size_t k = 0; k < N; k++) {
-                    e += ((*this)[i][k] * rhs[k][j]);
-                }
-                r[i][j] = e;
-            }
-        }
+        gemm(1.0, *this, rhs, 0.0, r);
         return r;
     }
 
@@ -359,12 +353,12 @@ namespace PCOE {
             throw std::domain_error("Matrix must be square");
         }
 
-        double d = determinant();
-        if (std::abs(d) < 1e-15) {
+        LUDecomposition lu(*this);
+        if (std::abs(lu.determinant()) < 1e-15) {
             throw std::domain_error("Matrix is singular.");
         }
 
-        return adjoint() / d;
+        return lu.inverse();
     }
 
     double Matrix::minor(std::size_t m, std::size_t n) const {
@@ -381,6 +375,10 @@ namespace PCOE {
         return r;
     }
 
+    Matrix Matrix::solve(const Matrix& b) const {
+        return LUDecomposition(*this).solve(b);
+    }
+
     Matrix Matrix::submatrix(std::size_t m, std::size_t n) const {
         if (m >= M) {
             throw std::out_of_range("m is too big.");
@@ -417,36 +415,38 @@ namespace PCOE {
         return r;
     }
 
+    void Matrix::transposeInto(Matrix& result) const {
+        if (result.rows() != N || result.cols() != M) {
+            result.resize(N, M);
+        }
+        for (size_t i = 0; i < M; i++) {
+            const double* row = rowData(i);
+            for (size_t j = 0; j < N; j++) {
+                result[j][i] = row[j];
+            }
+        }
+    }
+
     // Weighted covariance. Alpha is a scaling factor and defaults to 1.
     // Beta is also a scaling parameter and defaults to 0. For default values
     // there will be no scaling.
     // Note that weighted covariance function differs for sigma
     // points vs other samples, and this one is assuming sigma points.
+    // The (1 - alpha^2 + beta) correction to the weight of the first sigma
+    // point is applied once per column, as it always has been.
     Matrix Matrix::weightedCovariance(const Matrix& w, const double alpha, const double beta) const {
         if (N != w.M || w.N != 1) {
             throw std::domain_error("w is not a column vector with M rows.");
         }
 
-        Matrix result(M, M);
-
-        Matrix wmean = weightedMean(w);
-
-        // Compute covariance
-        for (std::size_t i = 0; i < N; ++i) {
-            Matrix column = col(i);
-            Matrix diff = column - wmean;
-            Matrix diffT = diff.transpose();
-            Matrix temp = diff * diffT;
-            result = result + temp * w[i][0];
-
-            // Offset with alpha term
-            column = col(0);
-            diff = column - wmean;
-            diffT = diff.transpose();
-            temp = diff * diffT;
-            result += temp * (1 - alpha * alpha + beta);
-        }
+        std::vector<double> weights(w.data, w.data + w.M);
+        std::vector<double> mean(M);
+        Matrix centered(M, N);
+        PCOE::weightedCenter(*this, weights, mean, centered);
 
+        Matrix result(M, M);
+        double w0Correction = static_cast<double>(N) * (1 - alpha * alpha + beta);
+        PCOE::weightedCovariance(centered, weights, w0Correction, result);
         return result;
     }
 
@@ -596,4 +596,218 @@ namespace PCOE {
 
         return true;
     }
+
+    /***********************************************************************/
+    /* Matrix multiplication                                               */
+    /***********************************************************************/
+    namespace {
+        // Products with fewer multiply-adds than this use the unpacked kernel
+        const std::size_t GEMM_SMALL = 32 * 32 * 32;
+        // Depth (rows of B) of a packed block of B
+        const std::size_t GEMM_KC = 256;
+        // Columns in a packed block of B
+        const std::size_t GEMM_NC = 512;
+        // Columns in a strip of packed B, which is the width of the inner kernel
+        const std::size_t GEMM_NR = 8;
+
+        // Scale row c by beta, or clear it if beta is zero so that NaNs in C are not kept
+        inline void scaleRow(double* c, std::size_t n, double beta) {
+            if (std::fpclassify(beta) == FP_ZERO) {
+                std::fill_n(c, n, 0.0);
+            }
+            else {
+                for (std::size_t j = 0; j < n; ++j) {
+                    c[j] *= beta;
+                }
+            }
+        }
+
+        // C = alpha*A*B + beta*C, one row of C at a time. Each element is summed
+        // in order of k, so for alpha = 1 the result matches a dot product.
+        void gemmSmall(double alpha, const Matrix& A, const Matrix& B, double beta, Matrix& C) {
+            std::size_t m = A.rows();
+            std::size_t n = B.cols();
+            std::size_t kk = A.cols();
+            for (std::size_t i = 0; i < m; ++i) {
+                double* c = C.rowData(i);
+                const double* a = A.rowData(i);
+                scaleRow(c, n, beta);
+                for (std::size_t k = 0; k < kk; ++k) {
+                    double aik = alpha * a[k];
+                    const double* b = B.rowData(k);
+                    for (std::size_t j = 0; j < n; ++j) {
+                        c[j] += aik * b[j];
+                    }
+                }
+            }
+        }
+
+        // C = alpha*A*B + beta*C for larger matrices. Blocks of B are packed into
+        // strips of GEMM_NR columns stored row by row, so the inner kernel reads A
+        // and B contiguously and keeps GEMM_NR sums that are updated together.
+        void gemmBlocked(double alpha, const Matrix& A, const Matrix& B, double beta, Matrix& C) {
+            static thread_local std::vector<double> packed;
+
+            std::size_t m = A.rows();
+            std::size_t n = B.cols();
+            std::size_t kk = A.cols();
+            for (std::size_t i = 0; i < m; ++i) {
+                scaleRow(C.rowData(i), n, beta);
+            }
+
+            for (std::size_t j0 = 0; j0 < n; j0 += GEMM_NC) {
+                std::size_t nc = std::min(GEMM_NC, n - j0);
+                std::size_t strips = (nc + GEMM_NR - 1) / GEMM_NR;
+                for (std::size_t k0 = 0; k0 < kk; k0 += GEMM_KC) {
+                    std::size_t kc = std::min(GEMM_KC, kk - k0);
+
+                    // Pack B[k0:k0+kc, j0:j0+nc] into strips, padding the last strip with zeros
+                    if (packed.size() < strips * kc * GEMM_NR) {
+                        packed.resize(strips * kc * GEMM_NR);
+                    }
+                    for (std::size_t s = 0; s < strips; ++s) {
+                        double* p = packed.data() + s * kc * GEMM_NR;
+                        std::size_t width = std::min(GEMM_NR, nc - s * GEMM_NR);
+                        for (std::size_t k = 0; k < kc; ++k) {
+                            const double* b = B.rowData(k0 + k) + j0 + s * GEMM_NR;
+                            std::size_t jj = 0;
+                            for (; jj < width; ++jj) {
+                                p[k * GEMM_NR + jj] = b[jj];
+                            }
+                            for (; jj < GEMM_NR; ++jj) {
+                                p[k * GEMM_NR + jj] = 0;
+                            }
+                        }
+                    }
+
+                    for (std::size_t i = 0; i < m; ++i) {
+                        const double* a = A.rowData(i) + k0;
+                        double* c = C.rowData(i) + j0;
+                        for (std::size_t s = 0; s < strips; ++s) {
+                            const double* p = packed.data() + s * kc * GEMM_NR;
+                            double sum[GEMM_NR] = {};
+                            for (std::size_t k = 0; k < kc; ++k) {
+                                for (std::size_t jj = 0; jj < GEMM_NR; ++jj) {
+                                    sum[jj] += a[k] * p[k * GEMM_NR + jj];
+                                }
+                            }
+                            std::size_t width = std::min(GEMM_NR, nc - s * GEMM_NR);
+                            for (std::size_t jj = 0; jj < width; ++jj) {
+                                c[s * GEMM_NR + jj] += alpha * sum[jj];
+                            }
+                        }
+                    }
+                }
+            }
+        }
+    }
+
+    void gemm(double alpha, const Matrix& A, const Matrix& B, double beta, Matrix& C) {
+        if (A.cols() != B.rows() || C.rows() != A.rows() || C.cols() != B.cols()) {
+            throw std::domain_error("Matrices are not compatible.");
+        }
+        if (&C == &A || &C == &B) {
+            throw std::domain_error("Result must not be an argument.");
+        }
+
+        if (A.rows() * A.cols() * B.cols() < GEMM_SMALL) {
+            gemmSmall(alpha, A, B, beta, C);
+        }
+        else {
+            gemmBlocked(alpha, A, B, beta, C);
+        }
+    }
+
+    /***********************************************************************/
+    /* Weighted covariance                                                 */
+    /***********************************************************************/
+    namespace {
+        // Weighted dot product of two rows, sum over i of w[i]*a[i]*b[i]
+        inline double weightedDot(const double* a, const double* b, const double* w, std::size_t n) {
+            double sum = 0;
+            for (std::size_t i = 0; i < n; ++i) {
+                sum += w[i] * a[i] * b[i];
+            }
+            return sum;
+        }
+    }
+
+    void weightedCenter(const Matrix& X, const std::vector<double>& w,
+                        std::vector<double>& mean, Matrix& Xc) {
+        if (w.size() != X.cols()) {
+            throw std::domain_error("w does not have one weight per column.");
+        }
+        if (Xc.rows() != X.rows() || Xc.cols() != X.cols() || mean.size() != X.rows()) {
+            throw std::domain_error("Outputs are not the same size as X.");
+        }
+
+        std::size_t n = X.cols();
+        for (std::size_t i = 0; i < X.rows(); ++i) {
+            const double* x = X.rowData(i);
+            double* xc = Xc.rowData(i);
+            double m = 0;
+            for (std::size_t j = 0; j < n; ++j) {
+                m += w[j] * x[j];
+            }
+            for (std::size_t j = 0; j < n; ++j) {
+                xc[j] = x[j] - m;
+            }
+            mean[i] = m;
+        }
+    }
+
+    void weightedCovariance(const Matrix& Xc, const std::vector<double>& w,
+                            double w0Correction, Matrix& C) {
+        if (w.size() != Xc.cols()) {
+            throw std::domain_error("w does not have one weight per column.");
+        }
+        if (C.rows() != Xc.rows() || C.cols() != Xc.rows()) {
+            throw std::domain_error("C is not square with one row per row of Xc.");
+        }
+
+        // Column 0 is handled separately so that its weight can be corrected
+        // without copying w
+        std::size_t m = Xc.rows();
+        std::size_t n = Xc.cols();
+        if (n == 0) {
+            for (std::size_t i = 0; i < m; ++i) {
+                std::fill_n(C.rowData(i), m, 0.0);
+            }
+            return;
+        }
+        double w0 = w[0] + w0Correction;
+        for (std::size_t i = 0; i < m; ++i) {
+            const double* a = Xc.rowData(i);
+            double* c = C.rowData(i);
+            for (std::size_t j = i; j < m; ++j) {
+                const double* b = Xc.rowData(j);
+                c[j] = w0 * a[0] * b[0] + weightedDot(a + 1, b + 1, w.data() + 1, n - 1);
+            }
+        }
+        for (std::size_t i = 1; i < m; ++i) {
+            double* c = C.rowData(i);
+            for (std::size_t j = 0; j < i; ++j) {
+                c[j] = C.rowData(j)[i];
+            }
+        }
+    }
+
+    void weightedCrossCovariance(const Matrix& Xc, const Matrix& Zc,
+                                 const std::vector<double>& w, Matrix& C) {
+        if (w.size() != Xc.cols() || Zc.cols() != Xc.cols()) {
+            throw std::domain_error("Xc, Zc and w do not have the same number of samples.");
+        }
+        if (C.rows() != Xc.rows() || C.cols() != Zc.rows()) {
+            throw std::domain_error("C does not have one row per row of Xc and one column per row of Zc.");
+        }
+
+        std::size_t n = Xc.cols();
+        for (std::size_t i = 0; i < Xc.rows(); ++i) {
+            const double* a = Xc.rowData(i);
+            double* c = C.rowData(i);
+            for (std::size_t j = 0; j < Zc.rows(); ++j) {
+                c[j] = weightedDot(a, Zc.rowData(j), w.data(), n);
+            }
+        }
+    }
 }
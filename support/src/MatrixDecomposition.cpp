@@ -0,0 +1,316 @@
+/**  @file      MatrixDecomposition.cpp
+ *
+ *   @brief     Factorizations of square matrices, used to solve linear systems
+ *              without forming an explicit inverse.
+ *
+ *   @version   0.1.0
+ *   @date      2026-10-15
+ *
+ *   @copyright Copyright (c) 2016 United States Government as represented by
+ *              the Administrator of the National Aeronautics and Space
+ *              Administration. All Rights Reserved.
+ */
+
+#include "MatrixDecomposition.h"
+
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+namespace PCOE {
+    /***********************************************************************/
+    /* LU decomposition                                                    */
+    /***********************************************************************/
+    LUDecomposition::LUDecomposition(const Matrix& a)
+        : lu(a), pivot(a.rows()), pivotSign(1) {
+        if (!a.isSquare()) {
+            throw std::domain_error("Matrix must be square");
+        }
+
+        std::size_t n = lu.rows();
+        for (std::size_t i = 0; i < n; ++i) {
+            pivot[i] = i;
+        }
+
+        for (std::size_t k = 0; k < n; ++k) {
+            // Use the largest remaining element in column k as the pivot
+            std::size_t p = k;
+            double maxValue = std::abs(lu[k][k]);
+            for (std::size_t i = k + 1; i < n; ++i) {
+                if (std::abs(lu[i][k]) > maxValue) {
+                    maxValue = std::abs(lu[i][k]);
+                    p = i;
+                }
+            }
+            if (!(maxValue > 0)) {
+                throw std::domain_error("Matrix is singular.");
+            }
+            if (p != k) {
+                std::swap_ranges(lu.rowData(p), lu.rowData(p) + n, lu.rowData(k));
+                std::swap(pivot[p], pivot[k]);
+                pivotSign = -pivotSign;
+            }
+
+            // Eliminate column k below the diagonal
+            const double* rowK = lu.rowData(k);
+            for (std::size_t i = k + 1; i < n; ++i) {
+                double* rowI = lu.rowData(i);
+                double factor = rowI[k] / rowK[k];
+                rowI[k] = factor;
+                for (std::size_t j = k + 1; j < n; ++j) {
+                    rowI[j] -= factor * rowK[j];
+                }
+            }
+        }
+    }
+
+    Matrix LUDecomposition::solve(const Matrix& b) const {
+        std::size_t n = lu.rows();
+        if (b.rows() != n) {
+            throw std::domain_error("Right-hand side has the wrong number of rows");
+        }
+        std::size_t m = b.cols();
+
+        // Permute b, then solve Ly = Pb and Ux = y in place
+        Matrix x(n, m);
+        for (std::size_t i = 0; i < n; ++i) {
+            std::copy(b.rowData(pivot[i]), b.rowData(pivot[i]) + m, x.rowData(i));
+        }
+        for (std::size_t i = 0; i < n; ++i) {
+            double* rowI = x.rowData(i);
+            for (std::size_t k = 0; k < i; ++k) {
+                double factor = lu[i][k];
+                const double* rowK = x.rowData(k);
+                for (std::size_t j = 0; j < m; ++j) {
+                    rowI[j] -= factor * rowK[j];
+                }
+            }
+        }
+        for (std::size_t i = n; i-- > 0;) {
+            double* rowI = x.rowData(i);
+            for (std::size_t k = i + 1; k < n; ++k) {
+                double factor = lu[i][k];
+                const double* rowK = x.rowData(k);
+                for (std::size_t j = 0; j < m; ++j) {
+                    rowI[j] -= factor * rowK[j];
+                }
+            }
+            double diagonal = lu[i][i];
+            for (std::size_t j = 0; j < m; ++j) {
+                rowI[j] /= diagonal;
+            }
+        }
+        return x;
+    }
+
+    double LUDecomposition::determinant() const {
+        double r = pivotSign;
+        for (std::size_t i = 0; i < lu.rows(); ++i) {
+            r *= lu[i][i];
+        }
+        return r;
+    }
+
+    Matrix LUDecomposition::inverse() const {
+        return solve(Matrix::identity(lu.rows()));
+    }
+
+    /***********************************************************************/
+    /* Cholesky decomposition                                              */
+    /***********************************************************************/
+    CholeskyDecomposition::CholeskyDecomposition(const Matrix& a) {
+        factor(a);
+    }
+
+    void CholeskyDecomposition::factor(const Matrix& a) {
+        if (!a.isSquare()) {
+            throw std::domain_error("Matrix must be square");
+        }
+
+        std::size_t n = a.rows();
+        if (l.rows() != n || l.cols() != n) {
+            l.resize(n, n);
+        }
+        for (std::size_t j = 0; j < n; ++j) {
+            double* rowJ = l.rowData(j);
+            std::fill(rowJ + j + 1, rowJ + n, 0.0);
+            double d = a[j][j];
+            for (std::size_t k = 0; k < j; ++k) {
+                d -= rowJ[k] * rowJ[k];
+            }
+            if (!(d > 0)) {
+                throw std::domain_error("Matrix is not positive definite");
+            }
+            rowJ[j] = std::sqrt(d);
+            for (std::size_t i = j + 1; i < n; ++i) {
+                double* rowI = l.rowData(i);
+                double s = a[i][j];
+                for (std::size_t k = 0; k < j; ++k) {
+                    s -= rowI[k] * rowJ[k];
+                }
+                rowI[j] = s / rowJ[j];
+            }
+        }
+    }
+
+    void CholeskyDecomposition::factorProduct(const Matrix& a) {
+        std::size_t n = a.rows();
+        std::size_t k = a.cols();
+        if (k < n) {
+            throw std::domain_error("Matrix has more rows than columns");
+        }
+        if (work.rows() != n || work.cols() != k) {
+            work.resize(n, k);
+        }
+        for (std::size_t i = 0; i < n; ++i) {
+            std::copy(a.rowData(i), a.rowData(i) + k, work.rowData(i));
+        }
+
+        // Reduce A to [L 0] by applying Householder reflections from the right,
+        // one per row. This is a QR decomposition of A' written in terms of the
+        // rows of A, so that every access is along a row.
+        for (std::size_t j = 0; j < n; ++j) {
+            double* v = work.rowData(j);
+            double norm = 0;
+            for (std::size_t c = j; c < k; ++c) {
+                norm = std::hypot(norm, v[c]);
+            }
+            if (!(norm > 0)) {
+                throw std::domain_error("Matrix rows are linearly dependent");
+            }
+            // Reflect v[j..k) onto -sign(v[j])*norm*e_j, storing the Householder
+            // vector in place
+            if (v[j] < 0) {
+                norm = -norm;
+            }
+            for (std::size_t c = j; c < k; ++c) {
+                v[c] /= norm;
+            }
+            v[j] += 1;
+            for (std::size_t i = j + 1; i < n; ++i) {
+                double* row = work.rowData(i);
+                double s = 0;
+                for (std::size_t c = j; c < k; ++c) {
+                    s += row[c] * v[c];
+                }
+                s = -s / v[j];
+                for (std::size_t c = j; c < k; ++c) {
+                    row[c] += s * v[c];
+                }
+            }
+            v[j] = -norm;
+        }
+
+        // Copy out L, choosing signs so that its diagonal is positive
+        if (l.rows() != n || l.cols() != n) {
+            l.resize(n, n);
+        }
+        for (std::size_t i = 0; i < n; ++i) {
+            const double* row = work.rowData(i);
+            double* out = l.rowData(i);
+            for (std::size_t j = 0; j <= i; ++j) {
+                double diagonal = work.rowData(j)[j];
+                out[j] = diagonal < 0 ? -row[j] : row[j];
+            }
+            std::fill(out + i + 1, out + n, 0.0);
+        }
+    }
+
+    void CholeskyDecomposition::update(std::vector<double>& x) {
+        std::size_t n = l.rows();
+        if (x.size() != n) {
+            throw std::domain_error("Update vector has the wrong number of elements");
+        }
+
+        // Apply a Givens rotation per column to fold x into L
+        for (std::size_t k = 0; k < n; ++k) {
+            double lkk = l[k][k];
+            double r = std::hypot(lkk, x[k]);
+            double c = r / lkk;
+            double s = x[k] / lkk;
+            l[k][k] = r;
+            for (std::size_t i = k + 1; i < n; ++i) {
+                double lik = (l[i][k] + s * x[i]) / c;
+                l[i][k] = lik;
+                x[i] = c * x[i] - s * lik;
+            }
+        }
+    }
+
+    void CholeskyDecomposition::downdate(std::vector<double>& x) {
+        std::size_t n = l.rows();
+        if (x.size() != n) {
+            throw std::domain_error("Downdate vector has the wrong number of elements");
+        }
+
+        // Apply a hyperbolic rotation per column to remove x from L
+        for (std::size_t k = 0; k < n; ++k) {
+            double lkk = l[k][k];
+            double r2 = (lkk - x[k]) * (lkk + x[k]);
+            if (!(r2 > 0)) {
+                throw std::domain_error("Matrix is not positive definite");
+            }
+            double r = std::sqrt(r2);
+            double c = r / lkk;
+            double s = x[k] / lkk;
+            l[k][k] = r;
+            for (std::size_t i = k + 1; i < n; ++i) {
+                double lik = (l[i][k] - s * x[i]) / c;
+                l[i][k] = lik;
+                x[i] = c * x[i] - s * lik;
+            }
+        }
+    }
+
+    Matrix CholeskyDecomposition::solve(const Matrix& b) const {
+        Matrix x(b.rows(), b.cols());
+        solve(b, x);
+        return x;
+    }
+
+    void CholeskyDecomposition::solve(const Matrix& b, Matrix& x) const {
+        std::size_t n = l.rows();
+        if (b.rows() != n) {
+            throw std::domain_error("Right-hand side has the wrong number of rows");
+        }
+        std::size_t m = b.cols();
+        if (&x != &b) {
+            if (x.rows() != n || x.cols() != m) {
+                x.resize(n, m);
+            }
+            for (std::size_t i = 0; i < n; ++i) {
+                std::copy(b.rowData(i), b.rowData(i) + m, x.rowData(i));
+            }
+        }
+
+        // Solve Ly = b, then L'x = y, in place
+        for (std::size_t i = 0; i < n; ++i) {
+            double* rowI = x.rowData(i);
+            for (std::size_t k = 0; k < i; ++k) {
+                double factor = l[i][k];
+                const double* rowK = x.rowData(k);
+                for (std::size_t j = 0; j < m; ++j) {
+                    rowI[j] -= factor * rowK[j];
+                }
+            }
+            double diagonal = l[i][i];
+            for (std::size_t j = 0; j < m; ++j) {
+                rowI[j] /= diagonal;
+            }
+        }
+        for (std::size_t i = n; i-- > 0;) {
+            double* rowI = x.rowData(i);
+            for (std::size_t k = i + 1; k < n; ++k) {
+                double factor = l[k][i];
+                const double* rowK = x.rowData(k);
+                for (std::size_t j = 0; j < m; ++j) {
+                    rowI[j] -= factor * rowK[j];
+                }
+            }
+            double diagonal = l[i][i];
+            for (std::size_t j = 0; j < m; ++j) {
+                rowI[j] /= diagonal;
+            }
+        }
+    }
+}
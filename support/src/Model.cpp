@@ -28,6 +28,53 @@ namespace PCOE {
         stateEqn(t, x, u, n, m_dt);
     }
 
+    void Model::stateEqnBatch(const double t, Matrix & X, const Matrix & U, const Matrix & N) {
+        stateEqnBatch(t, X, U, N, m_dt);
+    }
+
+    void Model::stateEqnBatch(const double t, Matrix & X, const Matrix & U, const Matrix & N,
+        const double dt) {
+        std::vector<double> x(numStates);
+        std::vector<double> u(numInputs);
+        std::vector<double> n(numStates);
+        for (std::size_t sample = 0; sample < X.cols(); sample++) {
+            for (unsigned int i = 0; i < numStates; i++) {
+                x[i] = X[i][sample];
+                n[i] = N[i][sample];
+            }
+            for (unsigned int i = 0; i < numInputs; i++) {
+                u[i] = U[i][sample];
+            }
+            stateEqn(t, x, u, n, dt);
+            for (unsigned int i = 0; i < numStates; i++) {
+                X[i][sample] = x[i];
+            }
+        }
+    }
+
+    void Model::outputEqnBatch(const double t, const Matrix & X, const Matrix & U,
+        const Matrix & N, Matrix & Z) {
+        std::vector<double> x(numStates);
+        std::vector<double> u(numInputs);
+        std::vector<double> n(numOutputs);
+        std::vector<double> z(numOutputs);
+        for (std::size_t sample = 0; sample < X.cols(); sample++) {
+            for (unsigned int i = 0; i < numStates; i++) {
+                x[i] = X[i][sample];
+            }
+            for (unsigned int i = 0; i < numInputs; i++) {
+                u[i] = U[i][sample];
+            }
+            for (unsigned int i = 0; i < numOutputs; i++) {
+                n[i] = N[i][sample];
+            }
+            outputEqn(t, x, u, n, z);
+            for (unsigned int i = 0; i < numOutputs; i++) {
+                Z[i][sample] = z[i];
+            }
+        }
+    }
+
     unsigned int Model::getNumStates() const {
         return numStates;
     }
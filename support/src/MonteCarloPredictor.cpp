@@ -18,13 +18,20 @@
 *     All Rights Reserved.
 */
 
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <memory>
 #include <random>
 #include <string>
 #include <vector>
 
+#include "Executor.h"
 #include "Exceptions.h"
 #include "MonteCarloPredictor.h"
 #include "Matrix.h"
+#include "Random.h"
+#include "UDataViews.h"
 
 namespace PCOE {
     // Configuration Keys
@@ -34,12 +41,23 @@ namespace PCOE {
     const std::string NUMSAMPLES_KEY = "Predictor.numSamples";
     const std::string HORIZON_KEY = "Predictor.horizon";
     const std::string INPUTUNCERTAINTY_KEY = "Predictor.inputUncertainty";
+    const std::string NUMTHREADS_KEY = "Predictor.numThreads";
+    const std::string SEED_KEY = "Predictor.seed";
+    const std::string STOPATEVENT_KEY = "Predictor.stopAtEvent";
+    const std::string SAMPLING_KEY = "Predictor.sampling";
+
+    // Number of samples advanced together through the model's batched equations. Threads are also
+    // given whole blocks, so that no two threads write to the same word of an occurrence row.
+    const unsigned int SAMPLE_BLOCK = 64;
+    static_assert(SAMPLE_BLOCK % OccurrenceMatrix::WORD_BITS == 0, "Sample blocks must fill whole occurrence words");
 
     // Other string constants
-    const std::string MODULE_NAME = "MonteCarloPredictor";
+    // A C string, so that logging from predict does not allocate
+    const char MODULE_NAME[] = "MonteCarloPredictor";
 
     // ConfigMap-based Constructor
-    MonteCarloPredictor::MonteCarloPredictor(GSAPConfigMap & configMap) : Predictor() {
+    MonteCarloPredictor::MonteCarloPredictor(GSAPConfigMap & configMap)
+        : Predictor(), numThreads(1), fixedSeed(false), seed(0), stopAtEvent(false), sampling(Sampling::Random) {
         // Check for required parameters:
         // model = model to be used for simulation
         // numSamples = number of samples used for prediction
@@ -58,6 +76,7 @@ namespace PCOE {
         std::vector<std::string> processNoiseStrings = configMap[PROCESSNOISE_KEY];
         for (unsigned int i = 0; i < processNoiseStrings.size(); i++) {
             processNoise.push_back(std::stod(processNoiseStrings[i]));
+            processNoiseSD.push_back(std::sqrt(processNoise.back()));
         }
 
         // Set up input uncertainty
@@ -69,6 +88,50 @@ namespace PCOE {
         // Set up predicted outputs
         predictedOutputs = configMap[PREDICTEDOUTPUTS_KEY];
 
+        // Set number of threads (optional). 0 means use one thread per core.
+        if (configMap.includes(NUMTHREADS_KEY)) {
+            numThreads = static_cast<unsigned int>(std::stoul(configMap[NUMTHREADS_KEY][0]));
+            if (numThreads == 0) {
+                numThreads = Executor::instance().getNumWorkers();
+            }
+        }
+
+        // Set seed (optional). Configuring a seed makes predictions repeatable.
+        if (configMap.includes(SEED_KEY)) {
+            fixedSeed = true;
+            seed = std::stoull(configMap[SEED_KEY][0]);
+        }
+
+        // Stop simulating each sample once its event has occurred (optional). Trajectories are then
+        // only computed up to the event.
+        if (configMap.includes(STOPATEVENT_KEY)) {
+            stopAtEvent = configMap[STOPATEVENT_KEY][0] == "true" || configMap[STOPATEVENT_KEY][0] == "1";
+        }
+
+        // Set sampling method (optional): random, antithetic, lhs, halton or sobol
+        if (configMap.includes(SAMPLING_KEY)) {
+            const std::string & method = configMap[SAMPLING_KEY][0];
+            if (method == "random") {
+                sampling = Sampling::Random;
+            }
+            else if (method == "antithetic") {
+                sampling = Sampling::Antithetic;
+            }
+            else if (method == "lhs") {
+                sampling = Sampling::LatinHypercube;
+            }
+            else if (method == "halton") {
+                sampling = Sampling::Halton;
+            }
+            else if (method == "sobol") {
+                sampling = Sampling::Sobol;
+            }
+            else {
+                log.FormatLine(LOG_ERROR, MODULE_NAME, "Unknown sampling method %s", method.c_str());
+                throw ConfigurationError("Unknown sampling method");
+            }
+        }
+
         log.WriteLine(LOG_INFO, MODULE_NAME, "MonteCarloPredictor created");
     }
 
@@ -106,91 +169,384 @@ namespace PCOE {
             throw ConfigurationError("MonteCarloPredictor does not have a model!");
         }
 
-        // Create a random number generator
-        std::random_device rDevice;
-        std::mt19937 generator(rDevice());
+        // Look up the outputs before any workers start, so the ProgData containers are not modified concurrently
+        auto & theEvent = data.events[event];
+        std::vector<DataPoint *> trajectoryPoints;
+        for (unsigned int p = 0; p < pModel->getNumPredictedOutputs(); p++) {
+            trajectoryPoints.push_back(&data.sysTrajectories[predictedOutputs[p]]);
+        }
 
-        // For each sample
-        for (unsigned int sample = 0; sample < numSamples; sample++) {
-            // 1. Sample the state
-            // Create state vector
-            Matrix xMean(pModel->getNumStates(), 1);
+        // Check that the results can hold every time step of the prediction
+        unsigned int numTimes = 0;
+        for (double t = tP; t <= tP + horizon; t += pModel->getDt()) {
+            numTimes++;
+        }
+        if (theEvent.occurrenceMatrix.size() < numTimes) {
+            log.WriteLine(LOG_ERROR, MODULE_NAME, "Occurrence matrix is smaller than the prediction horizon");
+            throw std::range_error("Occurrence matrix is smaller than the prediction horizon");
+        }
+        for (unsigned int timeIndex = 0; timeIndex < numTimes; timeIndex++) {
+            if (theEvent.occurrenceMatrix[timeIndex].size() < numSamples) {
+                theEvent.occurrenceMatrix[timeIndex].resize(numSamples);
+            }
+        }
+        if (theEvent.probMatrix.size() < numTimes) {
+            theEvent.probMatrix.resize(numTimes, NAN);
+        }
+        for (auto trajectory : trajectoryPoints) {
+            if (trajectory->getNumTimes() + 1 < numTimes) {
+                log.WriteLine(LOG_ERROR, MODULE_NAME, "System trajectory is smaller than the prediction horizon");
+                throw std::range_error("System trajectory is smaller than the prediction horizon");
+            }
+        }
 
-            // Assume for now that UData is mean and covariance type, and so we are assuming multivariate normal
-            // NOTE: Can check UData uncertainty type to see what it is and how to handle. Perhaps it would be useful to have general code to deal with this, to get samples from it directly? So don't have to check within here.
-            // First step is to construct the mean vector and covariance matrix from the UDatas
+        // Construct the distribution of the state. For a mean and covariance this is multivariate normal,
+        // and the covariance is the same for every sample, so it is factored once here rather than once
+        // per sample. Weighted samples are drawn from directly.
+        StateDistribution x0;
+        if (state[0].uncertainty() == UType::WSamples) {
+            std::size_t numParticles = state[0].npoints();
+            x0.particles = Matrix(pModel->getNumStates(), numParticles);
+            for (unsigned int xIndex = 0; xIndex < pModel->getNumStates(); xIndex++) {
+                WSamplesView samples(state[xIndex]);
+                std::size_t count = std::min(numParticles, samples.size());
+                for (std::size_t p = 0; p < count; p++) {
+                    x0.particles[xIndex][p] = samples.sample(p);
+                }
+                if (xIndex == 0) {
+                    double sum = 0;
+                    for (std::size_t p = 0; p < count; p++) {
+                        sum += samples.weight(p);
+                        x0.cumulativeWeights.push_back(sum);
+                    }
+                }
+            }
+        }
+        else {
+            x0.mean.resize(pModel->getNumStates());
             Matrix Pxx(pModel->getNumStates(), pModel->getNumStates());
             for (unsigned int xIndex = 0; xIndex < pModel->getNumStates(); xIndex++) {
-                xMean[xIndex][0] = state[xIndex][MEAN];
-                std::vector<double> covariance = state[xIndex].getVec(COVAR());
-                Pxx.row(xIndex, state[xIndex].getVec(COVAR(0)));
+                MeanCovarView distribution(state[xIndex]);
+                Span<const double> covar = distribution.covar();
+                if (covar.size() != pModel->getNumStates()) {
+                    log.WriteLine(LOG_ERROR, MODULE_NAME, "State covariance does not match the number of states");
+                    throw std::range_error("State covariance does not match the number of states");
+                }
+                x0.mean[xIndex] = distribution.mean();
+                for (unsigned int j = 0; j < covar.size(); j++) {
+                    Pxx[xIndex][j] = covar[j];
+                }
             }
+            x0.chol = Pxx.chol();
+        }
 
-            // Now we have mean vector (x) and covariance matrix (Pxx). We can use that to sample a realization of the state.
-            // I need to generate a vector of random numbers, size of the state vector
-            Matrix xRandom(pModel->getNumStates(), 1);
-            // Create standard normal distribution
-            std::normal_distribution<> standardDistribution(0, 1);
-            for (unsigned int xIndex = 0; xIndex < pModel->getNumStates(); xIndex++) {
-                xRandom[xIndex][0] = standardDistribution(generator);
-            }
-            // Update with mean and covariance
-            xRandom = xMean + Pxx.chol()*xRandom;
-            std::vector<double> x = static_cast<std::vector<double>>(xRandom.col(0));
-
-            // 2. Sample the input parameters
-            // For now, hard-code and assume Gaussian, but these should be specified somehow in the configMap
-            // Assuming that for each input parameter, we have specified mean and standard deviation
-            // We have a list of pairs (mean,stddev) for each input parameter
-            // The order must correspond to the order of the input parameters in the model:
-            //   mean_ip1, stddev_ip1, mean_ip2, stddev_ip2, ...
-            std::vector<double> inputParameters(pModel->getNumInputParameters());
-            for (unsigned int ipIndex = 0; ipIndex < pModel->getNumInputParameters(); ipIndex++) {
-                // Create distribution for this input parameter
-                std::normal_distribution<> inputParameterDistribution(inputUncertainty[2 * ipIndex], inputUncertainty[2 * ipIndex + 1]);
-                // Sample a value for it
-                inputParameters[ipIndex] = inputParameterDistribution(generator);
-            }
-
-            // 3. Simulate until time limit reached
-            std::vector<double> u(pModel->getNumInputs());
-            std::vector<double> z(pModel->getNumPredictedOutputs());
+        // Choose the key for the per-sample random number streams
+        std::uint64_t key = seed;
+        if (!fixedSeed) {
+            std::random_device rDevice;
+            key = (static_cast<std::uint64_t>(rDevice()) << 32) | rDevice();
+        }
+
+        // Place the initial draws of the samples, unless they are drawn from the random number streams
+        std::unique_ptr<SamplePoints> points;
+        if (sampling != Sampling::Random && sampling != Sampling::Antithetic) {
+            std::size_t dimensions = (x0.cumulativeWeights.empty() ? pModel->getNumStates() : 1) +
+                pModel->getNumInputParameters();
+            SamplePoints::Method method = SamplePoints::Method::LatinHypercube;
+            if (sampling == Sampling::Halton) {
+                method = SamplePoints::Method::Halton;
+            }
+            else if (sampling == Sampling::Sobol) {
+                method = SamplePoints::Method::Sobol;
+                if (dimensions > SamplePoints::MAX_SOBOL_DIMENSIONS) {
+                    log.WriteLine(LOG_ERROR, MODULE_NAME, "Too many states and input parameters for Sobol sampling");
+                    throw std::range_error("Too many states and input parameters for Sobol sampling");
+                }
+            }
+            points.reset(new SamplePoints(method, dimensions, numSamples, key));
+        }
+
+        // Occurrence and trajectories are written in place. Each trajectory holds numSamples values per
+        // time, so they all have the same stride.
+        SampleOutputs outputs;
+        outputs.occurrence = theEvent.occurrenceMatrix.words(0);
+        outputs.occurrenceStride = theEvent.occurrenceMatrix.wordStride();
+        outputs.toe.assign(numSamples, INFINITY);
+        outputs.trajectoryStride = 0;
+        for (auto trajectory : trajectoryPoints) {
+            outputs.trajectories.push_back(trajectory->sampleData(numTimes, numSamples));
+            outputs.trajectoryStride = trajectory->getSampleStride();
+        }
+
+        // Divide the samples into contiguous ranges, one per thread. Ranges are aligned to
+        // SAMPLE_BLOCK samples so that threads never share a word of the packed occurrence rows.
+        unsigned int numBlocks = std::max(1u, (numSamples + SAMPLE_BLOCK - 1) / SAMPLE_BLOCK);
+        unsigned int blocksPerWorker = (numBlocks + numThreads - 1) / numThreads;
+        unsigned int samplesPerWorker = blocksPerWorker * SAMPLE_BLOCK;
+        unsigned int numWorkers = (numBlocks + blocksPerWorker - 1) / blocksPerWorker;
+
+        std::vector<SampleStatistics> statistics(numWorkers);
+        for (auto & workerStatistics : statistics) {
+            workerStatistics.occurrences.assign(numTimes, 0);
+            workerStatistics.toeHistogram = Histogram(tP - pModel->getDt() / 2, pModel->getDt(), numTimes);
+        }
+
+        if (numWorkers == 1) {
+            simulateSamples(tP, x0, key, points.get(), 0, numSamples, numTimes, outputs, statistics[0]);
+        }
+        else {
+            PCOE_LOG_FORMAT(log, LOG_TRACE, MODULE_NAME, "Simulating %u samples in %u tasks", numSamples, numWorkers);
+            Executor::instance().parallelFor(numWorkers, [&](unsigned int w) {
+                unsigned int first = w * samplesPerWorker;
+                unsigned int last = std::min(numSamples, first + samplesPerWorker);
+                simulateSamples(tP, x0, key, points.get(), first, last, numTimes, outputs, statistics[w]);
+            });
+        }
+
+        // Store results. Trajectories are committed here, on the predictor thread, so that readers of
+        // the data points never write to them.
+        for (auto trajectory : trajectoryPoints) {
+            trajectory->commitSamples();
+        }
+        theEvent.timeOfEvent.setVec(outputs.toe);
+
+        SampleStatistics & total = statistics[0];
+        for (unsigned int w = 1; w < numWorkers; w++) {
+            for (unsigned int timeIndex = 0; timeIndex < numTimes; timeIndex++) {
+                total.occurrences[timeIndex] += statistics[w].occurrences[timeIndex];
+            }
+            total.toe.merge(statistics[w].toe);
+            total.toeHistogram.merge(statistics[w].toeHistogram);
+        }
+        if (numSamples > 0) {
+            for (unsigned int timeIndex = 0; timeIndex < numTimes; timeIndex++) {
+                theEvent.probMatrix[timeIndex] = static_cast<double>(total.occurrences[timeIndex]) / numSamples;
+            }
+            theEvent.eventProb = static_cast<double>(total.toe.count()) / numSamples;
+        }
+        theEvent.toeStatistics = total.toe;
+        theEvent.toeHistogram = total.toeHistogram;
+    }
+
+    // Simulate samples [first, last)
+    void MonteCarloPredictor::simulateSamples(const double tP, const StateDistribution & x0,
+                                              const std::uint64_t key, const SamplePoints * points,
+                                              const unsigned int first, const unsigned int last,
+                                              const unsigned int numTimes, SampleOutputs & outputs,
+                                              SampleStatistics & statistics) {
+        unsigned int numStates = pModel->getNumStates();
+        unsigned int numInputParameters = pModel->getNumInputParameters();
+        unsigned int numPredictedOutputs = pModel->getNumPredictedOutputs();
+
+        // Working storage, reused for every block. Each column holds one sample of the block.
+        Matrix X;
+        Matrix U;
+        Matrix N;
+        Matrix Z;
+        Matrix inputParameters;
+        std::vector<bool> occurred;
+        std::vector<Philox4x32> generators;
+        std::vector<double> signs;  // -1 for the second sample of an antithetic pair
+        unsigned int stateDimensions = x0.cumulativeWeights.empty() ? numStates : 1;
+        // Initial draws of a sample: a uniform value to choose a particle, or a normal value for each
+        // state, followed by a normal value for each input parameter
+        std::vector<double> draws(stateDimensions + numInputParameters);
+        unsigned int firstNormal = x0.cumulativeWeights.empty() ? 0 : 1;
+        std::vector<double> noise(numStates);
+
+        // For each block of samples
+        for (unsigned int blockStart = first; blockStart < last; blockStart += SAMPLE_BLOCK) {
+            unsigned int blockSize = std::min(SAMPLE_BLOCK, last - blockStart);
+            if (X.cols() != blockSize) {
+                X.resize(numStates, blockSize);
+                U.resize(pModel->getNumInputs(), blockSize);
+                N.resize(numStates, blockSize);
+                Z.resize(numPredictedOutputs, blockSize);
+                inputParameters.resize(numInputParameters, blockSize);
+            }
+
+            // Each sample has its own random number stream, so its results do not depend on the number of threads.
+            // Both samples of an antithetic pair use the stream of the pair.
+            generators.clear();
+            signs.clear();
+            for (unsigned int s = 0; s < blockSize; s++) {
+                unsigned int sample = blockStart + s;
+                bool antithetic = sampling == Sampling::Antithetic;
+                generators.push_back(Philox4x32(key, antithetic ? sample / 2 : sample));
+                signs.push_back(antithetic && sample % 2 == 1 ? -1.0 : 1.0);
+            }
+
+            for (unsigned int s = 0; s < blockSize; s++) {
+                Philox4x32 & generator = generators[s];
+                const double * point = points == nullptr ? nullptr : (*points)[blockStart + s];
+                if (point == nullptr) {
+                    if (firstNormal > 0) {
+                        draws[0] = uniformOpen(generator);
+                    }
+                    fillNormal(generator, draws.data() + firstNormal, draws.size() - firstNormal);
+                    if (signs[s] < 0) {
+                        if (firstNormal > 0) {
+                            draws[0] = 1 - draws[0];
+                        }
+                        for (std::size_t i = firstNormal; i < draws.size(); i++) {
+                            draws[i] = -draws[i];
+                        }
+                    }
+                }
+                else {
+                    if (firstNormal > 0) {
+                        draws[0] = point[0];
+                    }
+                    inverseNormalCdf(point + firstNormal, draws.data() + firstNormal, draws.size() - firstNormal);
+                }
+
+                // 1. Sample the state
+                if (!x0.cumulativeWeights.empty()) {
+                    // Draw a particle with probability proportional to its weight
+                    double u = draws[0] * x0.cumulativeWeights.back();
+                    auto chosen = std::upper_bound(x0.cumulativeWeights.begin(), x0.cumulativeWeights.end(), u);
+                    std::size_t particle = std::min(static_cast<std::size_t>(chosen - x0.cumulativeWeights.begin()),
+                                                    x0.cumulativeWeights.size() - 1);
+                    for (unsigned int i = 0; i < numStates; i++) {
+                        X[i][s] = x0.particles[i][particle];
+                    }
+                }
+                else {
+                    // x = xMean + chol(Pxx)*r, where r is standard normal
+                    for (unsigned int i = 0; i < numStates; i++) {
+                        double x = x0.mean[i];
+                        for (unsigned int j = 0; j <= i; j++) {
+                            x += x0.chol[i][j] * draws[j];
+                        }
+                        X[i][s] = x;
+                    }
+                }
+
+                // 2. Sample the input parameters
+                // For now, hard-code and assume Gaussian, but these should be specified somehow in the configMap
+                // Assuming that for each input parameter, we have specified mean and standard deviation
+                // We have a list of pairs (mean,stddev) for each input parameter
+                // The order must correspond to the order of the input parameters in the model:
+                //   mean_ip1, stddev_ip1, mean_ip2, stddev_ip2, ...
+                for (unsigned int ipIndex = 0; ipIndex < numInputParameters; ipIndex++) {
+                    inputParameters[ipIndex][s] = inputUncertainty[2 * ipIndex] +
+                        inputUncertainty[2 * ipIndex + 1] * draws[stateDimensions + ipIndex];
+                }
+            }
+
+            // 3. Simulate the block until time limit reached
+            // Samples that are still being simulated occupy the first activeCount columns
+            std::vector<unsigned int> activeSamples;
+            for (unsigned int s = 0; s < blockSize; s++) {
+                activeSamples.push_back(blockStart + s);
+            }
             double t = tP;
             unsigned int timeIndex = 0;
-            data.events[event].timeOfEvent[sample] = INFINITY;
             while (t <= tP + horizon) {
                 // Get inputs for time t
-                pModel->inputEqn(t, inputParameters, u);
+                pModel->inputEqnBatch(t, inputParameters, U);
 
                 // Check threshold at time t and set timeOfEvent if reaching for first time
                 // If timeOfEvent is not set to INFINITY that means we already encountered the event,
                 // and we don't want to overwrite that.
-                auto & theEvent = data.events[event];
-                theEvent.occurrenceMatrix[timeIndex][sample] = pModel->thresholdEqn(t, x, u);
-                if (pModel->thresholdEqn(t, x, u) && theEvent.timeOfEvent[sample] == INFINITY) {
-                    theEvent.timeOfEvent[sample] = t;
+                pModel->thresholdEqnBatch(t, X, U, occurred);
+                OccurrenceMatrix::Word * occurrence = outputs.occurrence + timeIndex * outputs.occurrenceStride;
+                for (unsigned int s = 0; s < activeSamples.size(); s++) {
+                    unsigned int sample = activeSamples[s];
+                    OccurrenceMatrix::Word bit = OccurrenceMatrix::Word(1) << (sample % OccurrenceMatrix::WORD_BITS);
+                    if (occurred[s]) {
+                        occurrence[sample / OccurrenceMatrix::WORD_BITS] |= bit;
+                        statistics.occurrences[timeIndex]++;
+                        if (std::isinf(outputs.toe[sample])) {
+                            outputs.toe[sample] = t;
+                            statistics.toe.add(t);
+                            statistics.toeHistogram.add(t);
+                        }
+                    }
+                    else {
+                        occurrence[sample / OccurrenceMatrix::WORD_BITS] &= ~bit;
+                    }
                 }
 
                 // Write to system trajectory (model variables for which we are interested in predicted values)
-                pModel->predictedOutputEqn(t, x, u, z);
-                for (unsigned int p = 0; p < pModel->getNumPredictedOutputs(); p++) {
-                    data.sysTrajectories[predictedOutputs[p]][timeIndex][sample] = z[p];
+                pModel->predictedOutputEqnBatch(t, X, U, Z);
+                for (unsigned int p = 0; p < numPredictedOutputs; p++) {
+                    double * trajectory = outputs.trajectories[p] + timeIndex * outputs.trajectoryStride;
+                    for (unsigned int s = 0; s < activeSamples.size(); s++) {
+                        trajectory[activeSamples[s]] = Z[p][s];
+                    }
+                }
+
+                // Stop simulating samples that have reached the event. For the remaining time steps the
+                // event is marked as occurred and the trajectories are left undefined (NaN).
+                if (stopAtEvent) {
+                    unsigned int activeCount = 0;
+                    for (unsigned int s = 0; s < activeSamples.size(); s++) {
+                        unsigned int sample = activeSamples[s];
+                        if (occurred[s]) {
+                            OccurrenceMatrix::Word bit = OccurrenceMatrix::Word(1) << (sample % OccurrenceMatrix::WORD_BITS);
+                            for (unsigned int k = timeIndex + 1; k < numTimes; k++) {
+                                outputs.occurrence[k * outputs.occurrenceStride + sample / OccurrenceMatrix::WORD_BITS] |= bit;
+                                statistics.occurrences[k]++;
+                                for (unsigned int p = 0; p < numPredictedOutputs; p++) {
+                                    outputs.trajectories[p][k * outputs.trajectoryStride + sample] = NAN;
+                                }
+                            }
+                            continue;
+                        }
+                        if (activeCount != s) {
+                            for (unsigned int i = 0; i < numStates; i++) {
+                                X[i][activeCount] = X[i][s];
+                            }
+                            for (unsigned int i = 0; i < pModel->getNumInputs(); i++) {
+                                U[i][activeCount] = U[i][s];
+                            }
+                            for (unsigned int i = 0; i < numInputParameters; i++) {
+                                inputParameters[i][activeCount] = inputParameters[i][s];
+                            }
+                            generators[activeCount] = generators[s];
+                            signs[activeCount] = signs[s];
+                            activeSamples[activeCount] = sample;
+                        }
+                        activeCount++;
+                    }
+                    if (activeCount == 0) {
+                        break;
+                    }
+                    if (activeCount != activeSamples.size()) {
+                        activeSamples.resize(activeCount);
+                        generators.erase(generators.begin() + static_cast<std::ptrdiff_t>(activeCount), generators.end());
+                        signs.resize(activeCount);
+                        X.resize(numStates, activeCount);
+                        U.resize(pModel->getNumInputs(), activeCount);
+                        N.resize(numStates, activeCount);
+                        Z.resize(numPredictedOutputs, activeCount);
+                        inputParameters.resize(numInputParameters, activeCount);
+                    }
                 }
 
                 // Sample process noise - for now, assuming independent
-                std::vector<double> noise(pModel->getNumStates());
-                for (unsigned int xIndex = 0; xIndex < pModel->getNumStates(); xIndex++) {
-                    std::normal_distribution<> noiseDistribution(0, sqrt(processNoise[xIndex]));
-                    noise[xIndex] = noiseDistribution(generator);
+                for (unsigned int s = 0; s < activeSamples.size(); s++) {
+                    fillNormal(generators[s], noise.data(), numStates);
+                    for (unsigned int xIndex = 0; xIndex < numStates; xIndex++) {
+                        N[xIndex][s] = processNoiseSD[xIndex] * signs[s] * noise[xIndex];
+                    }
                 }
 
                 // Update state for t to t+dt
-                pModel->stateEqn(t, x, u, noise);
+                pModel->stateEqnBatch(t, X, U, N);
 
                 // Update time
                 t += pModel->getDt();
                 timeIndex++;
             }
+
+            // Samples in which the event did not occur within the horizon are counted above the bins
+            for (unsigned int sample = blockStart; sample < blockStart + blockSize; sample++) {
+                if (std::isinf(outputs.toe[sample])) {
+                    statistics.toeHistogram.add(INFINITY);
+                }
+            }
         }
     }
 }
@@ -20,8 +20,13 @@
 
 #include "Observer.h"
 
+#include <cmath>
+#include <stdexcept>
+#include <string>
 #include <vector>
 
+#include "ConfigMap.h"
+
 namespace PCOE {
     // Get current time
     double Observer::getTime() const {
@@ -37,4 +42,23 @@ namespace PCOE {
     bool Observer::isInitialized() const {
         return m_initialized;
     }
+
+    Matrix Observer::readSquareMatrix(const ConfigMap & configMap, const std::string & key,
+                                      const std::string & name, const char * moduleName) const {
+        const std::vector<std::string> & values = configMap.at(key);
+        std::size_t dimension = static_cast<std::size_t>(std::sqrt(values.size()));
+        if (dimension * dimension != values.size()) {
+            log.WriteLine(LOG_ERROR, moduleName, name + " is not a square matrix!");
+            throw std::domain_error(name + " is not a square matrix!");
+        }
+        Matrix result(dimension, dimension);
+        std::size_t index = 0;
+        for (std::size_t row = 0; row < dimension; row++) {
+            for (std::size_t col = 0; col < dimension; col++) {
+                result[row][col] = std::stod(values[index]);
+                index++;
+            }
+        }
+        return result;
+    }
 }
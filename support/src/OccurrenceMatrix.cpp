@@ -0,0 +1,96 @@
+// Copyright (c) 2016 United States Government as represented by
+// the Administrator of the National Aeronautics and Space Administration.
+// All Rights Reserved.
+
+#include <algorithm>
+
+#include "OccurrenceMatrix.h"
+
+namespace PCOE {
+    const OccurrenceMatrix::size_type OccurrenceMatrix::WORD_BITS;
+
+    // Bits at and above the size of each row are kept clear, so rows can be
+    // compared a word at a time.
+
+    bool OccurrenceMatrix::ConstRow::operator==(const ConstRow & other) const {
+        if (size() != other.size()) {
+            return false;
+        }
+        size_type nWords = (size() + WORD_BITS - 1) / WORD_BITS;
+        return std::equal(matrix->words(index), matrix->words(index) + nWords, other.matrix->words(other.index));
+    }
+
+    bool OccurrenceMatrix::ConstRow::operator==(const std::vector<bool> & other) const {
+        return size() == other.size() && std::equal(begin(), end(), other.begin());
+    }
+
+    void OccurrenceMatrix::Row::resize(size_type samples) {
+        matrix->reserve(samples);
+        matrix->lengths[index] = samples;
+        matrix->clearTail(index);
+    }
+
+    OccurrenceMatrix::Row & OccurrenceMatrix::Row::operator=(const std::vector<bool> & values) {
+        resize(values.size());
+        Word * rowWords = matrix->words(index);
+        std::fill(rowWords, rowWords + matrix->stride, Word(0));
+        for (size_type i = 0; i < values.size(); i++) {
+            if (values[i]) {
+                rowWords[i / WORD_BITS] |= Word(1) << (i % WORD_BITS);
+            }
+        }
+        return *this;
+    }
+
+    OccurrenceMatrix::OccurrenceMatrix() : stride(0) { }
+
+    void OccurrenceMatrix::resize(size_type rows, size_type samples) {
+        reserve(samples);
+        bits.resize(rows * stride, Word(0));
+        lengths.resize(rows, samples);
+    }
+
+    void OccurrenceMatrix::setSamples(size_type samples) {
+        reserve(samples);
+        for (size_type row = 0; row < lengths.size(); row++) {
+            lengths[row] = samples;
+            clearTail(row);
+        }
+    }
+
+    bool OccurrenceMatrix::operator==(const OccurrenceMatrix & other) const {
+        if (size() != other.size()) {
+            return false;
+        }
+        for (size_type row = 0; row < size(); row++) {
+            if ((*this)[row] != other[row]) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    void OccurrenceMatrix::reserve(size_type samples) {
+        size_type newStride = (samples + WORD_BITS - 1) / WORD_BITS;
+        if (newStride <= stride) {
+            return;
+        }
+        std::vector<Word> newBits(lengths.size() * newStride, Word(0));
+        for (size_type row = 0; row < lengths.size(); row++) {
+            std::copy(words(row), words(row) + stride, newBits.begin() + static_cast<std::ptrdiff_t>(row * newStride));
+        }
+        bits.swap(newBits);
+        stride = newStride;
+    }
+
+    void OccurrenceMatrix::clearTail(size_type row) {
+        size_type length = lengths[row];
+        Word * rowWords = words(row);
+        size_type firstWord = length / WORD_BITS;
+        if (firstWord >= stride) {
+            return;
+        }
+        rowWords[firstWord] &= (Word(1) << (length % WORD_BITS)) - 1;
+        std::fill(rowWords + firstWord + 1, rowWords + stride, Word(0));
+    }
+}
@@ -0,0 +1,475 @@
+/**  ParticleFilter - Body
+ *   @file       ParticleFilter.cpp
+ *   @ingroup    GPIC++
+ *   @ingroup    Observer
+ *
+ *   @brief      Particle filter class. Implements sequential importance resampling
+ *               state estimation for nonlinear models. Uses the Model class.
+ *
+ *   @version    0.1.0
+ *
+ *   @pre        N/A
+ *
+ *      Created: October 15, 2026
+ *
+ *   @copyright Copyright (c) 2016 United States Government as represented by
+ *     the Administrator of the National Aeronautics and Space Administration.
+ *     All Rights Reserved.
+ */
+
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "Executor.h"
+#include "GSAPConfigMap.h"
+#include "Model.h"
+#include "Random.h"
+#include "UData.h"
+
+#include "Exceptions.h"
+#include "ParticleFilter.h"
+
+namespace PCOE {
+    // Configuration Keys
+    const std::string Q_KEY = "Observer.Q";
+    const std::string R_KEY = "Observer.R";
+    const std::string NUMPARTICLES_KEY = "Observer.numParticles";
+    const std::string NUMTHREADS_KEY = "Observer.numThreads";
+    const std::string SEED_KEY = "Observer.seed";
+    const std::string RESAMPLE_KEY = "Observer.resampleThreshold";
+
+    // Other string constants
+    // A C string, so that logging from step does not allocate
+    const char MODULE_NAME[] = "ParticleFilter";
+
+    // Number of particles advanced together through the model's batched equations. Threads are
+    // given whole blocks.
+    const unsigned int PARTICLE_BLOCK = 256;
+
+    namespace {
+        // Random number stream of a particle in a step. Each step uses 2^32 streams, one per
+        // particle, so results do not depend on how particles are divided among threads.
+        inline std::uint64_t particleStream(std::uint64_t step, unsigned int particle) {
+            return (step << 32) | particle;
+        }
+
+        // x += L*r for lower triangular L
+        inline void addCorrelated(const Matrix & L, const std::vector<double> & r, Matrix & X,
+                                  std::size_t column) {
+            for (std::size_t i = 0; i < L.rows(); i++) {
+                const double * row = L.rowData(i);
+                double sum = 0;
+                for (std::size_t j = 0; j <= i; j++) {
+                    sum += row[j] * r[j];
+                }
+                X[i][column] += sum;
+            }
+        }
+    }
+
+    // Constructor
+    ParticleFilter::ParticleFilter(Model * model, const Matrix Q, const Matrix R,
+                                   const unsigned int numParticles)
+        : Observer(), m_numParticles(numParticles), m_numThreads(1), m_resampleThreshold(0.5),
+          m_fixedSeed(false), m_seed(0), m_stepCount(0) {
+        if (m_numParticles == 0) {
+            log.WriteLine(LOG_ERROR, MODULE_NAME, "numParticles must be positive");
+            throw std::range_error("numParticles must be positive");
+        }
+
+        // Set the model (use the function so that it sets up the other stuff)
+        setModel(model);
+
+        // Set Q, R
+        m_Q = Q;
+        m_R = R;
+
+        // Check that Q and R are the right size
+        if (m_Q.rows() != m_Q.cols() || m_Q.rows() != pModel->getNumStates()) {
+            log.WriteLine(LOG_ERROR, MODULE_NAME, "Q does not have the right number of values");
+            throw std::range_error("Q does not have the right number of values");
+        }
+        if (m_R.rows() != m_R.cols() || m_R.rows() != pModel->getNumOutputs()) {
+            log.WriteLine(LOG_ERROR, MODULE_NAME, "R does not have the right number of values");
+            throw std::range_error("R does not have the right number of values");
+        }
+    }
+
+    // GSAPConfigMap-based Constructor
+    ParticleFilter::ParticleFilter(GSAPConfigMap & configMap)
+        : Observer(), m_numThreads(1), m_resampleThreshold(0.5), m_fixedSeed(false), m_seed(0),
+          m_stepCount(0) {
+        // Check for required parameters: Q, R, numParticles
+        configMap.checkRequiredParams({ Q_KEY, R_KEY, NUMPARTICLES_KEY });
+
+        log.WriteLine(LOG_DEBUG, MODULE_NAME, "Setting Q");
+        m_Q = readSquareMatrix(configMap, Q_KEY, "Q", MODULE_NAME);
+        log.WriteLine(LOG_DEBUG, MODULE_NAME, "Setting R");
+        m_R = readSquareMatrix(configMap, R_KEY, "R", MODULE_NAME);
+
+        m_numParticles = static_cast<unsigned int>(std::stoul(configMap.at(NUMPARTICLES_KEY)[0]));
+        if (m_numParticles == 0) {
+            log.WriteLine(LOG_ERROR, MODULE_NAME, "numParticles must be positive");
+            throw std::range_error("numParticles must be positive");
+        }
+
+        // Set number of threads (optional). 0 means use one thread per core.
+        if (configMap.includes(NUMTHREADS_KEY)) {
+            setNumThreads(static_cast<unsigned int>(std::stoul(configMap.at(NUMTHREADS_KEY)[0])));
+        }
+
+        // Set seed (optional), for reproducible results
+        if (configMap.includes(SEED_KEY)) {
+            setSeed(std::stoull(configMap.at(SEED_KEY)[0]));
+        }
+
+        // Set resampling threshold (optional), as a fraction of the number of particles
+        if (configMap.includes(RESAMPLE_KEY)) {
+            m_resampleThreshold = std::stod(configMap.at(RESAMPLE_KEY)[0]);
+        }
+
+        log.FormatLine(LOG_INFO, MODULE_NAME, "Created particle filter with %u particles", m_numParticles);
+    }
+
+    // Set model
+    void ParticleFilter::setModel(Model * model) {
+        // Set the model pointer
+        pModel = model;
+
+        // Set up variables that are dependent on the model
+        m_xEstimated.resize(pModel->getNumStates());
+        m_uOld.resize(pModel->getNumInputs());
+        m_zEstimated.resize(pModel->getNumOutputs());
+    }
+
+    // Set number of threads
+    void ParticleFilter::setNumThreads(unsigned int numThreads) {
+        m_numThreads = numThreads == 0 ? Executor::instance().getNumWorkers() : numThreads;
+    }
+
+    // Set seed
+    void ParticleFilter::setSeed(std::uint64_t seed) {
+        m_seed = seed;
+        m_fixedSeed = true;
+    }
+
+    // Run task(first, last, workspace) on contiguous ranges of whole blocks of particles
+    template <typename Function>
+    void ParticleFilter::forEachRange(Function task) {
+        unsigned int numBlocks = (m_numParticles + PARTICLE_BLOCK - 1) / PARTICLE_BLOCK;
+        unsigned int numThreads = static_cast<unsigned int>(m_work.size());
+        unsigned int blocksPerWorker = (numBlocks + numThreads - 1) / numThreads;
+        unsigned int particlesPerWorker = blocksPerWorker * PARTICLE_BLOCK;
+        unsigned int numWorkers = (numBlocks + blocksPerWorker - 1) / blocksPerWorker;
+
+        if (numWorkers == 1) {
+            task(0, m_numParticles, m_work[0]);
+            return;
+        }
+
+        Executor::instance().parallelFor(numWorkers, [&](unsigned int w) {
+            unsigned int first = w * particlesPerWorker;
+            unsigned int last = std::min(m_numParticles, first + particlesPerWorker);
+            task(first, last, m_work[w]);
+        });
+    }
+
+    // Initialize function (required by Observer interface)
+    void ParticleFilter::initialize(const double t0, const std::vector<double> & x0,
+                                    const std::vector<double> & u0) {
+        log.WriteLine(LOG_DEBUG, MODULE_NAME, "Initializing");
+
+        // Check that model has been set
+        if (pModel == NULL) {
+            log.WriteLine(LOG_ERROR, MODULE_NAME, "Particle filter does not have a model!");
+            throw ConfigurationError("Particle filter does not have a model!");
+        }
+
+        // Check that Q and R were set consistent with the model
+        if (m_Q.rows() != pModel->getNumStates()) {
+            log.WriteLine(LOG_ERROR, MODULE_NAME, "Q does not have the right number of values");
+            throw std::range_error("Q does not have the right number of values");
+        }
+        if (m_R.rows() != pModel->getNumOutputs()) {
+            log.WriteLine(LOG_ERROR, MODULE_NAME, "R does not have the right number of values");
+            throw std::range_error("R does not have the right number of values");
+        }
+
+        // Factor the noise covariances once
+        try {
+            m_sqrtQ.factor(m_Q);
+            m_sqrtR.factor(m_R);
+        }
+        catch (std::domain_error &) {
+            log.WriteLine(LOG_ERROR, MODULE_NAME, "Q and R must be positive definite");
+            throw;
+        }
+
+        // Choose the key for the random number streams
+        if (!m_fixedSeed) {
+            std::random_device rDevice;
+            m_seed = (static_cast<std::uint64_t>(rDevice()) << 32) | rDevice();
+        }
+        m_stepCount = 0;
+
+        // Set up particle storage, and a workspace for each thread
+        unsigned int numStates = pModel->getNumStates();
+        unsigned int numOutputs = pModel->getNumOutputs();
+        unsigned int blockSize = std::min(PARTICLE_BLOCK, m_numParticles);
+        m_particles = Matrix(numStates, m_numParticles);
+        m_resampled = Matrix(numStates, m_numParticles);
+        m_outputs = Matrix(numOutputs, m_numParticles);
+        m_weights.assign(m_numParticles, 1.0 / m_numParticles);
+        m_logLikelihoods.assign(m_numParticles, 0.0);
+        m_work.resize(m_numThreads);
+        for (auto & work : m_work) {
+            work.X = Matrix(numStates, blockSize);
+            work.U = Matrix(pModel->getNumInputs(), blockSize);
+            work.N = Matrix(numStates, blockSize);
+            work.zeroNoiseZ = Matrix(numOutputs, blockSize);
+            work.Z = Matrix(numOutputs, blockSize);
+            work.random.resize(numStates);
+            work.residual.resize(numOutputs);
+        }
+
+        // Initialize time, state, inputs
+        m_t = t0;
+        m_xEstimated = x0;
+        m_uOld = u0;
+
+        // Sample the particles from N(x0, Q)
+        forEachRange([&](unsigned int first, unsigned int last, Workspace &) {
+            sampleParticles(x0, first, last);
+        });
+
+        // Compute corresponding output estimate
+        std::vector<double> zeroNoiseZ(numOutputs);
+        pModel->outputEqn(m_t, m_xEstimated, m_uOld, zeroNoiseZ, m_zEstimated);
+
+        // Set initialized flag
+        m_initialized = true;
+        log.WriteLine(LOG_DEBUG, MODULE_NAME, "Initialize completed");
+    }
+
+    // Sample initial particles
+    void ParticleFilter::sampleParticles(const std::vector<double> & x0, const unsigned int first,
+                                         const unsigned int last) {
+        unsigned int numStates = pModel->getNumStates();
+        std::vector<double> random(numStates);
+        for (unsigned int p = first; p < last; p++) {
+            Philox4x32 generator(m_seed, particleStream(m_stepCount, p));
+            fillNormal(generator, random.data(), numStates);
+            for (unsigned int i = 0; i < numStates; i++) {
+                m_particles[i][p] = x0[i];
+            }
+            addCorrelated(m_sqrtQ.lower(), random, m_particles, p);
+        }
+    }
+
+    // Propagate particles [first, last) and compute their log-likelihoods
+    void ParticleFilter::propagateParticles(const double newT, const double dt,
+                                            const std::vector<double> & u,
+                                            const std::vector<double> & z,
+                                            const unsigned int first, const unsigned int last,
+                                            Workspace & work) {
+        unsigned int numStates = pModel->getNumStates();
+        unsigned int numInputs = pModel->getNumInputs();
+        unsigned int numOutputs = pModel->getNumOutputs();
+        const Matrix & sqrtQ = m_sqrtQ.lower();
+        const Matrix & sqrtR = m_sqrtR.lower();
+
+        for (unsigned int blockStart = first; blockStart < last; blockStart += PARTICLE_BLOCK) {
+            unsigned int blockSize = std::min(PARTICLE_BLOCK, last - blockStart);
+            if (work.X.cols() != blockSize) {
+                work.X.resize(numStates, blockSize);
+                work.U.resize(numInputs, blockSize);
+                work.N.resize(numStates, blockSize);
+                work.zeroNoiseZ = Matrix(numOutputs, blockSize);
+                work.Z.resize(numOutputs, blockSize);
+            }
+
+            // Copy the block of particles, and draw process noise for each
+            for (unsigned int i = 0; i < numStates; i++) {
+                const double * particles = m_particles.rowData(i) + blockStart;
+                std::copy(particles, particles + blockSize, work.X.rowData(i));
+                std::fill(work.N.rowData(i), work.N.rowData(i) + blockSize, 0.0);
+            }
+            for (unsigned int s = 0; s < blockSize; s++) {
+                Philox4x32 generator(m_seed, particleStream(m_stepCount, blockStart + s));
+                fillNormal(generator, work.random.data(), numStates);
+                addCorrelated(sqrtQ, work.random, work.N, s);
+            }
+
+            // Propagate the block through the state equation
+            for (unsigned int i = 0; i < numInputs; i++) {
+                std::fill(work.U.rowData(i), work.U.rowData(i) + blockSize, m_uOld[i]);
+            }
+            pModel->stateEqnBatch(newT, work.X, work.U, work.N, dt);
+
+            // Compute outputs, and the log-likelihood of z: -0.5*|inv(sqrtR)*(z - zi)|^2
+            for (unsigned int i = 0; i < numInputs; i++) {
+                std::fill(work.U.rowData(i), work.U.rowData(i) + blockSize, u[i]);
+            }
+            pModel->outputEqnBatch(newT, work.X, work.U, work.zeroNoiseZ, work.Z);
+            for (unsigned int s = 0; s < blockSize; s++) {
+                double sumSquares = 0;
+                for (unsigned int i = 0; i < numOutputs; i++) {
+                    const double * row = sqrtR.rowData(i);
+                    double r = z[i] - work.Z[i][s];
+                    for (unsigned int j = 0; j < i; j++) {
+                        r -= row[j] * work.residual[j];
+                    }
+                    r /= row[i];
+                    work.residual[i] = r;
+                    sumSquares += r * r;
+                }
+                m_logLikelihoods[blockStart + s] = -0.5 * sumSquares;
+            }
+
+            // Copy the block back
+            for (unsigned int i = 0; i < numStates; i++) {
+                std::copy(work.X.rowData(i), work.X.rowData(i) + blockSize, m_particles.rowData(i) + blockStart);
+            }
+            for (unsigned int i = 0; i < numOutputs; i++) {
+                std::copy(work.Z.rowData(i), work.Z.rowData(i) + blockSize, m_outputs.rowData(i) + blockStart);
+            }
+        }
+    }
+
+    // Step function (required by Observer interface)
+    void ParticleFilter::step(const double newT, const std::vector<double> & u,
+                              const std::vector<double> & z) {
+        PCOE_LOG_LINE(log, LOG_DEBUG, MODULE_NAME, "Starting step");
+
+        if (!isInitialized()) {
+            log.WriteLine(LOG_ERROR, MODULE_NAME, "Called step before initialized");
+            throw std::domain_error("ParticleFilter::step not initialized");
+        }
+
+        // Update time
+        double dt = newT - m_t;
+        if (dt <= 0) {
+            log.WriteLine(LOG_ERROR, MODULE_NAME, "dt is less than or equal to zero");
+            throw std::domain_error("ParticleFilter::step dt is 0");
+        }
+        m_t = newT;
+        m_stepCount++;
+
+        // 1. Propagate and weight the particles, in parallel
+        forEachRange([&](unsigned int first, unsigned int last, Workspace & work) {
+            propagateParticles(newT, dt, u, z, first, last, work);
+        });
+
+        // 2. Update the weights, scaling likelihoods by the largest so that they do not underflow.
+        // Particles with zero weight stay at zero; scaling them could overflow, giving 0 * inf.
+        double maxLogLikelihood = -INFINITY;
+        for (unsigned int p = 0; p < m_numParticles; p++) {
+            if (m_weights[p] > 0) {
+                maxLogLikelihood = std::max(maxLogLikelihood, m_logLikelihoods[p]);
+            }
+        }
+        double sum = 0;
+        for (unsigned int p = 0; p < m_numParticles; p++) {
+            if (m_weights[p] > 0) {
+                m_weights[p] *= std::exp(m_logLikelihoods[p] - maxLogLikelihood);
+                sum += m_weights[p];
+            }
+        }
+        if (!(sum > 0) || !std::isfinite(sum)) {
+            log.WriteLine(LOG_ERROR, MODULE_NAME, "All particle weights are zero");
+            throw std::domain_error("ParticleFilter::step all particle weights are zero");
+        }
+        double sumSquares = 0;
+        for (unsigned int p = 0; p < m_numParticles; p++) {
+            m_weights[p] /= sum;
+            sumSquares += m_weights[p] * m_weights[p];
+        }
+
+        // 3. Compute state and output estimates as the weighted means of the particles
+        weightedMeanInto(m_particles, m_xEstimated);
+        weightedMeanInto(m_outputs, m_zEstimated);
+
+        // 4. Resample if the effective sample size has become too small
+        double effectiveSampleSize = 1 / sumSquares;
+        if (effectiveSampleSize < m_resampleThreshold * m_numParticles) {
+            PCOE_LOG_FORMAT(log, LOG_TRACE, MODULE_NAME, "Resampling, effective sample size %f", effectiveSampleSize);
+            resample();
+        }
+
+        // Update uOld
+        m_uOld = u;
+    }
+
+    // Weighted mean of the columns of X
+    void ParticleFilter::weightedMeanInto(const Matrix & X, std::vector<double> & mean) const {
+        for (unsigned int i = 0; i < X.rows(); i++) {
+            const double * row = X.rowData(i);
+            double sum = 0;
+            for (unsigned int p = 0; p < m_numParticles; p++) {
+                sum += m_weights[p] * row[p];
+            }
+            mean[i] = sum;
+        }
+    }
+
+    // Systematic resampling: a single uniform draw places N evenly spaced pointers on the
+    // cumulative weights, so the selection takes O(N) time
+    void ParticleFilter::resample() {
+        Philox4x32 generator(m_seed, particleStream(m_stepCount, m_numParticles));
+        double spacing = 1.0 / m_numParticles;
+        double pointer = uniformOpen(generator) * spacing;
+        double cumulative = m_weights[0];
+        unsigned int source = 0;
+        for (unsigned int p = 0; p < m_numParticles; p++) {
+            while (pointer > cumulative && source + 1 < m_numParticles) {
+                source++;
+                cumulative += m_weights[source];
+            }
+            for (unsigned int i = 0; i < m_particles.rows(); i++) {
+                m_resampled[i][p] = m_particles[i][source];
+            }
+            pointer += spacing;
+        }
+        swap(m_particles, m_resampled);
+        std::fill(m_weights.begin(), m_weights.end(), spacing);
+    }
+
+    // Get state mean
+    const std::vector<double> & ParticleFilter::getStateMean() const {
+        return m_xEstimated;
+    }
+
+    // Get output mean
+    const std::vector<double> & ParticleFilter::getOutputMean() const {
+        return m_zEstimated;
+    }
+
+    // Get particles
+    const Matrix & ParticleFilter::getParticles() const {
+        return m_particles;
+    }
+
+    // Get weights
+    const std::vector<double> & ParticleFilter::getWeights() const {
+        return m_weights;
+    }
+
+    std::vector<UData> ParticleFilter::getStateEstimate() const {
+        std::vector<UData> state(pModel->getNumStates());
+        std::vector<double> samples(2 * m_numParticles);
+        for (unsigned int i = 0; i < pModel->getNumStates(); i++) {
+            const double * row = m_particles.rowData(i);
+            for (unsigned int p = 0; p < m_numParticles; p++) {
+                samples[SAMPLE(p)] = row[p];
+                samples[WEIGHT(p)] = m_weights[p];
+            }
+            state[i].uncertainty(UType::WSamples);
+            state[i].npoints(m_numParticles);
+            state[i].setVec(samples);
+        }
+        return state;
+    }
+}
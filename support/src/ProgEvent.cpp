@@ -34,7 +34,7 @@ namespace PCOE {
     ProgEvent::ProgEvent() : ProgMeta(),
         nSamples(0) {
         probMatrix.resize(1, NAN);
-        occurrenceMatrix.resize(1, std::vector<bool>(nSamples));
+        occurrenceMatrix.resize(1, nSamples);
     }
 
     void ProgEvent::setUncertainty(const UType uncertType) {
@@ -49,7 +49,7 @@ namespace PCOE {
 
     void ProgEvent::setNumTimes(const unsigned int nTimes) {
         probMatrix.resize(nTimes + 1, NAN);  // +1 for NOW
-        occurrenceMatrix.resize(nTimes + 1, std::vector<bool>(nSamples));
+        occurrenceMatrix.resize(nTimes + 1, nSamples);
     }
 
     unsigned int ProgEvent::getNumTimes() const {
@@ -58,9 +58,7 @@ namespace PCOE {
 
     void ProgEvent::setNumOccurrenceSamples(const unsigned int nSamplesIn) {
         nSamples = nSamplesIn;
-        for (auto & it : occurrenceMatrix) {
-            it.resize(nSamples);
-        }
+        occurrenceMatrix.setSamples(nSamples);
     }
 
     unsigned int ProgEvent::getNumOccurrenceSamples() const {
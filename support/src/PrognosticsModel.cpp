@@ -0,0 +1,72 @@
+/**  PrognosticsModel - Body
+*   @file       PrognosticsModel.cpp
+*   @ingroup    GSAP-Support
+*
+*   @brief      PrognosticsModel class.
+*               Default (per-sample) implementations of the batched equations.
+*
+*   @version    0.1.0
+*
+*   @pre        N/A
+*
+*      Created: October 15, 2026
+*
+*   @copyright Copyright (c) 2016 United States Government as represented by
+*     the Administrator of the National Aeronautics and Space Administration.
+*     All Rights Reserved.
+*/
+
+#include "PrognosticsModel.h"
+
+#include <vector>
+
+namespace PCOE {
+    void PrognosticsModel::thresholdEqnBatch(const double t, const Matrix & X, const Matrix & U,
+        std::vector<bool> & occurred) {
+        std::vector<double> x(numStates);
+        std::vector<double> u(numInputs);
+        occurred.resize(X.cols());
+        for (std::size_t sample = 0; sample < X.cols(); sample++) {
+            for (unsigned int i = 0; i < numStates; i++) {
+                x[i] = X[i][sample];
+            }
+            for (unsigned int i = 0; i < numInputs; i++) {
+                u[i] = U[i][sample];
+            }
+            occurred[sample] = thresholdEqn(t, x, u);
+        }
+    }
+
+    void PrognosticsModel::inputEqnBatch(const double t, const Matrix & inputParameters, Matrix & U) {
+        std::vector<double> params(numInputParameters);
+        std::vector<double> u(numInputs);
+        for (std::size_t sample = 0; sample < inputParameters.cols(); sample++) {
+            for (unsigned int i = 0; i < numInputParameters; i++) {
+                params[i] = inputParameters[i][sample];
+            }
+            inputEqn(t, params, u);
+            for (unsigned int i = 0; i < numInputs; i++) {
+                U[i][sample] = u[i];
+            }
+        }
+    }
+
+    void PrognosticsModel::predictedOutputEqnBatch(const double t, const Matrix & X, const Matrix & U,
+        Matrix & Z) {
+        std::vector<double> x(numStates);
+        std::vector<double> u(numInputs);
+        std::vector<double> z(numPredictedOutputs);
+        for (std::size_t sample = 0; sample < X.cols(); sample++) {
+            for (unsigned int i = 0; i < numStates; i++) {
+                x[i] = X[i][sample];
+            }
+            for (unsigned int i = 0; i < numInputs; i++) {
+                u[i] = U[i][sample];
+            }
+            predictedOutputEqn(t, x, u, z);
+            for (unsigned int i = 0; i < numPredictedOutputs; i++) {
+                Z[i][sample] = z[i];
+            }
+        }
+    }
+}
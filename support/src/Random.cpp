@@ -0,0 +1,57 @@
+// Copyright (c) 2016 United States Government as represented by
+// the Administrator of the National Aeronautics and Space Administration.
+// All Rights Reserved.
+
+#include <algorithm>
+#include <cmath>
+
+#include "Random.h"
+
+namespace PCOE {
+    namespace {
+        // Pairs of normals produced per Box-Muller chunk
+        const std::size_t NORMAL_CHUNK = 64;
+        const double twoPi = 6.28318530717958647693;
+    }
+
+    void fillUniform(Philox4x32 & generator, double * values, std::size_t count) {
+        for (std::size_t i = 0; i < count; i++) {
+            values[i] = uniformOpen(generator);
+        }
+    }
+
+    void fillNormal(Philox4x32 & generator, double * values, std::size_t count) {
+        double radius[NORMAL_CHUNK];
+        double angle[NORMAL_CHUNK];
+        while (count > 0) {
+            std::size_t pairs = std::min(NORMAL_CHUNK, (count + 1) / 2);
+            for (std::size_t i = 0; i < pairs; i++) {
+                radius[i] = uniformOpen(generator);
+                angle[i] = uniformOpen(generator);
+            }
+            for (std::size_t i = 0; i < pairs; i++) {
+                radius[i] = std::sqrt(-2 * std::log(radius[i]));
+                angle[i] *= twoPi;
+            }
+
+            std::size_t whole = std::min(pairs, count / 2);
+            for (std::size_t i = 0; i < whole; i++) {
+                values[2 * i] = radius[i] * std::cos(angle[i]);
+                values[2 * i + 1] = radius[i] * std::sin(angle[i]);
+            }
+            if (whole < pairs) {
+                values[2 * whole] = radius[whole] * std::cos(angle[whole]);
+            }
+
+            std::size_t filled = std::min(2 * pairs, count);
+            values += filled;
+            count -= filled;
+        }
+    }
+
+    void inverseNormalCdf(const double * p, double * x, std::size_t count) {
+        for (std::size_t i = 0; i < count; i++) {
+            x[i] = inverseNormalCdf(p[i]);
+        }
+    }
+}
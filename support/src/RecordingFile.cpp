@@ -0,0 +1,224 @@
+// Copyright (c) 2016 United States Government as represented by
+// the Administrator of the National Aeronautics and Space Administration.
+// All Rights Reserved.
+
+#include <cstring>
+#include <stdexcept>
+
+#include "Exceptions.h"
+#include "RecordingFile.h"
+
+namespace PCOE {
+    static const char FILE_MAGIC[8] = { 'G', 'S', 'A', 'P', 'R', 'E', 'C', '\0' };
+    static const std::uint32_t VERSION = 1;
+    static const std::uint32_t CHUNK_MAGIC = 0x4B4E4843;  // CHNK
+    static const std::size_t CHUNK_HEADER_SIZE = 16;
+    static const std::size_t ALIGNMENT = 8;
+
+    namespace {
+        inline std::size_t padded(std::size_t size) {
+            return (size + ALIGNMENT - 1) / ALIGNMENT * ALIGNMENT;
+        }
+
+        template <class T>
+        void put(std::vector<char> & out, const T & value) {
+            const char * bytes = reinterpret_cast<const char *>(&value);
+            out.insert(out.end(), bytes, bytes + sizeof(T));
+        }
+
+        template <class T>
+        void putArray(std::vector<char> & out, const std::vector<T> & values) {
+            const char * bytes = reinterpret_cast<const char *>(values.data());
+            out.insert(out.end(), bytes, bytes + values.size() * sizeof(T));
+            out.resize(padded(out.size()), '\0');
+        }
+
+        template <class T>
+        T readAt(const char * data) {
+            T value;
+            std::memcpy(&value, data, sizeof(T));
+            return value;
+        }
+    }
+
+    RecordingWriter::RecordingWriter(const std::string & path, std::size_t rowsPerChunk)
+        : file(std::fopen(path.c_str(), "wb")), chunkRows(rowsPerChunk == 0 ? 1 : rowsPerChunk), nextColumn(0) {
+        if (file == nullptr) {
+            throw std::runtime_error("Could not create recording file");
+        }
+    }
+
+    RecordingWriter::~RecordingWriter() {
+        flush();
+        std::fclose(file);
+    }
+
+    void RecordingWriter::setColumns(const std::vector<RecordingColumn> & newColumns) {
+        if (!columns.empty()) {
+            throw std::logic_error("Recording columns are already set");
+        }
+        columns = newColumns;
+        data.resize(columns.size());
+
+        buffer.clear();
+        buffer.insert(buffer.end(), FILE_MAGIC, FILE_MAGIC + sizeof(FILE_MAGIC));
+        put(buffer, VERSION);
+        put(buffer, static_cast<std::uint32_t>(columns.size()));
+        for (const auto & column : columns) {
+            put(buffer, static_cast<std::uint32_t>(column.kind));
+            put(buffer, static_cast<std::uint32_t>(column.name.size()));
+            buffer.insert(buffer.end(), column.name.begin(), column.name.end());
+            buffer.resize(padded(buffer.size()), '\0');
+        }
+        std::fwrite(buffer.data(), 1, buffer.size(), file);
+        std::fflush(file);
+    }
+
+    void RecordingWriter::beginRow(std::int64_t time) {
+        rowTimes.push_back(time);
+        nextColumn = 0;
+    }
+
+    void RecordingWriter::add(const double * values, std::size_t count, bool valid, std::int64_t time) {
+        if (nextColumn >= data.size()) {
+            throw std::out_of_range("More columns added than the recording has");
+        }
+        ColumnData & column = data[nextColumn++];
+        column.counts.push_back(static_cast<std::uint32_t>(count));
+        column.valid.push_back(valid ? 1 : 0);
+        column.times.push_back(time);
+        column.values.insert(column.values.end(), values, values + count);
+    }
+
+    void RecordingWriter::endRow() {
+        // Columns that were not added are empty
+        for (; nextColumn < data.size(); nextColumn++) {
+            ColumnData & column = data[nextColumn];
+            column.counts.push_back(0);
+            column.valid.push_back(0);
+            column.times.push_back(0);
+        }
+        if (rowTimes.size() >= chunkRows) {
+            flush();
+        }
+    }
+
+    void RecordingWriter::flush() {
+        if (rowTimes.empty()) {
+            return;
+        }
+
+        buffer.clear();
+        put(buffer, CHUNK_MAGIC);
+        put(buffer, static_cast<std::uint32_t>(rowTimes.size()));
+        put(buffer, std::uint64_t(0));  // Payload size, set below
+        putArray(buffer, rowTimes);
+        for (auto & column : data) {
+            putArray(buffer, column.counts);
+            putArray(buffer, column.valid);
+            putArray(buffer, column.times);
+            putArray(buffer, column.values);
+            column.counts.clear();
+            column.valid.clear();
+            column.times.clear();
+            column.values.clear();
+        }
+        std::uint64_t payloadSize = buffer.size() - CHUNK_HEADER_SIZE;
+        std::memcpy(&buffer[8], &payloadSize, sizeof(payloadSize));
+        rowTimes.clear();
+
+        std::fwrite(buffer.data(), 1, buffer.size(), file);
+        std::fflush(file);
+    }
+
+    bool RecordingReader::isRecording(const char * fileData, std::size_t fileSize) {
+        return fileSize >= sizeof(FILE_MAGIC) && std::memcmp(fileData, FILE_MAGIC, sizeof(FILE_MAGIC)) == 0;
+    }
+
+    RecordingReader::RecordingReader(const char * fileData, std::size_t fileSize)
+        : data(fileData), size(fileSize), next(0), rowCount(0), rowTimes(nullptr) {
+        if (!isRecording(data, size) || size < 16 || readAt<std::uint32_t>(data + 8) != VERSION) {
+            throw FormatError("Not a recording file");
+        }
+        std::uint32_t columnCount = readAt<std::uint32_t>(data + 12);
+        next = 16;
+        for (std::uint32_t i = 0; i < columnCount; i++) {
+            if (next + 8 > size) {
+                throw FormatError("Recording file header is truncated");
+            }
+            RecordingColumn column;
+            column.kind = static_cast<RecordingColumnKind>(readAt<std::uint32_t>(data + next));
+            std::uint32_t nameSize = readAt<std::uint32_t>(data + next + 4);
+            next += 8;
+            if (next + nameSize > size) {
+                throw FormatError("Recording file header is truncated");
+            }
+            column.name.assign(data + next, nameSize);
+            next = padded(next + nameSize);
+            columns.push_back(column);
+        }
+        views.resize(columns.size());
+    }
+
+    bool RecordingReader::nextChunk() {
+        rowCount = 0;
+        if (next + CHUNK_HEADER_SIZE > size || readAt<std::uint32_t>(data + next) != CHUNK_MAGIC) {
+            return false;
+        }
+        std::size_t rows = readAt<std::uint32_t>(data + next + 4);
+        std::uint64_t payloadSize = readAt<std::uint64_t>(data + next + 8);
+        if (payloadSize > size - next - CHUNK_HEADER_SIZE) {
+            // Incomplete chunk
+            return false;
+        }
+        const char * payload = data + next + CHUNK_HEADER_SIZE;
+        const char * payloadEnd = payload + payloadSize;
+
+        const char * p = payload;
+        auto take = [&](std::size_t bytes) {
+            if (padded(bytes) > static_cast<std::size_t>(payloadEnd - p)) {
+                throw FormatError("Recording chunk is malformed");
+            }
+            const char * block = p;
+            p += padded(bytes);
+            return block;
+        };
+        rowTimes = reinterpret_cast<const std::int64_t *>(take(rows * sizeof(std::int64_t)));
+        for (auto & view : views) {
+            view.counts = reinterpret_cast<const std::uint32_t *>(take(rows * sizeof(std::uint32_t)));
+            view.valid = reinterpret_cast<const std::uint8_t *>(take(rows));
+            view.times = reinterpret_cast<const std::int64_t *>(take(rows * sizeof(std::int64_t)));
+            view.offsets.resize(rows);
+            std::size_t total = 0;
+            for (std::size_t row = 0; row < rows; row++) {
+                view.offsets[row] = total;
+                total += view.counts[row];
+            }
+            view.values = reinterpret_cast<const double *>(take(total * sizeof(double)));
+        }
+
+        next += CHUNK_HEADER_SIZE + payloadSize;
+        rowCount = rows;
+        return true;
+    }
+
+    std::int64_t RecordingReader::rowTime(std::size_t row) const {
+        if (row >= rowCount) {
+            throw std::out_of_range("Row is not in the current chunk");
+        }
+        return rowTimes[row];
+    }
+
+    RecordingReader::Cell RecordingReader::get(std::size_t column, std::size_t row) const {
+        if (column >= views.size() || row >= rowCount) {
+            throw std::out_of_range("Cell is not in the current chunk");
+        }
+        const ColumnView & view = views[column];
+        Cell cell;
+        cell.values = view.values + view.offsets[row];
+        cell.count = view.counts[row];
+        cell.valid = view.valid[row] != 0;
+        cell.time = view.times[row];
+        return cell;
+    }
+}
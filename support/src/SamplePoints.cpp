@@ -0,0 +1,198 @@
+// Copyright (c) 2016 United States Government as represented by
+// the Administrator of the National Aeronautics and Space Administration.
+// All Rights Reserved.
+
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+#include "Random.h"
+#include "SamplePoints.h"
+
+namespace PCOE {
+    const std::size_t SamplePoints::MAX_SOBOL_DIMENSIONS;
+
+    namespace {
+        // Randomization draws from streams above those used for samples
+        const std::uint64_t STREAM_BASE = std::uint64_t(1) << 63;
+
+        /// Keep a coordinate inside (0, 1)
+        double interior(double u) {
+            const double epsilon = 1.0 / 9007199254740992.0;
+            return std::min(std::max(u, epsilon), 1 - epsilon);
+        }
+
+        // Sobol direction numbers for dimensions 2 to 21, from Joe and Kuo,
+        // "Constructing Sobol sequences with better two-dimensional projections"
+        // (2008), file new-joe-kuo-6.21201. The first dimension uses the
+        // identity. Each entry is the degree s and coefficients a of a
+        // primitive polynomial, and the initial direction numbers m.
+        struct SobolEntry {
+            unsigned int s;
+            unsigned int a;
+            unsigned int m[7];
+        };
+
+        const SobolEntry SOBOL_TABLE[] = {
+            { 1, 0, { 1 } },
+            { 2, 1, { 1, 3 } },
+            { 3, 1, { 1, 3, 1 } },
+            { 3, 2, { 1, 1, 1 } },
+            { 4, 1, { 1, 1, 3, 3 } },
+            { 4, 4, { 1, 3, 5, 13 } },
+            { 5, 2, { 1, 1, 5, 5, 17 } },
+            { 5, 4, { 1, 1, 5, 5, 5 } },
+            { 5, 7, { 1, 1, 7, 11, 19 } },
+            { 5, 11, { 1, 1, 5, 1, 1 } },
+            { 5, 13, { 1, 1, 1, 3, 11 } },
+            { 5, 14, { 1, 3, 5, 5, 31 } },
+            { 6, 1, { 1, 3, 3, 9, 7, 49 } },
+            { 6, 13, { 1, 1, 1, 15, 21, 21 } },
+            { 6, 16, { 1, 3, 1, 13, 27, 49 } },
+            { 6, 19, { 1, 1, 1, 15, 7, 5 } },
+            { 6, 22, { 1, 3, 1, 15, 13, 25 } },
+            { 6, 25, { 1, 1, 5, 5, 19, 61 } },
+            { 7, 1, { 1, 3, 7, 11, 23, 15, 103 } },
+            { 7, 4, { 1, 3, 7, 13, 13, 15, 69 } }
+        };
+
+        const unsigned int SOBOL_BITS = 32;
+    }
+
+    SamplePoints::SamplePoints(Method method, std::size_t dimensions, std::size_t count, std::uint64_t key)
+        : nDimensions(dimensions), nPoints(count), values(dimensions * count) {
+        switch (method) {
+        case Method::LatinHypercube:
+            generateLatinHypercube(key);
+            break;
+        case Method::Halton:
+            generateHalton(key);
+            break;
+        case Method::Sobol:
+            if (dimensions > MAX_SOBOL_DIMENSIONS) {
+                throw std::range_error("Too many dimensions for Sobol points");
+            }
+            generateSobol(key);
+            break;
+        default:
+            throw std::range_error("Unknown sampling method");
+        }
+    }
+
+    void SamplePoints::generateLatinHypercube(std::uint64_t key) {
+        std::vector<std::size_t> strata(nPoints);
+        for (std::size_t d = 0; d < nDimensions; d++) {
+            Philox4x32 generator(key, STREAM_BASE + d);
+            for (std::size_t i = 0; i < nPoints; i++) {
+                strata[i] = i;
+            }
+            // Fisher-Yates shuffle
+            for (std::size_t i = nPoints; i > 1; i--) {
+                std::size_t j = static_cast<std::size_t>(uniformOpen(generator) * static_cast<double>(i));
+                std::swap(strata[i - 1], strata[std::min(j, i - 1)]);
+            }
+            for (std::size_t i = 0; i < nPoints; i++) {
+                double u = (static_cast<double>(strata[i]) + uniformOpen(generator)) / static_cast<double>(nPoints);
+                values[i * nDimensions + d] = interior(u);
+            }
+        }
+    }
+
+    void SamplePoints::generateHalton(std::uint64_t key) {
+        // First nDimensions primes
+        std::vector<std::size_t> bases;
+        for (std::size_t candidate = 2; bases.size() < nDimensions; candidate++) {
+            bool prime = true;
+            for (std::size_t base : bases) {
+                if (candidate % base == 0) {
+                    prime = false;
+                    break;
+                }
+            }
+            if (prime) {
+                bases.push_back(candidate);
+            }
+        }
+
+        std::vector<std::size_t> permutations;
+        for (std::size_t d = 0; d < nDimensions; d++) {
+            Philox4x32 generator(key, STREAM_BASE + d);
+            std::size_t b = bases[d];
+            double base = static_cast<double>(b);
+
+            // One random permutation of the digits for each digit position, enough
+            // positions for full double precision. Positions past the last digit of
+            // i hold 0, which is permuted too, so the points fill the whole interval.
+            std::size_t nDigits = static_cast<std::size_t>(std::ceil(53 * std::log(2.0) / std::log(base)));
+            permutations.resize(nDigits * b);
+            for (std::size_t k = 0; k < nDigits; k++) {
+                std::size_t * permutation = permutations.data() + k * b;
+                for (std::size_t digit = 0; digit < b; digit++) {
+                    permutation[digit] = digit;
+                }
+                for (std::size_t digit = b; digit > 1; digit--) {
+                    std::size_t j = static_cast<std::size_t>(uniformOpen(generator) * static_cast<double>(digit));
+                    std::swap(permutation[digit - 1], permutation[std::min(j, digit - 1)]);
+                }
+            }
+
+            for (std::size_t i = 0; i < nPoints; i++) {
+                // Scrambled radical inverse of i
+                double u = 0;
+                double scale = 1 / base;
+                std::size_t n = i;
+                for (std::size_t k = 0; k < nDigits; k++) {
+                    u += static_cast<double>(permutations[k * b + n % b]) * scale;
+                    n /= b;
+                    scale /= base;
+                }
+                values[i * nDimensions + d] = interior(u);
+            }
+        }
+    }
+
+    void SamplePoints::generateSobol(std::uint64_t key) {
+        std::vector<std::uint32_t> direction(SOBOL_BITS);
+        for (std::size_t d = 0; d < nDimensions; d++) {
+            if (d == 0) {
+                for (unsigned int k = 0; k < SOBOL_BITS; k++) {
+                    direction[k] = std::uint32_t(1) << (SOBOL_BITS - 1 - k);
+                }
+            }
+            else {
+                const SobolEntry & entry = SOBOL_TABLE[d - 1];
+                for (unsigned int k = 0; k < SOBOL_BITS; k++) {
+                    if (k < entry.s) {
+                        direction[k] = entry.m[k] << (SOBOL_BITS - 1 - k);
+                    }
+                    else {
+                        std::uint32_t v = direction[k - entry.s] ^ (direction[k - entry.s] >> entry.s);
+                        for (unsigned int j = 1; j < entry.s; j++) {
+                            if ((entry.a >> (entry.s - 1 - j)) & 1) {
+                                v ^= direction[k - j];
+                            }
+                        }
+                        direction[k] = v;
+                    }
+                }
+            }
+
+            Philox4x32 generator(key, STREAM_BASE + d);
+            std::uint32_t shift = generator();
+            std::uint32_t x = 0;
+            for (std::size_t i = 0; i < nPoints; i++) {
+                // Gray code order: point i differs from point i - 1 by the
+                // direction number of the lowest zero bit of i - 1
+                if (i > 0) {
+                    std::size_t c = 0;
+                    for (std::size_t n = i - 1; n & 1; n >>= 1) {
+                        c++;
+                    }
+                    x ^= direction[c];
+                }
+                double u = (static_cast<double>(x ^ shift) + 0.5) / 4294967296.0;
+                values[i * nDimensions + d] = u;
+            }
+        }
+    }
+}
@@ -0,0 +1,49 @@
+// Copyright (c) 2016 United States Government as represented by
+// the Administrator of the National Aeronautics and Space Administration.
+// All Rights Reserved.
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+
+#include "SampleTensor.h"
+
+namespace PCOE {
+    static const std::size_t ALIGNMENT = 64;
+    static const std::size_t ALIGNED_ELEMENTS = ALIGNMENT / sizeof(double);
+
+    SampleTensor::SampleTensor() : offset(0), nRows(0), nCols(0), rowStride(0) { }
+
+    SampleTensor::SampleTensor(const SampleTensor & other) : SampleTensor() {
+        *this = other;
+    }
+
+    SampleTensor & SampleTensor::operator=(const SampleTensor & other) {
+        if (this != &other) {
+            // Copied row by row, since the copy's storage may be aligned differently
+            resize(other.nRows, other.nCols);
+            for (size_type r = 0; r < nRows; r++) {
+                std::copy(other.row(r), other.row(r) + nCols, row(r));
+            }
+        }
+        return *this;
+    }
+
+    void SampleTensor::resize(size_type rows, size_type cols) {
+        nRows = rows;
+        nCols = cols;
+        rowStride = (cols + ALIGNED_ELEMENTS - 1) / ALIGNED_ELEMENTS * ALIGNED_ELEMENTS;
+        storage.assign(rows * rowStride + ALIGNED_ELEMENTS, NAN);
+
+        std::uintptr_t address = reinterpret_cast<std::uintptr_t>(storage.data());
+        offset = ((ALIGNMENT - address % ALIGNMENT) % ALIGNMENT) / sizeof(double);
+    }
+
+    void SampleTensor::clear() {
+        std::vector<double>().swap(storage);
+        offset = 0;
+        nRows = 0;
+        nCols = 0;
+        rowStride = 0;
+    }
+}
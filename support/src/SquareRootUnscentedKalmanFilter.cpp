@@ -0,0 +1,399 @@
+/**  SquareRootUnscentedKalmanFilter - Body
+ *   @file       SquareRootUnscentedKalmanFilter.cpp
+ *   @ingroup    GPIC++
+ *   @ingroup    Observer
+ *
+ *   @brief      Square-root unscented Kalman filter class. Implements the square-root
+ *               UKF state estimation algorithm for nonlinear models. Uses the Model class.
+ *
+ *   @version    0.1.0
+ *
+ *   @pre        N/A
+ *
+ *      Created: October 15, 2026
+ *
+ *   @copyright Copyright (c) 2016 United States Government as represented by
+ *     the Administrator of the National Aeronautics and Space Administration.
+ *     All Rights Reserved.
+ */
+
+#include <algorithm>
+#include <string>
+#include <vector>
+#include <cmath>
+
+#include "GSAPConfigMap.h"
+#include "Model.h"
+#include "UData.h"
+
+#include "Exceptions.h"
+#include "SquareRootUnscentedKalmanFilter.h"
+
+namespace PCOE {
+    // Configuration Keys
+    const std::string Q_KEY = "Observer.Q";
+    const std::string R_KEY = "Observer.R";
+    const std::string K_KEY = "Observer.kappa";
+    const std::string A_KEY = "Observer.alpha";
+    const std::string B_KEY = "Observer.beta";
+
+    // Other string constants
+    // A C string, so that logging from step does not allocate
+    const char MODULE_NAME[] = "SquareRootUnscentedKalmanFilter";
+
+    namespace {
+        // Fill the compound matrix [sqrt(w)*centered(:, 1:end), sqrtNoise], whose
+        // product with its transpose is the covariance excluding the first sigma point
+        void fillCompound(const Matrix & centered, double w, const Matrix & sqrtNoise,
+                          Matrix & compound) {
+            double scale = std::sqrt(w);
+            std::size_t numPoints = centered.cols() - 1;
+            for (std::size_t i = 0; i < centered.rows(); i++) {
+                const double * c = centered.rowData(i);
+                const double * noise = sqrtNoise.rowData(i);
+                double * out = compound.rowData(i);
+                for (std::size_t j = 0; j < numPoints; j++) {
+                    out[j] = scale * c[j + 1];
+                }
+                std::copy(noise, noise + sqrtNoise.cols(), out + numPoints);
+            }
+        }
+    }
+
+    // Constructor
+    SquareRootUnscentedKalmanFilter::SquareRootUnscentedKalmanFilter(Model * model, const Matrix Q,
+                                                                     const Matrix R) : Observer() {
+        // Set the model (use the function so that it sets up the other stuff)
+        setModel(model);
+
+        // Set Q, R
+        m_Q = Q;
+        m_R = R;
+
+        // Check that Q and R are the right size
+        if (m_Q.rows() != m_Q.cols() || m_Q.rows() != pModel->getNumStates()) {
+            log.WriteLine(LOG_ERROR, MODULE_NAME, "Q does not have the right number of values");
+            throw std::range_error("Q does not have the right number of values");
+        }
+        if (m_R.rows() != m_R.cols() || m_R.rows() != pModel->getNumOutputs()) {
+            log.WriteLine(LOG_ERROR, MODULE_NAME, "R does not have the right number of values");
+            throw std::range_error("R does not have the right number of values");
+        }
+    }
+
+    // GSAPConfigMap-based Constructor
+    SquareRootUnscentedKalmanFilter::SquareRootUnscentedKalmanFilter(GSAPConfigMap & configMap) : Observer() {
+        // Check for required parameters: Q, R
+        configMap.checkRequiredParams({ Q_KEY, R_KEY });
+
+        log.WriteLine(LOG_DEBUG, MODULE_NAME, "Setting Q");
+        m_Q = readSquareMatrix(configMap, Q_KEY, "Q", MODULE_NAME);
+        log.WriteLine(LOG_DEBUG, MODULE_NAME, "Setting R");
+        m_R = readSquareMatrix(configMap, R_KEY, "R", MODULE_NAME);
+
+        // Set kappa, alpha and beta (optional)
+        if (configMap.includes(K_KEY)) {
+            setKappa(std::stod(configMap.at(K_KEY)[0]));
+        }
+        if (configMap.includes(A_KEY)) {
+            setAlpha(std::stod(configMap.at(A_KEY)[0]));
+        }
+        if (configMap.includes(B_KEY)) {
+            setBeta(std::stod(configMap.at(B_KEY)[0]));
+        }
+
+        log.WriteLine(LOG_INFO, MODULE_NAME, "Created square-root UKF");
+    }
+
+    // Set model
+    void SquareRootUnscentedKalmanFilter::setModel(Model * model) {
+        // Set the model pointer
+        pModel = model;
+
+        std::size_t numStates = pModel->getNumStates();
+        std::size_t numInputs = pModel->getNumInputs();
+        std::size_t numOutputs = pModel->getNumOutputs();
+        std::size_t numSigmaPoints = 2 * numStates + 1;
+
+        // Set up variables that are dependent on the model
+        m_xEstimated.resize(numStates);
+        m_uOld.resize(numInputs);
+        m_zEstimated.resize(numOutputs);
+
+        // Set parameters to default values, unless they have been configured already
+        if (std::isnan(m_kappa)) {
+            m_kappa = 3.0 - numStates;
+        }
+        if (std::isnan(m_alpha)) {
+            m_alpha = 1;
+        }
+        if (std::isnan(m_beta)) {
+            m_beta = 0;
+        }
+
+        // Size the step workspace. Matrix zero-initializes, which the noise matrices rely on.
+        m_work.X = Matrix(numStates, numSigmaPoints);
+        m_work.Z = Matrix(numOutputs, numSigmaPoints);
+        m_work.U = Matrix(numInputs, numSigmaPoints);
+        m_work.zeroNoiseX = Matrix(numStates, numSigmaPoints);
+        m_work.zeroNoiseZ = Matrix(numOutputs, numSigmaPoints);
+        m_work.Xc = Matrix(numStates, numSigmaPoints);
+        m_work.Zc = Matrix(numOutputs, numSigmaPoints);
+        m_work.compoundX = Matrix(numStates, numSigmaPoints - 1 + numStates);
+        m_work.compoundZ = Matrix(numOutputs, numSigmaPoints - 1 + numOutputs);
+        m_work.Pxz = Matrix(numStates, numOutputs);
+        m_work.PxzT = Matrix(numOutputs, numStates);
+        m_work.Kk = Matrix(numStates, numOutputs);
+        m_work.KkT = Matrix(numOutputs, numStates);
+        m_work.KkSz = Matrix(numStates, numOutputs);
+        m_work.Sz.factor(Matrix::identity(numOutputs));
+        m_work.wm.resize(numSigmaPoints);
+        m_work.wc.resize(numSigmaPoints);
+        m_work.xkk1.resize(numStates);
+        m_work.zkk1.resize(numOutputs);
+        m_work.column.resize(std::max(numStates, numOutputs));
+        m_work.zeroNoiseZVector.assign(numOutputs, 0.0);
+    }
+
+    // Set kappa value
+    void SquareRootUnscentedKalmanFilter::setKappa(double kappa) {
+        m_kappa = kappa;
+    }
+
+    // Set alpha value
+    void SquareRootUnscentedKalmanFilter::setAlpha(double alpha) {
+        m_alpha = alpha;
+    }
+
+    // Set beta value
+    void SquareRootUnscentedKalmanFilter::setBeta(double beta) {
+        m_beta = beta;
+    }
+
+    // Initialize function (required by Observer interface)
+    void SquareRootUnscentedKalmanFilter::initialize(const double t0, const std::vector<double> & x0,
+                                                     const std::vector<double> & u0) {
+        log.WriteLine(LOG_DEBUG, MODULE_NAME, "Initializing");
+
+        // Check that model has been set
+        if (pModel == NULL) {
+            log.WriteLine(LOG_ERROR, MODULE_NAME, "Square-root UKF does not have a model!");
+            throw ConfigurationError("Square-root UKF does not have a model!");
+        }
+
+        // Check that Q and R were set consistent with the model
+        if (m_Q.rows() != pModel->getNumStates()) {
+            log.WriteLine(LOG_ERROR, MODULE_NAME, "Q does not have the right number of values");
+            throw std::range_error("Q does not have the right number of values");
+        }
+        if (m_R.rows() != pModel->getNumOutputs()) {
+            log.WriteLine(LOG_ERROR, MODULE_NAME, "R does not have the right number of values");
+            throw std::range_error("R does not have the right number of values");
+        }
+
+        // Factor the noise covariances once
+        try {
+            m_sqrtQ.factor(m_Q);
+            m_sqrtR.factor(m_R);
+        }
+        catch (std::domain_error &) {
+            log.WriteLine(LOG_ERROR, MODULE_NAME, "Q and R must be positive definite");
+            throw;
+        }
+
+        // Compute the sigma point weights (scaled unscented transform)
+        double numStates = pModel->getNumStates();
+        double lambda = m_alpha * m_alpha * (numStates + m_kappa) - numStates;
+        if (!(numStates + lambda > 0)) {
+            log.WriteLine(LOG_ERROR, MODULE_NAME, "alpha and kappa give non-positive sigma point spread");
+            throw std::domain_error("alpha and kappa give non-positive sigma point spread");
+        }
+        std::vector<double> & wm = m_work.wm;
+        std::vector<double> & wc = m_work.wc;
+        wm[0] = lambda / (numStates + lambda);
+        wc[0] = wm[0] + (1 - m_alpha * m_alpha + m_beta);
+        for (std::size_t i = 1; i < wm.size(); i++) {
+            wm[i] = 0.5 / (numStates + lambda);
+            wc[i] = wm[i];
+        }
+
+        // Initialize time, state, inputs and covariance
+        m_t = t0;
+        m_xEstimated = x0;
+        m_uOld = u0;
+        m_S = m_sqrtQ;
+
+        // Compute corresponding output estimate
+        pModel->outputEqn(m_t, m_xEstimated, m_uOld, m_work.zeroNoiseZVector, m_zEstimated);
+
+        // Set initialized flag
+        m_initialized = true;
+        log.WriteLine(LOG_DEBUG, MODULE_NAME, "Initialize completed");
+    }
+
+    // Get state mean
+    const std::vector<double> & SquareRootUnscentedKalmanFilter::getStateMean() const {
+        return m_xEstimated;
+    }
+
+    // Get output mean
+    const std::vector<double> & SquareRootUnscentedKalmanFilter::getOutputMean() const {
+        return m_zEstimated;
+    }
+
+    // Get state covariance
+    Matrix SquareRootUnscentedKalmanFilter::getStateCovariance() const {
+        const Matrix & S = m_S.lower();
+        return S * S.transpose();
+    }
+
+    // Get square root of state covariance
+    const Matrix & SquareRootUnscentedKalmanFilter::getStateCovarianceSqrt() const {
+        return m_S.lower();
+    }
+
+    // Add or remove a weighted column of centered sigma points from a factor
+    void SquareRootUnscentedKalmanFilter::rankOneUpdate(CholeskyDecomposition & factor,
+                                                        const Matrix & centered,
+                                                        std::size_t column, double weight) {
+        std::size_t n = centered.rows();
+        double scale = std::sqrt(std::abs(weight));
+        m_work.column.resize(n);
+        for (std::size_t i = 0; i < n; i++) {
+            m_work.column[i] = scale * centered[i][column];
+        }
+        if (weight >= 0) {
+            factor.update(m_work.column);
+        }
+        else {
+            factor.downdate(m_work.column);
+        }
+    }
+
+    // Step function (required by Observer interface)
+    void SquareRootUnscentedKalmanFilter::step(const double newT, const std::vector<double> & u,
+                                               const std::vector<double> & z) {
+        PCOE_LOG_LINE(log, LOG_DEBUG, MODULE_NAME, "Starting step");
+
+        if (!isInitialized()) {
+            log.WriteLine(LOG_ERROR, MODULE_NAME, "Called step before initialized");
+            throw std::domain_error("SquareRootUnscentedKalmanFilter::step not initialized");
+        }
+
+        // Update time
+        double dt = newT - m_t;
+        m_t = newT;
+        if (dt <= 0) {
+            log.WriteLine(LOG_ERROR, MODULE_NAME, "dt is less than or equal to zero");
+            throw std::domain_error("SquareRootUnscentedKalmanFilter::step dt is 0");
+        }
+
+        unsigned int numStates = pModel->getNumStates();
+        unsigned int numInputs = pModel->getNumInputs();
+        unsigned int numOutputs = pModel->getNumOutputs();
+        unsigned int numSigmaPoints = 2 * numStates + 1;
+        Workspace & w = m_work;
+
+        // 1. Predict
+        PCOE_LOG_LINE(log, LOG_TRACE, MODULE_NAME, "Starting step - predict");
+
+        // Sigma points are the mean plus and minus the columns of S, scaled by sqrt(n + lambda)
+        const Matrix & S = m_S.lower();
+        double gamma = m_alpha * std::sqrt(numStates + m_kappa);
+        for (unsigned int i = 0; i < numStates; i++) {
+            double * row = w.X.rowData(i);
+            const double * sRow = S.rowData(i);
+            row[0] = m_xEstimated[i];
+            for (unsigned int j = 0; j < numStates; j++) {
+                row[j + 1] = m_xEstimated[i] + gamma * sRow[j];
+                row[j + numStates + 1] = m_xEstimated[i] - gamma * sRow[j];
+            }
+        }
+
+        // Propagate sigma points through state equation, all sigma points at once
+        for (unsigned int i = 0; i < numInputs; i++) {
+            std::fill(w.U.rowData(i), w.U.rowData(i) + numSigmaPoints, m_uOld[i]);
+        }
+        pModel->stateEqnBatch(newT, w.X, w.U, w.zeroNoiseX, dt);
+
+        // Predicted state, and the square root of its covariance from a QR
+        // decomposition followed by a rank-one update for the first sigma point
+        weightedCenter(w.X, w.wm, w.xkk1, w.Xc);
+        fillCompound(w.Xc, w.wc[1], m_sqrtQ.lower(), w.compoundX);
+        try {
+            m_S.factorProduct(w.compoundX);
+            rankOneUpdate(m_S, w.Xc, 0, w.wc[0]);
+        }
+        catch (std::domain_error &) {
+            log.WriteLine(LOG_ERROR, MODULE_NAME, "Predicted state covariance is not positive definite");
+            throw;
+        }
+
+        // Propagate sigma points through output equation
+        for (unsigned int i = 0; i < numInputs; i++) {
+            std::fill(w.U.rowData(i), w.U.rowData(i) + numSigmaPoints, u[i]);
+        }
+        pModel->outputEqnBatch(newT, w.X, w.U, w.zeroNoiseZ, w.Z);
+
+        // Predicted output and the square root of its covariance
+        weightedCenter(w.Z, w.wm, w.zkk1, w.Zc);
+        fillCompound(w.Zc, w.wc[1], m_sqrtR.lower(), w.compoundZ);
+        try {
+            w.Sz.factorProduct(w.compoundZ);
+            rankOneUpdate(w.Sz, w.Zc, 0, w.wc[0]);
+        }
+        catch (std::domain_error &) {
+            log.WriteLine(LOG_ERROR, MODULE_NAME, "Predicted output covariance is not positive definite");
+            throw;
+        }
+
+        // 2. Update
+        PCOE_LOG_LINE(log, LOG_TRACE, MODULE_NAME, "Starting step - update");
+
+        // Compute Kalman gain, Kk = Pxz*(Sz*Sz')^-1, from Kk' = (Sz*Sz')^-1*Pxz'
+        weightedCrossCovariance(w.Xc, w.Zc, w.wc, w.Pxz);
+        w.Pxz.transposeInto(w.PxzT);
+        w.Sz.solve(w.PxzT, w.KkT);
+        w.KkT.transposeInto(w.Kk);
+
+        // Compute state estimate, x = xkk1 + Kk*(z - zkk1)
+        for (unsigned int i = 0; i < numStates; i++) {
+            const double * gainRow = w.Kk.rowData(i);
+            double correction = 0;
+            for (unsigned int j = 0; j < numOutputs; j++) {
+                correction += gainRow[j] * (z[j] - w.zkk1[j]);
+            }
+            m_xEstimated[i] = w.xkk1[i] + correction;
+        }
+
+        // Compute output estimate
+        pModel->outputEqn(newT, m_xEstimated, u, w.zeroNoiseZVector, m_zEstimated);
+
+        // Compute covariance square root: P = Pkk1 - (Kk*Sz)*(Kk*Sz)', one column at a time
+        gemm(1.0, w.Kk, w.Sz.lower(), 0.0, w.KkSz);
+        try {
+            for (unsigned int j = 0; j < numOutputs; j++) {
+                rankOneUpdate(m_S, w.KkSz, j, -1.0);
+            }
+        }
+        catch (std::domain_error &) {
+            log.WriteLine(LOG_ERROR, MODULE_NAME, "Updated state covariance is not positive definite");
+            throw;
+        }
+
+        // Update uOld
+        m_uOld = u;
+    }
+
+    std::vector<UData> SquareRootUnscentedKalmanFilter::getStateEstimate() const {
+        Matrix P = getStateCovariance();
+        std::vector<UData> state(pModel->getNumStates());
+        for (unsigned int i = 0; i < pModel->getNumStates(); i++) {
+            state[i].uncertainty(UType::MeanCovar);
+            state[i].npoints(pModel->getNumStates());
+            state[i][MEAN] = m_xEstimated[i];
+            state[i][COVAR()] = static_cast<std::vector<double>>(P.row(i));
+        }
+        return state;
+    }
+}
@@ -4,6 +4,8 @@
 */
 
 #include <cmath>
+#include <stdexcept>
+
 #include "StatisticalTools.h"
 
 namespace PCOE {
@@ -51,4 +53,102 @@ namespace PCOE {
         }
         return sum / N;
     }
+
+    RunningStatistics::RunningStatistics() : n(0), m(0), m2(0) { }
+
+    void RunningStatistics::add(double x) {
+        n++;
+        double delta = x - m;
+        m += delta / static_cast<double>(n);
+        m2 += delta * (x - m);
+    }
+
+    void RunningStatistics::merge(const RunningStatistics & other) {
+        if (other.n == 0) {
+            return;
+        }
+        std::size_t total = n + other.n;
+        double delta = other.m - m;
+        double nA = static_cast<double>(n);
+        double nB = static_cast<double>(other.n);
+        m += delta * nB / static_cast<double>(total);
+        m2 += other.m2 + delta * delta * nA * nB / static_cast<double>(total);
+        n = total;
+    }
+
+    double RunningStatistics::mean() const {
+        return n == 0 ? NAN : m;
+    }
+
+    double RunningStatistics::variance() const {
+        return n == 0 ? NAN : m2 / static_cast<double>(n);
+    }
+
+    double RunningStatistics::stdv() const {
+        return std::sqrt(variance());
+    }
+
+    Histogram::Histogram() : Histogram(0, 1, 0) { }
+
+    Histogram::Histogram(double lower, double width, std::size_t bins)
+        : lowerEdge(lower), binWidth(width), counts(bins, 0), underflow(0), overflow(0), n(0) {
+        if (!(width > 0)) {
+            throw std::range_error("Histogram bin width must be positive");
+        }
+    }
+
+    void Histogram::add(double x) {
+        if (std::isnan(x)) {
+            return;
+        }
+        n++;
+        double position = (x - lowerEdge) / binWidth;
+        if (position < 0) {
+            underflow++;
+        }
+        else if (position >= static_cast<double>(counts.size())) {
+            overflow++;
+        }
+        else {
+            counts[static_cast<std::size_t>(position)]++;
+        }
+    }
+
+    void Histogram::merge(const Histogram & other) {
+        if (other.counts.size() != counts.size()) {
+            throw std::range_error("Histograms have different bins");
+        }
+        for (std::size_t bin = 0; bin < counts.size(); bin++) {
+            counts[bin] += other.counts[bin];
+        }
+        underflow += other.underflow;
+        overflow += other.overflow;
+        n += other.n;
+    }
+
+    double Histogram::center(std::size_t bin) const {
+        return lowerEdge + (static_cast<double>(bin) + 0.5) * binWidth;
+    }
+
+    double Histogram::quantile(double p) const {
+        if (n == 0) {
+            return NAN;
+        }
+        // Rank of the quantile, counting from 1
+        std::size_t rank = static_cast<std::size_t>(std::ceil(p * static_cast<double>(n)));
+        if (rank == 0) {
+            rank = 1;
+        }
+        std::size_t seen = underflow;
+        if (seen >= rank) {
+            return -INFINITY;
+        }
+        for (std::size_t bin = 0; bin < counts.size(); bin++) {
+            seen += counts[bin];
+            if (seen >= rank) {
+                return center(bin);
+            }
+        }
+        return INFINITY;
+    }
 }
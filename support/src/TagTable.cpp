@@ -0,0 +1,89 @@
+// Copyright (c) 2016 United States Government as represented by
+// the Administrator of the National Aeronautics and Space Administration.
+// All Rights Reserved.
+
+#include <chrono>
+#include <cmath>
+#include <stdexcept>
+#include <thread>
+
+#include "TagTable.h"
+
+namespace PCOE {
+    const TagTable::Handle TagTable::BLOCK_SIZE;
+    const TagTable::Handle TagTable::MAX_BLOCKS;
+
+    TagTable::TagTable() : count(0) {
+        for (auto & block : blocks) {
+            block.store(nullptr, std::memory_order_relaxed);
+        }
+    }
+
+    TagTable::~TagTable() {
+        for (auto & block : blocks) {
+            delete[] block.load(std::memory_order_relaxed);
+        }
+    }
+
+    TagTable::Handle TagTable::add() {
+        Handle handle = count.load(std::memory_order_relaxed);
+        Handle blockIndex = handle / BLOCK_SIZE;
+        if (blockIndex >= MAX_BLOCKS) {
+            throw std::length_error("Tag table is full");
+        }
+        if (handle % BLOCK_SIZE == 0) {
+            Slot * block = new Slot[BLOCK_SIZE];
+            for (Handle i = 0; i < BLOCK_SIZE; i++) {
+                block[i].sequence.store(0, std::memory_order_relaxed);
+                block[i].value.store(NAN, std::memory_order_relaxed);
+                block[i].time.store(0, std::memory_order_relaxed);
+            }
+            blocks[blockIndex].store(block, std::memory_order_release);
+        }
+        count.store(handle + 1, std::memory_order_release);
+        return handle;
+    }
+
+    void TagTable::set(Handle handle, const Datum<double> & value) {
+        Slot & s = const_cast<Slot &>(slot(handle));
+        std::uint64_t sequence = s.sequence.load(std::memory_order_relaxed);
+        s.sequence.store(sequence + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        s.value.store(value.get(), std::memory_order_relaxed);
+        s.time.store(value.getTime(), std::memory_order_relaxed);
+        s.sequence.store(sequence + 2, std::memory_order_release);
+    }
+
+    Datum<double> TagTable::get(Handle handle) const {
+        const Slot & s = slot(handle);
+        double value;
+        Datum<double>::ms_rep time;
+        std::uint64_t before;
+        std::uint64_t after = 0;
+        do {
+            before = s.sequence.load(std::memory_order_acquire);
+            if (before & 1) {
+                // A write is in progress
+                std::this_thread::yield();
+                continue;
+            }
+            value = s.value.load(std::memory_order_relaxed);
+            time = s.time.load(std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_acquire);
+            after = s.sequence.load(std::memory_order_relaxed);
+        } while ((before & 1) || before != after);
+
+        return Datum<double>(value, Datum<double>::time_point(std::chrono::milliseconds(time)));
+    }
+
+    TagTable::Handle TagTable::size() const {
+        return count.load(std::memory_order_acquire);
+    }
+
+    const TagTable::Slot & TagTable::slot(Handle handle) const {
+        if (handle >= size()) {
+            throw std::out_of_range("Invalid tag handle");
+        }
+        return blocks[handle / BLOCK_SIZE].load(std::memory_order_acquire)[handle % BLOCK_SIZE];
+    }
+}
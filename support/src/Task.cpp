@@ -0,0 +1,236 @@
+// Copyright (c) 2016 United States Government as represented by
+// the Administrator of the National Aeronautics and Space Administration.
+// All Rights Reserved.
+
+#include <exception>
+#include <stdexcept>
+#include <thread>
+#include <typeinfo>
+
+#include "Executor.h"
+#include "Task.h"
+
+namespace PCOE {
+    Task::Task()
+        : log(Log::Instance()), moduleName(""), state(ThreadState::Created),
+          scheduled(false), rescheduled(false), cleanedUp(false),
+          timerPending(false), timerValid(false), timer(0) {
+        // Construct the executor first, so that it is destroyed after the task
+        Executor::instance();
+    }
+
+    Task::~Task() {
+        ThreadState current = state;
+        if (current == ThreadState::Enabled || current == ThreadState::Started ||
+            current == ThreadState::Paused) {
+            state = ThreadState::Stopped;
+        }
+        cancelTimer();
+
+        // Derived parts are already destroyed, so skip cleanup
+        unique_lock lock(m);
+        cleanedUp = true;
+        idle.wait(lock, [this]() { return !scheduled; });
+    }
+
+    void Task::enable() {
+        lock_guard guard(m);
+        switch (state.load())
+        {
+        case ThreadState::Created:
+            log.WriteLine(LOG_DEBUG, moduleName, "Enabling");
+            state = ThreadState::Enabled;
+            break;
+        case ThreadState::Enabled:
+            log.WriteLine(LOG_WARN, moduleName, "Already Enabled");
+            break;
+        default:
+            throw std::domain_error("Cannot enter Enabled state from current state.");
+            break;
+        }
+    }
+
+    void Task::start() {
+        {
+            lock_guard guard(m);
+            switch (state.load())
+            {
+            case ThreadState::Created:
+            case ThreadState::Enabled:
+            case ThreadState::Paused:
+                log.WriteLine(LOG_DEBUG, moduleName, "Starting");
+                state = ThreadState::Started;
+                break;
+            case ThreadState::Started:
+                log.WriteLine(LOG_WARN, moduleName, "Already Started");
+                break;
+            default:
+                throw std::domain_error("Cannot enter Started state from current state.");
+                break;
+            }
+        }
+        schedule();
+    }
+
+    void Task::pause() {
+        lock_guard guard(m);
+        switch (state.load())
+        {
+        case ThreadState::Enabled:
+        case ThreadState::Started:
+            log.WriteLine(LOG_DEBUG, moduleName, "Pausing");
+            state = ThreadState::Paused;
+            break;
+        case ThreadState::Paused:
+            log.WriteLine(LOG_WARN, moduleName, "Already Paused");
+            break;
+        default:
+            throw std::domain_error("Cannot enter Paused state from current state.");
+            break;
+        }
+    }
+
+    void Task::stop() {
+        {
+            lock_guard guard(m);
+            switch (state.load())
+            {
+            case ThreadState::Enabled:
+            case ThreadState::Started:
+            case ThreadState::Paused:
+                log.WriteLine(LOG_DEBUG, moduleName, "Stopping");
+                state = ThreadState::Stopped;
+                break;
+            case ThreadState::Stopped:
+                log.WriteLine(LOG_WARN, moduleName, "Already Stopped");
+                break;
+            default:
+                throw std::domain_error("Cannot enter Stopped state from current state.");
+                break;
+            }
+        }
+        cancelTimer();
+        schedule();
+    }
+
+    void Task::join() {
+        unique_lock lock(m);
+        ThreadState current = state;
+        if (current == ThreadState::Created || current == ThreadState::Ended) {
+            log.WriteLine(LOG_ERROR, moduleName, "Could not join task.");
+            return;
+        }
+        idle.wait(lock, [this]() {
+            return state == ThreadState::Stopped && cleanedUp && !scheduled;
+        });
+        state = ThreadState::Ended;
+    }
+
+    ThreadState Task::getState() const {
+        return state;
+    }
+
+    void Task::schedule() {
+        {
+            lock_guard guard(m);
+            ThreadState current = state;
+            if (current == ThreadState::Created || current == ThreadState::Ended) {
+                return;
+            }
+            if (scheduled) {
+                rescheduled = true;
+                return;
+            }
+            scheduled = true;
+        }
+        Executor::instance().submit([this]() { execute(); });
+    }
+
+    void Task::scheduleAfter(std::chrono::milliseconds delay) {
+        {
+            lock_guard guard(m);
+            ThreadState current = state;
+            if (timerPending || current == ThreadState::Stopped || current == ThreadState::Ended) {
+                return;
+            }
+            timerPending = true;
+        }
+        unsigned long id = Executor::instance().submitAfter(delay, [this]() {
+            {
+                lock_guard guard(m);
+                timerPending = false;
+                timerValid = false;
+            }
+            schedule();
+        });
+        lock_guard guard(m);
+        if (timerPending) {
+            timer = id;
+            timerValid = true;
+        }
+    }
+
+    void Task::cancelTimer() {
+        unique_lock lock(m);
+        while (timerPending) {
+            if (timerValid) {
+                unsigned long id = timer;
+                lock.unlock();
+                bool cancelled = Executor::instance().cancel(id);
+                lock.lock();
+                if (cancelled) {
+                    timerPending = false;
+                    timerValid = false;
+                }
+                // Otherwise the timer fired, and cleared timerPending
+            }
+            else {
+                // The timer is being created
+                lock.unlock();
+                std::this_thread::yield();
+                lock.lock();
+            }
+        }
+    }
+
+    void Task::execute() {
+        ThreadState current = state;
+        bool runCleanup = false;
+        if (current == ThreadState::Stopped) {
+            lock_guard guard(m);
+            runCleanup = !cleanedUp;
+            cleanedUp = true;
+        }
+
+        try {
+            if (current == ThreadState::Started) {
+                run();
+            }
+            else if (runCleanup) {
+                cleanup();
+            }
+        }
+        catch (const std::exception& ex) {
+            std::string msg;
+            msg.append(typeid(ex).name());
+            msg.append(" ");
+            msg.append(ex.what());
+            log.WriteLine(LOG_ERROR, moduleName, msg);
+        }
+        catch (...) {
+            log.WriteLine(LOG_ERROR, moduleName, "Unknown exception");
+        }
+        // A failed cycle is logged and the task keeps its state, so later cycles still run
+
+        unique_lock lock(m);
+        if (rescheduled) {
+            rescheduled = false;
+            lock.unlock();
+            Executor::instance().submit([this]() { execute(); });
+        }
+        else {
+            scheduled = false;
+            idle.notify_all();
+        }
+    }
+}
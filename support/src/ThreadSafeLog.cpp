@@ -6,13 +6,21 @@
 
 #include <cstdarg>
 #include <cstdio>
+#include <cstring>
 #include <ctime>
 
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
 #include <iomanip>
 #include <sstream>
 #include <iostream>
 #include <string>
+#include <thread>
 #include <unordered_map>
+#include <vector>
+
+#include "BoundedQueue.h"
 
 // Implementation note(JW): I initially wrote this class using C++ iostreams, but I couldn't find any
 // way to implement FormatLine without adding in a call to sprintf. It therefore seems more
@@ -53,10 +61,9 @@ namespace PCOE {
         return (*i).second;
     }
 
-    inline std::string WriteTime() {
+    inline std::string WriteTime(std::chrono::system_clock::time_point now) {
         using namespace std::chrono;
 
-        system_clock::time_point now = system_clock::now();
         std::time_t now_tt = system_clock::to_time_t(now);
         system_clock::time_point now_sec = system_clock::from_time_t(now_tt);
         milliseconds ms = duration_cast<milliseconds>(now - now_sec);
@@ -73,6 +80,10 @@ namespace PCOE {
         return ss.str();
     }
 
+    inline std::string WriteTime() {
+        return WriteTime(std::chrono::system_clock::now());
+    }
+
     inline std::string WriteLevel(const int level) {
         std::string str;
         switch (level) {
@@ -104,6 +115,258 @@ namespace PCOE {
         return str;
     }
 
+    /// A line logged asynchronously
+    struct LogRecord {
+        static const std::size_t TAG_SIZE = 48;
+        static const std::size_t TEXT_SIZE = 208;
+
+        std::chrono::system_clock::time_point time;
+        LOG_VERBOSITY level;
+        bool verbatim;  ///< Write text only, without time, level and tag
+        std::shared_ptr<std::FILE> fd;
+        char tag[TAG_SIZE];
+        char text[TEXT_SIZE];
+        std::string longText;  ///< Used instead of text when the message does not fit
+
+        const char * message() const {
+            return longText.empty() ? text : longText.c_str();
+        }
+    };
+
+    /// Writes records from per-thread buffers on a background thread
+    class AsyncLogWriter {
+    public:
+        static const std::size_t BUFFER_SIZE = 512;
+
+        /// Whether lines go to the writer, rather than straight to the file
+        static std::atomic<bool> enabled;
+
+        static AsyncLogWriter & instance() {
+            static AsyncLogWriter writer;
+            return writer;
+        }
+
+        ~AsyncLogWriter() {
+            enabled = false;
+            {
+                std::lock_guard<std::mutex> guard(m);
+                stopping = true;
+            }
+            wake.notify_one();
+            thread.join();
+        }
+
+        void setInterval(std::chrono::milliseconds flushInterval) {
+            std::lock_guard<std::mutex> guard(m);
+            interval = flushInterval;
+        }
+
+        /// Queue a record on the calling thread's buffer. Does not lock unless
+        /// the record needs an immediate flush or the buffer is full.
+        void push(LogRecord && record) {
+            bool urgent = !record.verbatim && record.level <= LOG_ERROR;
+            Buffer & buffer = threadBuffer();
+            while (!buffer.records.tryPush(std::move(record))) {
+                requestRound();
+                std::this_thread::yield();
+            }
+            if (urgent) {
+                requestRound();
+            }
+        }
+
+        /// Wait until every record queued before the call is written and flushed
+        void flush() {
+            std::unique_lock<std::mutex> lock(m);
+            unsigned long long target = started + 1;
+            roundRequested = true;
+            wake.notify_one();
+            done.wait(lock, [this, target]() { return finished >= target; });
+        }
+
+    private:
+        struct Buffer {
+            Buffer() : records(BUFFER_SIZE), orphaned(false) { }
+            BoundedQueue<LogRecord> records;
+            std::atomic<bool> orphaned;  ///< The owning thread has exited
+        };
+
+        /// Marks the thread's buffer when the thread exits
+        struct BufferHandle {
+            std::shared_ptr<Buffer> buffer;
+            ~BufferHandle() {
+                if (buffer) {
+                    buffer->orphaned = true;
+                }
+            }
+        };
+
+        AsyncLogWriter() : interval(100), stopping(false), roundRequested(false),
+            started(0), finished(0) {
+            thread = std::thread(&AsyncLogWriter::run, this);
+        }
+
+        Buffer & threadBuffer() {
+            thread_local BufferHandle handle;
+            if (!handle.buffer) {
+                handle.buffer = std::make_shared<Buffer>();
+                std::lock_guard<std::mutex> guard(m);
+                buffers.push_back(handle.buffer);
+            }
+            return *handle.buffer;
+        }
+
+        void requestRound() {
+            {
+                std::lock_guard<std::mutex> guard(m);
+                roundRequested = true;
+            }
+            wake.notify_one();
+        }
+
+        void run() {
+            std::vector<LogRecord> batch;
+            std::vector<std::shared_ptr<Buffer>> current;
+            std::unique_lock<std::mutex> lock(m);
+            for (;;) {
+                wake.wait_for(lock, interval, [this]() { return roundRequested || stopping; });
+                bool last = stopping;
+                roundRequested = false;
+                unsigned long long round = ++started;
+                // Buffers of exited threads are dropped once they are empty
+                buffers.erase(std::remove_if(buffers.begin(), buffers.end(),
+                    [](const std::shared_ptr<Buffer> & buffer) {
+                        return buffer->orphaned && buffer->records.size() == 0;
+                    }), buffers.end());
+                current = buffers;
+                lock.unlock();
+
+                for (auto & buffer : current) {
+                    LogRecord record;
+                    while (buffer->records.tryPop(record)) {
+                        batch.push_back(std::move(record));
+                    }
+                }
+                current.clear();
+                write(batch);
+                batch.clear();
+
+                lock.lock();
+                finished = round;
+                done.notify_all();
+                if (last) {
+                    break;
+                }
+            }
+        }
+
+        /// Format the records, then write and flush each file once
+        void write(std::vector<LogRecord> & records) {
+            // Lines from different threads are written in the order they were logged
+            std::stable_sort(records.begin(), records.end(),
+                [](const LogRecord & a, const LogRecord & b) { return a.time < b.time; });
+
+            std::vector<std::pair<std::shared_ptr<std::FILE>, std::string>> files;
+            std::time_t lastSecond = 0;
+            std::string timeStr;
+            for (const LogRecord & record : records) {
+                auto file = std::find_if(files.begin(), files.end(),
+                    [&record](const std::pair<std::shared_ptr<std::FILE>, std::string> & f) {
+                        return f.first == record.fd;
+                    });
+                if (file == files.end()) {
+                    files.emplace_back(record.fd, std::string());
+                    file = files.end() - 1;
+                }
+                std::string & out = file->second;
+                if (!record.verbatim) {
+                    // Most lines share a second with the line before
+                    std::time_t second = std::chrono::system_clock::to_time_t(record.time);
+                    if (timeStr.empty() || second != lastSecond) {
+                        timeStr = WriteTime(record.time);
+                        lastSecond = second;
+                    }
+                    else {
+                        using namespace std::chrono;
+                        auto ms = duration_cast<milliseconds>(
+                            record.time - system_clock::from_time_t(second)).count();
+                        int msValue = std::min(std::max(static_cast<int>(ms), 0), 999);
+                        std::size_t msPos = timeStr.size() - 4;
+                        timeStr[msPos] = static_cast<char>('0' + msValue / 100);
+                        timeStr[msPos + 1] = static_cast<char>('0' + msValue / 10 % 10);
+                        timeStr[msPos + 2] = static_cast<char>('0' + msValue % 10);
+                    }
+                    out += timeStr;
+                    out += WriteLevel(record.level);
+                    out += record.tag;
+                    out += '|';
+                }
+                out += record.message();
+                out += '\n';
+            }
+            for (auto & file : files) {
+                std::fwrite(file.second.data(), 1, file.second.size(), file.first.get());
+                std::fflush(file.first.get());
+            }
+        }
+
+        std::mutex m;
+        std::condition_variable wake;
+        std::condition_variable done;
+        std::chrono::milliseconds interval;
+        bool stopping;
+        bool roundRequested;
+        unsigned long long started;   ///< Number of rounds started
+        unsigned long long finished;  ///< Number of the last round finished
+        std::vector<std::shared_ptr<Buffer>> buffers;
+        std::thread thread;
+    };
+
+    std::atomic<bool> AsyncLogWriter::enabled(false);
+    const std::size_t AsyncLogWriter::BUFFER_SIZE;
+    const std::size_t LogRecord::TAG_SIZE;
+    const std::size_t LogRecord::TEXT_SIZE;
+
+    static LogRecord MakeRecord(const LOG_VERBOSITY level, const char * tag,
+        const std::shared_ptr<std::FILE> & fd) {
+        LogRecord record;
+        record.time = std::chrono::system_clock::now();
+        record.level = level;
+        record.verbatim = false;
+        record.fd = fd;
+        std::size_t length = std::min(std::strlen(tag), LogRecord::TAG_SIZE - 1);
+        std::memcpy(record.tag, tag, length);
+        record.tag[length] = '\0';
+        return record;
+    }
+
+    static void SetText(LogRecord & record, const char * text) {
+        std::size_t length = std::strlen(text);
+        if (length < LogRecord::TEXT_SIZE) {
+            std::memcpy(record.text, text, length + 1);
+        }
+        else {
+            record.longText = text;
+        }
+    }
+
+    void Log::SetAsync(bool enabled, std::chrono::milliseconds flushInterval) {
+        if (enabled) {
+            AsyncLogWriter::instance().setInterval(flushInterval);
+            AsyncLogWriter::enabled = true;
+        }
+        else if (AsyncLogWriter::enabled) {
+            AsyncLogWriter::enabled = false;
+            AsyncLogWriter::instance().flush();
+        }
+    }
+
+    void Log::Flush() {
+        if (AsyncLogWriter::enabled) {
+            AsyncLogWriter::instance().flush();
+        }
+    }
+
     void Log::Initialize(const std::string & name,
         const std::string & version = "N/A", const std::string & note = "") const {
         if (LOG_LEVEL == LOG_OFF) {
@@ -122,6 +385,20 @@ namespace PCOE {
             char timeStr[16] = { 0 };
             std::strftime(timeStr, 16, "%Y-%m-%d", timeinfo);
 
+            if (AsyncLogWriter::enabled) {
+                std::stringstream ss;
+                ss << name << " [Version " << version << "]\n"
+                    << "Compiled " << __DATE__ << " " << __TIME__ << "\n"
+                    << "Copyright (c) 2013-2016 United States Government as represented by the\n"
+                    << "Administrator of the National Aeronautics and Space Administration.\n"
+                    << "All Rights Reserved.\n\n"
+                    << "This file contains debugging information about the " << name << ".\n"
+                    << note << "\n\n"
+                    << "Log file generated on " << timeStr << ".";
+                LogVerbatim(ss.str());
+                return;
+            }
+
             std::lock_guard<std::mutex> guard(*m);
             std::fprintf(fd.get(), "%s [Version %s]\n", name.c_str(), version.c_str());
             std::fprintf(fd.get(), "Compiled %s %s\n", __DATE__, __TIME__);
@@ -150,15 +427,26 @@ namespace PCOE {
 
     void Log::WriteLine(const LOG_VERBOSITY level, const std::string& tag,
         const std::string& value) const {
+        WriteLine(level, tag.c_str(), value.c_str());
+    }
+
+    void Log::WriteLine(const LOG_VERBOSITY level, const char* tag, const char* value) const {
         if (level > LOG_LEVEL || !fd) {
             return;
         }
 
+        if (AsyncLogWriter::enabled) {
+            LogRecord record = MakeRecord(level, tag, fd);
+            SetText(record, value);
+            AsyncLogWriter::instance().push(std::move(record));
+            return;
+        }
+
         std::string ss = WriteTime();
         std::string ssL = WriteLevel(level);
 
         std::lock_guard<std::mutex> guard(*m);
-        std::fprintf(fd.get(), "%s%s%s|%s\n", ss.c_str(), ssL.c_str(), tag.c_str(), value.c_str());
+        std::fprintf(fd.get(), "%s%s%s|%s\n", ss.c_str(), ssL.c_str(), tag, value);
         std::fflush(fd.get());
     }
 
@@ -170,20 +458,59 @@ namespace PCOE {
             return;
         }
         va_start(args, format);
+        VFormatLine(level, tag.c_str(), format.c_str(), args);
+        va_end(args);
+    }
+
+    void Log::FormatLine(const LOG_VERBOSITY level, const char* tag, const char* format, ...) const {
+        va_list args;
+
+        if (level > LOG_LEVEL || !fd) {
+            return;
+        }
+        va_start(args, format);
+        VFormatLine(level, tag, format, args);
+        va_end(args);
+    }
+
+    void Log::VFormatLine(const LOG_VERBOSITY level, const char* tag, const char* format,
+        va_list args) const {
+        if (AsyncLogWriter::enabled) {
+            // Arguments may not outlive the call, so the message is formatted here
+            LogRecord record = MakeRecord(level, tag, fd);
+            va_list argsCopy;
+            va_copy(argsCopy, args);
+            int length = std::vsnprintf(record.text, LogRecord::TEXT_SIZE, format, argsCopy);
+            va_end(argsCopy);
+            if (length >= static_cast<int>(LogRecord::TEXT_SIZE)) {
+                std::size_t size = static_cast<std::size_t>(length) + 1;
+                record.longText.resize(size);
+                std::vsnprintf(&record.longText[0], size, format, args);
+                record.longText.resize(size - 1);
+            }
+            AsyncLogWriter::instance().push(std::move(record));
+            return;
+        }
 
         std::string ss = WriteTime();
         std::string ssL = WriteLevel(level);
 
         std::lock_guard<std::mutex> guard(*m);
-        std::fprintf(fd.get(), "%s%s%s|", ss.c_str(), ssL.c_str(), tag.c_str());
-        std::vfprintf(fd.get(), format.c_str(), args);
+        std::fprintf(fd.get(), "%s%s%s|", ss.c_str(), ssL.c_str(), tag);
+        std::vfprintf(fd.get(), format, args);
         std::fputc('\n', fd.get());
         std::fflush(fd.get());
-
-        va_end(args);
     }
 
     void Log::LogVerbatim(const std::string & text) const {
+        if (AsyncLogWriter::enabled && fd) {
+            LogRecord record = MakeRecord(LOG_OFF, "", fd);
+            record.verbatim = true;
+            SetText(record, text.c_str());
+            AsyncLogWriter::instance().push(std::move(record));
+            return;
+        }
+
         std::lock_guard<std::mutex> guard(*m);
         std::fprintf(fd.get(), "%s\n", text.c_str());
         std::fflush(fd.get());
@@ -16,6 +16,7 @@
  *     All Rights Reserved.
  **/
 
+#include <algorithm>
 #include <cmath>  // For isnan
 #include <chrono>  // For lastUpdated
 #include <stdexcept>
@@ -192,9 +193,28 @@ namespace PCOE {
         return m_interface->getVec(key, m_data);
     }
 
+    UData::size_type UData::getVec(const size_type key, double * values, const size_type count) const {
+        if (key >= m_data.size()) {
+            return 0;
+        }
+        size_type n = std::min(count, m_data.size() - key);
+        std::copy(m_data.begin() + static_cast<difference_type>(key),
+                  m_data.begin() + static_cast<difference_type>(key + n), values);
+        return n;
+    }
+
     void UData::setVec(const size_type key, const std::vector<double> & value) {
         m_interface->setVec(key, value, m_data);
         m_updated = clock::now();
         m_valid = true;
     }
+
+    void UData::setVec(const size_type key, const double * values, const size_type count) {
+        // Same as UDataInterface::setVec, which no interface overrides
+        for (size_type i = 0; i < count && key + i < m_data.size(); i++) {
+            m_data[key + i] = values[i];
+        }
+        m_updated = clock::now();
+        m_valid = true;
+    }
 }
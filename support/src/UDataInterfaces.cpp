@@ -41,11 +41,10 @@ namespace PCOE {
     }
 
     std::vector<double> UDataInterface::getVec(const std::vector<double>::size_type key, const std::vector<double> &data) const {
-        std::vector<double> returnValue;
-        for (auto i = key; i < data.size(); i++) {
-            returnValue.push_back(data[i]);
+        if (key >= data.size()) {
+            return std::vector<double>();
         }
-        return returnValue;
+        return std::vector<double>(data.begin() + static_cast<std::vector<double>::difference_type>(key), data.end());
     }
 
 
@@ -25,6 +25,7 @@
 #include <cmath>
 
 #include "GSAPConfigMap.h"
+#include "MatrixDecomposition.h"
 #include "Model.h"
 #include "UData.h"
 
@@ -40,7 +41,20 @@ namespace PCOE {
     const std::string B_KEY = "Observer.beta";
     
     // Other string constants
-    const std::string MODULE_NAME = "UnscentedKalmanFilter";
+    // A C string, so that logging from step does not allocate
+    const char MODULE_NAME[] = "UnscentedKalmanFilter";
+
+    namespace {
+        // Copy src into dst, only reallocating dst if it is the wrong size
+        void copyInto(const Matrix& src, Matrix& dst) {
+            if (dst.rows() != src.rows() || dst.cols() != src.cols()) {
+                dst.resize(src.rows(), src.cols());
+            }
+            for (std::size_t i = 0; i < src.rows(); i++) {
+                std::copy(src.rowData(i), src.rowData(i) + src.cols(), dst.rowData(i));
+            }
+        }
+    }
     
     // Constructor
     UnscentedKalmanFilter::UnscentedKalmanFilter(Model * model, const Matrix Q, const Matrix R) : Observer() {
@@ -88,6 +102,32 @@ namespace PCOE {
         if (std::isnan(m_sigmaX.beta)) {
             m_sigmaX.beta = 0;
         }
+
+        // Size the step workspace. Matrix zero-initializes, which the noise matrices rely on.
+        std::size_t numStates = pModel->getNumStates();
+        std::size_t numInputs = pModel->getNumInputs();
+        std::size_t numOutputs = pModel->getNumOutputs();
+        std::size_t numSigmaPoints = 2 * numStates + 1;
+        m_work.Xkk1 = Matrix(numStates, numSigmaPoints);
+        m_work.Zkk1 = Matrix(numOutputs, numSigmaPoints);
+        m_work.Xc = Matrix(numStates, numSigmaPoints);
+        m_work.Zc = Matrix(numOutputs, numSigmaPoints);
+        m_work.U = Matrix(numInputs, numSigmaPoints);
+        m_work.zeroNoiseX = Matrix(numStates, numSigmaPoints);
+        m_work.zeroNoiseZ = Matrix(numOutputs, numSigmaPoints);
+        m_work.Pkk1 = Matrix(numStates, numStates);
+        m_work.Pzz = Matrix(numOutputs, numOutputs);
+        m_work.Pxz = Matrix(numStates, numOutputs);
+        m_work.PxzT = Matrix(numOutputs, numStates);
+        m_work.Kk = Matrix(numStates, numOutputs);
+        m_work.KkT = Matrix(numOutputs, numStates);
+        m_work.KkPzz = Matrix(numStates, numOutputs);
+        m_work.scaledP = Matrix(numStates, numStates);
+        m_work.cholP.factor(Matrix::identity(numStates));
+        m_work.cholPzz.factor(Matrix::identity(numOutputs));
+        m_work.xkk1.resize(numStates);
+        m_work.zkk1.resize(numOutputs);
+        m_work.zeroNoiseZVector.assign(numOutputs, 0.0);
     }
     
     // GSAPConfigMap-based Constructor
@@ -97,39 +137,11 @@ namespace PCOE {
         
         // Set Q
         log.WriteLine(LOG_DEBUG, MODULE_NAME, "Setting Q");
-        std::vector<std::string> QValues = configMap.at(Q_KEY);
-        // Make sure it has enough values to fill a square matrix
-        if (std::abs(sqrt(QValues.size()) - floor(sqrt(QValues.size()))) > 1e-12) {
-            log.WriteLine(LOG_ERROR, MODULE_NAME, "Q is not a square matrix!");
-            throw std::domain_error("Q is not a square matrix!");
-        }
-        std::size_t dimension = static_cast<std::size_t>(sqrt(QValues.size()));
-        m_Q.resize(dimension, dimension);
-        unsigned int qValueIndex = 0;
-        for (unsigned int row = 0; row < dimension; row++) {
-            for (unsigned int col = 0; col < dimension; col++) {
-                m_Q[row][col] = std::stod(QValues[qValueIndex]);
-                qValueIndex++;
-            }
-        }
-        
+        m_Q = readSquareMatrix(configMap, Q_KEY, "Q", MODULE_NAME);
+
         // Set R
         log.WriteLine(LOG_DEBUG, MODULE_NAME, "Setting R");
-        std::vector<std::string> RValues = configMap.at(R_KEY);
-        // Make sure it has enough values to fill a square matrix
-        if (std::abs(sqrt(RValues.size()) - floor(sqrt(RValues.size()))) > 1e-12) {
-            log.WriteLine(LOG_ERROR, MODULE_NAME, "R is not a square matrix!");
-            throw std::domain_error("R is not a square matrix!");
-        }
-        dimension = static_cast<std::size_t>(sqrt(RValues.size()));
-        m_R.resize(dimension, dimension);
-        unsigned int rValueIndex = 0;
-        for (unsigned int row = 0; row < dimension; row++) {
-            for (unsigned int col = 0; col < dimension; col++) {
-                m_Q[row][col] = std::stod(RValues[rValueIndex]);
-                rValueIndex++;
-            }
-        }
+        m_R = readSquareMatrix(configMap, R_KEY, "R", MODULE_NAME);
         
         // Set kappa (optional)
         if (configMap.includes(K_KEY)) {
@@ -219,9 +231,11 @@ namespace PCOE {
     }
     
     // Step function (required by Observer interface)
+    // All temporaries live in m_work, so after the first call this does not
+    // allocate unless the model's equations do.
     void UnscentedKalmanFilter::step(const double newT, const std::vector<double> & u,
                                      const std::vector<double> & z) {
-        log.WriteLine(LOG_DEBUG, MODULE_NAME, "Starting step");
+        PCOE_LOG_LINE(log, LOG_DEBUG, MODULE_NAME, "Starting step");
         
         if (!isInitialized()) {
             log.WriteLine(LOG_ERROR, MODULE_NAME, "Called step before initialized");
@@ -237,89 +251,78 @@ namespace PCOE {
         }
         
         unsigned int numStates = pModel->getNumStates();
+        unsigned int numInputs = pModel->getNumInputs();
         unsigned int numOutputs = pModel->getNumOutputs();
         unsigned int numSigmaPoints = static_cast<unsigned int>(m_sigmaX.M.cols());
-        
-        std::vector<double> zeroNoise(numStates);
+        Workspace & w = m_work;
         
         // 1. Predict
-        log.WriteLine(LOG_TRACE, MODULE_NAME, "Starting step - predict");
+        PCOE_LOG_LINE(log, LOG_TRACE, MODULE_NAME, "Starting step - predict");
         
         // Compute sigma points for current state estimate
         computeSigmaPoints(m_xEstimated, m_Q, m_sigmaX.kappa, m_sigmaX.alpha, m_sigmaX.M, m_sigmaX.w);
         
-        // Propagate sigma points through state equation
-        Matrix Xkk1(numStates, numSigmaPoints);
-        for (unsigned int i = 0; i < numSigmaPoints; i++) {
-            // Get ith sigma point
-            std::vector<double> x = static_cast<std::vector<double>>(m_sigmaX.M.col(i));
-            // Apply state equation
-            pModel->stateEqn(newT, x, m_uOld, zeroNoise, dt);
-            // Set column in Xkk1
-            Xkk1.col(i, x);
+        // Propagate sigma points through state equation, all sigma points at once
+        copyInto(m_sigmaX.M, w.Xkk1);
+        for (unsigned int i = 0; i < numInputs; i++) {
+            std::fill(w.U.rowData(i), w.U.rowData(i) + numSigmaPoints, m_uOld[i]);
         }
+        pModel->stateEqnBatch(newT, w.Xkk1, w.U, w.zeroNoiseX, dt);
         
-        // Recombine weighted sigma points to produce predicted state and covariance
-        std::vector<double> xkk1 = static_cast<std::vector<double>>(Xkk1.weightedMean(Matrix(m_sigmaX.w)));
-        Matrix Pkk1 = Xkk1.weightedCovariance(Matrix(m_sigmaX.w), m_sigmaX.alpha, m_sigmaX.beta) + m_Q;
+        // Recombine weighted sigma points to produce predicted state and covariance. The
+        // first weight is corrected once per sigma point, matching Matrix::weightedCovariance.
+        double w0Correction = numSigmaPoints * (1 - m_sigmaX.alpha * m_sigmaX.alpha + m_sigmaX.beta);
+        weightedCenter(w.Xkk1, m_sigmaX.w, w.xkk1, w.Xc);
+        weightedCovariance(w.Xc, m_sigmaX.w, w0Correction, w.Pkk1);
+        w.Pkk1 += m_Q;
         
         // Propagate sigma points through output equation
-        Matrix Zkk1(numOutputs, numSigmaPoints);
-        for (unsigned int i = 0; i < numSigmaPoints; i++) {
-            // Get ith predicted sigma point
-            std::vector<double> zkk1(numOutputs);
-            // Apply state equation
-            pModel->outputEqn(newT, static_cast<std::vector<double>>(Xkk1.col(i)), u, zeroNoise, zkk1);
-            // Set column in Zkk1
-            Zkk1.col(i, zkk1);
+        for (unsigned int i = 0; i < numInputs; i++) {
+            std::fill(w.U.rowData(i), w.U.rowData(i) + numSigmaPoints, u[i]);
         }
+        pModel->outputEqnBatch(newT, w.Xkk1, w.U, w.zeroNoiseZ, w.Zkk1);
         
         // Recombine weighted sigma points to produce predicted measurement and covariance
-        std::vector<double> zkk1 = static_cast<std::vector<double>>(Zkk1.weightedMean(Matrix(m_sigmaX.w)));
-        Matrix Pzz = Zkk1.weightedCovariance(Matrix(m_sigmaX.w), m_sigmaX.alpha, m_sigmaX.beta) + m_R;
+        weightedCenter(w.Zkk1, m_sigmaX.w, w.zkk1, w.Zc);
+        weightedCovariance(w.Zc, m_sigmaX.w, w0Correction, w.Pzz);
+        w.Pzz += m_R;
         
         // 2. Update
-        log.WriteLine(LOG_TRACE, MODULE_NAME, "Starting step - update");
+        PCOE_LOG_LINE(log, LOG_TRACE, MODULE_NAME, "Starting step - update");
         
         // Compute state-output cross-covariance matrix
-        Matrix Pxz(numStates, numOutputs);
-        for (unsigned int i = 0; i < numSigmaPoints; i++) {
-            Matrix columnx(numStates, 1);
-            Matrix columnz(numOutputs, 1);
-            columnx.col(0, Xkk1.col(i));
-            columnz.col(0, Zkk1.col(i));
-            
-            Matrix xkk1m(numStates, 1);
-            Matrix zkk1m(numOutputs, 1);
-            xkk1m.col(0, xkk1);
-            zkk1m.col(0, zkk1);
-            
-            Matrix diffx = columnx - xkk1m;
-            Matrix diffzT = (columnz - zkk1m).transpose();
-            Matrix temp = diffx*diffzT;
-            Pxz = Pxz + temp*m_sigmaX.w[i];
+        weightedCrossCovariance(w.Xc, w.Zc, m_sigmaX.w, w.Pxz);
+        
+        // Compute Kalman gain, Kk = Pxz*Pzz^-1. Since Pzz is symmetric, Kk' = Pzz^-1*Pxz', which is
+        // found with triangular solves against the Cholesky factor of Pzz rather than an explicit inverse.
+        w.Pxz.transposeInto(w.PxzT);
+        try {
+            w.cholPzz.factor(w.Pzz);
+            w.cholPzz.solve(w.PxzT, w.KkT);
         }
+        catch (std::domain_error &) {
+            PCOE_LOG_LINE(log, LOG_DEBUG, MODULE_NAME, "Pzz is not positive definite, using LU decomposition");
+            w.KkT = w.Pzz.solve(w.PxzT);
+        }
+        w.KkT.transposeInto(w.Kk);
         
-        
-        // Compute Kalman gain
-        Matrix Kk = Pxz*Pzz.inverse();
-        
-        // Compute state estimate
-        Matrix xkk1m(numStates, 1);
-        Matrix zkk1m(numOutputs, 1);
-        Matrix zm(numOutputs, 1);
-        xkk1m.col(0, xkk1);
-        zkk1m.col(0, zkk1);
-        zm.col(0, z);
-        Matrix xk1m = xkk1m + Kk*(zm - zkk1m);
-        m_xEstimated = static_cast<std::vector<double>>(xk1m.col(0));
+        // Compute state estimate, x = xkk1 + Kk*(z - zkk1)
+        for (unsigned int i = 0; i < numStates; i++) {
+            const double* gainRow = w.Kk.rowData(i);
+            double correction = 0;
+            for (unsigned int j = 0; j < numOutputs; j++) {
+                correction += gainRow[j] * (z[j] - w.zkk1[j]);
+            }
+            m_xEstimated[i] = w.xkk1[i] + correction;
+        }
         
         // Compute output estimate
-        std::vector<double> zeroNoiseZ(numOutputs);
-        pModel->outputEqn(newT, m_xEstimated, u, zeroNoiseZ, m_zEstimated);
+        pModel->outputEqn(newT, m_xEstimated, u, w.zeroNoiseZVector, m_zEstimated);
         
-        // Compute covariance
-        m_P = Pkk1 - Kk*Pzz*Kk.transpose();
+        // Compute covariance, P = Pkk1 - Kk*Pzz*Kk'
+        gemm(1.0, w.Kk, w.Pzz, 0.0, w.KkPzz);
+        copyInto(w.Pkk1, m_P);
+        gemm(-1.0, w.KkPzz, w.KkT, 1.0, m_P);
         
         // Update uOld
         m_uOld = u;
@@ -331,7 +334,7 @@ namespace PCOE {
                                                    const Matrix & Pxx, const double kappa,
                                                    const double alpha,
                                                    Matrix & X, std::vector<double> & w) {
-        log.WriteLine(LOG_TRACE, MODULE_NAME, "Computing sigma points");
+        PCOE_LOG_LINE(log, LOG_TRACE, MODULE_NAME, "Computing sigma points");
         
         // Assumes that sigma points have been set up correctly within the constructor
         unsigned int numStates = static_cast<unsigned int>(mx.size());
@@ -343,13 +346,15 @@ namespace PCOE {
         }
         
         // Compute a matrix square root using Cholesky decomposition
-        Matrix nkPxx = Pxx;
+        Matrix & nkPxx = m_work.scaledP;
+        copyInto(Pxx, nkPxx);
         for (unsigned int i = 0; i < nkPxx.rows(); i++) {
             for (unsigned int j = 0; j < nkPxx.cols(); j++) {
                 nkPxx[i][j] *= (numStates + kappa);
             }
         }
-        Matrix matrixSq = nkPxx.chol();
+        m_work.cholP.factor(nkPxx);
+        const Matrix & matrixSq = m_work.cholP.lower();
         
         // For sigma points 2 to n+1, it is mx + ith column of matrix square root
         for (unsigned int i = 0; i < numStates; i++) {
@@ -377,9 +382,11 @@ namespace PCOE {
         
         // Scale the sigma points
         // 1. Xi' = X0 + alpha*(Xi-X0)
-        Matrix X0 = X.col(0);
-        for (unsigned int i = 1; i < numSigmaPoints; i++) {
-            X.col(i,X0 + alpha*(X.col(i)-X0));
+        for (unsigned int i = 0; i < X.rows(); i++) {
+            double* row = X.rowData(i);
+            for (unsigned int j = 1; j < numSigmaPoints; j++) {
+                row[j] = row[0] + alpha * (row[j] - row[0]);
+            }
         }
         
         // 2. W0' = W0/alpha^2 + (1/alpha^2-1)
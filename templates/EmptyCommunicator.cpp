@@ -13,7 +13,8 @@
 namespace PCOE {
     const std::string MODULE_NAME = "EMPTYCOMM"; // Replace with your module name for log
 
-    EmptyCommunicator::EmptyCommunicator(const ConfigMap & configMap) {
+    EmptyCommunicator::EmptyCommunicator(const ConfigMap & configMap) :
+        CommonCommunicator(configMap) {
         log.WriteLine(LOG_DEBUG, MODULE_NAME, "Configuring");
         ///------------------------------------
         /// HERE IS WHERE YOU CONFIGURE THE Communicator.
@@ -28,7 +29,7 @@ namespace PCOE {
         ///------------------------------------
     }
 
-    void EmptyCommunicator::write(AllData data) {
+    void EmptyCommunicator::write(const AllData & data) {
         ///------------------------------------
         /// HERE IS WHERE YOU SEND DATA
         ///     Send any of the data in the DataStore data or progData
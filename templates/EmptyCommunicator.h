@@ -37,7 +37,7 @@ namespace PCOE {
          *  @param      data        Reference to DataStore containing all the input data
          *  @param      progData    Output from each prognoser
          **/
-        void write(AllData data) override; // Comment out if not needed
+        void write(const AllData & data) override; // Comment out if not needed
 
         /** @brief      Subscriber callback function- used to introduce data into the prognostic framework
          *  @param      data  Reference to DataStore containing all the data